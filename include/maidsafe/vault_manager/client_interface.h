@@ -19,49 +19,181 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_CLIENT_INTERFACE_H_
 #define MAIDSAFE_VAULT_MANAGER_CLIENT_INTERFACE_H_
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <exception>
 #include <functional>
 #include <future>
-#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "asio/io_service.hpp"
 #include "asio/io_service_strand.hpp"
+#include "asio/steady_timer.hpp"
 #include "boost/filesystem/path.hpp"
+#include "boost/optional/optional.hpp"
 
 #include "maidsafe/common/asio_service.h"
-#include "maidsafe/common/on_scope_exit.h"
 #include "maidsafe/common/rsa.h"
 #include "maidsafe/common/types.h"
 #include "maidsafe/passport/passport.h"
 
+#include "maidsafe/vault_manager/vault_event.h"
+
 namespace maidsafe {
 
 namespace vault_manager {
 
-namespace detail {
-
-template <typename ResultType, typename MessageType>
-struct PromiseAndTimer;
-
-}  // namespace detail
-
+class TimingWheel;
+struct Capabilities;
 struct Challenge;
 struct LogMessage;
+struct OwnerAdded;
+struct OwnerChallenge;
+struct SessionTicket;
+struct VaultEventNotification;
 struct VaultRunningResponse;
 struct VaultStartedResponse;
 
+// Parameters of a single vault in a batched StartVaults call.  If 'vault_dir' is empty, the
+// VaultManager chooses the vault's directory.  If 'owner' is set, the vault is started on behalf
+// of that Maid, which must have been added with AddMaid; otherwise on behalf of the
+// ClientInterface's own Maid.
+struct StartVaultSpec {
+  StartVaultSpec(boost::filesystem::path vault_dir_in, DiskUsage max_disk_usage_in)
+      : vault_dir(std::move(vault_dir_in)),
+        max_disk_usage(std::move(max_disk_usage_in)),
+        owner() {
+#if defined(USE_VLOGGING) && defined(TESTING)
+    send_hostname_to_visualiser_server = false;
+#endif
+#ifdef TESTING
+    pmid_list_index = -1;
+#endif
+  }
+
+  boost::filesystem::path vault_dir;
+  DiskUsage max_disk_usage;
+  boost::optional<passport::PublicMaid::Name> owner;
+#ifdef USE_VLOGGING
+  std::string vlog_session_id;
+#endif
+#if defined(USE_VLOGGING) && defined(TESTING)
+  bool send_hostname_to_visualiser_server;
+#endif
+#ifdef TESTING
+  int pmid_list_index;  // Ignored if negative.
+#endif
+};
+
+// Parameters of a single vault in a TakeOwnership call.  'owner' is as for StartVaultSpec.
+struct TakeOwnershipSpec {
+  TakeOwnershipSpec(NonEmptyString label_in, boost::filesystem::path vault_dir_in,
+                    DiskUsage max_disk_usage_in)
+      : label(std::move(label_in)),
+        vault_dir(std::move(vault_dir_in)),
+        max_disk_usage(std::move(max_disk_usage_in)),
+        owner() {}
+
+  NonEmptyString label;
+  boost::filesystem::path vault_dir;
+  DiskUsage max_disk_usage;
+  boost::optional<passport::PublicMaid::Name> owner;
+};
+
+// If the connection to the VaultManager is lost, the ClientInterface reconnects automatically
+// (backing off exponentially, with jitter, between attempts).  It resumes its session using the
+// ticket issued by the VaultManager where possible, replays any vault requests still awaiting a
+// response and renews any vault event subscription.
+//
+// Further Maids can be authenticated over the same connection with AddMaid, each through its own
+// challenge, so that one ClientInterface can act for many owners.  They are authenticated again
+// automatically after a reconnection.  Vault events are only delivered for the ClientInterface's
+// own Maid.
+//
+// There are two ways to use it.  Constructed with just a Maid, it runs its own asio thread and
+// the constructor blocks until the session is established; requests return futures.  Constructed
+// with a caller-supplied io_service, it starts no asio thread, and AsyncConnect and the Async*
+// request functions report through completion handlers instead (see client_interface_awaitable.h
+// for C++20 coroutine support).  The blocking API is a thin wrapper around the asynchronous one.
+// Either way, since tcp::Connection only connects synchronously, each attempt to connect runs on
+// a short-lived thread of its own so that it doesn't hold up the strand.
 class ClientInterface {
  public:
+  typedef std::function<void(const VaultEvent&)> VaultEventFunctor;
+  typedef uint64_t RequestId;
+  // 'error' is null on success.  Handlers are invoked once each, on the ClientInterface's strand,
+  // and must not block.  Any still outstanding when the ClientInterface is destroyed are dropped.
+  typedef std::function<void(std::exception_ptr error)> ConnectHandler;
+  typedef std::function<void(std::exception_ptr error,
+                             std::unique_ptr<passport::PmidAndSigner> pmid_and_signer)>
+      VaultRequestHandler;
+  // Invoked once per vault of a batch, with the vault's index in the batch.
+  typedef std::function<void(std::size_t index, std::exception_ptr error,
+                             std::unique_ptr<passport::PmidAndSigner> pmid_and_signer)>
+      BatchVaultRequestHandler;
+
+  // An in-flight request.  'request_id' can be passed to CancelRequest.
+  struct PendingVaultRequest {
+    PendingVaultRequest(RequestId request_id_in,
+                        std::future<std::unique_ptr<passport::PmidAndSigner>> result_in)
+        : request_id(request_id_in), result(std::move(result_in)) {}
+    PendingVaultRequest(PendingVaultRequest&& other)
+        : request_id(other.request_id), result(std::move(other.result)) {}
+    PendingVaultRequest& operator=(PendingVaultRequest&& other) {
+      request_id = other.request_id;
+      result = std::move(other.result);
+      return *this;
+    }
+
+    RequestId request_id;
+    std::future<std::unique_ptr<passport::PmidAndSigner>> result;
+  };
+
   ClientInterface(const ClientInterface&) = delete;
   ClientInterface(ClientInterface&&) = delete;
   ClientInterface& operator=(ClientInterface) = delete;
 
   explicit ClientInterface(const passport::Maid& maid);
+  // Doesn't connect until AsyncConnect is called.  'io_service' must outlive this object, which
+  // must not be destroyed from a handler running on 'io_service' other than one of its own.  If
+  // nothing is running 'io_service' by then, destruction takes up to kRpcTimeout longer.
+  ClientInterface(const passport::Maid& maid, asio::io_service& io_service);
   ~ClientInterface();
 
+  // Connects to the VaultManager and establishes a session.  Must be called exactly once on an
+  // object constructed with a caller-supplied io_service.  The connect blocks, so it's made on a
+  // thread of its own; the handler is invoked once, on the strand.  On failure (including timing
+  // out) any connection is closed and the object should be destroyed.
+  void AsyncConnect(ConnectHandler on_session_established);
+
+  // Authenticates 'maid' over this object's connection.  Once done, requests can be made on its
+  // behalf by setting the 'owner' of a StartVaultSpec or TakeOwnershipSpec to its name.
+  std::future<void> AddMaid(const passport::Maid& maid);
+  void AsyncAddMaid(const passport::Maid& maid, ConnectHandler on_added);
+
+  // Completion-handler equivalents of the future-returning functions below.  They never block, and
+  // return the ID of the request (or requests, for batches) for use with CancelRequest.
+  RequestId AsyncTakeOwnership(const NonEmptyString& label,
+                               const boost::filesystem::path& vault_dir, DiskUsage max_disk_usage,
+                               std::chrono::steady_clock::duration timeout,
+                               VaultRequestHandler handler);
+  RequestId AsyncTakeOwnership(const TakeOwnershipSpec& spec,
+                               std::chrono::steady_clock::duration timeout,
+                               VaultRequestHandler handler);
+  RequestId AsyncStartVault(const StartVaultSpec& spec,
+                            std::chrono::steady_clock::duration timeout,
+                            VaultRequestHandler handler);
+  std::vector<RequestId> AsyncStartVaults(const std::vector<StartVaultSpec>& specs,
+                                          BatchVaultRequestHandler handler);
+  std::vector<RequestId> AsyncTakeOwnership(const std::vector<TakeOwnershipSpec>& specs,
+                                            BatchVaultRequestHandler handler);
+
   std::future<std::unique_ptr<passport::PmidAndSigner>> TakeOwnership(
       const NonEmptyString& label, const boost::filesystem::path& vault_dir,
       DiskUsage max_disk_usage);
@@ -75,6 +207,39 @@ class ClientInterface {
       const boost::filesystem::path& vault_dir, DiskUsage max_disk_usage);
 #endif
 
+  // Variants of TakeOwnership and StartVault with a per-request deadline.  Each request carries its
+  // own ID, so any number can be in flight at once (including several for the same label).
+  PendingVaultRequest TakeOwnership(const NonEmptyString& label,
+                                    const boost::filesystem::path& vault_dir,
+                                    DiskUsage max_disk_usage,
+                                    std::chrono::steady_clock::duration timeout);
+  PendingVaultRequest TakeOwnership(const TakeOwnershipSpec& spec,
+                                    std::chrono::steady_clock::duration timeout);
+  PendingVaultRequest StartVault(const StartVaultSpec& spec,
+                                 std::chrono::steady_clock::duration timeout);
+
+  // Fails the request with asio::error::operation_aborted.  Any later response from the
+  // VaultManager for this request is ignored.  Returns false if the request has already completed.
+  bool CancelRequest(RequestId request_id);
+
+  // Batched equivalents of StartVault and TakeOwnership, sent to the VaultManager as a single
+  // request.  The returned futures are in the same order as 'specs', and each becomes ready
+  // independently as soon as the VaultManager reports on the corresponding vault.
+  std::vector<std::future<std::unique_ptr<passport::PmidAndSigner>>> StartVaults(
+      const std::vector<StartVaultSpec>& specs);
+  std::vector<std::future<std::unique_ptr<passport::PmidAndSigner>>> TakeOwnership(
+      const std::vector<TakeOwnershipSpec>& specs);
+
+  // Subscribes to state transitions of all vaults owned by this client's Maid.  Events still held
+  // by the VaultManager with a sequence number greater than 'last_sequence_number' are replayed
+  // first, so a client which reconnects can pass the value of LastVaultEventSequenceNumber() from
+  // its previous session to resume without missing events.  If events it hadn't seen are no longer
+  // held, the first one passed on has 'follows_gap' set.  'on_vault_event' is invoked on this
+  // object's asio thread and must not block.
+  void SubscribeToVaultEvents(VaultEventFunctor on_vault_event,
+                              uint64_t last_sequence_number = 0);
+  uint64_t LastVaultEventSequenceNumber() const;
+
 #ifdef TESTING
   // This function sets up global variables specifying:
   // * the desired TCP listening port of the VaultManager (VM)
@@ -107,35 +272,114 @@ class ClientInterface {
 
   // Blocks until MarkNetworkAsStable is called.
   std::future<void> WaitForStableNetwork();
+  // Invokes 'on_stable' once MarkNetworkAsStable has been called.
+  void AsyncWaitForStableNetwork(std::function<void()> on_stable);
 #endif
 
  private:
-  typedef detail::PromiseAndTimer<std::unique_ptr<passport::PmidAndSigner>, VaultStartedResponse>
-      VaultRequest;
+  ClientInterface(const passport::Maid& maid, std::unique_ptr<AsioService> asio_service,
+                  asio::io_service* io_service);
 
+  // Runs ConnectToVaultManager on a thread of its own, since it blocks, then passes the new
+  // connection or the error to 'on_done' on the strand, unless this object is being destroyed.
+  void AsyncConnectToVaultManager(
+      std::function<void(std::shared_ptr<tcp::Connection>, std::exception_ptr)> on_done);
   std::shared_ptr<tcp::Connection> ConnectToVaultManager();
-  std::future<std::unique_ptr<passport::PmidAndSigner>> AddVaultRequest(
-      const NonEmptyString& label);
+  std::shared_ptr<tcp::Connection> ConnectToPort(tcp::Port port);
+  // Whether the VaultManager on 'tcp_connection' identifies itself as 'instance_id'.  Closes the
+  // connection if not.
+  bool IsVaultManagerInstance(std::shared_ptr<tcp::Connection> tcp_connection,
+                              const std::string& instance_id);
+  void FinishConnect(std::exception_ptr error);
+  // Sends a ResumeSessionRequest if we hold a session ticket, otherwise ValidateConnectionRequest.
+  void StartSession();
+  void HandleConnectionClosed(uint64_t connection_generation);
+  void ScheduleReconnect();
+  void Reconnect();
+  // Replays the requests made on behalf of 'owner' (or of our own Maid if not set).
+  void ReplayPendingRequests(const boost::optional<passport::PublicMaid::Name>& owner);
+  // Authenticates all added Maids again over a new connection.
+  void ReAddMaids();
+  // 'on_added' is null when re-adding a Maid after reconnecting.
+  RequestId AddPendingOwner(const passport::Maid& maid, ConnectHandler on_added);
+  void FinishAddOwner(RequestId request_id, std::exception_ptr error);
+  // Send via the current connection.  Messages sent while reconnecting are dropped.
+  template <typename MessageType>
+  void SendToVaultManager(MessageType message);
+  void SendSerialised(tcp::Message message);
+  // Keeps a copy of 'message' to replay if the connection is lost before the request completes.
+  void RetainForReplay(RequestId request_id, tcp::Message message);
+  RequestId AddVaultRequest(const NonEmptyString& label,
+                            std::chrono::steady_clock::duration timeout,
+                            const boost::optional<passport::PublicMaid::Name>& owner,
+                            VaultRequestHandler handler);
+  // Removes the request and invokes its handler.  Returns false if it has already completed.
+  bool CompleteVaultRequest(RequestId request_id, std::exception_ptr error,
+                            std::unique_ptr<passport::PmidAndSigner> pmid_and_signer);
   void HandleReceivedMessage(tcp::Message&& message);
+  void HandleCompactMessage(const tcp::Message& message);
+  void HandleCapabilities(Capabilities&& capabilities);
   void HandleVaultRunningResponse(VaultRunningResponse&& vault_running_response);
 #ifdef TESTING
   void HandleNetworkStableResponse();
 #endif
-  void InvokeCallBack(Challenge&& challenge, std::function<void(Challenge&&)>& callback);
+  void HandleChallenge(Challenge&& challenge);
+  void HandleSessionTicket(SessionTicket&& session_ticket);
+  void HandleOwnerChallenge(OwnerChallenge&& owner_challenge);
+  void HandleOwnerAdded(OwnerAdded&& owner_added);
   void HandleLogMessage(LogMessage&& log_message);
+  void HandleVaultEventNotification(VaultEventNotification&& vault_event_notification);
+
+  struct OngoingVaultRequest {
+    OngoingVaultRequest(VaultRequestHandler handler_in,
+                        boost::optional<passport::PublicMaid::Name> owner_in)
+        : handler(std::move(handler_in)), timer_id(0), owner(std::move(owner_in)), message() {}
+
+    VaultRequestHandler handler;
+    uint64_t timer_id;  // A TimingWheel::TimerId.
+    // Not set if acting for our own Maid.
+    boost::optional<passport::PublicMaid::Name> owner;
+    tcp::Message message;
+  };
+
+  struct PendingOwner {
+    PendingOwner(passport::Maid maid_in, ConnectHandler on_added_in)
+        : maid(std::move(maid_in)), on_added(std::move(on_added_in)), timer_id(0) {}
+
+    passport::Maid maid;
+    ConnectHandler on_added;
+    uint64_t timer_id;
+  };
 
   const passport::Maid kMaid_;
-  std::mutex mutex_;
-  std::function<void(Challenge&&)> on_challenge_;
-  std::promise<void> network_stable_;
-  std::once_flag network_stable_flag_;
-  std::map<NonEmptyString, std::shared_ptr<VaultRequest>> ongoing_vault_requests_;
-  AsioService asio_service_;
+  const passport::PublicMaid::Name kMaidName_;
+  mutable std::mutex mutex_;
+  std::atomic<bool> shutting_down_;
+  std::string session_ticket_;
+  ConnectHandler on_session_established_;
+  uint64_t session_timer_id_;
+  std::atomic<uint64_t> connection_generation_;
+  // Whether the VaultManager has advertised Capabilities::kCompactMessages on this connection.
+  std::atomic<bool> compact_messages_;
+  // Set while ConnectToVaultManager waits for the VaultManager's Capabilities to learn which
+  // instance it has reached.  Guarded by 'mutex_'.
+  std::promise<std::string>* instance_id_reply_;
+  int reconnect_attempts_;
+  std::vector<std::function<void()>> on_network_stable_;
+  std::unordered_map<RequestId, OngoingVaultRequest> ongoing_vault_requests_;
+  std::unordered_map<RequestId, PendingOwner> pending_owners_;
+  std::vector<passport::Maid> added_maids_;
+  std::atomic<RequestId> next_request_id_;
+  VaultEventFunctor on_vault_event_;
+  uint64_t last_vault_event_sequence_number_;
+  // Null if running on a caller-supplied io_service.
+  std::unique_ptr<AsioService> asio_service_;
   asio::io_service::strand strand_;
+  std::shared_ptr<TimingWheel> timing_wheel_;
+  asio::steady_timer reconnect_timer_;
   std::shared_ptr<tcp::Connection> tcp_connection_;
-  // We need to ensure the connection is closed in the event of the constructor throwing, or the
-  // asio_service destructor will hang.
-  on_scope_exit connection_closer_;
+  // The attempt to connect currently or most recently made by AsyncConnectToVaultManager.
+  std::future<void> connect_attempt_;
 };
 
 }  // namespace vault_manager
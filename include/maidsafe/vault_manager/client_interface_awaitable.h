@@ -0,0 +1,124 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_CLIENT_INTERFACE_AWAITABLE_H_
+#define MAIDSAFE_VAULT_MANAGER_CLIENT_INTERFACE_AWAITABLE_H_
+
+// Awaitable wrappers for ClientInterface's asynchronous functions, for use from C++20 coroutines.
+// They are only defined if the compiler supports coroutines, e.g.:
+//
+//   std::unique_ptr<passport::PmidAndSigner> pmid_and_signer{
+//       co_await AwaitStartVault(client_interface, spec, timeout)};
+//
+// The coroutine is resumed on the ClientInterface's strand.  Errors are rethrown by co_await.
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include "maidsafe/vault_manager/client_interface.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace detail {
+
+template <typename ResultType>
+class ClientInterfaceAwaiter {
+ public:
+  typedef std::function<void(std::exception_ptr, ResultType)> Handler;
+
+  explicit ClientInterfaceAwaiter(std::function<void(Handler)> start)
+      : start_(std::move(start)), error_(), result_() {}
+
+  bool await_ready() const noexcept { return false; }
+
+  void await_suspend(std::coroutine_handle<> coroutine) {
+    // The coroutine (and this awaiter with it) may be resumed and destroyed before 'start'
+    // returns, so nothing belonging to this object is touched after the handler is passed on.
+    auto start(std::move(start_));
+    start([this, coroutine](std::exception_ptr error, ResultType result) {
+      error_ = error;
+      result_ = std::move(result);
+      coroutine.resume();
+    });
+  }
+
+  ResultType await_resume() {
+    if (error_)
+      std::rethrow_exception(error_);
+    return std::move(result_);
+  }
+
+ private:
+  std::function<void(Handler)> start_;
+  std::exception_ptr error_;
+  ResultType result_;
+};
+
+struct Unit {};
+
+}  // namespace detail
+
+typedef detail::ClientInterfaceAwaiter<std::unique_ptr<passport::PmidAndSigner>>
+    VaultRequestAwaiter;
+
+// 'client_interface' must have been constructed with a caller-supplied io_service.
+inline detail::ClientInterfaceAwaiter<detail::Unit> AwaitConnect(
+    ClientInterface& client_interface) {
+  return detail::ClientInterfaceAwaiter<detail::Unit>(
+      [&client_interface](std::function<void(std::exception_ptr, detail::Unit)> handler) {
+        client_interface.AsyncConnect(
+            [handler](std::exception_ptr error) { handler(error, detail::Unit()); });
+      });
+}
+
+inline VaultRequestAwaiter AwaitStartVault(ClientInterface& client_interface,
+                                           StartVaultSpec spec,
+                                           std::chrono::steady_clock::duration timeout) {
+  return VaultRequestAwaiter([&client_interface, spec, timeout](
+      VaultRequestAwaiter::Handler handler) {
+    client_interface.AsyncStartVault(spec, timeout, std::move(handler));
+  });
+}
+
+inline VaultRequestAwaiter AwaitTakeOwnership(ClientInterface& client_interface,
+                                              NonEmptyString label,
+                                              boost::filesystem::path vault_dir,
+                                              DiskUsage max_disk_usage,
+                                              std::chrono::steady_clock::duration timeout) {
+  return VaultRequestAwaiter([&client_interface, label, vault_dir, max_disk_usage, timeout](
+      VaultRequestAwaiter::Handler handler) {
+    client_interface.AsyncTakeOwnership(label, vault_dir, max_disk_usage, timeout,
+                                        std::move(handler));
+  });
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // __cpp_impl_coroutine
+
+#endif  // MAIDSAFE_VAULT_MANAGER_CLIENT_INTERFACE_AWAITABLE_H_
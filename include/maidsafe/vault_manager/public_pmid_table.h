@@ -0,0 +1,82 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_PUBLIC_PMID_TABLE_H_
+#define MAIDSAFE_VAULT_MANAGER_PUBLIC_PMID_TABLE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/passport/types.h"
+
+namespace boost {
+
+namespace interprocess {
+
+class mapped_region;
+
+}  // namespace interprocess
+
+}  // namespace boost
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// A read-only table of PublicPmids held in a memory-mapped file.  The test environment writes it
+// once and every vault of a local test network maps the same file, so a vault is sent only the
+// file's path and checksum rather than every public key.  Keys are parsed only when looked up.
+//
+// The file holds a header, an index of fixed-size entries (name, offset, size) sorted by name, then
+// the serialised keys.  Mapping a table hashes and bounds-checks it, taking time linear in its
+// size; a lookup is a binary search of the index.  Copies share the mapping.  Threadsafe.
+class PublicPmidTable {
+ public:
+  // Writes 'public_pmids' to 'path', replacing any existing file, and returns the checksum to pass
+  // to the constructor.
+  static std::string Write(const boost::filesystem::path& path,
+                           const std::vector<passport::PublicPmid>& public_pmids);
+
+  // Throws if the file can't be mapped, is malformed or its contents don't hash to 'checksum'.
+  PublicPmidTable(const boost::filesystem::path& path, const std::string& checksum);
+
+  std::size_t Size() const { return count_; }
+  // Throws CommonErrors::no_such_element if there's no key called 'name'.
+  passport::PublicPmid Find(const passport::PublicPmid::Name& name) const;
+  // Parses every key, so is only suitable for small tables.
+  std::vector<passport::PublicPmid> GetAll() const;
+
+ private:
+  const unsigned char* Entry(std::size_t index) const;
+  passport::PublicPmid Parse(const unsigned char* entry) const;
+
+  std::shared_ptr<const boost::interprocess::mapped_region> region_;
+  const unsigned char* begin_;
+  std::size_t size_, count_;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_PUBLIC_PMID_TABLE_H_
@@ -19,6 +19,9 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_VAULT_CONFIG_H_
 #define MAIDSAFE_VAULT_MANAGER_VAULT_CONFIG_H_
 
+#include <chrono>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -31,6 +34,8 @@ namespace maidsafe {
 
 namespace vault_manager {
 
+class PublicPmidTable;
+
 struct VaultConfig {
   VaultConfig(const passport::Pmid& pmid_in, const boost::filesystem::path& vault_dir_in,
               const DiskUsage& max_disk_usage_in);
@@ -50,10 +55,41 @@ struct VaultConfig {
     kIgnoreStopRequest
   };
 
+  // How a dummy vault behaves once configured, so that scale and soak tests can mimic a realistic
+  // fleet.  The default vault starts at once, uses no extra memory, doesn't log, crash or join the
+  // network, and stops as soon as asked.
+  struct BehaviourProfile {
+    BehaviourProfile()
+        : startup_delay_min(0),
+          startup_delay_max(0),
+          resident_bytes(0),
+          log_lines_per_second(0),
+          crash_probability_per_minute(0.0),
+          shutdown_delay(0),
+          joined_network_delay(-1) {}
+    // Each vault draws its startup delay uniformly from this range.
+    std::chrono::milliseconds startup_delay_min, startup_delay_max;
+    // Allocated and touched once started.
+    uint64_t resident_bytes;
+    uint32_t log_lines_per_second;
+    double crash_probability_per_minute;
+    // Time taken to stop once asked.
+    std::chrono::milliseconds shutdown_delay;
+    // From having started until sending JoinedNetwork.  Negative for never.
+    std::chrono::milliseconds joined_network_delay;
+  };
+
   struct TestConfig {
-    TestConfig() : test_type(TestType::kNone), public_pmid_list() {}
+    TestConfig()
+        : test_type(TestType::kNone),
+          behaviour_profile(),
+          public_pmid_list(),
+          public_pmid_table() {}
     TestType test_type;
+    BehaviourProfile behaviour_profile;
     std::vector<passport::PublicPmid> public_pmid_list;
+    // Set instead of 'public_pmid_list' when the test environment provides a shared table.
+    std::shared_ptr<const PublicPmidTable> public_pmid_table;
   } test_config;
 
   bool send_hostname_to_visualiser_server;
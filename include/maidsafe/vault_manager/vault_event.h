@@ -0,0 +1,69 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_VAULT_EVENT_H_
+#define MAIDSAFE_VAULT_MANAGER_VAULT_EVENT_H_
+
+#include <cstdint>
+#include <utility>
+
+#include "maidsafe/common/types.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// kStarted   - vault process has connected to the VaultManager and received its credentials.
+// kJoined    - vault has joined the network.
+// kExited    - vault process has stopped and will not be restarted.
+// kRestarted - vault process stopped unexpectedly and the VaultManager is restarting it.
+enum class VaultEventType : int32_t { kStarted, kJoined, kExited, kRestarted };
+
+// A single state transition of a vault.  'sequence_number' is allocated by the VaultManager and is
+// strictly increasing per owner, so a client can detect missed events and resume after
+// reconnecting.  'exit_code' is only meaningful for kExited and kRestarted.  'follows_gap' is set
+// on the first event replayed to a resuming client if events it hadn't seen were lost in between
+// (e.g. dropped from the VaultManager's log, or lost when it restarted).  The sequence number of
+// such an event may be lower than the last one the client saw, and it restarts the sequence.
+struct VaultEvent {
+  VaultEvent()
+      : sequence_number(0),
+        type(VaultEventType::kStarted),
+        vault_label(),
+        exit_code(0),
+        follows_gap(false) {}
+  VaultEvent(uint64_t sequence_number_in, VaultEventType type_in, NonEmptyString vault_label_in,
+             int32_t exit_code_in)
+      : sequence_number(sequence_number_in),
+        type(type_in),
+        vault_label(std::move(vault_label_in)),
+        exit_code(exit_code_in),
+        follows_gap(false) {}
+
+  uint64_t sequence_number;
+  VaultEventType type;
+  NonEmptyString vault_label;
+  int32_t exit_code;
+  bool follows_gap;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_VAULT_EVENT_H_
@@ -0,0 +1,56 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_VAULT_HOST_H_
+#define MAIDSAFE_VAULT_MANAGER_VAULT_HOST_H_
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "maidsafe/vault_manager/vault_interface.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// A vault host runs many vaults as threads of a single process, for local test networks.  A
+// VaultManager configured with a non-zero 'vaults_per_host' starts the vault executable with
+// kVaultHostArgument rather than once per vault, so the executable's main should check IsVaultHost
+// first and if so, return the result of RunVaultHost.
+
+extern const std::string kVaultHostArgument;
+
+// Runs one hosted vault on the calling thread and returns its exit code.  'vault_interface' has
+// already retrieved the vault's config.  'args' is the command line the vault would have been given
+// had it been started as a process of its own.  Logging is shared by all vaults of the host.
+typedef std::function<int(VaultInterface& vault_interface, const std::vector<std::string>& args)>
+    HostedVaultFunctor;
+
+bool IsVaultHost(int argc, char* argv[]);
+
+// Runs each vault which the VaultManager asks for in a thread of its own, until disconnected from
+// the VaultManager.  Then stops the remaining vaults and returns once they have all returned or
+// given up waiting for them.  The return value is for main.
+int RunVaultHost(int argc, char* argv[], HostedVaultFunctor run_vault);
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_VAULT_HOST_H_
@@ -19,6 +19,8 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_VAULT_INTERFACE_H_
 #define MAIDSAFE_VAULT_MANAGER_VAULT_INTERFACE_H_
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstdint>
 #include <functional>
@@ -28,9 +30,11 @@
 #include <string>
 
 #include "asio/io_service_strand.hpp"
+#include "asio/steady_timer.hpp"
 
 #include "maidsafe/common/asio_service.h"
 #include "maidsafe/common/on_scope_exit.h"
+#include "maidsafe/common/process.h"
 #include "maidsafe/common/rsa.h"
 #include "maidsafe/common/types.h"
 #include "maidsafe/passport/passport.h"
@@ -41,6 +45,7 @@ namespace maidsafe {
 
 namespace vault_manager {
 
+struct Capabilities;
 struct VaultStartedResponse;
 
 class VaultInterface {
@@ -49,7 +54,11 @@ class VaultInterface {
   VaultInterface(VaultInterface&&) = delete;
   VaultInterface& operator=(VaultInterface) = delete;
 
-  explicit VaultInterface(tcp::Port vault_manager_port);
+  // 'hosted_vault_id' is zero unless this vault is one of the threads of a vault host (see
+  // vault_host.h), in which case it identifies the vault to the VaultManager in place of the
+  // process ID.
+  explicit VaultInterface(tcp::Port vault_manager_port, process::ProcessId hosted_vault_id = 0);
+  ~VaultInterface();
 
   VaultConfig GetConfiguration();
 
@@ -58,6 +67,12 @@ class VaultInterface {
 
   void SendJoined();
 
+  // The VaultManager relays 'message' to every session of this vault's owner.
+  void SendLogMessage(const std::string& message);
+
+  // Makes WaitForExit return 'exit_code' as though the VaultManager had asked the vault to stop.
+  void Stop(int exit_code);
+
 #ifdef TESTING
   void KillConnection();
   void SendInvalidMessage();
@@ -66,18 +81,39 @@ class VaultInterface {
 
  private:
   void HandleReceivedMessage(tcp::Message&& message);
+  void HandleCompactMessage(const tcp::Message& message);
+  // Once the vault has been configured, losing the VaultManager doesn't stop it.  It keeps trying
+  // to reconnect for up to kVaultReconnectTimeout so that a restarted VaultManager can adopt it.
   void OnConnectionClosed();
+  void ScheduleReconnect();
+  void Reconnect();
+  void Exit(int exit_code);
 
+  void HandleCapabilities(Capabilities&& capabilities);
   void HandleVaultStartedResponse(VaultStartedResponse&& vault_started_response);
   void HandleVaultShutdownRequest();
+  // Reads the config handed to this process by the VaultManager when it was spawned, if any (see
+  // VaultConfigChannel).  Returns false if there was none, in which case it must be asked for.
+  bool ReadHandedOffConfig();
 
   std::promise<int> exit_code_promise_;
   std::once_flag exit_code_flag_;
+  std::atomic<bool> exiting_;
+  const process::ProcessId kProcessId_;
+  const bool kHosted_;
   tcp::Port vault_manager_port_;
   std::function<void(VaultStartedResponse&&)> on_vault_started_response_;
   std::unique_ptr<VaultConfig> vault_config_;
+  // Whether the VaultManager has advertised Capabilities::kCompactMessages.
+  std::atomic<bool> compact_messages_;
+  // Given in the VaultStartedResponse; only accessed on the strand.
+  std::string adoption_token_;
+  int reconnect_attempts_;
+  std::chrono::steady_clock::time_point disconnected_at_;
+  std::mutex mutex_;
   AsioService asio_service_;
   asio::io_service::strand strand_;
+  asio::steady_timer reconnect_timer_;
   std::shared_ptr<tcp::Connection> tcp_connection_;
   // We need to ensure the connection is closed in the event of the constructor throwing, or the
   // asio_service destructor will hang.
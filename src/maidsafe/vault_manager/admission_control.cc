@@ -0,0 +1,99 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/admission_control.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "maidsafe/common/log.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+AdmissionControl::AdmissionControl(Limits limits)
+    : kLimits_(std::move(limits)),
+      tokens_(static_cast<double>(kLimits_.max_new_connections_per_second)),
+      last_refill_(std::chrono::steady_clock::now()),
+      admitted_connections_(0),
+      rejected_connections_(0),
+      evicted_connections_(0),
+      vault_only_connections_(0),
+      rejected_challenges_(0) {}
+
+AdmissionControl::Admission AdmissionControl::AdmitConnection(
+    std::size_t pending_connections, std::size_t vaults_awaiting_connection) {
+  RefillTokens();
+  if (tokens_ < 1.0) {
+    if (vaults_awaiting_connection != 0) {
+      ++vault_only_connections_;
+      return EvictionRequired(pending_connections)
+                 ? Admission::kAcceptVaultOnlyAfterEvictingOldest
+                 : Admission::kAcceptVaultOnly;
+    }
+    // Only log the first of each thousand rejections to keep the cost of a rejection low.
+    if (rejected_connections_++ % 1000 == 0)
+      LOG(kWarning) << "Rejecting new connections - rate limit exceeded.";
+    return Admission::kReject;
+  }
+  tokens_ -= 1.0;
+  ++admitted_connections_;
+  return EvictionRequired(pending_connections) ? Admission::kAcceptAfterEvictingOldest
+                                               : Admission::kAccept;
+}
+
+bool AdmissionControl::AdmitChallenge(std::size_t outstanding_challenges) {
+  if (outstanding_challenges < kLimits_.max_outstanding_challenges)
+    return true;
+  if (rejected_challenges_++ % 1000 == 0)
+    LOG(kWarning) << "Refusing to issue challenge - limit of "
+                  << kLimits_.max_outstanding_challenges << " outstanding reached.";
+  return false;
+}
+
+AdmissionControl::Stats AdmissionControl::GetStats() const {
+  Stats stats;
+  stats.admitted_connections = admitted_connections_;
+  stats.rejected_connections = rejected_connections_;
+  stats.evicted_connections = evicted_connections_;
+  stats.vault_only_connections = vault_only_connections_;
+  stats.rejected_challenges = rejected_challenges_;
+  return stats;
+}
+
+bool AdmissionControl::EvictionRequired(std::size_t pending_connections) {
+  if (pending_connections < kLimits_.max_pending_connections)
+    return false;
+  if (evicted_connections_++ % 1000 == 0)
+    LOG(kWarning) << "Evicting unidentified connections - limit of "
+                  << kLimits_.max_pending_connections << " reached.";
+  return true;
+}
+
+void AdmissionControl::RefillTokens() {
+  auto now(std::chrono::steady_clock::now());
+  std::chrono::duration<double> elapsed{now - last_refill_};
+  last_refill_ = now;
+  tokens_ = std::min(static_cast<double>(kLimits_.max_new_connections_per_second),
+                     tokens_ + elapsed.count() * kLimits_.max_new_connections_per_second);
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
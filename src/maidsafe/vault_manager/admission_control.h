@@ -0,0 +1,88 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_ADMISSION_CONTROL_H_
+#define MAIDSAFE_VAULT_MANAGER_ADMISSION_CONTROL_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Protects the VaultManager's single thread and its file descriptors from a flood of local
+// connections.  Newly-accepted connections are admitted at a limited rate (a token bucket holding
+// up to one second's worth of connections).  Once the limit of unidentified connections is reached,
+// the oldest of these is evicted to make room, since a genuine client or vault identifies itself
+// immediately on connecting.  While vaults which the VaultManager spawned are yet to connect, a
+// connection beyond the rate limit is still admitted, but only to identify itself as one of those
+// vaults, so that a flood can't stop the VaultManager's own vaults from starting.  Validation
+// challenges are only issued while the number outstanding is below a limit.  Apart from GetStats,
+// not threadsafe - only to be used from the VaultManager's asio thread.
+class AdmissionControl {
+ public:
+  enum class Admission {
+    kAccept,
+    kAcceptAfterEvictingOldest,
+    kAcceptVaultOnly,
+    kAcceptVaultOnlyAfterEvictingOldest,
+    kReject
+  };
+
+  struct Stats {
+    uint64_t admitted_connections, rejected_connections, evicted_connections,
+        vault_only_connections, rejected_challenges;
+  };
+
+  struct Limits {
+    Limits()
+        : max_new_connections_per_second(kMaxNewConnectionsPerSecond),
+          max_pending_connections(kMaxPendingConnections),
+          max_outstanding_challenges(kMaxOutstandingChallenges) {}
+    std::size_t max_new_connections_per_second, max_pending_connections,
+        max_outstanding_challenges;
+  };
+
+  explicit AdmissionControl(Limits limits = Limits());
+
+  Admission AdmitConnection(std::size_t pending_connections,
+                            std::size_t vaults_awaiting_connection = 0);
+  bool AdmitChallenge(std::size_t outstanding_challenges);
+  Stats GetStats() const;
+
+ private:
+  void RefillTokens();
+  bool EvictionRequired(std::size_t pending_connections);
+
+  const Limits kLimits_;
+  double tokens_;
+  std::chrono::steady_clock::time_point last_refill_;
+  std::atomic<uint64_t> admitted_connections_, rejected_connections_, evicted_connections_,
+      vault_only_connections_, rejected_challenges_;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_ADMISSION_CONTROL_H_
@@ -0,0 +1,351 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/benchmarks/bench_micro.h"
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "boost/filesystem/operations.hpp"
+#include "boost/filesystem/path.hpp"
+#include "boost/optional/optional.hpp"
+
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/crypto.h"
+#include "maidsafe/common/process.h"
+#include "maidsafe/common/rsa.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/common/tcp/connection.h"
+#include "maidsafe/common/tcp/listener.h"
+#include "maidsafe/passport/passport.h"
+
+#include "maidsafe/vault_manager/client_connections.h"
+#include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/config_file_handler.h"
+#include "maidsafe/vault_manager/process_manager.h"
+#include "maidsafe/vault_manager/rpc_helper.h"
+#include "maidsafe/vault_manager/timing_wheel.h"
+#include "maidsafe/vault_manager/utils.h"
+#include "maidsafe/vault_manager/vault_event.h"
+#include "maidsafe/vault_manager/vault_info.h"
+#include "maidsafe/vault_manager/messages/add_owner_request.h"
+#include "maidsafe/vault_manager/messages/batch_start_vault_request.h"
+#include "maidsafe/vault_manager/messages/batch_take_ownership_request.h"
+#include "maidsafe/vault_manager/messages/capabilities.h"
+#include "maidsafe/vault_manager/messages/challenge.h"
+#include "maidsafe/vault_manager/messages/challenge_response.h"
+#include "maidsafe/vault_manager/messages/joined_network.h"
+#include "maidsafe/vault_manager/messages/log_message.h"
+#include "maidsafe/vault_manager/messages/max_disk_usage_update.h"
+#include "maidsafe/vault_manager/messages/network_stable_request.h"
+#include "maidsafe/vault_manager/messages/network_stable_response.h"
+#include "maidsafe/vault_manager/messages/owner_added.h"
+#include "maidsafe/vault_manager/messages/owner_challenge.h"
+#include "maidsafe/vault_manager/messages/owner_challenge_response.h"
+#include "maidsafe/vault_manager/messages/resume_session_request.h"
+#include "maidsafe/vault_manager/messages/session_ticket.h"
+#include "maidsafe/vault_manager/messages/set_network_as_stable.h"
+#include "maidsafe/vault_manager/messages/start_vault_request.h"
+#include "maidsafe/vault_manager/messages/subscribe_to_vault_events_request.h"
+#include "maidsafe/vault_manager/messages/take_ownership_request.h"
+#include "maidsafe/vault_manager/messages/validate_connection_request.h"
+#include "maidsafe/vault_manager/messages/vault_event_notification.h"
+#include "maidsafe/vault_manager/messages/vault_running_response.h"
+#include "maidsafe/vault_manager/messages/vault_shutdown_request.h"
+#include "maidsafe/vault_manager/messages/vault_started.h"
+#include "maidsafe/vault_manager/messages/vault_started_response.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace bench {
+
+namespace {
+
+// Creating keys is slow, so a few are made up front and shared between all the vaults and
+// clients.  Nothing measured here requires them to be distinct.
+const std::size_t kKeyCount(4);
+const std::vector<std::size_t> kVaultCounts{1, 16, 256, 1024};
+const std::vector<std::size_t> kConnectionCounts{16, 256};
+
+struct Keys {
+  Keys() : maids(), pmids() {
+    for (std::size_t i(0); i < kKeyCount; ++i) {
+      maids.emplace_back(passport::CreateMaidAndSigner().first);
+      pmids.push_back(
+          std::make_shared<passport::PmidAndSigner>(passport::CreatePmidAndSigner()));
+    }
+  }
+
+  std::vector<passport::Maid> maids;
+  std::vector<std::shared_ptr<passport::PmidAndSigner>> pmids;
+};
+
+// Open loopback connections, for use as the keys of lookups by connection.
+class Connections {
+ public:
+  Connections(asio::io_service::strand& strand, std::size_t count)
+      : mutex_(), accepted_(), connections_() {
+    auto listener(tcp::Listener::MakeShared(strand, [this](tcp::ConnectionPtr connection) {
+      std::lock_guard<std::mutex> lock{mutex_};
+      accepted_.push_back(connection);
+    }, GetInitialListeningPort()));
+    for (std::size_t i(0); i < count; ++i)
+      connections_.push_back(tcp::Connection::MakeShared(strand, listener->ListeningPort()));
+    listener->StopListening();
+  }
+
+  ~Connections() {
+    for (auto& connection : connections_)
+      connection->Close();
+    std::lock_guard<std::mutex> lock{mutex_};
+    for (auto& connection : accepted_)
+      connection->Close();
+  }
+
+  const std::vector<tcp::ConnectionPtr>& Get() const { return connections_; }
+
+ private:
+  std::mutex mutex_;
+  std::vector<tcp::ConnectionPtr> accepted_;
+  std::vector<tcp::ConnectionPtr> connections_;
+};
+
+VaultInfo MakeVaultInfo(const Keys& keys, std::size_t index) {
+  VaultInfo vault_info;
+  vault_info.pmid_and_signer = keys.pmids[index % kKeyCount];
+  vault_info.vault_dir = GetTestEnvironmentRootDir() / ("vault_" + std::to_string(index));
+  vault_info.max_disk_usage = DiskUsage{1000000000};
+  vault_info.owner_name = passport::PublicMaid(keys.maids[index % kKeyCount]).name();
+  vault_info.label = GenerateLabel();
+  return vault_info;
+}
+
+template <typename Message>
+void RunMessage(const std::string& name, const Message& message, Seconds min_time,
+                BenchReport& report) {
+  const SerialisedData serialised(Serialise(Message::tag, message));
+  const std::map<std::string, double> params{{"bytes", static_cast<double>(serialised.size())}};
+  report.Add("messages", name + " serialise",
+             Measure(min_time, [&] { Serialise(Message::tag, message); }), params);
+  report.Add("messages", name + " parse", Measure(min_time, [&] {
+    InputVectorStream binary_input_stream{serialised};
+    MessageTag tag(static_cast<MessageTag>(-1));
+    Parse(binary_input_stream, tag);
+    Parse<Message>(binary_input_stream);
+  }), params);
+}
+
+void RunMessages(const Keys& keys, Seconds min_time, BenchReport& report) {
+  const NonEmptyString label{GenerateLabel()};
+  const fs::path vault_dir{GetTestEnvironmentRootDir() / "vault"};
+  const asymm::PlainText plaintext{RandomString(64)};
+  const passport::PublicMaid public_maid{keys.maids[0]};
+  const asymm::Signature signature{asymm::Sign(plaintext, keys.maids[0].private_key())};
+  const crypto::AES256Key symm_key{RandomString(crypto::AES256_KeySize)};
+  const crypto::AES256InitialisationVector symm_iv{RandomString(crypto::AES256_IVSize)};
+  VaultInfo vault_info{MakeVaultInfo(keys, 0)};
+  vault_info.adoption_token = RandomString(32);
+
+  std::vector<StartVaultRequest> start_vault_requests;
+  std::vector<TakeOwnershipRequest> take_ownership_requests;
+  for (uint64_t i(0); i < 16; ++i) {
+    start_vault_requests.emplace_back(label, i, vault_dir, DiskUsage{1000});
+    take_ownership_requests.emplace_back(label, i, vault_dir, DiskUsage{1000});
+  }
+
+  RunMessage("AddOwnerRequest", AddOwnerRequest(1), min_time, report);
+  RunMessage("BatchStartVaultRequest (16)",
+             BatchStartVaultRequest(std::move(start_vault_requests)), min_time, report);
+  RunMessage("BatchTakeOwnershipRequest (16)",
+             BatchTakeOwnershipRequest(std::move(take_ownership_requests)), min_time, report);
+  RunMessage("Capabilities", Capabilities(Capabilities::kAll), min_time, report);
+  RunMessage("Challenge", Challenge(plaintext), min_time, report);
+  RunMessage("ChallengeResponse", ChallengeResponse(public_maid, signature), min_time, report);
+  RunMessage("JoinedNetwork", JoinedNetwork(), min_time, report);
+  RunMessage("LogMessage", LogMessage(RandomAlphaNumericString(256)), min_time, report);
+  RunMessage("MaxDiskUsageUpdate", MaxDiskUsageUpdate(DiskUsage{1000}), min_time, report);
+#ifdef TESTING
+  RunMessage("NetworkStableRequest", NetworkStableRequest(), min_time, report);
+  RunMessage("NetworkStableResponse", NetworkStableResponse(), min_time, report);
+  RunMessage("SetNetworkAsStable", SetNetworkAsStable(), min_time, report);
+#endif
+  RunMessage("OwnerAdded", OwnerAdded(1), min_time, report);
+  RunMessage("OwnerChallenge", OwnerChallenge(1, plaintext), min_time, report);
+  RunMessage("OwnerChallengeResponse", OwnerChallengeResponse(1, public_maid, signature), min_time,
+             report);
+  RunMessage("ResumeSessionRequest", ResumeSessionRequest(RandomString(128)), min_time, report);
+  RunMessage("SessionTicket", SessionTicket(RandomString(128)), min_time, report);
+  RunMessage("StartVaultRequest", StartVaultRequest(label, 1, vault_dir, DiskUsage{1000}),
+             min_time, report);
+  RunMessage("SubscribeToVaultEventsRequest", SubscribeToVaultEventsRequest(0), min_time, report);
+  RunMessage("TakeOwnershipRequest", TakeOwnershipRequest(label, 1, vault_dir, DiskUsage{1000}),
+             min_time, report);
+  RunMessage("ValidateConnectionRequest", ValidateConnectionRequest(), min_time, report);
+  RunMessage("VaultEventNotification",
+             VaultEventNotification(VaultEvent(1, VaultEventType::kJoined, label, 0)), min_time,
+             report);
+  // Encrypts the vault's keys afresh each time; see bench_take_ownership for the cached path.
+  RunMessage("VaultRunningResponse", VaultRunningResponse(label, 1, *keys.pmids[0]), min_time,
+             report);
+  RunMessage("VaultShutdownRequest", VaultShutdownRequest(), min_time, report);
+  RunMessage("VaultStarted", VaultStarted(process::GetProcessId(), vault_info.adoption_token),
+             min_time, report);
+  RunMessage("VaultStartedResponse", VaultStartedResponse(vault_info, symm_key, symm_iv),
+             min_time, report);
+}
+
+void RunConfigFile(const Keys& keys, Seconds min_time, BenchReport& report) {
+  for (auto vault_count : kVaultCounts) {
+    ConfigFileHandler config_file_handler{GetTestEnvironmentRootDir() /
+                                          ("bench_config_" + std::to_string(vault_count))};
+    std::vector<VaultInfo> vaults;
+    for (std::size_t i(0); i < vault_count; ++i)
+      vaults.push_back(MakeVaultInfo(keys, i));
+    const std::map<std::string, double> params{{"vaults", static_cast<double>(vault_count)}};
+    report.Add("config file", "save",
+               Measure(min_time, [&] { config_file_handler.WriteConfigFile(vaults); }), params);
+    report.Add("config file", "load",
+               Measure(min_time, [&] { config_file_handler.ReadConfigFile(); }), params);
+  }
+}
+
+void RunProcessManager(const Keys& keys, Seconds min_time, BenchReport& report) {
+  AsioService asio_service{1};
+  asio::io_service::strand strand{asio_service.service()};
+  for (auto vault_count : kConnectionCounts) {
+    Connections connections{strand, vault_count};
+    auto process_manager(ProcessManager::MakeShared(asio_service.service(), GetPathToVault(),
+                                                    GetInitialListeningPort()));
+    std::vector<NonEmptyString> labels;
+    for (std::size_t i(0); i < vault_count; ++i) {
+      VaultInfo vault_info{MakeVaultInfo(keys, i)};
+      vault_info.pmid_and_signer.reset();
+      vault_info.tcp_connection = connections.Get()[i];
+      labels.push_back(vault_info.label);
+      process_manager->AddRunningVaultForTesting(std::move(vault_info));
+    }
+    const std::map<std::string, double> params{{"vaults", static_cast<double>(vault_count)}};
+    // Cycles through every vault, so that the mean cost of a linear search is measured.
+    std::size_t index(0);
+    report.Add("process manager", "Find(label)", Measure(min_time, [&] {
+      process_manager->Find(labels[index++ % vault_count]);
+    }), params);
+    report.Add("process manager", "Contains(label)", Measure(min_time, [&] {
+      process_manager->Contains(labels[index++ % vault_count]);
+    }), params);
+    report.Add("process manager", "Find(connection)", Measure(min_time, [&] {
+      process_manager->Find(connections.Get()[index++ % vault_count]);
+    }), params);
+    report.Add("process manager", "GetAll",
+               Measure(min_time, [&] { process_manager->GetAll(); }), params);
+    process_manager->ReleaseAll();
+  }
+}
+
+void RunClientConnections(const Keys& keys, Seconds min_time, BenchReport& report) {
+  AsioService asio_service{1};
+  asio::io_service::strand strand{asio_service.service()};
+  auto timing_wheel(TimingWheel::MakeShared(asio_service.service()));
+  std::vector<passport::PublicMaid> public_maids;
+  for (const auto& maid : keys.maids)
+    public_maids.emplace_back(maid);
+  const asymm::PlainText challenge{RandomString(64)};
+
+  for (auto connection_count : kConnectionCounts) {
+    Connections connections{strand, connection_count};
+    const auto& all(connections.Get());
+    auto client_connections(ClientConnections::MakeShared(timing_wheel));
+    // All but the last connection are held validated throughout; the last is added, validated and
+    // removed to measure a whole client session.
+    for (std::size_t i(0); i + 1 < connection_count; ++i) {
+      client_connections->Add(all[i], challenge);
+      client_connections->Validate(all[i], public_maids[i % kKeyCount], true);
+    }
+    const std::map<std::string, double> params{
+        {"connections", static_cast<double>(connection_count)}};
+    report.Add("client connections", "Add, Validate and Remove", Measure(min_time, [&] {
+      client_connections->Add(all.back(), challenge);
+      client_connections->GetChallenge(all.back());
+      client_connections->Validate(all.back(), public_maids[0], true);
+      client_connections->Remove(all.back());
+    }), params);
+    std::size_t index(0);
+    const std::size_t validated_count(connection_count - 1);
+    report.Add("client connections", "FindValidated", Measure(min_time, [&] {
+      client_connections->FindValidated(all[index++ % validated_count]);
+    }), params);
+    report.Add("client connections", "FindOwner", Measure(min_time, [&] {
+      const std::size_t i(index++ % validated_count);
+      client_connections->FindOwner(all[i], public_maids[i % kKeyCount].name());
+    }), params);
+    report.Add("client connections", "GetSessions", Measure(min_time, [&] {
+      client_connections->GetSessions(public_maids[index++ % kKeyCount].name());
+    }), params);
+    report.Add("client connections", "GetAll",
+               Measure(min_time, [&] { client_connections->GetAll(); }), params);
+    for (const auto& connection : all)
+      client_connections->Remove(connection);
+  }
+}
+
+void RunRpcHelper(Seconds min_time, BenchReport& report) {
+  AsioService asio_service{1};
+  auto timing_wheel(TimingWheel::MakeShared(asio_service.service()));
+  std::function<void(Challenge&&)> callback;
+  std::mutex mutex;
+  const asymm::PlainText plaintext{RandomString(64)};
+  report.Add("rpc helper", "SetResponseCallback", Measure(min_time, [&] {
+    auto future(SetResponseCallback<std::unique_ptr<asymm::PlainText>, Challenge>(
+        callback, timing_wheel, mutex));
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      callback(Challenge(plaintext));
+      callback = nullptr;
+    }
+    future.get();
+  }));
+}
+
+}  // unnamed namespace
+
+void RunMicroBenchmarks(Seconds min_time, BenchReport& report) {
+  const Keys keys;
+  RunMessages(keys, min_time, report);
+  RunConfigFile(keys, min_time, report);
+  RunProcessManager(keys, min_time, report);
+  RunClientConnections(keys, min_time, report);
+  report.Add("utils", "GenerateLabel", Measure(min_time, [] { GenerateLabel(); }));
+  RunRpcHelper(min_time, report);
+}
+
+}  // namespace bench
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
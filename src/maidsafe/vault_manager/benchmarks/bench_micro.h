@@ -0,0 +1,47 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_BENCHMARKS_BENCH_MICRO_H_
+#define MAIDSAFE_VAULT_MANAGER_BENCHMARKS_BENCH_MICRO_H_
+
+#include "maidsafe/vault_manager/benchmarks/bench_report.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace bench {
+
+// Single-threaded measurements of the VaultManager's building blocks, each run for at least
+// 'min_time':
+//   messages            - serialising and parsing every message type
+//   config file         - saving and loading the config file holding varying numbers of vaults
+//   process manager     - looking vaults up by label and by connection
+//   client connections  - validating, finding and removing clients
+//   utils               - GenerateLabel
+//   rpc helper          - a SetResponseCallback promise being set and collected
+// Requires test::SetEnvironment to have been called.
+void RunMicroBenchmarks(Seconds min_time, BenchReport& report);
+
+}  // namespace bench
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_BENCHMARKS_BENCH_MICRO_H_
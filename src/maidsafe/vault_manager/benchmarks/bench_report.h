@@ -0,0 +1,148 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_BENCHMARKS_BENCH_REPORT_H_
+#define MAIDSAFE_VAULT_MANAGER_BENCHMARKS_BENCH_REPORT_H_
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace bench {
+
+typedef std::chrono::duration<double> Seconds;
+
+struct BenchResult {
+  std::string suite, name;
+  uint64_t iterations;
+  Seconds elapsed;
+  // Settings the result depends on, e.g. the number of vaults a lookup ran against.
+  std::map<std::string, double> params;
+};
+
+// Calls 'operation' repeatedly for at least 'min_time', reading the clock only once per batch so
+// that doing so doesn't dominate quick operations.  Returns the number of calls and time taken.
+template <typename Operation>
+std::pair<uint64_t, Seconds> Measure(Seconds min_time, Operation operation) {
+  uint64_t iterations(0), batch(1);
+  const auto start(std::chrono::steady_clock::now());
+  Seconds elapsed{};
+  while (elapsed < min_time) {
+    for (uint64_t i(0); i < batch; ++i)
+      operation();
+    iterations += batch;
+    elapsed = std::chrono::steady_clock::now() - start;
+    if (batch < 1024 && elapsed < min_time / 100)
+      batch *= 2;
+  }
+  return std::make_pair(iterations, elapsed);
+}
+
+// Collects results and prints them either as a table or as a single JSON document, so that runs
+// can be saved and compared over time.
+class BenchReport {
+ public:
+  BenchReport(std::string benchmark, bool json)
+      : kBenchmark_(std::move(benchmark)), kJson_(json), results_() {}
+
+  bool Json() const { return kJson_; }
+
+  void Add(std::string suite, std::string name, std::pair<uint64_t, Seconds> measurement,
+           std::map<std::string, double> params = std::map<std::string, double>()) {
+    results_.push_back(BenchResult{std::move(suite), std::move(name), measurement.first,
+                                   measurement.second, std::move(params)});
+  }
+
+  void Print(std::ostream& output) const {
+    if (kJson_)
+      return PrintJson(output);
+    std::string suite;
+    for (const auto& result : results_) {
+      if (result.suite != suite) {
+        suite = result.suite;
+        output << suite << ":\n";
+      }
+      output << "  " << result.name;
+      for (const auto& param : result.params)
+        output << "   " << param.first << ": " << param.second;
+      output << "   ops/s: " << OpsPerSecond(result) << "   ns/op: " << NsPerOp(result) << '\n';
+    }
+  }
+
+ private:
+  static double OpsPerSecond(const BenchResult& result) {
+    return result.elapsed.count() > 0 ? result.iterations / result.elapsed.count() : 0.0;
+  }
+
+  static double NsPerOp(const BenchResult& result) {
+    return result.iterations ? result.elapsed.count() * 1e9 / result.iterations : 0.0;
+  }
+
+  // Only our own suite, result and parameter names are written, so '"' and '\' are all that need
+  // escaping.
+  static std::string Quote(const std::string& text) {
+    std::string quoted(1, '"');
+    for (char c : text) {
+      if (c == '"' || c == '\\')
+        quoted += '\\';
+      quoted += c;
+    }
+    return quoted + '"';
+  }
+
+  void PrintJson(std::ostream& output) const {
+    output << "{\n  \"benchmark\": " << Quote(kBenchmark_)
+           << ",\n  \"timestamp\": " << std::time(nullptr) << ",\n  \"results\": [";
+    for (std::size_t i(0); i < results_.size(); ++i) {
+      const BenchResult& result(results_[i]);
+      output << (i ? "," : "") << "\n    {\"suite\": " << Quote(result.suite)
+             << ", \"name\": " << Quote(result.name) << ", \"iterations\": " << result.iterations
+             << ", \"seconds\": " << result.elapsed.count()
+             << ", \"ops_per_second\": " << OpsPerSecond(result)
+             << ", \"ns_per_op\": " << NsPerOp(result) << ", \"params\": {";
+      bool first(true);
+      for (const auto& param : result.params) {
+        output << (first ? "" : ", ") << Quote(param.first) << ": " << param.second;
+        first = false;
+      }
+      output << "}}";
+    }
+    output << "\n  ]\n}\n";
+  }
+
+  const std::string kBenchmark_;
+  const bool kJson_;
+  std::vector<BenchResult> results_;
+};
+
+}  // namespace bench
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_BENCHMARKS_BENCH_REPORT_H_
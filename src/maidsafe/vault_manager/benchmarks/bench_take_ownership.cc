@@ -0,0 +1,117 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+// Measures how many TakeOwnership responses per second can be built and serialised for a running
+// vault, first encrypting the vault's keys afresh for every response and then reusing the bundle
+// held in a VaultKeysCache.  Usage:
+//   bench_take_ownership [seconds per run (default 5)] [vaults (default 16)]
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/types.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/passport/passport.h"
+
+#include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/vault_keys_cache.h"
+#include "maidsafe/vault_manager/messages/vault_running_response.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace {
+
+struct Vault {
+  NonEmptyString label;
+  passport::PmidAndSigner pmid_and_signer;
+};
+
+// Runs 'make_response' round-robin over 'vaults' for 'duration', returning responses per second.
+template <typename MakeResponse>
+double Run(const std::vector<Vault>& vaults, std::chrono::seconds duration,
+           MakeResponse make_response) {
+  uint64_t responses(0), total_size(0);
+  const auto start(std::chrono::steady_clock::now());
+  const auto deadline(start + duration);
+  while (std::chrono::steady_clock::now() < deadline) {
+    for (const auto& vault : vaults) {
+      total_size += Serialise(VaultRunningResponse::tag, make_response(vault, responses)).size();
+      ++responses;
+    }
+  }
+  std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - start};
+  LOG(kVerbose) << "Serialised " << total_size << " bytes.";
+  return responses / elapsed.count();
+}
+
+}  // unnamed namespace
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+int main(int argc, char* argv[]) {
+  using maidsafe::vault_manager::Vault;
+  using maidsafe::vault_manager::VaultRunningResponse;
+  int exit_code{0};
+  try {
+    auto unuseds(maidsafe::log::Logging::Instance().Initialise(argc, argv));
+    std::chrono::seconds duration{5};
+    std::size_t vault_count{16};
+    if (unuseds.size() > 1U)
+      duration = std::chrono::seconds{std::stoi(std::string{&unuseds[1][0]})};
+    if (unuseds.size() > 2U)
+      vault_count = static_cast<std::size_t>(std::stoi(std::string{&unuseds[2][0]}));
+
+    // Creating keys is slow, so do this up front.
+    std::vector<Vault> vaults;
+    for (std::size_t i(0); i < vault_count; ++i) {
+      vaults.push_back(Vault{maidsafe::NonEmptyString{maidsafe::RandomAlphaNumericString(20)},
+                             maidsafe::passport::CreatePmidAndSigner()});
+    }
+
+    std::cout << "TakeOwnership responses for " << vault_count << " vaults over "
+              << duration.count() << "s per run:\n";
+    double uncached{maidsafe::vault_manager::Run(vaults, duration,
+                                                 [](const Vault& vault, uint64_t request_id) {
+      return VaultRunningResponse(vault.label, request_id, vault.pmid_and_signer);
+    })};
+    std::cout << "  encrypting per response: " << uncached << " responses/s\n";
+
+    maidsafe::vault_manager::VaultKeysCache vault_keys_cache;
+    double cached{maidsafe::vault_manager::Run(vaults, duration,
+                                               [&](const Vault& vault, uint64_t request_id) {
+      return VaultRunningResponse(vault.label, request_id,
+                                  vault_keys_cache.Get(vault.label, vault.pmid_and_signer));
+    })};
+    std::cout << "  cached key bundles:      " << cached << " responses/s   (x"
+              << cached / uncached << ")\n";
+  } catch (const std::exception& e) {
+    std::cout << "Benchmark failed: " << boost::diagnostic_information(e) << '\n';
+    exit_code = 1;
+  }
+  return exit_code;
+}
@@ -0,0 +1,213 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+// Compares the TimingWheel with one asio::steady_timer per timeout, holding a large number of
+// concurrent pending timeouts (as with many unvalidated connections, starting vaults and
+// outstanding requests).  Half of the timeouts are cancelled, as most connection timeouts are, and
+// the rest are left to expire.  Usage:
+//   bench_timing_wheel [pending timeouts (default 50000)] [longest timeout in ms (default 3000)]
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "asio/steady_timer.hpp"
+
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/vault_manager/timing_wheel.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace {
+
+typedef std::chrono::steady_clock::duration Duration;
+typedef std::chrono::steady_clock::time_point TimePoint;
+
+struct TimeoutResult {
+  std::chrono::duration<double, std::milli> add_time, cancel_time;
+  std::chrono::duration<double, std::milli> mean_lateness, max_lateness;
+  std::size_t expired;
+};
+
+// Records how late each expiry ran, and waits until every timeout has either expired or been
+// cancelled.
+class Lateness {
+ public:
+  explicit Lateness(std::size_t total)
+      : mutex_(), cond_var_(), total_lateness_(), max_lateness_(), expired_(0), cancelled_(0),
+        kTotal_(total) {}
+
+  void Record(TimePoint deadline) {
+    Duration lateness{std::max(Duration{}, std::chrono::steady_clock::now() - deadline)};
+    std::lock_guard<std::mutex> lock{mutex_};
+    total_lateness_ += lateness;
+    max_lateness_ = std::max(max_lateness_, lateness);
+    ++expired_;
+    cond_var_.notify_one();
+  }
+
+  void Cancelled(std::size_t count) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    cancelled_ += count;
+    cond_var_.notify_one();
+  }
+
+  void Wait(TimeoutResult& result) {
+    std::unique_lock<std::mutex> lock{mutex_};
+    cond_var_.wait(lock, [&] { return expired_ + cancelled_ == kTotal_; });
+    result.expired = expired_;
+    result.max_lateness = max_lateness_;
+    if (expired_ != 0)
+      result.mean_lateness = total_lateness_ / static_cast<Duration::rep>(expired_);
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cond_var_;
+  Duration total_lateness_, max_lateness_;
+  std::size_t expired_, cancelled_;
+  const std::size_t kTotal_;
+};
+
+std::vector<Duration> MakeTimeouts(std::size_t count, std::chrono::milliseconds longest) {
+  std::vector<Duration> timeouts;
+  timeouts.reserve(count);
+  for (std::size_t i(0); i < count; ++i)
+    timeouts.emplace_back(std::chrono::milliseconds{(RandomUint32() % longest.count()) + 1});
+  return timeouts;
+}
+
+TimeoutResult RunTimingWheel(const std::vector<Duration>& timeouts) {
+  AsioService asio_service{1};
+  auto timing_wheel(TimingWheel::MakeShared(asio_service.service()));
+  Lateness lateness{timeouts.size()};
+  std::vector<TimingWheel::TimerId> timer_ids;
+  timer_ids.reserve(timeouts.size());
+
+  TimeoutResult result{};
+  auto start(std::chrono::steady_clock::now());
+  for (const auto& timeout : timeouts) {
+    TimePoint deadline{std::chrono::steady_clock::now() + timeout};
+    timer_ids.push_back(timing_wheel->Add(timeout, [&, deadline] { lateness.Record(deadline); }));
+  }
+  result.add_time = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  std::size_t cancelled{0};
+  for (std::size_t i(0); i < timer_ids.size(); i += 2) {
+    if (timing_wheel->Cancel(timer_ids[i]))
+      ++cancelled;
+  }
+  result.cancel_time = std::chrono::steady_clock::now() - start;
+  lateness.Cancelled(cancelled);
+
+  lateness.Wait(result);
+  return result;
+}
+
+TimeoutResult RunAsioTimers(const std::vector<Duration>& timeouts) {
+  AsioService asio_service{1};
+  asio::io_service& io_service(asio_service.service());
+  Lateness lateness{timeouts.size()};
+  std::vector<std::unique_ptr<asio::steady_timer>> timers;
+  timers.reserve(timeouts.size());
+
+  // asio timers aren't threadsafe, so create and cancel them on the io_service's thread.
+  TimeoutResult result{};
+  std::promise<void> added;
+  io_service.post([&] {
+    auto start(std::chrono::steady_clock::now());
+    for (const auto& timeout : timeouts) {
+      TimePoint deadline{std::chrono::steady_clock::now() + timeout};
+      timers.emplace_back(new asio::steady_timer{io_service, timeout});
+      timers.back()->async_wait([&, deadline](const std::error_code& error_code) {
+        if (!error_code)
+          lateness.Record(deadline);
+      });
+    }
+    result.add_time = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    std::size_t cancelled{0};
+    for (std::size_t i(0); i < timers.size(); i += 2)
+      cancelled += timers[i]->cancel();
+    result.cancel_time = std::chrono::steady_clock::now() - start;
+    lateness.Cancelled(cancelled);
+    added.set_value();
+  });
+  added.get_future().wait();
+
+  lateness.Wait(result);
+  std::promise<void> cleared;
+  io_service.post([&] {
+    timers.clear();
+    cleared.set_value();
+  });
+  cleared.get_future().wait();
+  return result;
+}
+
+void Print(const std::string& name, const TimeoutResult& result) {
+  std::cout << "  " << name << "   add: " << result.add_time.count()
+            << "ms   cancel: " << result.cancel_time.count() << "ms   expired: " << result.expired
+            << "   mean lateness: " << result.mean_lateness.count()
+            << "ms   max lateness: " << result.max_lateness.count() << "ms\n";
+}
+
+}  // unnamed namespace
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+int main(int argc, char* argv[]) {
+  int exit_code{0};
+  try {
+    auto unuseds(maidsafe::log::Logging::Instance().Initialise(argc, argv));
+    std::size_t count{50000};
+    std::chrono::milliseconds longest{3000};
+    if (unuseds.size() > 1U)
+      count = static_cast<std::size_t>(std::stoi(std::string{&unuseds[1][0]}));
+    if (unuseds.size() > 2U)
+      longest = std::chrono::milliseconds{std::max(1, std::stoi(std::string{&unuseds[2][0]}))};
+
+    auto timeouts(maidsafe::vault_manager::MakeTimeouts(count, longest));
+    std::cout << count << " concurrent pending timeouts of up to " << longest.count()
+              << "ms, half of them cancelled:\n";
+    using maidsafe::vault_manager::Print;
+    Print("timing wheel", maidsafe::vault_manager::RunTimingWheel(timeouts));
+    Print("asio timers ", maidsafe::vault_manager::RunAsioTimers(timeouts));
+  } catch (const std::exception& e) {
+    std::cout << "Benchmark failed: " << boost::diagnostic_information(e) << '\n';
+    exit_code = 1;
+  }
+  return exit_code;
+}
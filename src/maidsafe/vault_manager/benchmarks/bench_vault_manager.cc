@@ -0,0 +1,174 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+// Measures the VaultManager's building blocks (see bench_micro.h), then its client handshake
+// throughput (connect, challenge, signature check) in connections per second, with its crypto
+// worker pool sized to a single thread and then to one thread per core.  Usage:
+//   bench_vault_manager [--json] [--skip_handshakes] [seconds per handshake run (default 10)]
+//                       [concurrent clients (default 2 per core)]
+// With --json the results are printed as a single JSON document, so that runs can be saved and
+// compared over time.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "boost/filesystem/operations.hpp"
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/process.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/passport/passport.h"
+
+#include "maidsafe/vault_manager/admission_control.h"
+#include "maidsafe/vault_manager/client_interface.h"
+#include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/utils.h"
+#include "maidsafe/vault_manager/vault_manager.h"
+#include "maidsafe/vault_manager/benchmarks/bench_micro.h"
+#include "maidsafe/vault_manager/benchmarks/bench_report.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace {
+
+const bench::Seconds kMicroBenchmarkTime{0.25};
+
+struct HandshakeResult {
+  uint64_t handshakes, failures;
+  bench::Seconds elapsed;
+};
+
+HandshakeResult RunHandshakes(std::size_t crypto_thread_count,
+                              const std::vector<passport::Maid>& maids,
+                              std::chrono::seconds duration) {
+  // Lift the admission limits so that they don't cap the measurement.
+  AdmissionControl::Limits limits;
+  limits.max_new_connections_per_second = 1000000;
+  limits.max_pending_connections = 10000;
+  limits.max_outstanding_challenges = 10000;
+  VaultManager vault_manager{crypto_thread_count, limits};
+
+  std::atomic<uint64_t> handshakes(0), failures(0);
+  const auto start(std::chrono::steady_clock::now());
+  const auto deadline(start + duration);
+  std::vector<std::thread> clients;
+  for (const auto& maid : maids) {
+    clients.emplace_back([&, maid] {
+      while (std::chrono::steady_clock::now() < deadline) {
+        try {
+          ClientInterface client_interface{maid};
+          ++handshakes;
+        } catch (const std::exception& e) {
+          LOG(kWarning) << "Handshake failed: " << boost::diagnostic_information(e);
+          ++failures;
+        }
+      }
+    });
+  }
+  for (auto& client : clients)
+    client.join();
+  HandshakeResult result;
+  result.handshakes = handshakes;
+  result.failures = failures;
+  result.elapsed = std::chrono::steady_clock::now() - start;
+  return result;
+}
+
+}  // unnamed namespace
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+int main(int argc, char* argv[]) {
+  using maidsafe::vault_manager::HandshakeResult;
+  namespace bench = maidsafe::vault_manager::bench;
+  fs::path test_env_root_dir;
+  int exit_code{0};
+  try {
+    auto unuseds(maidsafe::log::Logging::Instance().Initialise(argc, argv));
+    bool json{false}, skip_handshakes{false};
+    std::vector<std::string> positionals;
+    for (std::size_t i(1); i < unuseds.size(); ++i) {
+      std::string arg{&unuseds[i][0]};
+      if (arg == "--json")
+        json = true;
+      else if (arg == "--skip_handshakes")
+        skip_handshakes = true;
+      else
+        positionals.push_back(arg);
+    }
+    std::chrono::seconds duration{10};
+    std::size_t hardware_threads{std::max(1U, std::thread::hardware_concurrency())};
+    std::size_t client_count{2 * hardware_threads};
+    if (positionals.size() > 0U)
+      duration = std::chrono::seconds{std::stoi(positionals[0])};
+    if (positionals.size() > 1U)
+      client_count = static_cast<std::size_t>(std::stoi(positionals[1]));
+
+    test_env_root_dir = fs::temp_directory_path() / fs::unique_path("MaidSafe_Bench_%%%%-%%%%");
+    fs::create_directories(test_env_root_dir);
+    maidsafe::vault_manager::test::SetEnvironment(
+        maidsafe::vault_manager::GetInitialListeningPort(), test_env_root_dir,
+        maidsafe::process::GetOtherExecutablePath("dummy_vault"));
+
+    bench::BenchReport report{"bench_vault_manager", json};
+    bench::RunMicroBenchmarks(maidsafe::vault_manager::kMicroBenchmarkTime, report);
+
+    if (!skip_handshakes) {
+      // Creating keys is slow, so do this up front.
+      std::vector<maidsafe::passport::Maid> maids;
+      for (std::size_t i(0); i < client_count; ++i)
+        maids.emplace_back(maidsafe::passport::CreateMaidAndSigner().first);
+
+      std::vector<std::size_t> crypto_thread_counts{1};
+      if (hardware_threads > 1U)
+        crypto_thread_counts.push_back(hardware_threads);
+      for (auto crypto_thread_count : crypto_thread_counts) {
+        HandshakeResult result{
+            maidsafe::vault_manager::RunHandshakes(crypto_thread_count, maids, duration)};
+        report.Add("client handshakes", "connect and validate",
+                   std::make_pair(result.handshakes, result.elapsed),
+                   {{"crypto_threads", static_cast<double>(crypto_thread_count)},
+                    {"clients", static_cast<double>(client_count)},
+                    {"failures", static_cast<double>(result.failures)}});
+      }
+    }
+    report.Print(std::cout);
+  } catch (const std::exception& e) {
+    std::cout << "Benchmark failed: " << boost::diagnostic_information(e) << '\n';
+    exit_code = 1;
+  }
+  boost::system::error_code ec;
+  if (!test_env_root_dir.empty())
+    fs::remove_all(test_env_root_dir, ec);
+  return exit_code;
+}
@@ -0,0 +1,562 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+// Puts an in-process VaultManager under a mixed load of many concurrent client sessions and fake
+// vaults, and reports the throughput and p50/p99/p99.9 latency of each kind of operation.  Usage:
+//   vm_loadgen [--json] [--seconds=30] [--sessions=1000] [--maids=8] [--max_vaults=16]
+//              [--log_rate=50] [--mix=handshake:30,start_vault:10,take_ownership:40,drop:20]
+// Each session repeatedly picks one of these operations at random, weighted by --mix:
+//   handshake      - closes the session, then connects and validates a new one in its place.
+//   start_vault    - starts a fake vault for the session's Maid while fewer than --max_vaults run.
+//   take_ownership - takes over a running vault of the session's Maid.  The first takeover of each
+//                    vault moves it to a new directory, which restarts it; later ones don't.
+//   drop           - sends a TakeOwnership request and closes the session without waiting for the
+//                    response, then connects a new one.  Its latency includes the reconnection.
+// An operation which can't be done yet (e.g. take_ownership before any vault is running) is
+// replaced by a handshake.
+//
+// The fake vaults are further instances of this executable, which the VaultManager starts like any
+// other vault.  Each floods its owner's sessions with --log_rate log messages per second (0 for
+// none), relayed by the VaultManager.  Every session costs two file descriptors, so the soft limit
+// on open files is raised as far as the hard limit allows.
+
+#ifndef MAIDSAFE_WIN32
+#include <sys/resource.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "boost/filesystem/operations.hpp"
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/process.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/passport/passport.h"
+
+#include "maidsafe/vault_manager/admission_control.h"
+#include "maidsafe/vault_manager/client_interface.h"
+#include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/utils.h"
+#include "maidsafe/vault_manager/vault_event.h"
+#include "maidsafe/vault_manager/vault_interface.h"
+#include "maidsafe/vault_manager/vault_manager.h"
+#include "maidsafe/vault_manager/benchmarks/bench_report.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// Set by the load generator before the VaultManager starts any vault and inherited by the vault
+// processes, it tells an instance of this executable to run as a fake vault at the given log rate.
+const char* const kFakeVaultLogRateVariable("MAIDSAFE_VM_LOADGEN_LOG_RATE");
+
+const std::chrono::seconds kRequestTimeout{60};
+
+enum Operation : std::size_t { kHandshake, kStartVault, kTakeOwnership, kDrop, kOperationCount };
+
+const std::array<const char*, kOperationCount> kOperationNames{
+    {"handshake", "start_vault", "take_ownership", "drop"}};
+
+struct Options {
+  Options()
+      : json(false),
+        duration(30),
+        session_count(1000),
+        maid_count(8),
+        max_vaults(16),
+        log_rate(50),
+        weights{{30, 10, 40, 20}} {}
+
+  bool json;
+  std::chrono::seconds duration;
+  std::size_t session_count, maid_count, max_vaults;
+  unsigned log_rate;
+  std::array<unsigned, kOperationCount> weights;
+};
+
+void ParseMix(const std::string& mix, Options& options) {
+  options.weights.fill(0);
+  std::size_t begin(0);
+  while (begin < mix.size()) {
+    std::size_t end(std::min(mix.find(',', begin), mix.size()));
+    std::string entry(mix.substr(begin, end - begin));
+    std::size_t colon(entry.find(':'));
+    auto name(std::find(kOperationNames.begin(), kOperationNames.end(), entry.substr(0, colon)));
+    if (colon == std::string::npos || name == kOperationNames.end())
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+    options.weights[name - kOperationNames.begin()] =
+        static_cast<unsigned>(std::stoul(entry.substr(colon + 1)));
+    begin = end + 1;
+  }
+  if (std::all_of(options.weights.begin(), options.weights.end(),
+                  [](unsigned weight) { return weight == 0; }))
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+}
+
+Options ParseOptions(const std::vector<std::string>& args) {
+  Options options;
+  for (const auto& arg : args) {
+    std::size_t equals(arg.find('='));
+    std::string name(arg.substr(0, equals)), value;
+    if (equals != std::string::npos)
+      value = arg.substr(equals + 1);
+    if (name == "--json")
+      options.json = true;
+    else if (value.empty())
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+    else if (name == "--seconds")
+      options.duration = std::chrono::seconds{std::stoi(value)};
+    else if (name == "--sessions")
+      options.session_count = std::stoul(value);
+    else if (name == "--maids")
+      options.maid_count = std::max<std::size_t>(1, std::stoul(value));
+    else if (name == "--max_vaults")
+      options.max_vaults = std::stoul(value);
+    else if (name == "--log_rate")
+      options.log_rate = static_cast<unsigned>(std::stoul(value));
+    else if (name == "--mix")
+      ParseMix(value, options);
+    else
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+  }
+  return options;
+}
+
+void RaiseOpenFileLimit() {
+#ifndef MAIDSAFE_WIN32
+  rlimit limit;
+  if (getrlimit(RLIMIT_NOFILE, &limit) != 0 || limit.rlim_cur == limit.rlim_max)
+    return;
+  limit.rlim_cur = limit.rlim_max;
+  if (setrlimit(RLIMIT_NOFILE, &limit) != 0)
+    LOG(kWarning) << "Failed to raise the limit on open files.";
+#endif
+}
+
+void SetFakeVaultLogRate(unsigned log_rate) {
+  const std::string value(std::to_string(log_rate));
+#ifdef MAIDSAFE_WIN32
+  _putenv_s(kFakeVaultLogRateVariable, value.c_str());
+#else
+  setenv(kFakeVaultLogRateVariable, value.c_str(), 1);
+#endif
+}
+
+int RunFakeVault(uint16_t port, unsigned log_rate) {
+  VaultInterface vault_interface{port};
+  vault_interface.SendJoined();
+  std::atomic<bool> exiting(false);
+  std::thread flood;
+  if (log_rate != 0) {
+    flood = std::thread([&] {
+      const std::chrono::microseconds interval(1000000 / log_rate);
+      auto next(Clock::now());
+      for (uint64_t count(0); !exiting; ++count) {
+        vault_interface.SendLogMessage("vm_loadgen log message " + std::to_string(count));
+        next += interval;
+        std::this_thread::sleep_until(next);
+      }
+    });
+  }
+  int exit_code{vault_interface.WaitForExit()};
+  exiting = true;
+  if (flood.joinable())
+    flood.join();
+  return exit_code;
+}
+
+// Latencies of the operations which succeeded, and counts of those which failed.
+class Recorder {
+ public:
+  Recorder() : mutex_(), latencies_(), failures_() { failures_.fill(0); }
+
+  void Record(Operation operation, Clock::time_point start, bool succeeded) {
+    const bench::Seconds latency(Clock::now() - start);
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (succeeded)
+      latencies_[operation].push_back(latency.count());
+    else
+      ++failures_[operation];
+  }
+
+  void AddTo(bench::BenchReport& report, bench::Seconds elapsed, const Options& options) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    for (std::size_t i(0); i < kOperationCount; ++i) {
+      auto& latencies(latencies_[i]);
+      std::sort(latencies.begin(), latencies.end());
+      report.Add("load", kOperationNames[i], std::make_pair(latencies.size(), elapsed),
+                 {{"sessions", static_cast<double>(options.session_count)},
+                  {"weight", static_cast<double>(options.weights[i])},
+                  {"failures", static_cast<double>(failures_[i])},
+                  {"p50_ms", Percentile(latencies, 0.5) * 1000},
+                  {"p99_ms", Percentile(latencies, 0.99) * 1000},
+                  {"p999_ms", Percentile(latencies, 0.999) * 1000}});
+    }
+  }
+
+ private:
+  // Nearest-rank percentile of 'sorted'.
+  static double Percentile(const std::vector<double>& sorted, double fraction) {
+    if (sorted.empty())
+      return 0.0;
+    return sorted[static_cast<std::size_t>(fraction * (sorted.size() - 1) + 0.5)];
+  }
+
+  std::mutex mutex_;
+  std::array<std::vector<double>, kOperationCount> latencies_;
+  std::array<uint64_t, kOperationCount> failures_;
+};
+
+struct Session {
+  explicit Session(std::size_t maid_index_in) : maid_index(maid_index_in), client() {}
+  const std::size_t maid_index;
+  std::unique_ptr<ClientInterface> client;
+};
+
+// Runs every session on one shared io_service.  A session only has one operation in flight at a
+// time, and its ClientInterface is only replaced by one of the reconnection threads, since it
+// mustn't be destroyed from a handler on the shared io_service.
+class LoadGenerator {
+ public:
+  LoadGenerator(const Options& options, const std::vector<passport::Maid>& maids,
+                fs::path vaults_root, Recorder& recorder)
+      : kOptions_(options),
+        kMaids_(maids),
+        kVaultsRoot_(std::move(vaults_root)),
+        recorder_(recorder),
+        asio_service_(std::max(1U, std::thread::hardware_concurrency())),
+        vaults_mutex_(),
+        labels_(maids.size()),
+        vault_dirs_(),
+        vault_count_(0),
+        dir_count_(0),
+        running_(false),
+        reconnect_mutex_(),
+        reconnect_cond_var_(),
+        reconnections_(),
+        stopping_(false),
+        finished_count_(0),
+        reconnectors_(),
+        observers_(),
+        sessions_() {}
+
+  ~LoadGenerator() {
+    {
+      std::lock_guard<std::mutex> lock{reconnect_mutex_};
+      stopping_ = true;
+    }
+    reconnect_cond_var_.notify_all();
+    for (auto& reconnector : reconnectors_)
+      reconnector.join();
+    sessions_.clear();
+    observers_.clear();
+    asio_service_.Stop();
+  }
+
+  // Returns how long the load was applied for.
+  bench::Seconds Run() {
+    // One blocking session per Maid learns the labels of its running vaults.
+    for (std::size_t i(0); i < kMaids_.size(); ++i) {
+      observers_.emplace_back(new ClientInterface{kMaids_[i]});
+      observers_.back()->SubscribeToVaultEvents(
+          [this, i](const VaultEvent& event) { HandleVaultEvent(i, event); });
+    }
+    for (std::size_t i(0); i < kOptions_.session_count; ++i)
+      sessions_.emplace_back(new Session{i % kMaids_.size()});
+    for (std::size_t i(0); i < asio_service_.ThreadCount(); ++i)
+      reconnectors_.emplace_back([this] { ReconnectLoop(); });
+
+    running_ = true;
+    const auto start(Clock::now());
+    for (auto& session : sessions_)
+      Connect(*session, kHandshake, Clock::now());
+    std::this_thread::sleep_for(kOptions_.duration);
+    running_ = false;
+    const bench::Seconds elapsed(Clock::now() - start);
+
+    // Let the operations in flight complete, bounded by their timeout.
+    std::unique_lock<std::mutex> lock{reconnect_mutex_};
+    if (!reconnect_cond_var_.wait_for(lock, kRequestTimeout + std::chrono::seconds(10), [&] {
+          return finished_count_ == sessions_.size();
+        })) {
+      LOG(kWarning) << sessions_.size() - finished_count_ << " sessions didn't finish.";
+    }
+    return elapsed;
+  }
+
+ private:
+  struct Reconnection {
+    Session* session;
+    Operation operation;
+    Clock::time_point start;
+  };
+
+  void HandleVaultEvent(std::size_t maid_index, const VaultEvent& event) {
+    std::lock_guard<std::mutex> lock{vaults_mutex_};
+    auto& labels(labels_[maid_index]);
+    const std::string label(event.vault_label.string());
+    auto itr(std::find(labels.begin(), labels.end(), label));
+    if (event.type == VaultEventType::kStarted && itr == labels.end()) {
+      labels.push_back(label);
+    } else if (event.type == VaultEventType::kExited && itr != labels.end()) {
+      labels.erase(itr);
+      vault_dirs_.erase(label);
+      --vault_count_;
+    }
+  }
+
+  fs::path NewVaultDir() { return kVaultsRoot_ / ("vault_" + std::to_string(++dir_count_)); }
+
+  Operation PickOperation() const {
+    unsigned total(0);
+    for (auto weight : kOptions_.weights)
+      total += weight;
+    unsigned pick(RandomUint32() % total);
+    std::size_t i(0);
+    while (pick >= kOptions_.weights[i])
+      pick -= kOptions_.weights[i++];
+    return static_cast<Operation>(i);
+  }
+
+  void Connect(Session& session, Operation operation, Clock::time_point start) {
+    session.client.reset(new ClientInterface{kMaids_[session.maid_index], asio_service_.service()});
+    session.client->AsyncConnect([this, &session, operation, start](std::exception_ptr error) {
+      recorder_.Record(operation, start, !error);
+      if (error)
+        return QueueReconnection(session, kHandshake, Clock::now());
+      Next(session);
+    });
+  }
+
+  // Called from the session's own handlers once its previous operation has completed.
+  void Next(Session& session) {
+    if (!running_)
+      return Finished();
+    switch (PickOperation()) {
+      case kStartVault:
+        if (StartVault(session))
+          return;
+        break;
+      case kTakeOwnership:
+        if (TakeOwnership(session))
+          return;
+        break;
+      case kDrop:
+        return Drop(session);
+      default:
+        break;
+    }
+    QueueReconnection(session, kHandshake, Clock::now());
+  }
+
+  bool StartVault(Session& session) {
+    if (++vault_count_ > kOptions_.max_vaults) {
+      --vault_count_;
+      return false;
+    }
+    const auto start(Clock::now());
+    session.client->AsyncStartVault(
+        StartVaultSpec{NewVaultDir(), DiskUsage{1000000}}, kRequestTimeout,
+        [this, &session, start](std::exception_ptr error,
+                                std::unique_ptr<passport::PmidAndSigner> /*pmid_and_signer*/) {
+          if (error)
+            --vault_count_;
+          recorder_.Record(kStartVault, start, !error);
+          Next(session);
+        });
+    return true;
+  }
+
+  bool TakeOwnership(Session& session) {
+    std::string label;
+    fs::path vault_dir;
+    {
+      std::lock_guard<std::mutex> lock{vaults_mutex_};
+      const auto& labels(labels_[session.maid_index]);
+      if (labels.empty())
+        return false;
+      label = labels[RandomUint32() % labels.size()];
+      auto itr(vault_dirs_.find(label));
+      vault_dir = (itr == vault_dirs_.end() ? NewVaultDir() : itr->second);
+    }
+    const auto start(Clock::now());
+    session.client->AsyncTakeOwnership(
+        TakeOwnershipSpec{NonEmptyString{label}, vault_dir, DiskUsage{1000000}}, kRequestTimeout,
+        [this, &session, label, vault_dir, start](
+            std::exception_ptr error, std::unique_ptr<passport::PmidAndSigner> /*pmid_signer*/) {
+          if (!error) {
+            std::lock_guard<std::mutex> lock{vaults_mutex_};
+            vault_dirs_[label] = vault_dir;
+          }
+          recorder_.Record(kTakeOwnership, start, !error);
+          Next(session);
+        });
+    return true;
+  }
+
+  void Drop(Session& session) {
+    const auto start(Clock::now());
+    session.client->AsyncTakeOwnership(
+        TakeOwnershipSpec{NonEmptyString{RandomAlphaNumericString(16)}, NewVaultDir(),
+                          DiskUsage{1000000}},
+        kRequestTimeout, [](std::exception_ptr, std::unique_ptr<passport::PmidAndSigner>) {});
+    QueueReconnection(session, kDrop, start);
+  }
+
+  void QueueReconnection(Session& session, Operation operation, Clock::time_point start) {
+    {
+      std::lock_guard<std::mutex> lock{reconnect_mutex_};
+      reconnections_.push_back(Reconnection{&session, operation, start});
+    }
+    reconnect_cond_var_.notify_all();
+  }
+
+  void ReconnectLoop() {
+    for (;;) {
+      Reconnection reconnection;
+      {
+        std::unique_lock<std::mutex> lock{reconnect_mutex_};
+        reconnect_cond_var_.wait(lock, [&] { return stopping_ || !reconnections_.empty(); });
+        if (reconnections_.empty())
+          return;
+        reconnection = reconnections_.front();
+        reconnections_.pop_front();
+      }
+      reconnection.session->client.reset();
+      if (!running_) {
+        Finished();
+        continue;
+      }
+      // A handshake is timed from here, so that closing the previous session isn't included.
+      Connect(*reconnection.session, reconnection.operation,
+              reconnection.operation == kHandshake ? Clock::now() : reconnection.start);
+    }
+  }
+
+  void Finished() {
+    {
+      std::lock_guard<std::mutex> lock{reconnect_mutex_};
+      ++finished_count_;
+    }
+    reconnect_cond_var_.notify_all();
+  }
+
+  const Options kOptions_;
+  const std::vector<passport::Maid>& kMaids_;
+  const fs::path kVaultsRoot_;
+  Recorder& recorder_;
+  AsioService asio_service_;
+  std::mutex vaults_mutex_;
+  std::vector<std::vector<std::string>> labels_;
+  std::map<std::string, fs::path> vault_dirs_;
+  std::atomic<std::size_t> vault_count_;
+  std::atomic<uint64_t> dir_count_;
+  std::atomic<bool> running_;
+  std::mutex reconnect_mutex_;
+  std::condition_variable reconnect_cond_var_;
+  std::deque<Reconnection> reconnections_;
+  bool stopping_;
+  std::size_t finished_count_;
+  std::vector<std::thread> reconnectors_;
+  std::vector<std::unique_ptr<ClientInterface>> observers_;
+  std::vector<std::unique_ptr<Session>> sessions_;
+};
+
+}  // unnamed namespace
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+int main(int argc, char* argv[]) {
+  namespace vm = maidsafe::vault_manager;
+  fs::path test_env_root_dir;
+  int exit_code{0};
+  try {
+    auto unuseds(maidsafe::log::Logging::Instance().Initialise(argc, argv));
+    if (const char* log_rate = std::getenv(vm::kFakeVaultLogRateVariable)) {
+      if (unuseds.size() != 2U)
+        BOOST_THROW_EXCEPTION(maidsafe::MakeError(maidsafe::CommonErrors::invalid_parameter));
+      return vm::RunFakeVault(static_cast<uint16_t>(std::stoi(std::string{&unuseds[1][0]})),
+                              static_cast<unsigned>(std::stoul(log_rate)));
+    }
+
+    std::vector<std::string> args;
+    for (std::size_t i(1); i < unuseds.size(); ++i)
+      args.emplace_back(&unuseds[i][0]);
+    const vm::Options options{vm::ParseOptions(args)};
+    vm::RaiseOpenFileLimit();
+
+    test_env_root_dir = fs::temp_directory_path() / fs::unique_path("MaidSafe_LoadGen_%%%%-%%%%");
+    fs::create_directories(test_env_root_dir);
+    vm::test::SetEnvironment(vm::GetInitialListeningPort(), test_env_root_dir,
+                             maidsafe::process::GetOtherExecutablePath("vm_loadgen"));
+    vm::SetFakeVaultLogRate(options.log_rate);
+
+    // Creating keys is slow, so do this up front.
+    std::vector<maidsafe::passport::Maid> maids;
+    for (std::size_t i(0); i < options.maid_count; ++i)
+      maids.emplace_back(maidsafe::passport::CreateMaidAndSigner().first);
+
+    vm::bench::BenchReport report{"vm_loadgen", options.json};
+    {
+      // Lift the admission limits so that they don't cap the load.
+      vm::AdmissionControl::Limits limits;
+      limits.max_new_connections_per_second = 1000000;
+      limits.max_pending_connections = 100000;
+      limits.max_outstanding_challenges = 100000;
+      vm::VaultManager vault_manager{std::max(1U, std::thread::hardware_concurrency()), limits};
+      vm::Recorder recorder;
+      vm::LoadGenerator load_generator{options, maids, test_env_root_dir / "vaults", recorder};
+      const vm::bench::Seconds elapsed{load_generator.Run()};
+      recorder.AddTo(report, elapsed, options);
+    }
+    report.Print(std::cout);
+  } catch (const std::exception& e) {
+    std::cout << "Load generation failed: " << boost::diagnostic_information(e) << '\n';
+    exit_code = 1;
+  }
+  boost::system::error_code ec;
+  if (!test_env_root_dir.empty())
+    fs::remove_all(test_env_root_dir, ec);
+  return exit_code;
+}
@@ -0,0 +1,193 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+// Feeds a capture recorded by a VaultManager (see vault_manager --capture_file) into a fresh
+// in-process VaultManager, reproducing the captured connections and the timing of their messages,
+// then reports how long the VaultManager spent handling each kind of message.  Usage:
+//   vm_replay [--json] [--speed=1] <capture file>
+// --speed scales the captured timing, e.g. 10 replays ten times faster; 0 sends everything as fast
+// as possible.  The replayed connections are plain tcp::Connections rather than clients or vaults,
+// so their handshakes fail (the challenge differs from the captured one) and the requests which
+// follow are refused as unvalidated.  What is reproduced is the shape and volume of the traffic,
+// e.g. a log storm or a reconnect storm, and the handler cost it incurs, so that builds can be
+// compared against the same capture.
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "boost/filesystem/operations.hpp"
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/process.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/common/tcp/connection.h"
+
+#include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/discovery_file.h"
+#include "maidsafe/vault_manager/traffic_capture.h"
+#include "maidsafe/vault_manager/utils.h"
+#include "maidsafe/vault_manager/vault_manager.h"
+#include "maidsafe/vault_manager/benchmarks/bench_report.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// How long the VaultManager is given to handle the last of the replayed messages.
+const std::chrono::seconds kSettleTime{1};
+
+struct ReplayResult {
+  ReplayResult() : connections(0), failed_connections(0), messages(0), elapsed() {}
+  uint64_t connections, failed_connections, messages;
+  bench::Seconds elapsed;
+};
+
+ReplayResult Replay(TrafficCaptureReader& reader, double speed, tcp::Port port) {
+  AsioService asio_service{1};
+  asio::io_service::strand strand{asio_service.service()};
+  std::map<uint32_t, tcp::ConnectionPtr> connections;
+  ReplayResult result;
+  const auto start(Clock::now());
+  TrafficRecord record;
+  while (reader.Next(record)) {
+    if (speed > 0) {
+      std::this_thread::sleep_until(start + std::chrono::duration_cast<Clock::duration>(
+                                                std::chrono::duration<double, std::micro>(
+                                                    record.time.count() / speed)));
+    }
+    switch (record.type) {
+      case TrafficRecord::Type::kConnected:
+        try {
+          tcp::ConnectionPtr connection{tcp::Connection::MakeShared(strand, port)};
+          connection->Start([](tcp::Message) {}, [] {});
+          connections[record.connection_id] = connection;
+          ++result.connections;
+        } catch (const std::exception& e) {
+          LOG(kWarning) << "Failed to replay connection " << record.connection_id << ": "
+                        << boost::diagnostic_information(e);
+          ++result.failed_connections;
+        }
+        break;
+      case TrafficRecord::Type::kMessage: {
+        // Credentials aren't captured, so those messages can't be replayed.
+        auto itr(connections.find(record.connection_id));
+        if (itr != connections.end() && !IsCredential(record.tag)) {
+          itr->second->Send(std::move(record.message));
+          ++result.messages;
+        }
+        break;
+      }
+      case TrafficRecord::Type::kClosed: {
+        auto itr(connections.find(record.connection_id));
+        if (itr != connections.end()) {
+          itr->second->Close();
+          connections.erase(itr);
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  }
+  result.elapsed = Clock::now() - start;
+  std::this_thread::sleep_for(kSettleTime);
+  for (auto& connection : connections)
+    connection.second->Close();
+  asio_service.Stop();
+  return result;
+}
+
+}  // unnamed namespace
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+int main(int argc, char* argv[]) {
+  namespace vm = maidsafe::vault_manager;
+  fs::path test_env_root_dir;
+  int exit_code{0};
+  try {
+    auto unuseds(maidsafe::log::Logging::Instance().Initialise(argc, argv));
+    bool json{false};
+    double speed{1.0};
+    std::vector<std::string> positionals;
+    for (std::size_t i(1); i < unuseds.size(); ++i) {
+      std::string arg{&unuseds[i][0]};
+      if (arg == "--json")
+        json = true;
+      else if (arg.compare(0, 8, "--speed=") == 0)
+        speed = std::stod(arg.substr(8));
+      else
+        positionals.push_back(arg);
+    }
+    if (positionals.size() != 1U || speed < 0)
+      BOOST_THROW_EXCEPTION(maidsafe::MakeError(maidsafe::CommonErrors::invalid_parameter));
+    vm::TrafficCaptureReader reader{positionals[0]};
+
+    test_env_root_dir = fs::temp_directory_path() / fs::unique_path("MaidSafe_Replay_%%%%-%%%%");
+    fs::create_directories(test_env_root_dir);
+    vm::test::SetEnvironment(vm::GetInitialListeningPort(), test_env_root_dir,
+                             maidsafe::process::GetOtherExecutablePath("dummy_vault"));
+
+    vm::bench::BenchReport report{"vm_replay", json};
+    {
+      vm::VaultManager vault_manager;
+      vault_manager.StartHandlerTimings();
+      auto discovery_record(vm::ReadDiscoveryFile(vm::GetDiscoveryFilePath()));
+      const maidsafe::tcp::Port port{discovery_record ? discovery_record->port
+                                                      : vm::GetInitialListeningPort()};
+      const vm::ReplayResult result{vm::Replay(reader, speed, port)};
+      report.Add("replay", "messages", std::make_pair(result.messages, result.elapsed),
+                 {{"speed", speed},
+                  {"connections", static_cast<double>(result.connections)},
+                  {"failed_connections", static_cast<double>(result.failed_connections)}});
+      for (const auto& timing : vault_manager.GetHandlerTimings()) {
+        std::ostringstream name;
+        name << timing.first;
+        report.Add("handlers", name.str(),
+                   std::make_pair(timing.second.count, vm::bench::Seconds(timing.second.total)),
+                   {{"max_us", timing.second.max.count() / 1000.0}});
+      }
+    }
+    report.Print(std::cout);
+  } catch (const std::exception& e) {
+    std::cout << "Replay failed: " << boost::diagnostic_information(e) << '\n';
+    exit_code = 1;
+  }
+  boost::system::error_code ec;
+  if (!test_env_root_dir.empty())
+    fs::remove_all(test_env_root_dir, ec);
+  return exit_code;
+}
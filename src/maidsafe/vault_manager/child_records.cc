@@ -0,0 +1,92 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/child_records.h"
+
+#include <utility>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+
+#include "maidsafe/vault_manager/utils.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace {
+
+struct ChildRecordsFile {
+  template <typename Archive>
+  void load(Archive& archive) {
+    std::size_t count(0);
+    archive(count);
+    for (std::size_t i(0); i < count; ++i) {
+      ChildRecord child_record;
+      archive(child_record);
+      child_records.push_back(std::move(child_record));
+    }
+  }
+
+  template <typename Archive>
+  void save(Archive& archive) const {
+    archive(child_records.size());
+    for (const auto& child_record : child_records)
+      archive(child_record);
+  }
+
+  std::vector<ChildRecord> child_records;
+};
+
+}  // unnamed namespace
+
+void WriteChildRecords(const fs::path& path, const std::vector<ChildRecord>& child_records) {
+  ChildRecordsFile file;
+  file.child_records = child_records;
+  fs::path temp_path(path.string() + ".tmp");
+  // The records hold adoption tokens, so the file is owner-only before they're written to it.
+  CreateOwnerOnlyFile(temp_path);
+  if (!WriteFile(temp_path, ConvertToString(file))) {
+    LOG(kError) << "Failed to write child records to " << temp_path;
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  }
+  fs::rename(temp_path, path);
+}
+
+std::vector<ChildRecord> ReadChildRecords(const fs::path& path) {
+  boost::system::error_code error_code;
+  if (!fs::exists(path, error_code))
+    return std::vector<ChildRecord>{};
+  try {
+    return ConvertFromString<ChildRecordsFile>(ReadFile(path).string()).child_records;
+  } catch (const std::exception& e) {
+    LOG(kWarning) << "Failed to read child records from " << path << ": "
+                  << boost::diagnostic_information(e);
+    return std::vector<ChildRecord>{};
+  }
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
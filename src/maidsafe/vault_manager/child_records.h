@@ -0,0 +1,67 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_CHILD_RECORDS_H_
+#define MAIDSAFE_VAULT_MANAGER_CHILD_RECORDS_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/process.h"
+#include "maidsafe/common/types.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// What a restarted VaultManager needs to re-adopt a vault process left running by its predecessor.
+// The vault proves it's the process which was given 'adoption_token' when it reconnects.
+struct ChildRecord {
+  ChildRecord() : label(), process_id(0), adoption_token() {}
+  ChildRecord(NonEmptyString label_in, process::ProcessId process_id_in,
+              std::string adoption_token_in)
+      : label(std::move(label_in)),
+        process_id(process_id_in),
+        adoption_token(std::move(adoption_token_in)) {}
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(label, process_id, adoption_token);
+  }
+
+  NonEmptyString label;
+  process::ProcessId process_id;
+  std::string adoption_token;
+};
+
+// Replaces the file at 'path' with one only readable by its owner, since the tokens let a process
+// pass itself off as a vault.
+void WriteChildRecords(const boost::filesystem::path& path,
+                       const std::vector<ChildRecord>& child_records);
+
+// Returns an empty vector if the file doesn't exist or can't be parsed.
+std::vector<ChildRecord> ReadChildRecords(const boost::filesystem::path& path);
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_CHILD_RECORDS_H_
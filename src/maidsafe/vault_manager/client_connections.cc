@@ -18,6 +18,9 @@
 
 #include "maidsafe/vault_manager/client_connections.h"
 
+#include <algorithm>
+#include <utility>
+
 #include "maidsafe/common/error.h"
 #include "maidsafe/common/log.h"
 #include "maidsafe/common/on_scope_exit.h"
@@ -28,11 +31,16 @@ namespace maidsafe {
 
 namespace vault_manager {
 
-ClientConnections::ClientConnections(asio::io_service& io_service)
-    : io_service_(io_service), unvalidated_clients_(), clients_() {}
+ClientConnections::ClientConnections(std::shared_ptr<TimingWheel> timing_wheel)
+    : timing_wheel_(std::move(timing_wheel)),
+      unvalidated_clients_(),
+      clients_(),
+      sessions_(),
+      vault_event_subscribers_() {}
 
-std::shared_ptr<ClientConnections> ClientConnections::MakeShared(asio::io_service& io_service) {
-  return std::shared_ptr<ClientConnections>{new ClientConnections{io_service}};
+std::shared_ptr<ClientConnections> ClientConnections::MakeShared(
+    std::shared_ptr<TimingWheel> timing_wheel) {
+  return std::shared_ptr<ClientConnections>{new ClientConnections{std::move(timing_wheel)}};
 }
 
 ClientConnections::~ClientConnections() {
@@ -41,20 +49,27 @@ ClientConnections::~ClientConnections() {
 
 void ClientConnections::Add(tcp::ConnectionPtr connection, const asymm::PlainText& challenge) {
   assert(clients_.find(connection) == std::end(clients_));
-  TimerPtr timer{std::make_shared<Timer>(io_service_, kRpcTimeout)};
-  timer->async_wait([=](const std::error_code& error_code) {
-    if (!error_code || error_code != asio::error::operation_aborted) {
-      LOG(kWarning) << "Timed out waiting for Client to validate.";
-      connection->Close();
-    }
-  });
-  bool result{unvalidated_clients_.emplace(connection, std::make_pair(challenge, timer)).second};
+  TimingWheel::TimerId timer_id{timing_wheel_->Add(kRpcTimeout, [connection] {
+    LOG(kWarning) << "Timed out waiting for Client to validate.";
+    connection->Close();
+  })};
+  bool result{
+      unvalidated_clients_.emplace(connection, std::make_pair(challenge, timer_id)).second};
   assert(result);
   static_cast<void>(result);
 }
 
+asymm::PlainText ClientConnections::GetChallenge(tcp::ConnectionPtr connection) const {
+  auto itr(unvalidated_clients_.find(connection));
+  if (itr == std::end(unvalidated_clients_)) {
+    LOG(kError) << "Unvalidated Client TCP connection not found.";
+    BOOST_THROW_EXCEPTION(MakeError(VaultManagerErrors::connection_not_found));
+  }
+  return itr->second.first;
+}
+
 void ClientConnections::Validate(tcp::ConnectionPtr connection, const passport::PublicMaid& maid,
-                                 const asymm::Signature& signature) {
+                                 bool signature_is_valid) {
   auto itr(unvalidated_clients_.find(connection));
   if (itr == std::end(unvalidated_clients_)) {
     LOG(kError) << "Unvalidated Client TCP connection not found.";
@@ -63,29 +78,53 @@ void ClientConnections::Validate(tcp::ConnectionPtr connection, const passport::
 
   on_scope_exit cleanup{[this, itr] { itr->first->Close(); }};
 
-  if (asymm::CheckSignature(itr->second.first, signature, maid.public_key())) {
+  if (signature_is_valid) {
     LOG(kSuccess) << "Client " << DebugId(maid.name().value) << " TCP connection validated.";
   } else {
     LOG(kError) << "Client TCP connection validation failed.";
     BOOST_THROW_EXCEPTION(MakeError(AsymmErrors::invalid_signature));
   }
 
-  bool result{clients_.emplace(connection, maid.name()).second};
+  AddSession(connection, maid.name());
+  timing_wheel_->Cancel(itr->second.second);
   unvalidated_clients_.erase(itr);
   cleanup.Release();
-  assert(result);
-  static_cast<void>(result);
+}
+
+void ClientConnections::AddValidated(tcp::ConnectionPtr connection, const MaidName& maid_name) {
+  assert(unvalidated_clients_.find(connection) == std::end(unvalidated_clients_));
+  AddSession(connection, maid_name);
+  LOG(kSuccess) << "Client " << DebugId(maid_name.value) << " TCP connection resumed session.";
+}
+
+void ClientConnections::AddSession(tcp::ConnectionPtr connection, const MaidName& maid_name) {
+  std::vector<MaidName>& owners(clients_[connection].owners);
+  if (std::find(std::begin(owners), std::end(owners), maid_name) != std::end(owners))
+    return;
+  owners.push_back(maid_name);
+  sessions_[maid_name].push_back(connection);
 }
 
 bool ClientConnections::Remove(tcp::ConnectionPtr connection) {
   auto itr(clients_.find(connection));
   if (itr != std::end(clients_)) {
+    vault_event_subscribers_.erase(connection);
+    for (const auto& owner : itr->second.owners) {
+      auto sessions_itr(sessions_.find(owner));
+      assert(sessions_itr != std::end(sessions_));
+      std::vector<tcp::ConnectionPtr>& sessions(sessions_itr->second);
+      sessions.erase(std::remove(std::begin(sessions), std::end(sessions), connection),
+                     std::end(sessions));
+      if (sessions.empty())
+        sessions_.erase(sessions_itr);
+    }
     clients_.erase(itr);
     return true;
   }
 
   auto unvalidated_itr(unvalidated_clients_.find(connection));
   if (unvalidated_itr != std::end(unvalidated_clients_)) {
+    timing_wheel_->Cancel(unvalidated_itr->second.second);
     unvalidated_clients_.erase(unvalidated_itr);
     return true;
   }
@@ -100,7 +139,7 @@ void ClientConnections::CloseAll() {
     connection.first->Close();
 }
 
-ClientConnections::MaidName ClientConnections::FindValidated(tcp::ConnectionPtr connection) const {
+ClientConnections::Client& ClientConnections::FindClient(tcp::ConnectionPtr connection) {
   auto itr(clients_.find(connection));
   if (itr == std::end(clients_)) {
     auto unvalidated_itr(unvalidated_clients_.find(connection));
@@ -115,16 +154,67 @@ ClientConnections::MaidName ClientConnections::FindValidated(tcp::ConnectionPtr
   return itr->second;
 }
 
-tcp::ConnectionPtr ClientConnections::FindValidated(MaidName maid_name) const {
-  auto itr(std::find_if(std::begin(clients_), std::end(clients_),
-                        [&maid_name](const std::pair<tcp::ConnectionPtr, MaidName> client) {
-    return client.second == maid_name;
-  }));
-  if (itr == std::end(clients_)) {
-    LOG(kWarning) << "Client TCP connection not found.";
-    BOOST_THROW_EXCEPTION(MakeError(VaultManagerErrors::connection_not_found));
+const ClientConnections::Client& ClientConnections::FindClient(
+    tcp::ConnectionPtr connection) const {
+  return const_cast<ClientConnections*>(this)->FindClient(connection);
+}
+
+ClientConnections::MaidName ClientConnections::FindValidated(tcp::ConnectionPtr connection) const {
+  return FindClient(connection).owners.front();
+}
+
+ClientConnections::MaidName ClientConnections::FindOwner(
+    tcp::ConnectionPtr connection, const boost::optional<MaidName>& owner) const {
+  const Client& client(FindClient(connection));
+  if (!owner)
+    return client.owners.front();
+  if (std::find(std::begin(client.owners), std::end(client.owners), *owner) ==
+      std::end(client.owners)) {
+    LOG(kWarning) << "Client " << DebugId(owner->value) << " not authenticated on connection.";
+    BOOST_THROW_EXCEPTION(MakeError(VaultManagerErrors::unvalidated_client));
+  }
+  return *owner;
+}
+
+void ClientConnections::AddOwnerChallenge(tcp::ConnectionPtr connection, uint64_t request_id,
+                                          const asymm::PlainText& challenge) {
+  Client& client(FindClient(connection));
+  if (client.owner_challenges.size() >= kMaxPendingOwnerChallenges) {
+    LOG(kWarning) << "Too many owners awaiting validation on connection.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::cannot_exceed_limit));
+  }
+  client.owner_challenges[request_id] = challenge;
+}
+
+asymm::PlainText ClientConnections::GetOwnerChallenge(tcp::ConnectionPtr connection,
+                                                      uint64_t request_id) const {
+  const Client& client(FindClient(connection));
+  auto itr(client.owner_challenges.find(request_id));
+  if (itr == std::end(client.owner_challenges)) {
+    LOG(kError) << "No owner challenge with request ID " << request_id;
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::no_such_element));
+  }
+  return itr->second;
+}
+
+void ClientConnections::ValidateOwner(tcp::ConnectionPtr connection, uint64_t request_id,
+                                      const passport::PublicMaid& maid, bool signature_is_valid) {
+  Client& client(FindClient(connection));
+  if (client.owner_challenges.erase(request_id) == 0) {
+    LOG(kError) << "No owner challenge with request ID " << request_id;
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::no_such_element));
   }
-  return itr->first;
+  if (!signature_is_valid) {
+    LOG(kError) << "Client owner validation failed.";
+    BOOST_THROW_EXCEPTION(MakeError(AsymmErrors::invalid_signature));
+  }
+  AddSession(connection, maid.name());
+  LOG(kSuccess) << "Client " << DebugId(maid.name().value) << " added as owner of connection.";
+}
+
+std::vector<tcp::ConnectionPtr> ClientConnections::GetSessions(const MaidName& maid_name) const {
+  auto itr(sessions_.find(maid_name));
+  return itr == std::end(sessions_) ? std::vector<tcp::ConnectionPtr>() : itr->second;
 }
 
 std::vector<tcp::ConnectionPtr> ClientConnections::GetAll() const {
@@ -136,6 +226,29 @@ std::vector<tcp::ConnectionPtr> ClientConnections::GetAll() const {
   return all_connections;
 }
 
+std::size_t ClientConnections::UnvalidatedCount() const { return unvalidated_clients_.size(); }
+
+void ClientConnections::SubscribeToVaultEvents(tcp::ConnectionPtr connection) {
+  if (clients_.find(connection) == std::end(clients_)) {
+    LOG(kWarning) << "Only validated Clients can subscribe to vault events.";
+    BOOST_THROW_EXCEPTION(MakeError(VaultManagerErrors::unvalidated_client));
+  }
+  vault_event_subscribers_.insert(connection);
+}
+
+std::vector<tcp::ConnectionPtr> ClientConnections::GetVaultEventSubscribers(
+    const MaidName& maid_name) const {
+  std::vector<tcp::ConnectionPtr> subscribers;
+  auto itr(sessions_.find(maid_name));
+  if (itr == std::end(sessions_))
+    return subscribers;
+  for (const auto& session : itr->second) {
+    if (vault_event_subscribers_.count(session) && clients_.at(session).owners.front() == maid_name)
+      subscribers.push_back(session);
+  }
+  return subscribers;
+}
+
 }  //  namespace vault_manager
 
 }  //  namespace maidsafe
@@ -19,43 +19,99 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_CLIENT_CONNECTIONS_H_
 #define MAIDSAFE_VAULT_MANAGER_CLIENT_CONNECTIONS_H_
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
-#include "asio/io_service.hpp"
+#include "boost/optional.hpp"
 
 #include "maidsafe/common/rsa.h"
 #include "maidsafe/passport/types.h"
 
 #include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/timing_wheel.h"
 
 namespace maidsafe {
 
 namespace vault_manager {
 
+// Tracks client connections from the time they're sent a challenge.  Validated connections are
+// indexed both by connection and by owner, since a Maid may have several sessions open at once
+// (e.g. a dashboard and a CLI tool), and one connection may carry several Maids.  The Maid which
+// validated the connection is its primary owner; a multiplexing client authenticates further
+// owners over the validated connection, each through its own challenge (see AddOwnerRequest).
 class ClientConnections {
  public:
   typedef passport::PublicMaid::Name MaidName;
-  static std::shared_ptr<ClientConnections> MakeShared(asio::io_service& io_service);
+  static std::shared_ptr<ClientConnections> MakeShared(std::shared_ptr<TimingWheel> timing_wheel);
   ~ClientConnections();
   void Add(tcp::ConnectionPtr connection, const asymm::PlainText& challenge);
+  // Returns the challenge sent to the unvalidated connection.
+  asymm::PlainText GetChallenge(tcp::ConnectionPtr connection) const;
+  // 'signature_is_valid' is the result of checking the client's signature of its challenge.
   void Validate(tcp::ConnectionPtr connection, const passport::PublicMaid& maid,
-                const asymm::Signature& signature);
+                bool signature_is_valid);
+  // Adds a connection whose client has proved its identity by presenting a session ticket.
+  void AddValidated(tcp::ConnectionPtr connection, const MaidName& maid_name);
   bool Remove(tcp::ConnectionPtr connection);
   void CloseAll();
+  // Returns the connection's primary owner.
   MaidName FindValidated(tcp::ConnectionPtr connection) const;
-  tcp::ConnectionPtr FindValidated(MaidName maid_name) const;
+  // Returns 'owner' if set and it has been authenticated on the connection, otherwise the primary
+  // owner.  Throws if 'owner' is set but not authenticated.
+  MaidName FindOwner(tcp::ConnectionPtr connection, const boost::optional<MaidName>& owner) const;
+  // Records the challenge sent for a further owner of the validated connection.  Throws if the
+  // connection already has kMaxPendingOwnerChallenges outstanding.
+  void AddOwnerChallenge(tcp::ConnectionPtr connection, uint64_t request_id,
+                         const asymm::PlainText& challenge);
+  asymm::PlainText GetOwnerChallenge(tcp::ConnectionPtr connection, uint64_t request_id) const;
+  // Removes the challenge and, if 'signature_is_valid', adds 'maid' as an owner of the connection.
+  // Unlike Validate, failure doesn't close the connection, since other owners may be using it.
+  void ValidateOwner(tcp::ConnectionPtr connection, uint64_t request_id,
+                     const passport::PublicMaid& maid, bool signature_is_valid);
+  // Returns all validated connections of 'maid_name' (empty if there are none).
+  std::vector<tcp::ConnectionPtr> GetSessions(const MaidName& maid_name) const;
   std::vector<tcp::ConnectionPtr> GetAll() const;
+  // Number of connections which have been sent a challenge but not yet validated.
+  std::size_t UnvalidatedCount() const;
+  // The connection must already be validated.
+  void SubscribeToVaultEvents(tcp::ConnectionPtr connection);
+  // Returns all connections whose primary owner is 'maid_name' and which have subscribed to vault
+  // events.  Owners added with AddOwnerRequest aren't sent events: each owner's events have their
+  // own sequence, which a connection tracks only for its primary owner.
+  std::vector<tcp::ConnectionPtr> GetVaultEventSubscribers(const MaidName& maid_name) const;
 
  private:
-  explicit ClientConnections(asio::io_service& io_service);
-
-  asio::io_service& io_service_;
-  std::map<tcp::ConnectionPtr, std::pair<asymm::PlainText, TimerPtr>,
+  struct MaidNameHash {
+    std::size_t operator()(const MaidName& maid_name) const {
+      return std::hash<std::string>()(maid_name->string());
+    }
+  };
+
+  struct Client {
+    // The primary owner first.
+    std::vector<MaidName> owners;
+    std::map<uint64_t, asymm::PlainText> owner_challenges;
+  };
+
+  explicit ClientConnections(std::shared_ptr<TimingWheel> timing_wheel);
+  void AddSession(tcp::ConnectionPtr connection, const MaidName& maid_name);
+  Client& FindClient(tcp::ConnectionPtr connection);
+  const Client& FindClient(tcp::ConnectionPtr connection) const;
+
+  std::shared_ptr<TimingWheel> timing_wheel_;
+  std::map<tcp::ConnectionPtr, std::pair<asymm::PlainText, TimingWheel::TimerId>,
            std::owner_less<tcp::ConnectionPtr>> unvalidated_clients_;
-  std::map<tcp::ConnectionPtr, MaidName, std::owner_less<tcp::ConnectionPtr>> clients_;
+  std::unordered_map<tcp::ConnectionPtr, Client> clients_;
+  std::unordered_map<MaidName, std::vector<tcp::ConnectionPtr>, MaidNameHash> sessions_;
+  std::unordered_set<tcp::ConnectionPtr> vault_event_subscribers_;
 };
 
 }  // namespace vault_manager
@@ -18,63 +18,311 @@
 
 #include "maidsafe/vault_manager/client_interface.h"
 
+#include <algorithm>
+
 #include "maidsafe/common/make_unique.h"
 #include "maidsafe/common/utils.h"
 #include "maidsafe/common/config.h"
 #include "maidsafe/common/tcp/connection.h"
 
+#include "maidsafe/vault_manager/compact_message.h"
 #include "maidsafe/vault_manager/config.h"
-#include "maidsafe/vault_manager/rpc_helper.h"
+#include "maidsafe/vault_manager/discovery_file.h"
+#include "maidsafe/vault_manager/timing_wheel.h"
 #include "maidsafe/vault_manager/utils.h"
+#include "maidsafe/vault_manager/messages/add_owner_request.h"
+#include "maidsafe/vault_manager/messages/batch_start_vault_request.h"
+#include "maidsafe/vault_manager/messages/batch_take_ownership_request.h"
+#include "maidsafe/vault_manager/messages/capabilities.h"
 #include "maidsafe/vault_manager/messages/challenge.h"
 #include "maidsafe/vault_manager/messages/challenge_response.h"
 #include "maidsafe/vault_manager/messages/log_message.h"
 #include "maidsafe/vault_manager/messages/network_stable_request.h"
+#include "maidsafe/vault_manager/messages/owner_added.h"
+#include "maidsafe/vault_manager/messages/owner_challenge.h"
+#include "maidsafe/vault_manager/messages/owner_challenge_response.h"
+#include "maidsafe/vault_manager/messages/resume_session_request.h"
+#include "maidsafe/vault_manager/messages/session_ticket.h"
 #include "maidsafe/vault_manager/messages/set_network_as_stable.h"
 #include "maidsafe/vault_manager/messages/start_vault_request.h"
+#include "maidsafe/vault_manager/messages/subscribe_to_vault_events_request.h"
 #include "maidsafe/vault_manager/messages/take_ownership_request.h"
 #include "maidsafe/vault_manager/messages/validate_connection_request.h"
+#include "maidsafe/vault_manager/messages/vault_event_notification.h"
 #include "maidsafe/vault_manager/messages/vault_running_response.h"
 
 namespace maidsafe {
 
 namespace vault_manager {
 
+namespace {
+
+StartVaultRequest MakeStartVaultRequest(const NonEmptyString& label, uint64_t request_id,
+                                        const StartVaultSpec& spec) {
+  StartVaultRequest start_vault_request(label, request_id, spec.vault_dir, spec.max_disk_usage);
+  start_vault_request.owner = spec.owner;
+#ifdef USE_VLOGGING
+  start_vault_request.vlog_session_id = spec.vlog_session_id;
+#ifdef TESTING
+  start_vault_request.send_hostname_to_visualiser_server = spec.send_hostname_to_visualiser_server;
+#endif
+#endif
+#ifdef TESTING
+  if (spec.pmid_list_index >= 0)
+    start_vault_request.pmid_list_index = spec.pmid_list_index;
+#endif
+  return start_vault_request;
+}
+
+typedef std::promise<std::unique_ptr<passport::PmidAndSigner>> VaultPromise;
+
+ClientInterface::VaultRequestHandler SetPromise(std::shared_ptr<VaultPromise> promise) {
+  return [promise](std::exception_ptr error,
+                   std::unique_ptr<passport::PmidAndSigner> pmid_and_signer) {
+    if (error)
+      promise->set_exception(error);
+    else
+      promise->set_value(std::move(pmid_and_signer));
+  };
+}
+
+// Returns a handler which sets the value of the future at the corresponding index of 'results'.
+ClientInterface::BatchVaultRequestHandler SetPromises(
+    std::size_t count,
+    std::vector<std::future<std::unique_ptr<passport::PmidAndSigner>>>& results) {
+  std::vector<std::shared_ptr<VaultPromise>> promises;
+  for (std::size_t i(0); i < count; ++i) {
+    promises.emplace_back(std::make_shared<VaultPromise>());
+    results.emplace_back(promises.back()->get_future());
+  }
+  return [promises](std::size_t index, std::exception_ptr error,
+                    std::unique_ptr<passport::PmidAndSigner> pmid_and_signer) {
+    SetPromise(promises.at(index))(error, std::move(pmid_and_signer));
+  };
+}
+
+// Adapts a batch's handler for the vault at 'index' in the batch.
+ClientInterface::VaultRequestHandler BindIndex(ClientInterface::BatchVaultRequestHandler handler,
+                                               std::size_t index) {
+  return [handler, index](std::exception_ptr error,
+                          std::unique_ptr<passport::PmidAndSigner> pmid_and_signer) {
+    handler(index, error, std::move(pmid_and_signer));
+  };
+}
+
+TakeOwnershipRequest MakeTakeOwnershipRequest(uint64_t request_id,
+                                              const TakeOwnershipSpec& spec) {
+  TakeOwnershipRequest take_ownership_request(spec.label, request_id, spec.vault_dir,
+                                              spec.max_disk_usage);
+  take_ownership_request.owner = spec.owner;
+  return take_ownership_request;
+}
+
+}  // unnamed namespace
+
+template <typename MessageType>
+void ClientInterface::SendToVaultManager(MessageType message) {
+  SendSerialised(SerialiseMessage(std::move(message), compact_messages_));
+}
+
 ClientInterface::ClientInterface(const passport::Maid& maid)
+    : ClientInterface(maid, maidsafe::make_unique<AsioService>(1), nullptr) {
+  auto session_established(std::make_shared<std::promise<void>>());
+  AsyncConnect([session_established](std::exception_ptr error) {
+    if (error)
+      session_established->set_exception(error);
+    else
+      session_established->set_value();
+  });
+  // If this throws, the destructor closes the connection.
+  session_established->get_future().get();
+}
+
+ClientInterface::ClientInterface(const passport::Maid& maid, asio::io_service& io_service)
+    : ClientInterface(maid, nullptr, &io_service) {}
+
+ClientInterface::ClientInterface(const passport::Maid& maid,
+                                 std::unique_ptr<AsioService> asio_service,
+                                 asio::io_service* io_service)
     : kMaid_(maid),
+      kMaidName_(passport::PublicMaid(maid).name()),
       mutex_(),
-      on_challenge_(),
-      network_stable_(),
-      network_stable_flag_(),
-      asio_service_(1),
-      strand_(asio_service_.service()),
-      tcp_connection_(ConnectToVaultManager()),
-      connection_closer_([&] { tcp_connection_->Close(); }) {
-  Send(tcp_connection_, ValidateConnectionRequest());
-  auto challenge = SetResponseCallback<std::unique_ptr<asymm::PlainText>, Challenge>(
-                       on_challenge_, asio_service_.service(), mutex_).get();
-  Send(tcp_connection_, ChallengeResponse(passport::PublicMaid(kMaid_),
-                                          asymm::Sign(*challenge, kMaid_.private_key())));
+      shutting_down_(false),
+      session_ticket_(),
+      on_session_established_(),
+      session_timer_id_(0),
+      connection_generation_(0),
+      compact_messages_(false),
+      instance_id_reply_(nullptr),
+      reconnect_attempts_(0),
+      on_network_stable_(),
+      ongoing_vault_requests_(),
+      pending_owners_(),
+      added_maids_(),
+      next_request_id_(1),
+      on_vault_event_(),
+      last_vault_event_sequence_number_(0),
+      asio_service_(std::move(asio_service)),
+      strand_(asio_service_ ? asio_service_->service() : *io_service),
+      timing_wheel_(TimingWheel::MakeShared(strand_.get_io_service())),
+      reconnect_timer_(strand_.get_io_service()),
+      tcp_connection_(),
+      connect_attempt_() {
+  ongoing_vault_requests_.reserve(kMaxExpectedPendingVaultRequests);
 }
 
 ClientInterface::~ClientInterface() {
-// Ensure promise is set if required.
+  shutting_down_ = true;
+  std::future<void> connect_attempt;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    connect_attempt = std::move(connect_attempt_);
+  }
+  if (connect_attempt.valid())
+    connect_attempt.wait();
+  // The timer isn't threadsafe, so cancel it on the strand.  Once this has run, no further
+  // reconnection attempt will be made.
+  auto stop([this] {
+    reconnect_timer_.cancel();
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (tcp_connection_)
+      tcp_connection_->Close();
+  });
+  if (strand_.running_in_this_thread()) {
+    stop();
+  } else {
+    // If the io_service is no longer being run, the posted functor never runs (or only once this
+    // object has gone), so after a while stop inline instead.  Whichever claims the work first
+    // does it.
+    auto claimed(std::make_shared<std::atomic<bool>>(false));
+    auto stopped(std::make_shared<std::promise<void>>());
+    auto stopped_future(stopped->get_future());
+    strand_.post([stop, claimed, stopped] {
+      if (claimed->exchange(true))
+        return;
+      stop();
+      stopped->set_value();
+    });
+    if (stopped_future.wait_for(kRpcTimeout) != std::future_status::ready) {
+      if (claimed->exchange(true)) {
+        stopped_future.wait();
+      } else {
+        LOG(kWarning) << "io_service isn't being run; stopping without the strand.";
+        stop();
+      }
+    }
+  }
+// Release anyone waiting for a stable network.
 #ifdef TESTING
   HandleNetworkStableResponse();
 #endif
 }
 
+void ClientInterface::AsyncConnect(ConnectHandler on_session_established) {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    on_session_established_ = std::move(on_session_established);
+    // Allow for the VaultManager checking our signature as well as the two round trips.
+    session_timer_id_ = timing_wheel_->Add(kRpcTimeout * 2, [this] {
+      LOG(kError) << "Timed out waiting for VaultManager to validate the connection.";
+      FinishConnect(std::make_exception_ptr(MakeError(VaultManagerErrors::timed_out)));
+    });
+  }
+  // Given a discovery file, it's a single attempt via the loopback interface.
+  AsyncConnectToVaultManager(
+      [this](std::shared_ptr<tcp::Connection> tcp_connection, std::exception_ptr error) {
+        // The port scan can outlast the session timer.  Once FinishConnect has run, the outcome is
+        // dropped rather than starting a session for a handler which has already failed.
+        bool pending(false);
+        {
+          std::lock_guard<std::mutex> lock{mutex_};
+          pending = static_cast<bool>(on_session_established_);
+          if (pending && !error)
+            tcp_connection_ = tcp_connection;
+        }
+        if (!pending) {
+          if (tcp_connection) {
+            ++connection_generation_;
+            tcp_connection->Close();
+          }
+          return;
+        }
+        if (error)
+          return FinishConnect(error);
+        StartSession();
+      });
+}
+
+void ClientInterface::FinishConnect(std::exception_ptr error) {
+  ConnectHandler on_session_established;
+  std::shared_ptr<tcp::Connection> tcp_connection;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    on_session_established.swap(on_session_established_);
+    if (on_session_established && error)
+      tcp_connection.swap(tcp_connection_);
+  }
+  if (!on_session_established)
+    return;
+  timing_wheel_->Cancel(session_timer_id_);
+  if (tcp_connection) {
+    // A session which wasn't established in time is abandoned, not reconnected.
+    ++connection_generation_;
+    tcp_connection->Close();
+  }
+  strand_.dispatch([on_session_established, error] { on_session_established(error); });
+}
+
+void ClientInterface::AsyncConnectToVaultManager(
+    std::function<void(std::shared_ptr<tcp::Connection>, std::exception_ptr)> on_done) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  // Any previous attempt has already passed on its outcome, so this doesn't wait long.
+  connect_attempt_ = std::async(std::launch::async, [this, on_done] {
+    std::shared_ptr<tcp::Connection> tcp_connection;
+    std::exception_ptr error;
+    try {
+      tcp_connection = ConnectToVaultManager();
+    } catch (const std::exception&) {
+      error = std::current_exception();
+    }
+    strand_.post([this, on_done, tcp_connection, error] {
+      if (!shutting_down_)
+        return on_done(tcp_connection, error);
+      if (tcp_connection)
+        tcp_connection->Close();
+    });
+  });
+}
+
 std::shared_ptr<tcp::Connection> ClientInterface::ConnectToVaultManager() {
+  // A single attempt suffices if the VaultManager has published its port.  The scan is only needed
+  // if the discovery file is missing or stale, which includes the port now being used by a
+  // different VaultManager.
+  auto discovery_record(ReadDiscoveryFile(GetDiscoveryFilePath()));
+  if (discovery_record) {
+    try {
+      tcp::ConnectionPtr tcp_connection{ConnectToPort(discovery_record->port)};
+      if (IsVaultManagerInstance(tcp_connection, discovery_record->instance_id)) {
+        LOG(kSuccess) << "Connected to VaultManager " << discovery_record->instance_id
+                      << " which is listening on port " << discovery_record->port;
+        return tcp_connection;
+      }
+      LOG(kWarning) << "VaultManager on published port " << discovery_record->port << " isn't "
+                    << discovery_record->instance_id << ".  Scanning port range.";
+    } catch (const std::exception&) {
+      LOG(kWarning) << "Failed to connect to VaultManager " << discovery_record->instance_id
+                    << " on published port " << discovery_record->port
+                    << ".  Scanning port range.";
+    }
+  }
+
   unsigned attempts{0};
   tcp::Port initial_port{GetInitialListeningPort()};
   tcp::Port port{initial_port};
   while (attempts <= tcp::kMaxRangeAboveDefaultPort &&
          port <= std::numeric_limits<tcp::Port>::max()) {
     try {
-      tcp::ConnectionPtr tcp_connection{tcp::Connection::MakeShared(strand_, port)};
-      tcp_connection->Start(
-          [this](tcp::Message message) { HandleReceivedMessage(std::move(message)); },
-          [this] {});  // FIXME OnConnectionClosed
+      tcp::ConnectionPtr tcp_connection{ConnectToPort(port)};
       LOG(kSuccess) << "Connected to VaultManager which is listening on port " << port;
       return tcp_connection;
     } catch (const std::exception&) {
@@ -87,61 +335,419 @@ std::shared_ptr<tcp::Connection> ClientInterface::ConnectToVaultManager() {
   BOOST_THROW_EXCEPTION(MakeError(VaultManagerErrors::failed_to_connect));
 }
 
+std::shared_ptr<tcp::Connection> ClientInterface::ConnectToPort(tcp::Port port) {
+  tcp::ConnectionPtr tcp_connection{tcp::Connection::MakeShared(strand_, port)};
+  const uint64_t connection_generation{++connection_generation_};
+  tcp_connection->Start(
+      [this](tcp::Message message) { HandleReceivedMessage(std::move(message)); },
+      [this, connection_generation] { HandleConnectionClosed(connection_generation); });
+  return tcp_connection;
+}
+
+bool ClientInterface::IsVaultManagerInstance(tcp::ConnectionPtr tcp_connection,
+                                             const std::string& instance_id) {
+  std::promise<std::string> reply;
+  auto reply_future(reply.get_future());
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    instance_id_reply_ = &reply;
+  }
+  tcp_connection->Send(Serialise(Capabilities::tag, Capabilities(Capabilities::kAll)));
+  bool is_instance{reply_future.wait_for(kRpcTimeout) == std::future_status::ready &&
+                   reply_future.get() == instance_id};
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    instance_id_reply_ = nullptr;
+  }
+  if (!is_instance) {
+    // Make the closure of this connection look like that of one already replaced.
+    ++connection_generation_;
+    tcp_connection->Close();
+  }
+  return is_instance;
+}
+
+void ClientInterface::StartSession() {
+  std::string session_ticket;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    session_ticket = session_ticket_;
+  }
+  // The VaultManager's capabilities aren't known until it replies on this connection.
+  compact_messages_ = false;
+  SendToVaultManager(Capabilities(Capabilities::kAll));
+  if (session_ticket.empty())
+    SendToVaultManager(ValidateConnectionRequest());
+  else
+    SendToVaultManager(ResumeSessionRequest(std::move(session_ticket)));
+}
+
+void ClientInterface::HandleConnectionClosed(uint64_t connection_generation) {
+  // Ignore the closure of a connection which has already been replaced.
+  if (shutting_down_ || connection_generation != connection_generation_)
+    return;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    // Until the first session is established, AsyncConnect is left to time out.
+    if (on_session_established_)
+      return;
+    tcp_connection_.reset();
+  }
+  LOG(kWarning) << "Lost connection to VaultManager.";
+  ScheduleReconnect();
+}
+
+void ClientInterface::ScheduleReconnect() {
+  reconnect_timer_.expires_from_now(GetReconnectDelay(reconnect_attempts_++));
+  reconnect_timer_.async_wait(strand_.wrap([this](const std::error_code& error_code) {
+    if (error_code == asio::error::operation_aborted || shutting_down_)
+      return;
+    Reconnect();
+  }));
+}
+
+void ClientInterface::Reconnect() {
+  AsyncConnectToVaultManager(
+      [this](std::shared_ptr<tcp::Connection> tcp_connection, std::exception_ptr error) {
+        if (error) {
+          try {
+            std::rethrow_exception(error);
+          } catch (const std::exception& e) {
+            LOG(kWarning) << "Failed to reconnect: " << boost::diagnostic_information(e);
+          }
+          return ScheduleReconnect();
+        }
+        {
+          std::lock_guard<std::mutex> lock{mutex_};
+          tcp_connection_ = tcp_connection;
+        }
+        StartSession();
+      });
+}
+
+void ClientInterface::ReplayPendingRequests(
+    const boost::optional<passport::PublicMaid::Name>& owner) {
+  std::vector<tcp::Message> messages;
+  bool subscribed_to_vault_events(false);
+  uint64_t last_sequence_number(0);
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    for (const auto& ongoing_vault_request : ongoing_vault_requests_) {
+      if (ongoing_vault_request.second.owner == owner &&
+          !ongoing_vault_request.second.message.empty()) {
+        messages.push_back(ongoing_vault_request.second.message);
+      }
+    }
+    subscribed_to_vault_events = !owner && static_cast<bool>(on_vault_event_);
+    last_sequence_number = last_vault_event_sequence_number_;
+  }
+  LOG(kInfo) << "Reconnected to VaultManager.  Replaying " << messages.size()
+             << " pending requests.";
+  for (auto& message : messages)
+    SendSerialised(std::move(message));
+  if (subscribed_to_vault_events)
+    SendToVaultManager(SubscribeToVaultEventsRequest(last_sequence_number));
+}
+
+std::future<void> ClientInterface::AddMaid(const passport::Maid& maid) {
+  auto promise(std::make_shared<std::promise<void>>());
+  auto result(promise->get_future());
+  AsyncAddMaid(maid, [promise](std::exception_ptr error) {
+    if (error)
+      promise->set_exception(error);
+    else
+      promise->set_value();
+  });
+  return result;
+}
+
+void ClientInterface::AsyncAddMaid(const passport::Maid& maid, ConnectHandler on_added) {
+  SendToVaultManager(AddOwnerRequest(AddPendingOwner(maid, std::move(on_added))));
+}
+
+void ClientInterface::ReAddMaids() {
+  std::vector<RequestId> request_ids;
+  std::vector<passport::Maid> added_maids;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    // Additions which were in flight when the connection was lost are restarted.
+    for (const auto& pending_owner : pending_owners_)
+      request_ids.push_back(pending_owner.first);
+    added_maids = added_maids_;
+  }
+  for (const auto& maid : added_maids)
+    request_ids.push_back(AddPendingOwner(maid, nullptr));
+  for (const auto& request_id : request_ids)
+    SendToVaultManager(AddOwnerRequest(request_id));
+}
+
+ClientInterface::RequestId ClientInterface::AddPendingOwner(const passport::Maid& maid,
+                                                            ConnectHandler on_added) {
+  const RequestId request_id{next_request_id_++};
+  std::lock_guard<std::mutex> lock{mutex_};
+  auto& pending_owner(
+      pending_owners_.emplace(request_id, PendingOwner(maid, std::move(on_added))).first->second);
+  // The wheel never invokes the functor while Add is running, so it's safe to hold 'mutex_' here.
+  pending_owner.timer_id = timing_wheel_->Add(kRpcTimeout * 2, [this, request_id] {
+    LOG(kWarning) << "Timed out adding owner, request ID: " << request_id;
+    FinishAddOwner(request_id, std::make_exception_ptr(MakeError(VaultManagerErrors::timed_out)));
+  });
+  return request_id;
+}
+
+void ClientInterface::FinishAddOwner(RequestId request_id, std::exception_ptr error) {
+  ConnectHandler on_added;
+  passport::PublicMaid::Name owner;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto itr(pending_owners_.find(request_id));
+    if (itr == std::end(pending_owners_))
+      return;
+    timing_wheel_->Cancel(itr->second.timer_id);
+    on_added = std::move(itr->second.on_added);
+    owner = passport::PublicMaid(itr->second.maid).name();
+    // Only a first addition is recorded; a re-added Maid is already in 'added_maids_'.
+    if (!error && on_added)
+      added_maids_.push_back(itr->second.maid);
+    pending_owners_.erase(itr);
+  }
+  if (on_added) {
+    strand_.dispatch([on_added, error] { on_added(error); });
+  } else if (error) {
+    LOG(kError) << "Failed to authenticate " << DebugId(owner.value) << " after reconnecting.";
+  } else {
+    ReplayPendingRequests(owner);
+  }
+}
+
+void ClientInterface::SendSerialised(tcp::Message message) {
+  std::shared_ptr<tcp::Connection> tcp_connection;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    tcp_connection = tcp_connection_;
+  }
+  if (tcp_connection)
+    tcp_connection->Send(std::move(message));
+  else
+    LOG(kVerbose) << "Not connected to VaultManager - dropping message.";
+}
+
+void ClientInterface::RetainForReplay(RequestId request_id, tcp::Message message) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  auto itr(ongoing_vault_requests_.find(request_id));
+  if (itr != std::end(ongoing_vault_requests_))
+    itr->second.message = std::move(message);
+}
+
 std::future<std::unique_ptr<passport::PmidAndSigner>> ClientInterface::TakeOwnership(
     const NonEmptyString& label, const boost::filesystem::path& vault_dir,
     DiskUsage max_disk_usage) {
-  Send(tcp_connection_, TakeOwnershipRequest(label, vault_dir, max_disk_usage));
-  return AddVaultRequest(label);
+  return TakeOwnership(label, vault_dir, max_disk_usage, kVaultRequestTimeout).result;
+}
+
+ClientInterface::PendingVaultRequest ClientInterface::TakeOwnership(
+    const NonEmptyString& label, const boost::filesystem::path& vault_dir,
+    DiskUsage max_disk_usage, std::chrono::steady_clock::duration timeout) {
+  return TakeOwnership(TakeOwnershipSpec(label, vault_dir, max_disk_usage), timeout);
+}
+
+ClientInterface::PendingVaultRequest ClientInterface::TakeOwnership(
+    const TakeOwnershipSpec& spec, std::chrono::steady_clock::duration timeout) {
+  auto promise(std::make_shared<VaultPromise>());
+  auto result(promise->get_future());
+  const RequestId request_id{AsyncTakeOwnership(spec, timeout, SetPromise(promise))};
+  return PendingVaultRequest(request_id, std::move(result));
+}
+
+ClientInterface::RequestId ClientInterface::AsyncTakeOwnership(
+    const NonEmptyString& label, const boost::filesystem::path& vault_dir,
+    DiskUsage max_disk_usage, std::chrono::steady_clock::duration timeout,
+    VaultRequestHandler handler) {
+  return AsyncTakeOwnership(TakeOwnershipSpec(label, vault_dir, max_disk_usage), timeout,
+                            std::move(handler));
+}
+
+ClientInterface::RequestId ClientInterface::AsyncTakeOwnership(
+    const TakeOwnershipSpec& spec, std::chrono::steady_clock::duration timeout,
+    VaultRequestHandler handler) {
+  const RequestId request_id{AddVaultRequest(spec.label, timeout, spec.owner, std::move(handler))};
+  tcp::Message message{
+      Serialise(TakeOwnershipRequest::tag, MakeTakeOwnershipRequest(request_id, spec))};
+  RetainForReplay(request_id, message);
+  SendSerialised(std::move(message));
+  return request_id;
 }
 
 #ifdef USE_VLOGGING
 std::future<std::unique_ptr<passport::PmidAndSigner>> ClientInterface::StartVault(
     const boost::filesystem::path& vault_dir, DiskUsage max_disk_usage,
     const std::string& vlog_session_id) {
-  NonEmptyString label{GenerateLabel()};
-  StartVaultRequest start_vault_request(label, vault_dir, max_disk_usage);
-  start_vault_request.vlog_session_id = vlog_session_id;
-  Send(tcp_connection_, std::move(start_vault_request));
-  return AddVaultRequest(label);
+  StartVaultSpec spec(vault_dir, max_disk_usage);
+  spec.vlog_session_id = vlog_session_id;
+  return StartVault(spec, kVaultRequestTimeout).result;
 }
 #else
 std::future<std::unique_ptr<passport::PmidAndSigner>> ClientInterface::StartVault(
     const boost::filesystem::path& vault_dir, DiskUsage max_disk_usage) {
-  NonEmptyString label{GenerateLabel()};
-  Send(tcp_connection_, StartVaultRequest(label, vault_dir, max_disk_usage));
-  return AddVaultRequest(label);
+  return StartVault(StartVaultSpec(vault_dir, max_disk_usage), kVaultRequestTimeout).result;
 }
 #endif
 
-std::future<std::unique_ptr<passport::PmidAndSigner>> ClientInterface::AddVaultRequest(
-    const NonEmptyString& label) {
-  std::shared_ptr<VaultRequest> request(
-      std::make_shared<VaultRequest>(asio_service_.service(), std::chrono::seconds(30)));
-  request->timer.async_wait([request, label, this](const std::error_code& ec) {
-    if (ec && ec == asio::error::operation_aborted)
-      return;
-    LOG(kWarning) << "Timer expired - i.e. timed out for label: " << label.string();
-    std::lock_guard<std::mutex> lock{mutex_};
-    if (ec)
-      request->SetException(ec);
-    else
-      request->SetException(MakeError(VaultManagerErrors::timed_out));
-    ongoing_vault_requests_.erase(label);
-  });
+ClientInterface::PendingVaultRequest ClientInterface::StartVault(
+    const StartVaultSpec& spec, std::chrono::steady_clock::duration timeout) {
+  auto promise(std::make_shared<VaultPromise>());
+  auto result(promise->get_future());
+  const RequestId request_id{AsyncStartVault(spec, timeout, SetPromise(promise))};
+  return PendingVaultRequest(request_id, std::move(result));
+}
 
+ClientInterface::RequestId ClientInterface::AsyncStartVault(
+    const StartVaultSpec& spec, std::chrono::steady_clock::duration timeout,
+    VaultRequestHandler handler) {
+  NonEmptyString label{GenerateLabel()};
+  const RequestId request_id{AddVaultRequest(label, timeout, spec.owner, std::move(handler))};
+  tcp::Message message{
+      Serialise(StartVaultRequest::tag, MakeStartVaultRequest(label, request_id, spec))};
+  RetainForReplay(request_id, message);
+  SendSerialised(std::move(message));
+  return request_id;
+}
+
+std::vector<std::future<std::unique_ptr<passport::PmidAndSigner>>> ClientInterface::StartVaults(
+    const std::vector<StartVaultSpec>& specs) {
+  std::vector<std::future<std::unique_ptr<passport::PmidAndSigner>>> results;
+  AsyncStartVaults(specs, SetPromises(specs.size(), results));
+  return results;
+}
+
+std::vector<ClientInterface::RequestId> ClientInterface::AsyncStartVaults(
+    const std::vector<StartVaultSpec>& specs, BatchVaultRequestHandler handler) {
+  // The VaultManager handles the batch's vaults in turn, so allow a little extra time per vault.
+  // Batches larger than the VaultManager accepts are split.
+  const auto timeout(kVaultRequestTimeout + kRpcTimeout * specs.size());
+  std::vector<RequestId> request_ids;
+  BatchStartVaultRequest batch_request;
+  for (std::size_t i(0); i < specs.size(); ++i) {
+    NonEmptyString label{GenerateLabel()};
+    const RequestId request_id{
+        AddVaultRequest(label, timeout, specs[i].owner, BindIndex(handler, i))};
+    batch_request.requests.emplace_back(MakeStartVaultRequest(label, request_id, specs[i]));
+    // If replayed after a reconnection, the request is sent on its own rather than in a batch.
+    RetainForReplay(request_id, Serialise(StartVaultRequest::tag,
+                                          MakeStartVaultRequest(label, request_id, specs[i])));
+    request_ids.push_back(request_id);
+    if (batch_request.requests.size() == kMaxVaultsPerBatch) {
+      SendToVaultManager(std::move(batch_request));
+      batch_request = BatchStartVaultRequest();
+    }
+  }
+  if (!batch_request.requests.empty())
+    SendToVaultManager(std::move(batch_request));
+  return request_ids;
+}
+
+std::vector<std::future<std::unique_ptr<passport::PmidAndSigner>>> ClientInterface::TakeOwnership(
+    const std::vector<TakeOwnershipSpec>& specs) {
+  std::vector<std::future<std::unique_ptr<passport::PmidAndSigner>>> results;
+  AsyncTakeOwnership(specs, SetPromises(specs.size(), results));
+  return results;
+}
+
+std::vector<ClientInterface::RequestId> ClientInterface::AsyncTakeOwnership(
+    const std::vector<TakeOwnershipSpec>& specs, BatchVaultRequestHandler handler) {
+  const auto timeout(kVaultRequestTimeout + kRpcTimeout * specs.size());
+  std::vector<RequestId> request_ids;
+  BatchTakeOwnershipRequest batch_request;
+  for (std::size_t i(0); i < specs.size(); ++i) {
+    const TakeOwnershipSpec& spec(specs[i]);
+    const RequestId request_id{
+        AddVaultRequest(spec.label, timeout, spec.owner, BindIndex(handler, i))};
+    batch_request.requests.emplace_back(MakeTakeOwnershipRequest(request_id, spec));
+    RetainForReplay(request_id, Serialise(TakeOwnershipRequest::tag,
+                                          MakeTakeOwnershipRequest(request_id, spec)));
+    request_ids.push_back(request_id);
+    if (batch_request.requests.size() == kMaxVaultsPerBatch) {
+      SendToVaultManager(std::move(batch_request));
+      batch_request = BatchTakeOwnershipRequest();
+    }
+  }
+  if (!batch_request.requests.empty())
+    SendToVaultManager(std::move(batch_request));
+  return request_ids;
+}
+
+bool ClientInterface::CancelRequest(RequestId request_id) {
+  return CompleteVaultRequest(
+      request_id, std::make_exception_ptr(std::system_error(
+                      asio::error::make_error_code(asio::error::operation_aborted))),
+      nullptr);
+}
+
+ClientInterface::RequestId ClientInterface::AddVaultRequest(
+    const NonEmptyString& label, std::chrono::steady_clock::duration timeout,
+    const boost::optional<passport::PublicMaid::Name>& owner, VaultRequestHandler handler) {
+  const RequestId request_id{next_request_id_++};
+  // Requests naming our own Maid are replayed along with those naming no owner.
+  boost::optional<passport::PublicMaid::Name> acting_owner;
+  if (owner && *owner != kMaidName_)
+    acting_owner = owner;
   std::lock_guard<std::mutex> lock{mutex_};
-  ongoing_vault_requests_.insert(std::make_pair(label, request));
-  return request->promise.get_future();
+  auto& ongoing_vault_request(
+      ongoing_vault_requests_.insert(std::make_pair(
+          request_id, OngoingVaultRequest(std::move(handler), acting_owner))).first->second);
+  // The wheel never invokes the functor while Add is running, so it's safe to hold 'mutex_' here.
+  ongoing_vault_request.timer_id = timing_wheel_->Add(timeout, [request_id, label, this] {
+    LOG(kWarning) << "Timer expired - i.e. timed out for label: " << label.string()
+                  << ", request ID: " << request_id;
+    CompleteVaultRequest(request_id,
+                         std::make_exception_ptr(MakeError(VaultManagerErrors::timed_out)),
+                         nullptr);
+  });
+  return request_id;
+}
+
+bool ClientInterface::CompleteVaultRequest(
+    RequestId request_id, std::exception_ptr error,
+    std::unique_ptr<passport::PmidAndSigner> pmid_and_signer) {
+  VaultRequestHandler handler;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto itr(ongoing_vault_requests_.find(request_id));
+    if (itr == std::end(ongoing_vault_requests_))
+      return false;
+    handler = std::move(itr->second.handler);
+    timing_wheel_->Cancel(itr->second.timer_id);
+    ongoing_vault_requests_.erase(itr);
+  }
+  // asio requires handlers to be copyable.
+  auto result(
+      std::make_shared<std::unique_ptr<passport::PmidAndSigner>>(std::move(pmid_and_signer)));
+  strand_.dispatch([handler, error, result] { handler(error, std::move(*result)); });
+  return true;
 }
 
 void ClientInterface::HandleReceivedMessage(tcp::Message&& message) {
   try {
+    if (PeekTag(message) == MessageTag::kCompactMessage)
+      return HandleCompactMessage(message);
     InputVectorStream binary_input_stream(std::move(message));
     MessageTag tag(static_cast<MessageTag>(-1));
     Parse(binary_input_stream, tag);
     switch (tag) {
       case MessageTag::kChallenge:
-        InvokeCallBack(Parse<Challenge>(binary_input_stream), on_challenge_);
+        HandleChallenge(Parse<Challenge>(binary_input_stream));
+        break;
+      case MessageTag::kCapabilities:
+        HandleCapabilities(Parse<Capabilities>(binary_input_stream));
+        break;
+      case MessageTag::kSessionTicket:
+        HandleSessionTicket(Parse<SessionTicket>(binary_input_stream));
+        break;
+      case MessageTag::kOwnerChallenge:
+        HandleOwnerChallenge(Parse<OwnerChallenge>(binary_input_stream));
+        break;
+      case MessageTag::kOwnerAdded:
+        HandleOwnerAdded(Parse<OwnerAdded>(binary_input_stream));
         break;
       case MessageTag::kVaultRunningResponse:
         HandleVaultRunningResponse(Parse<VaultRunningResponse>(binary_input_stream));
@@ -151,6 +757,9 @@ void ClientInterface::HandleReceivedMessage(tcp::Message&& message) {
         HandleNetworkStableResponse();
         break;
 #endif
+      case MessageTag::kVaultEventNotification:
+        HandleVaultEventNotification(Parse<VaultEventNotification>(binary_input_stream));
+        break;
       case MessageTag::kLogMessage:
         HandleLogMessage(Parse<LogMessage>(binary_input_stream));
         break;
@@ -162,51 +771,140 @@ void ClientInterface::HandleReceivedMessage(tcp::Message&& message) {
   }
 }
 
+void ClientInterface::HandleCompactMessage(const tcp::Message& message) {
+  switch (CompactTag(message)) {
+#ifdef TESTING
+    case MessageTag::kNetworkStableResponse:
+      HandleNetworkStableResponse();
+      break;
+#endif
+    default:
+      LOG(kWarning) << "Unexpected compact message.";
+      break;
+  }
+}
+
+void ClientInterface::HandleCapabilities(Capabilities&& capabilities) {
+  compact_messages_ = (capabilities.flags & Capabilities::kCompactMessages) != 0;
+  std::lock_guard<std::mutex> lock{mutex_};
+  if (instance_id_reply_) {
+    instance_id_reply_->set_value(std::move(capabilities.instance_id));
+    instance_id_reply_ = nullptr;
+  }
+}
+
 void ClientInterface::HandleVaultRunningResponse(VaultRunningResponse&& vault_running_response) {
   NonEmptyString label(vault_running_response.vault_label);
   std::unique_ptr<passport::PmidAndSigner> pmid_and_signer;
-  std::unique_ptr<maidsafe_error> error;
+  std::exception_ptr error;
   if (vault_running_response.vault_keys) {
     pmid_and_signer = maidsafe::make_unique<passport::PmidAndSigner>(
         *vault_running_response.vault_keys->pmid_and_signer);
   } else if (vault_running_response.error) {
-    error = maidsafe::make_unique<maidsafe_error>(*vault_running_response.error);
-    LOG(kError) << "Got error for vault label: " << label.string() << "   Error: " << error->what();
+    LOG(kError) << "Got error for vault label: " << label.string()
+                << "   Error: " << vault_running_response.error->what();
+    error = std::make_exception_ptr(maidsafe_error(*vault_running_response.error));
   } else {
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
   }
 
-  std::lock_guard<std::mutex> lock{mutex_};
-  auto itr = ongoing_vault_requests_.find(label);
-  if (ongoing_vault_requests_.end() != itr) {
-    if (pmid_and_signer)
-      itr->second->SetValue(std::move(pmid_and_signer));
-    else
-      itr->second->SetException(*error);
-
-    itr->second->timer.cancel();
-    ongoing_vault_requests_.erase(itr);
-  } else {
-    LOG(kWarning) << "No pending requests in map";
+  if (!CompleteVaultRequest(vault_running_response.request_id, error,
+                            std::move(pmid_and_signer))) {
+    LOG(kWarning) << "No pending request with ID " << vault_running_response.request_id
+                  << " for vault label: " << label.string();
   }
 }
 
 #ifdef TESTING
 void ClientInterface::HandleNetworkStableResponse() {
-  std::call_once(network_stable_flag_, [&] { network_stable_.set_value(); });
+  std::vector<std::function<void()>> on_network_stable;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    on_network_stable.swap(on_network_stable_);
+  }
+  for (auto& on_stable : on_network_stable)
+    on_stable();
 }
 #endif
 
-void ClientInterface::InvokeCallBack(Challenge&& challenge,
-                                     std::function<void(Challenge&&)>& callback) {
-  if (callback)
-    callback(std::move(challenge));
-  else
-    LOG(kWarning) << "Call back not available";
+void ClientInterface::HandleChallenge(Challenge&& challenge) {
+  SendToVaultManager(ChallengeResponse(passport::PublicMaid(kMaid_),
+                                       asymm::Sign(challenge.plaintext, kMaid_.private_key())));
+}
+
+void ClientInterface::HandleSessionTicket(SessionTicket&& session_ticket) {
+  bool first_session(false);
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    session_ticket_ = std::move(session_ticket.ticket);
+    first_session = static_cast<bool>(on_session_established_);
+  }
+  reconnect_attempts_ = 0;
+  if (first_session) {
+    FinishConnect(nullptr);
+  } else {
+    ReplayPendingRequests(boost::none);
+    ReAddMaids();
+  }
+}
+
+void ClientInterface::HandleOwnerChallenge(OwnerChallenge&& owner_challenge) {
+  std::unique_ptr<passport::Maid> maid;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto itr(pending_owners_.find(owner_challenge.request_id));
+    if (itr == std::end(pending_owners_)) {
+      LOG(kWarning) << "No owner pending with request ID " << owner_challenge.request_id;
+      return;
+    }
+    maid = maidsafe::make_unique<passport::Maid>(itr->second.maid);
+  }
+  SendToVaultManager(OwnerChallengeResponse(owner_challenge.request_id,
+                                            passport::PublicMaid(*maid),
+                                            asymm::Sign(owner_challenge.plaintext,
+                                                        maid->private_key())));
+}
+
+void ClientInterface::HandleOwnerAdded(OwnerAdded&& owner_added) {
+  FinishAddOwner(owner_added.request_id,
+                 owner_added.error ? std::make_exception_ptr(*owner_added.error) : nullptr);
 }
 
 void ClientInterface::HandleLogMessage(LogMessage&& log_message) { LOG(kInfo) << log_message.data; }
 
+void ClientInterface::SubscribeToVaultEvents(VaultEventFunctor on_vault_event,
+                                             uint64_t last_sequence_number) {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    on_vault_event_ = std::move(on_vault_event);
+    last_vault_event_sequence_number_ = last_sequence_number;
+  }
+  SendToVaultManager(SubscribeToVaultEventsRequest(last_sequence_number));
+}
+
+uint64_t ClientInterface::LastVaultEventSequenceNumber() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return last_vault_event_sequence_number_;
+}
+
+void ClientInterface::HandleVaultEventNotification(
+    VaultEventNotification&& vault_event_notification) {
+  VaultEventFunctor on_vault_event;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    // Replayed events may overlap with ones already delivered; only pass each one on once.  After a
+    // gap the VaultManager's numbering may have restarted, so the sequence restarts too.
+    if (!vault_event_notification.event.follows_gap &&
+        vault_event_notification.event.sequence_number <= last_vault_event_sequence_number_) {
+      return;
+    }
+    last_vault_event_sequence_number_ = vault_event_notification.event.sequence_number;
+    on_vault_event = on_vault_event_;
+  }
+  if (on_vault_event)
+    on_vault_event(vault_event_notification.event);
+}
+
 #ifdef TESTING
 void ClientInterface::SetTestEnvironment(tcp::Port test_vault_manager_port,
                                          boost::filesystem::path test_env_root_dir,
@@ -219,42 +917,46 @@ void ClientInterface::SetTestEnvironment(tcp::Port test_vault_manager_port,
 std::future<std::unique_ptr<passport::PmidAndSigner>> ClientInterface::StartVault(
     const boost::filesystem::path& vault_dir, DiskUsage max_disk_usage,
     const std::string& vlog_session_id, bool send_hostname_to_visualiser_server) {
-  NonEmptyString label{GenerateLabel()};
-  StartVaultRequest start_vault_request(label, vault_dir, max_disk_usage);
-  start_vault_request.vlog_session_id = vlog_session_id;
-  start_vault_request.send_hostname_to_visualiser_server = send_hostname_to_visualiser_server;
-  Send(tcp_connection_, std::move(start_vault_request));
-  return AddVaultRequest(label);
+  StartVaultSpec spec(vault_dir, max_disk_usage);
+  spec.vlog_session_id = vlog_session_id;
+  spec.send_hostname_to_visualiser_server = send_hostname_to_visualiser_server;
+  return StartVault(spec, kVaultRequestTimeout).result;
 }
 
 std::future<std::unique_ptr<passport::PmidAndSigner>> ClientInterface::StartVault(
     const boost::filesystem::path& vault_dir, DiskUsage max_disk_usage,
     const std::string& vlog_session_id, bool send_hostname_to_visualiser_server,
     int pmid_list_index) {
-  NonEmptyString label{GenerateLabel()};
-  StartVaultRequest start_vault_request(label, vault_dir, max_disk_usage);
-  start_vault_request.vlog_session_id = vlog_session_id;
-  start_vault_request.send_hostname_to_visualiser_server = send_hostname_to_visualiser_server;
-  start_vault_request.pmid_list_index = pmid_list_index;
-  Send(tcp_connection_, std::move(start_vault_request));
-  return AddVaultRequest(label);
+  StartVaultSpec spec(vault_dir, max_disk_usage);
+  spec.vlog_session_id = vlog_session_id;
+  spec.send_hostname_to_visualiser_server = send_hostname_to_visualiser_server;
+  spec.pmid_list_index = pmid_list_index;
+  return StartVault(spec, kVaultRequestTimeout).result;
 }
 #else
 std::future<std::unique_ptr<passport::PmidAndSigner>> ClientInterface::StartVault(
     const boost::filesystem::path& vault_dir, DiskUsage max_disk_usage, int pmid_list_index) {
-  NonEmptyString label{GenerateLabel()};
-  StartVaultRequest start_vault_request(label, vault_dir, max_disk_usage);
-  start_vault_request.pmid_list_index = pmid_list_index;
-  Send(tcp_connection_, std::move(start_vault_request));
-  return AddVaultRequest(label);
+  StartVaultSpec spec(vault_dir, max_disk_usage);
+  spec.pmid_list_index = pmid_list_index;
+  return StartVault(spec, kVaultRequestTimeout).result;
 }
 #endif
 
-void ClientInterface::MarkNetworkAsStable() { Send(tcp_connection_, SetNetworkAsStable()); }
+void ClientInterface::MarkNetworkAsStable() { SendToVaultManager(SetNetworkAsStable()); }
 
 std::future<void> ClientInterface::WaitForStableNetwork() {
-  Send(tcp_connection_, NetworkStableRequest());
-  return network_stable_.get_future();
+  auto promise(std::make_shared<std::promise<void>>());
+  auto result(promise->get_future());
+  AsyncWaitForStableNetwork([promise] { promise->set_value(); });
+  return result;
+}
+
+void ClientInterface::AsyncWaitForStableNetwork(std::function<void()> on_stable) {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    on_network_stable_.push_back(std::move(on_stable));
+  }
+  SendToVaultManager(NetworkStableRequest());
 }
 #endif
 
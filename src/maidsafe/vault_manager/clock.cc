@@ -0,0 +1,131 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/clock.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "asio/steady_timer.hpp"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace {
+
+class AsioSteadyTimer : public Clock::Timer {
+ public:
+  explicit AsioSteadyTimer(asio::io_service& io_service) : timer_(io_service) {}
+
+  // Re-arming cancels the earlier wait, whose handler then sees operation_aborted.
+  void WaitUntil(Clock::TimePoint expiry, Clock::Handler handler) override {
+    timer_.expires_at(expiry);
+    timer_.async_wait([handler](const std::error_code& error_code) {
+      if (error_code != asio::error::operation_aborted)
+        handler();
+    });
+  }
+
+ private:
+  asio::steady_timer timer_;
+};
+
+class RealSteadyClock : public Clock {
+ public:
+  TimePoint Now() const override { return std::chrono::steady_clock::now(); }
+
+  std::unique_ptr<Timer> MakeTimer(asio::io_service& io_service) override {
+    return std::unique_ptr<Timer>{new AsioSteadyTimer{io_service}};
+  }
+};
+
+}  // unnamed namespace
+
+std::shared_ptr<Clock> SteadyClock() {
+  static const std::shared_ptr<Clock> steady_clock{std::make_shared<RealSteadyClock>()};
+  return steady_clock;
+}
+
+#ifdef TESTING
+class SimulatedClock::SimulatedTimer : public Clock::Timer {
+ public:
+  SimulatedTimer(SimulatedClock& clock, asio::io_service& io_service)
+      : clock_(clock), io_service_(io_service), expiry_(), handler_() {
+    std::lock_guard<std::mutex> lock{clock_.mutex_};
+    clock_.timers_.push_back(this);
+  }
+
+  ~SimulatedTimer() {
+    std::lock_guard<std::mutex> lock{clock_.mutex_};
+    clock_.timers_.erase(std::find(clock_.timers_.begin(), clock_.timers_.end(), this));
+  }
+
+  void WaitUntil(Clock::TimePoint expiry, Clock::Handler handler) override {
+    std::lock_guard<std::mutex> lock{clock_.mutex_};
+    expiry_ = expiry;
+    handler_ = std::move(handler);
+  }
+
+ private:
+  friend class SimulatedClock;
+
+  SimulatedClock& clock_;
+  asio::io_service& io_service_;
+  Clock::TimePoint expiry_;
+  Clock::Handler handler_;  // Empty unless waiting.
+};
+
+SimulatedClock::SimulatedClock() : mutex_(), now_(), timers_() {}
+
+SimulatedClock::~SimulatedClock() {}
+
+Clock::TimePoint SimulatedClock::Now() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return now_;
+}
+
+std::unique_ptr<Clock::Timer> SimulatedClock::MakeTimer(asio::io_service& io_service) {
+  return std::unique_ptr<Timer>{new SimulatedTimer{*this, io_service}};
+}
+
+void SimulatedClock::Advance(std::chrono::steady_clock::duration duration) {
+  std::vector<std::pair<TimePoint, SimulatedTimer*>> expired;
+  std::lock_guard<std::mutex> lock{mutex_};
+  now_ += duration;
+  for (SimulatedTimer* timer : timers_) {
+    if (timer->handler_ && timer->expiry_ <= now_)
+      expired.emplace_back(timer->expiry_, timer);
+  }
+  std::stable_sort(expired.begin(), expired.end(),
+                   [](const std::pair<TimePoint, SimulatedTimer*>& lhs,
+                      const std::pair<TimePoint, SimulatedTimer*>& rhs) {
+                     return lhs.first < rhs.first;
+                   });
+  for (auto& timer : expired) {
+    // Posting doesn't run the handler, so it's safe to hold the mutex.
+    Handler handler;
+    std::swap(handler, timer.second->handler_);
+    timer.second->io_service_.post(handler);
+  }
+}
+#endif
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
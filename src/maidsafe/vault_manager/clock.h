@@ -0,0 +1,86 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_CLOCK_H_
+#define MAIDSAFE_VAULT_MANAGER_CLOCK_H_
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "asio/io_service.hpp"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// The time source of a TimingWheel, and so of every connection, process and request timeout.
+// SteadyClock() is the real one.  A SimulatedClock only moves when advanced, so that timeouts can
+// be exercised deterministically and without waiting.
+class Clock {
+ public:
+  typedef std::chrono::steady_clock::time_point TimePoint;
+  typedef std::function<void()> Handler;
+
+  // A single-shot timer.  Calling WaitUntil again replaces any wait in progress.  Not threadsafe.
+  class Timer {
+   public:
+    virtual ~Timer() {}
+    // 'handler' is invoked on a thread running the timer's io_service once the clock reaches
+    // 'expiry'.  Destroying the timer abandons a wait which hasn't yet expired.
+    virtual void WaitUntil(TimePoint expiry, Handler handler) = 0;
+  };
+
+  virtual ~Clock() {}
+  virtual TimePoint Now() const = 0;
+  virtual std::unique_ptr<Timer> MakeTimer(asio::io_service& io_service) = 0;
+};
+
+// std::chrono::steady_clock, with asio timers.
+std::shared_ptr<Clock> SteadyClock();
+
+#ifdef TESTING
+// Starts at an arbitrary time and only moves when advanced.  Timers mustn't outlive the clock.
+// Threadsafe.
+class SimulatedClock : public Clock {
+ public:
+  SimulatedClock();
+  ~SimulatedClock();
+
+  TimePoint Now() const override;
+  std::unique_ptr<Timer> MakeTimer(asio::io_service& io_service) override;
+  // Posts the handlers of the timers which expire in the meantime to their io_services, earliest
+  // first.
+  void Advance(std::chrono::steady_clock::duration duration);
+
+ private:
+  class SimulatedTimer;
+
+  mutable std::mutex mutex_;
+  TimePoint now_;
+  std::vector<SimulatedTimer*> timers_;
+};
+#endif
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_CLOCK_H_
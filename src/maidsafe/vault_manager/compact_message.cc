@@ -0,0 +1,85 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/compact_message.h"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+
+#include "maidsafe/vault_manager/messages/joined_network.h"
+#include "maidsafe/vault_manager/messages/network_stable_request.h"
+#include "maidsafe/vault_manager/messages/network_stable_response.h"
+#include "maidsafe/vault_manager/messages/set_network_as_stable.h"
+#include "maidsafe/vault_manager/messages/validate_connection_request.h"
+#include "maidsafe/vault_manager/messages/vault_shutdown_request.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace {
+
+template <typename T>
+bool SizeMatches(const tcp::Message& frame) {
+  return frame.size() == kCompactHeaderSize + CompactLayout<T>::kSize;
+}
+
+}  // unnamed namespace
+
+MessageTag CompactTag(const tcp::Message& frame) {
+  if (frame.size() < kCompactHeaderSize ||
+      frame[0] != static_cast<byte>(MessageTag::kCompactMessage)) {
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+  }
+  const MessageTag tag{static_cast<MessageTag>(frame[1])};
+  bool valid{false};
+  switch (tag) {
+    case MessageTag::kValidateConnectionRequest:
+      valid = SizeMatches<ValidateConnectionRequest>(frame);
+      break;
+    case MessageTag::kVaultShutdownRequest:
+      valid = SizeMatches<VaultShutdownRequest>(frame);
+      break;
+    case MessageTag::kMaxDiskUsageUpdate:
+      valid = SizeMatches<MaxDiskUsageUpdate>(frame);
+      break;
+    case MessageTag::kJoinedNetwork:
+      valid = SizeMatches<JoinedNetwork>(frame);
+      break;
+    case MessageTag::kSetNetworkAsStable:
+      valid = SizeMatches<SetNetworkAsStable>(frame);
+      break;
+    case MessageTag::kNetworkStableRequest:
+      valid = SizeMatches<NetworkStableRequest>(frame);
+      break;
+    case MessageTag::kNetworkStableResponse:
+      valid = SizeMatches<NetworkStableResponse>(frame);
+      break;
+    default:
+      break;
+  }
+  if (!valid) {
+    LOG(kError) << "Invalid compact frame of " << frame.size() << " bytes.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+  }
+  return tag;
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
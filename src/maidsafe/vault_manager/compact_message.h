@@ -0,0 +1,133 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_COMPACT_MESSAGE_H_
+#define MAIDSAFE_VAULT_MANAGER_COMPACT_MESSAGE_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "maidsafe/common/types.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/common/tcp/connection.h"
+
+#include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/messages/empty_message.h"
+#include "maidsafe/vault_manager/messages/max_disk_usage_update.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Small fixed-size messages can be sent to a peer which has advertised
+// Capabilities::kCompactMessages in a packed layout rather than via cereal.  A compact frame is the
+// tag kCompactMessage, then the message's own tag, then exactly CompactLayout<T>::kSize bytes of
+// fields.  Encoding needs no stream, and decoding reads the fields in place without allocating or
+// throwing once the frame's size has been checked by CompactTag.
+const std::size_t kCompactHeaderSize = 2;
+
+// Specialised for each message which has a compact layout.
+template <typename T>
+struct CompactLayout {
+  static const bool kDefined = false;
+};
+
+template <MessageTag Tag>
+struct CompactLayout<EmptyMessage<Tag>> {
+  static const bool kDefined = true;
+  static const std::size_t kSize = 0;
+  static void Encode(const EmptyMessage<Tag>& /*message*/, byte* /*out*/) {}
+  static EmptyMessage<Tag> Decode(const byte* /*in*/) { return EmptyMessage<Tag>(); }
+};
+
+template <>
+struct CompactLayout<MaxDiskUsageUpdate> {
+  static const bool kDefined = true;
+  static const std::size_t kSize = sizeof(uint64_t);
+  // Big-endian.
+  static void Encode(const MaxDiskUsageUpdate& message, byte* out) {
+    uint64_t usage{message.usage.data};
+    for (std::size_t i(kSize); i != 0; --i, usage >>= 8)
+      out[i - 1] = static_cast<byte>(usage & 0xff);
+  }
+  static MaxDiskUsageUpdate Decode(const byte* in) {
+    uint64_t usage{0};
+    for (std::size_t i(0); i != kSize; ++i)
+      usage = (usage << 8) | in[i];
+    return MaxDiskUsageUpdate(DiskUsage(usage));
+  }
+};
+
+template <typename T>
+tcp::Message SerialiseCompact(const T& message) {
+  static_assert(CompactLayout<T>::kDefined, "This message has no compact layout.");
+  tcp::Message frame(kCompactHeaderSize + CompactLayout<T>::kSize);
+  frame[0] = static_cast<byte>(MessageTag::kCompactMessage);
+  frame[1] = static_cast<byte>(T::tag);
+  CompactLayout<T>::Encode(message, &frame[0] + kCompactHeaderSize);
+  return frame;
+}
+
+// Returns the tag of the message held in a compact frame.  Throws if that tag has no compact
+// layout or if the frame's size doesn't match its layout.
+MessageTag CompactTag(const tcp::Message& frame);
+
+// 'frame' must already have been checked by CompactTag.
+template <typename T>
+T ParseCompact(const tcp::Message& frame) {
+  static_assert(CompactLayout<T>::kDefined, "This message has no compact layout.");
+  assert(frame.size() == kCompactHeaderSize + CompactLayout<T>::kSize &&
+         frame[1] == static_cast<byte>(T::tag));
+  return CompactLayout<T>::Decode(&frame[0] + kCompactHeaderSize);
+}
+
+namespace detail {
+
+template <typename T>
+tcp::Message SerialiseMessage(T message, bool compact, std::true_type /*has_compact_layout*/) {
+  return compact ? SerialiseCompact(message) : Serialise(T::tag, std::move(message));
+}
+
+template <typename T>
+tcp::Message SerialiseMessage(T message, bool /*compact*/, std::false_type /*has_compact_layout*/) {
+  return Serialise(T::tag, std::move(message));
+}
+
+}  // namespace detail
+
+// Uses the compact layout if 'compact' is true (i.e. the peer has advertised
+// Capabilities::kCompactMessages) and T has one, otherwise cereal.
+template <typename T>
+tcp::Message SerialiseMessage(T message, bool compact) {
+  return detail::SerialiseMessage(std::move(message), compact,
+                                  std::integral_constant<bool, CompactLayout<T>::kDefined>());
+}
+
+template <typename T>
+void Send(tcp::ConnectionPtr connection, T message, bool compact) {
+  connection->Send(SerialiseMessage(std::move(message), compact));
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_COMPACT_MESSAGE_H_
@@ -18,16 +18,44 @@
 
 #include "maidsafe/vault_manager/config.h"
 
+#include <algorithm>
+#include <thread>
+
 namespace maidsafe {
 
 namespace vault_manager {
 
 const std::string kConfigFilename("vault_manager_config.dat");
+const std::string kOverridesFilename("vault_manager_overrides.conf");
+const std::string kChildrenFilename("vault_manager_children.dat");
+const std::string kDiscoveryFilename("vault_manager_endpoint.dat");
 const std::string kBootstrapFilename("bootstrap.dat");
 
 const std::chrono::seconds kRpcTimeout(2);
 const std::chrono::seconds kVaultStopTimeout(10);
+const std::chrono::seconds kVaultRequestTimeout(30);
 const int kMaxVaultRestarts(5);
+const std::size_t kMaxVaultEventsPerOwner(256);
+const std::size_t kMaxExpectedPendingVaultRequests(4096);
+const std::size_t kMaxNewConnectionsPerSecond(200);
+const std::size_t kMaxPendingConnections(64);
+const std::size_t kMaxOutstandingChallenges(64);
+const std::size_t kCryptoThreadCount(std::max(1U, std::thread::hardware_concurrency() / 2));
+const std::size_t kMaxQueuedCryptoJobs(1024);
+const std::chrono::seconds kSessionTicketLifetime(600);
+const std::chrono::milliseconds kInitialReconnectDelay(100);
+const std::chrono::milliseconds kMaxReconnectDelay(10000);
+const std::chrono::milliseconds kTimingWheelResolution(10);
+const std::size_t kVaultKeysCacheSize(64);
+const std::chrono::seconds kVaultReconnectTimeout(120);
+const std::chrono::milliseconds kAdoptionTimeout(kMaxReconnectDelay * 2);
+const std::chrono::seconds kAdoptedProcessPollInterval(1);
+const std::size_t kMaxPendingOwnerChallenges(256);
+const std::size_t kMaxVaultsPerBatch(64);
+const std::size_t kIdentityStoreThreadCount(2);
+const std::size_t kMaxMessagesAwaitingValidation(16);
+const std::size_t kMaxOutstandingSessionTickets(65536);
+const std::size_t kMaxLogMessageSize(64 * 1024);
 
 }  // namespace vault_manager
 
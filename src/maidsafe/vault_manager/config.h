@@ -20,6 +20,7 @@
 #define MAIDSAFE_VAULT_MANAGER_CONFIG_H_
 
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -38,17 +39,46 @@ typedef asio::steady_timer Timer;
 typedef std::shared_ptr<Timer> TimerPtr;
 
 extern const std::string kConfigFilename;
+extern const std::string kOverridesFilename;
+extern const std::string kChildrenFilename;
+extern const std::string kDiscoveryFilename;
 extern const std::string kBootstrapFilename;
 extern const std::chrono::seconds kRpcTimeout;
 extern const std::chrono::seconds kVaultStopTimeout;
+extern const std::chrono::seconds kVaultRequestTimeout;
 extern const int kMaxVaultRestarts;
+extern const std::size_t kMaxVaultEventsPerOwner;
+extern const std::size_t kMaxExpectedPendingVaultRequests;
+extern const std::size_t kMaxNewConnectionsPerSecond;
+extern const std::size_t kMaxPendingConnections;
+extern const std::size_t kMaxOutstandingChallenges;
+extern const std::size_t kCryptoThreadCount;
+extern const std::size_t kMaxQueuedCryptoJobs;
+extern const std::chrono::seconds kSessionTicketLifetime;
+extern const std::chrono::milliseconds kInitialReconnectDelay;
+extern const std::chrono::milliseconds kMaxReconnectDelay;
+extern const std::chrono::milliseconds kTimingWheelResolution;
+extern const std::size_t kVaultKeysCacheSize;
+extern const std::chrono::seconds kVaultReconnectTimeout;
+extern const std::chrono::milliseconds kAdoptionTimeout;
+extern const std::chrono::seconds kAdoptedProcessPollInterval;
+extern const std::size_t kMaxPendingOwnerChallenges;
+extern const std::size_t kMaxVaultsPerBatch;
+extern const std::size_t kIdentityStoreThreadCount;
+extern const std::size_t kMaxMessagesAwaitingValidation;
+extern const std::size_t kMaxOutstandingSessionTickets;
+extern const std::size_t kMaxLogMessageSize;
 
 DEFINE_OSTREAMABLE_ENUM_VALUES(
     MessageTag, std::uint8_t,
     (ValidateConnectionRequest)(Challenge)(ChallengeResponse)(StartVaultRequest)(
         TakeOwnershipRequest)(VaultRunningResponse)(VaultStarted)(VaultStartedResponse)(
         VaultShutdownRequest)(MaxDiskUsageUpdate)(JoinedNetwork)(LogMessage)(SetNetworkAsStable)(
-        NetworkStableRequest)(NetworkStableResponse))
+        NetworkStableRequest)(NetworkStableResponse)(SubscribeToVaultEventsRequest)(
+        VaultEventNotification)(BatchStartVaultRequest)(BatchTakeOwnershipRequest)(
+        ResumeSessionRequest)(SessionTicket)(Capabilities)(CompactMessage)(AddOwnerRequest)(
+        OwnerChallenge)(OwnerChallengeResponse)(OwnerAdded)(StartHostedVault)(StopHostedVault)(
+        HostedVaultExited))
 
 }  // namespace vault_manager
 
@@ -75,6 +75,7 @@ struct ConfigFile {
                          passport::DecryptAnpmid(encrypted_anpmid, symm_key, symm_iv)));
       if (has_owner_name)
         archive(vault.owner_name);
+      vaults.push_back(std::move(vault));
     }
   }
 
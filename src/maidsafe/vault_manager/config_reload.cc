@@ -0,0 +1,125 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/config_reload.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <sstream>
+#include <utility>
+
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace {
+
+typedef std::map<std::string, const VaultInfo*> VaultsByLabel;
+
+VaultsByLabel IndexByLabel(const std::vector<VaultInfo>& vaults) {
+  VaultsByLabel vaults_by_label;
+  for (const auto& vault : vaults)
+    vaults_by_label.emplace(vault.label.string(), &vault);
+  return vaults_by_label;
+}
+
+DiskUsage ParseDiskUsage(const std::string& value) {
+  if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos)
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+  try {
+    return DiskUsage{std::stoull(value)};
+  } catch (const std::exception&) {
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+  }
+}
+
+}  // unnamed namespace
+
+ConfigDiff DiffVaults(const std::vector<VaultInfo>& live, const std::vector<VaultInfo>& desired) {
+  ConfigDiff diff;
+  VaultsByLabel live_by_label{IndexByLabel(live)};
+  VaultsByLabel desired_by_label{IndexByLabel(desired)};
+  for (const auto& vault : desired) {
+    auto live_itr(live_by_label.find(vault.label.string()));
+    if (live_itr == std::end(live_by_label))
+      diff.added.push_back(vault);
+    else if (live_itr->second->vault_dir != vault.vault_dir)
+      diff.relocated.push_back(vault);
+    else if (live_itr->second->max_disk_usage != vault.max_disk_usage)
+      diff.resized.push_back(vault);
+  }
+  for (const auto& vault : live) {
+    if (desired_by_label.count(vault.label.string()) == 0)
+      diff.removed.push_back(vault);
+  }
+  return diff;
+}
+
+void ApplyOverrides(const std::string& contents, std::vector<VaultInfo>& vaults) {
+  std::vector<VaultInfo> overridden(vaults);
+  std::istringstream lines(contents);
+  std::string line;
+  int line_number(0);
+  while (std::getline(lines, line)) {
+    ++line_number;
+    line = line.substr(0, line.find('#'));
+    std::istringstream fields(line);
+    std::string label, field;
+    if (!(fields >> label))
+      continue;
+    auto vault_itr(std::find_if(
+        std::begin(overridden), std::end(overridden),
+        [&label](const VaultInfo& vault) { return vault.label.string() == label; }));
+    bool has_override(false);
+    while (fields >> field) {
+      has_override = true;
+      auto separator(field.find('='));
+      std::string key(field.substr(0, separator)),
+          value(separator == std::string::npos ? std::string() : field.substr(separator + 1));
+      if (separator == std::string::npos || value.empty() ||
+          (key != "max_disk_usage" && key != "vault_dir")) {
+        LOG(kError) << "Malformed override on line " << line_number << ": " << field;
+        BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+      }
+      if (key == "max_disk_usage") {
+        DiskUsage max_disk_usage{ParseDiskUsage(value)};
+        if (vault_itr != std::end(overridden))
+          vault_itr->max_disk_usage = max_disk_usage;
+      } else if (vault_itr != std::end(overridden)) {
+        vault_itr->vault_dir = boost::filesystem::path(value);
+      }
+    }
+    if (!has_override) {
+      LOG(kError) << "No overrides given for vault " << label << " on line " << line_number;
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+    }
+    if (vault_itr == std::end(overridden))
+      LOG(kWarning) << "Ignoring overrides for unknown vault " << label;
+  }
+  vaults.swap(overridden);
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
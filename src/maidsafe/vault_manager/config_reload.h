@@ -0,0 +1,57 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_CONFIG_RELOAD_H_
+#define MAIDSAFE_VAULT_MANAGER_CONFIG_RELOAD_H_
+
+#include <string>
+#include <vector>
+
+#include "maidsafe/vault_manager/vault_info.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// The changes needed to take the live set of vaults to the desired set, matching vaults by label.
+// A vault whose 'vault_dir' has changed is only listed in 'relocated', even if its
+// 'max_disk_usage' has also changed, since it's restarted with the desired values anyway.
+struct ConfigDiff {
+  bool Empty() const {
+    return added.empty() && removed.empty() && relocated.empty() && resized.empty();
+  }
+
+  std::vector<VaultInfo> added;      // Desired but not live.
+  std::vector<VaultInfo> removed;    // Live but not desired.
+  std::vector<VaultInfo> relocated;  // Desired values of vaults with a different 'vault_dir'.
+  std::vector<VaultInfo> resized;    // Desired values of vaults with a different 'max_disk_usage'.
+};
+
+ConfigDiff DiffVaults(const std::vector<VaultInfo>& live, const std::vector<VaultInfo>& desired);
+
+// Applies the operator's overrides in 'contents' to 'vaults'.  Each non-blank line is a vault label
+// followed by one or more of "max_disk_usage=<bytes>" and "vault_dir=<path>"; '#' starts a comment.
+// Overrides naming an unknown label are logged and ignored.  Throws CommonErrors::parsing_error
+// without modifying 'vaults' if any line is malformed.
+void ApplyOverrides(const std::string& contents, std::vector<VaultInfo>& vaults);
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_CONFIG_RELOAD_H_
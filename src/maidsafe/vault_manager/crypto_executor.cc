@@ -0,0 +1,38 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/crypto_executor.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+CryptoExecutor::CryptoExecutor(asio::io_service::strand& origin_strand, std::size_t thread_count,
+                               std::size_t max_queued_jobs)
+    : origin_strand_(origin_strand),
+      kThreadCount_(std::max(thread_count, std::size_t(1))),
+      kMaxQueuedJobs_(max_queued_jobs),
+      queued_jobs_(0),
+      asio_service_(static_cast<uint32_t>(kThreadCount_)) {}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,86 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_CRYPTO_EXECUTOR_H_
+#define MAIDSAFE_VAULT_MANAGER_CRYPTO_EXECUTOR_H_
+
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <utility>
+
+#include "asio/io_service_strand.hpp"
+
+#include "maidsafe/common/asio_service.h"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// A bounded pool of worker threads for CPU-heavy crypto work (checking signatures and encrypting
+// keys in outgoing messages), keeping it off the VaultManager's single I/O thread.  The result of
+// each job is passed back on the strand given at construction.
+class CryptoExecutor {
+ public:
+  CryptoExecutor(asio::io_service::strand& origin_strand, std::size_t thread_count,
+                 std::size_t max_queued_jobs = kMaxQueuedCryptoJobs);
+  CryptoExecutor(const CryptoExecutor&) = delete;
+  CryptoExecutor(CryptoExecutor&&) = delete;
+  CryptoExecutor& operator=(CryptoExecutor) = delete;
+
+  // Runs 'work' on a worker thread, then invokes 'on_done' on the origin strand with a future
+  // holding the result (or exception) of 'work'.  If 'max_queued_jobs' are already outstanding,
+  // returns false and does nothing.
+  template <typename Work, typename OnDone>
+  bool Post(Work work, OnDone on_done);
+
+  std::size_t ThreadCount() const { return kThreadCount_; }
+
+ private:
+  asio::io_service::strand& origin_strand_;
+  const std::size_t kThreadCount_, kMaxQueuedJobs_;
+  std::atomic<std::size_t> queued_jobs_;
+  // Must be last member so that the workers are joined before anything they use is destroyed.
+  AsioService asio_service_;
+};
+
+template <typename Work, typename OnDone>
+bool CryptoExecutor::Post(Work work, OnDone on_done) {
+  typedef decltype(work()) Result;
+  if (++queued_jobs_ > kMaxQueuedJobs_) {
+    --queued_jobs_;
+    return false;
+  }
+  auto task(std::make_shared<std::packaged_task<Result()>>(std::move(work)));
+  asio_service_.service().post([this, task, on_done]() {
+    (*task)();
+    --queued_jobs_;
+    auto result(std::make_shared<std::future<Result>>(task->get_future()));
+    origin_strand_.post([result, on_done]() mutable { on_done(std::move(*result)); });
+  });
+  return true;
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_CRYPTO_EXECUTOR_H_
@@ -0,0 +1,70 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/discovery_file.h"
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+void WriteDiscoveryFile(const fs::path& path, const DiscoveryRecord& record) {
+  // The temporary name is unique per instance, so two VaultManagers starting together can't
+  // interleave their writes.
+  fs::path temp_path(path.string() + "." + record.instance_id + ".tmp");
+  if (!WriteFile(temp_path, ConvertToString(record))) {
+    LOG(kError) << "Failed to write discovery file " << temp_path;
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  }
+  fs::rename(temp_path, path);
+}
+
+boost::optional<DiscoveryRecord> ReadDiscoveryFile(const fs::path& path) {
+  boost::system::error_code error_code;
+  if (!fs::exists(path, error_code))
+    return boost::none;
+  try {
+    return ConvertFromString<DiscoveryRecord>(ReadFile(path).string());
+  } catch (const std::exception& e) {
+    LOG(kWarning) << "Failed to read discovery file " << path << ": "
+                  << boost::diagnostic_information(e);
+    return boost::none;
+  }
+}
+
+void RemoveDiscoveryFile(const fs::path& path, const std::string& instance_id) {
+  auto record(ReadDiscoveryFile(path));
+  if (!record || record->instance_id != instance_id)
+    return;
+  boost::system::error_code error_code;
+  fs::remove(path, error_code);
+  if (error_code)
+    LOG(kWarning) << "Failed to remove discovery file " << path << ": " << error_code.message();
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,67 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_DISCOVERY_FILE_H_
+#define MAIDSAFE_VAULT_MANAGER_DISCOVERY_FILE_H_
+
+#include <string>
+#include <utility>
+
+#include "boost/filesystem/path.hpp"
+#include "boost/optional/optional.hpp"
+
+#include "maidsafe/common/process.h"
+#include "maidsafe/common/tcp/connection.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Published by a running VaultManager so that clients can connect to it directly rather than
+// probing each port in the range above the default one.  'instance_id' is random per VaultManager
+// instance, so a stale file can be told apart from the current one.
+struct DiscoveryRecord {
+  DiscoveryRecord() : port(0), instance_id(), process_id(0) {}
+  DiscoveryRecord(tcp::Port port_in, std::string instance_id_in,
+                  process::ProcessId process_id_in)
+      : port(port_in), instance_id(std::move(instance_id_in)), process_id(process_id_in) {}
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(port, instance_id, process_id);
+  }
+
+  tcp::Port port;
+  std::string instance_id;
+  process::ProcessId process_id;
+};
+
+// Atomically replaces the file at 'path', so that readers never see a partially-written record.
+void WriteDiscoveryFile(const boost::filesystem::path& path, const DiscoveryRecord& record);
+
+// Returns an empty optional if the file doesn't exist or can't be parsed.
+boost::optional<DiscoveryRecord> ReadDiscoveryFile(const boost::filesystem::path& path);
+
+// Removes the file at 'path' only if it still holds the record for 'instance_id'.  Doesn't throw.
+void RemoveDiscoveryFile(const boost::filesystem::path& path, const std::string& instance_id);
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_DISCOVERY_FILE_H_
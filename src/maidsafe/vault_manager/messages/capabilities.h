@@ -0,0 +1,76 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_CAPABILITIES_H_
+#define MAIDSAFE_VAULT_MANAGER_MESSAGES_CAPABILITIES_H_
+
+#include <cstdint>
+#include <string>
+
+#include "maidsafe/common/config.h"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Client or Vault to VaultManager as soon as the connection is made, and VaultManager to Client or
+// Vault in reply.  Lists the optional protocol features which the sender can handle.  A feature is
+// only used on a connection once the receiving side has advertised it.  Peers which predate this
+// message ignore it and never advertise anything, so they are never sent a feature they can't
+// parse.  The VaultManager's reply also carries its 'instance_id' (see discovery_file.h), so that a
+// client can tell whether it has reached the VaultManager which published the discovery file.
+struct Capabilities {
+  static const MessageTag tag = MessageTag::kCapabilities;
+
+  enum Flags : uint32_t {
+    // Small fixed-size messages can be sent in their compact layout (see compact_message.h).
+    kCompactMessages = 1 << 0,
+    kAll = kCompactMessages
+  };
+
+  Capabilities() : flags(0), instance_id() {}
+  Capabilities(const Capabilities&) = delete;
+  Capabilities(Capabilities&& other) MAIDSAFE_NOEXCEPT
+      : flags(other.flags),
+        instance_id(std::move(other.instance_id)) {}
+  explicit Capabilities(uint32_t flags_in, std::string instance_id_in = std::string())
+      : flags(flags_in), instance_id(std::move(instance_id_in)) {}
+  ~Capabilities() = default;
+  Capabilities& operator=(const Capabilities&) = delete;
+  Capabilities& operator=(Capabilities&& other) MAIDSAFE_NOEXCEPT {
+    flags = other.flags;
+    instance_id = std::move(other.instance_id);
+    return *this;
+  };
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(flags, instance_id);
+  }
+
+  uint32_t flags;
+  std::string instance_id;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_MESSAGES_CAPABILITIES_H_
@@ -0,0 +1,64 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_HOSTED_VAULT_EXITED_H_
+#define MAIDSAFE_VAULT_MANAGER_MESSAGES_HOSTED_VAULT_EXITED_H_
+
+#include <cstdint>
+
+#include "maidsafe/common/config.h"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Vault host to VaultManager
+struct HostedVaultExited {
+  static const MessageTag tag = MessageTag::kHostedVaultExited;
+
+  HostedVaultExited() = default;
+  HostedVaultExited(const HostedVaultExited&) = delete;
+  HostedVaultExited(HostedVaultExited&& other) MAIDSAFE_NOEXCEPT
+      : vault_id(std::move(other.vault_id)),
+        exit_code(std::move(other.exit_code)) {}
+  HostedVaultExited(uint64_t vault_id_in, int32_t exit_code_in)
+      : vault_id(vault_id_in), exit_code(exit_code_in) {}
+  ~HostedVaultExited() = default;
+  HostedVaultExited& operator=(const HostedVaultExited&) = delete;
+  HostedVaultExited& operator=(HostedVaultExited&& other) MAIDSAFE_NOEXCEPT {
+    vault_id = std::move(other.vault_id);
+    exit_code = std::move(other.exit_code);
+    return *this;
+  };
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(vault_id, exit_code);
+  }
+
+  uint64_t vault_id;
+  int32_t exit_code;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_MESSAGES_HOSTED_VAULT_EXITED_H_
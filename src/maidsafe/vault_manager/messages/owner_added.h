@@ -0,0 +1,69 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_OWNER_ADDED_H_
+#define MAIDSAFE_VAULT_MANAGER_MESSAGES_OWNER_ADDED_H_
+
+#include <cstdint>
+
+#include "boost/optional.hpp"
+#include "cereal/types/boost_optional.hpp"
+
+#include "maidsafe/common/config.h"
+#include "maidsafe/common/error.h"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// VaultManager to Client, completing an AddOwnerRequest.  Once received without an error, requests
+// on the connection may name the added Maid as their acting owner.
+struct OwnerAdded {
+  static const MessageTag tag = MessageTag::kOwnerAdded;
+
+  OwnerAdded() : request_id(0), error() {}
+  OwnerAdded(const OwnerAdded&) = delete;
+  OwnerAdded(OwnerAdded&& other) MAIDSAFE_NOEXCEPT : request_id(other.request_id),
+                                                     error(std::move(other.error)) {}
+  explicit OwnerAdded(uint64_t request_id_in) : request_id(request_id_in), error() {}
+  OwnerAdded(uint64_t request_id_in, maidsafe_error error_in)
+      : request_id(request_id_in), error(std::move(error_in)) {}
+  ~OwnerAdded() = default;
+  OwnerAdded& operator=(const OwnerAdded&) = delete;
+  OwnerAdded& operator=(OwnerAdded&& other) MAIDSAFE_NOEXCEPT {
+    request_id = other.request_id;
+    error = std::move(other.error);
+    return *this;
+  };
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(request_id, error);
+  }
+
+  uint64_t request_id;
+  boost::optional<maidsafe_error> error;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_MESSAGES_OWNER_ADDED_H_
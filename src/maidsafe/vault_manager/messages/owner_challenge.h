@@ -0,0 +1,65 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_OWNER_CHALLENGE_H_
+#define MAIDSAFE_VAULT_MANAGER_MESSAGES_OWNER_CHALLENGE_H_
+
+#include <cstdint>
+
+#include "maidsafe/common/config.h"
+#include "maidsafe/common/rsa.h"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// VaultManager to Client, in reply to an AddOwnerRequest.
+struct OwnerChallenge {
+  static const MessageTag tag = MessageTag::kOwnerChallenge;
+
+  OwnerChallenge() : request_id(0), plaintext() {}
+  OwnerChallenge(const OwnerChallenge&) = delete;
+  OwnerChallenge(OwnerChallenge&& other) MAIDSAFE_NOEXCEPT
+      : request_id(other.request_id),
+        plaintext(std::move(other.plaintext)) {}
+  OwnerChallenge(uint64_t request_id_in, asymm::PlainText plaintext_in)
+      : request_id(request_id_in), plaintext(std::move(plaintext_in)) {}
+  ~OwnerChallenge() = default;
+  OwnerChallenge& operator=(const OwnerChallenge&) = delete;
+  OwnerChallenge& operator=(OwnerChallenge&& other) MAIDSAFE_NOEXCEPT {
+    request_id = other.request_id;
+    plaintext = std::move(other.plaintext);
+    return *this;
+  };
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(request_id, plaintext);
+  }
+
+  uint64_t request_id;
+  asymm::PlainText plaintext;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_MESSAGES_OWNER_CHALLENGE_H_
@@ -0,0 +1,70 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_START_HOSTED_VAULT_H_
+#define MAIDSAFE_VAULT_MANAGER_MESSAGES_START_HOSTED_VAULT_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "cereal/types/string.hpp"
+#include "cereal/types/vector.hpp"
+
+#include "maidsafe/common/config.h"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// VaultManager to vault host.  'args' is the command line the vault would have been given had it
+// been started as a process of its own.
+struct StartHostedVault {
+  static const MessageTag tag = MessageTag::kStartHostedVault;
+
+  StartHostedVault() = default;
+  StartHostedVault(const StartHostedVault&) = delete;
+  StartHostedVault(StartHostedVault&& other) MAIDSAFE_NOEXCEPT
+      : vault_id(std::move(other.vault_id)),
+        args(std::move(other.args)) {}
+  StartHostedVault(uint64_t vault_id_in, std::vector<std::string> args_in)
+      : vault_id(vault_id_in), args(std::move(args_in)) {}
+  ~StartHostedVault() = default;
+  StartHostedVault& operator=(const StartHostedVault&) = delete;
+  StartHostedVault& operator=(StartHostedVault&& other) MAIDSAFE_NOEXCEPT {
+    vault_id = std::move(other.vault_id);
+    args = std::move(other.args);
+    return *this;
+  };
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(vault_id, args);
+  }
+
+  uint64_t vault_id;
+  std::vector<std::string> args;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_MESSAGES_START_HOSTED_VAULT_H_
@@ -19,6 +19,7 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_START_VAULT_REQUEST_H_
 #define MAIDSAFE_VAULT_MANAGER_MESSAGES_START_VAULT_REQUEST_H_
 
+#include <cstdint>
 #include <string>
 
 #include "boost/filesystem/path.hpp"
@@ -27,6 +28,7 @@
 
 #include "maidsafe/common/config.h"
 #include "maidsafe/common/types.h"
+#include "maidsafe/passport/types.h"
 
 #include "maidsafe/vault_manager/config.h"
 
@@ -44,6 +46,7 @@ struct StartVaultRequest {
 
   StartVaultRequest(StartVaultRequest&& other) MAIDSAFE_NOEXCEPT
       : vault_label(std::move(other.vault_label)),
+        request_id(std::move(other.request_id)),
         vault_dir(std::move(other.vault_dir)),
 #ifdef USE_VLOGGING
         vlog_session_id(std::move(other.vlog_session_id)),
@@ -54,12 +57,14 @@ struct StartVaultRequest {
 #ifdef TESTING
         pmid_list_index(std::move(other.pmid_list_index)),
 #endif
-        max_disk_usage(std::move(other.max_disk_usage)) {
+        max_disk_usage(std::move(other.max_disk_usage)),
+        owner(std::move(other.owner)) {
   }
 
-  StartVaultRequest(NonEmptyString vault_label_in, boost::filesystem::path vault_dir_in,
-                    DiskUsage max_disk_usage_in)
+  StartVaultRequest(NonEmptyString vault_label_in, uint64_t request_id_in,
+                    boost::filesystem::path vault_dir_in, DiskUsage max_disk_usage_in)
       : vault_label(std::move(vault_label_in)),
+        request_id(request_id_in),
         vault_dir(std::move(vault_dir_in)),
 #ifdef USE_VLOGGING
         vlog_session_id(),
@@ -70,7 +75,8 @@ struct StartVaultRequest {
 #ifdef TESTING
         pmid_list_index(),
 #endif
-        max_disk_usage(std::move(max_disk_usage_in)) {
+        max_disk_usage(std::move(max_disk_usage_in)),
+        owner() {
   }
 
   ~StartVaultRequest() = default;
@@ -79,6 +85,7 @@ struct StartVaultRequest {
 
   StartVaultRequest& operator=(StartVaultRequest&& other) MAIDSAFE_NOEXCEPT {
     vault_label = std::move(other.vault_label);
+    request_id = std::move(other.request_id);
     vault_dir = std::move(other.vault_dir);
 #ifdef USE_VLOGGING
     vlog_session_id = std::move(other.vlog_session_id);
@@ -90,12 +97,13 @@ struct StartVaultRequest {
     pmid_list_index = std::move(other.pmid_list_index);
 #endif
     max_disk_usage = std::move(other.max_disk_usage);
+    owner = std::move(other.owner);
     return *this;
   };
 
   template <typename Archive>
   void serialize(Archive& archive) {
-    archive(vault_label, vault_dir, max_disk_usage);
+    archive(vault_label, request_id, vault_dir, max_disk_usage, owner);
 #ifdef USE_VLOGGING
     archive(vlog_session_id);
 #endif
@@ -108,6 +116,7 @@ struct StartVaultRequest {
   }
 
   NonEmptyString vault_label;
+  uint64_t request_id;
   boost::filesystem::path vault_dir;
 #ifdef USE_VLOGGING
   std::string vlog_session_id;
@@ -119,6 +128,8 @@ struct StartVaultRequest {
   boost::optional<int> pmid_list_index;
 #endif
   DiskUsage max_disk_usage;
+  // The acting owner, if not the Maid which validated the connection (see AddOwnerRequest).
+  boost::optional<passport::PublicMaid::Name> owner;
 };
 
 }  // namespace vault_manager
@@ -0,0 +1,62 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_SUBSCRIBE_TO_VAULT_EVENTS_REQUEST_H_
+#define MAIDSAFE_VAULT_MANAGER_MESSAGES_SUBSCRIBE_TO_VAULT_EVENTS_REQUEST_H_
+
+#include <cstdint>
+
+#include "maidsafe/common/config.h"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Client to VaultManager
+struct SubscribeToVaultEventsRequest {
+  static const MessageTag tag = MessageTag::kSubscribeToVaultEventsRequest;
+
+  SubscribeToVaultEventsRequest() = default;
+  SubscribeToVaultEventsRequest(const SubscribeToVaultEventsRequest&) = delete;
+  SubscribeToVaultEventsRequest(SubscribeToVaultEventsRequest&& other) MAIDSAFE_NOEXCEPT
+      : last_sequence_number(std::move(other.last_sequence_number)) {}
+  explicit SubscribeToVaultEventsRequest(uint64_t last_sequence_number_in)
+      : last_sequence_number(last_sequence_number_in) {}
+  ~SubscribeToVaultEventsRequest() = default;
+  SubscribeToVaultEventsRequest& operator=(const SubscribeToVaultEventsRequest&) = delete;
+  SubscribeToVaultEventsRequest& operator=(SubscribeToVaultEventsRequest&& other)
+      MAIDSAFE_NOEXCEPT {
+    last_sequence_number = std::move(other.last_sequence_number);
+    return *this;
+  };
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(last_sequence_number);
+  }
+
+  uint64_t last_sequence_number;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_MESSAGES_SUBSCRIBE_TO_VAULT_EVENTS_REQUEST_H_
@@ -19,11 +19,16 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_TAKE_OWNERSHIP_REQUEST_H_
 #define MAIDSAFE_VAULT_MANAGER_MESSAGES_TAKE_OWNERSHIP_REQUEST_H_
 
+#include <cstdint>
+
 #include "boost/filesystem/path.hpp"
+#include "boost/optional.hpp"
+#include "cereal/types/boost_optional.hpp"
 
 #include "maidsafe/common/config.h"
 #include "maidsafe/common/types.h"
 #include "maidsafe/common/serialisation/types/boost_filesystem.h"
+#include "maidsafe/passport/types.h"
 
 #include "maidsafe/vault_manager/config.h"
 
@@ -41,14 +46,18 @@ struct TakeOwnershipRequest {
 
   TakeOwnershipRequest(TakeOwnershipRequest&& other) MAIDSAFE_NOEXCEPT
       : vault_label(std::move(other.vault_label)),
+        request_id(std::move(other.request_id)),
         vault_dir(std::move(other.vault_dir)),
-        max_disk_usage(std::move(other.max_disk_usage)) {}
+        max_disk_usage(std::move(other.max_disk_usage)),
+        owner(std::move(other.owner)) {}
 
-  TakeOwnershipRequest(NonEmptyString vault_label_in, boost::filesystem::path vault_dir_in,
-                       DiskUsage max_disk_usage_in)
+  TakeOwnershipRequest(NonEmptyString vault_label_in, uint64_t request_id_in,
+                       boost::filesystem::path vault_dir_in, DiskUsage max_disk_usage_in)
       : vault_label(std::move(vault_label_in)),
+        request_id(request_id_in),
         vault_dir(std::move(vault_dir_in)),
-        max_disk_usage(std::move(max_disk_usage_in)) {}
+        max_disk_usage(std::move(max_disk_usage_in)),
+        owner() {}
 
   ~TakeOwnershipRequest() = default;
 
@@ -56,19 +65,24 @@ struct TakeOwnershipRequest {
 
   TakeOwnershipRequest& operator=(TakeOwnershipRequest&& other) MAIDSAFE_NOEXCEPT {
     vault_label = std::move(other.vault_label);
+    request_id = std::move(other.request_id);
     vault_dir = std::move(other.vault_dir);
     max_disk_usage = std::move(other.max_disk_usage);
+    owner = std::move(other.owner);
     return *this;
   };
 
   template <typename Archive>
   void serialize(Archive& archive) {
-    archive(vault_label, vault_dir, max_disk_usage);
+    archive(vault_label, request_id, vault_dir, max_disk_usage, owner);
   }
 
   NonEmptyString vault_label;
+  uint64_t request_id;
   boost::filesystem::path vault_dir;
   DiskUsage max_disk_usage;
+  // The acting owner, if not the Maid which validated the connection (see AddOwnerRequest).
+  boost::optional<passport::PublicMaid::Name> owner;
 };
 
 }  // namespace vault_manager
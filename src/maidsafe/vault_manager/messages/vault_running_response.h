@@ -19,6 +19,7 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_VAULT_RUNNING_RESPONSE_H_
 #define MAIDSAFE_VAULT_MANAGER_MESSAGES_VAULT_RUNNING_RESPONSE_H_
 
+#include <cstdint>
 #include <memory>
 
 #include "boost/optional.hpp"
@@ -43,6 +44,23 @@ struct VaultRunningResponse {
   static const MessageTag tag = MessageTag::kVaultRunningResponse;
 
   struct VaultKeys {
+    // The keys as sent, encrypted under a one-off key.  Encrypting is the costly part of a
+    // response, so the VaultManager caches this per vault (see VaultKeysCache) and reuses it until
+    // the vault's identity changes.
+    struct Encrypted {
+      explicit Encrypted(const passport::PmidAndSigner& pmid_and_signer)
+          : symm_key(RandomString(crypto::AES256_KeySize)),
+            symm_iv(RandomString(crypto::AES256_IVSize)),
+            encrypted_anpmid(passport::EncryptAnpmid(pmid_and_signer.second, symm_key, symm_iv)),
+            encrypted_pmid(passport::EncryptPmid(pmid_and_signer.first, symm_key, symm_iv)),
+            pmid_name(pmid_and_signer.first.name()) {}
+
+      const crypto::AES256Key symm_key;
+      const crypto::AES256InitialisationVector symm_iv;
+      const crypto::CipherText encrypted_anpmid, encrypted_pmid;
+      const passport::Pmid::Name pmid_name;
+    };
+
     VaultKeys() = default;
 
     VaultKeys(const VaultKeys&) = default;
@@ -50,13 +68,18 @@ struct VaultRunningResponse {
     VaultKeys(VaultKeys&& other) MAIDSAFE_NOEXCEPT
         : symm_key(std::move(other.symm_key)),
           symm_iv(std::move(other.symm_iv)),
-          pmid_and_signer(std::move(other.pmid_and_signer)) {}
+          pmid_and_signer(std::move(other.pmid_and_signer)),
+          encrypted(std::move(other.encrypted)) {}
 
     explicit VaultKeys(passport::PmidAndSigner pmid_and_signer_in)
         : symm_key(RandomString(crypto::AES256_KeySize)),
           symm_iv(RandomString(crypto::AES256_IVSize)),
           pmid_and_signer(
-              std::make_shared<passport::PmidAndSigner>(std::move(pmid_and_signer_in))) {}
+              std::make_shared<passport::PmidAndSigner>(std::move(pmid_and_signer_in))),
+          encrypted() {}
+
+    explicit VaultKeys(std::shared_ptr<const Encrypted> encrypted_in)
+        : symm_key(), symm_iv(), pmid_and_signer(), encrypted(std::move(encrypted_in)) {}
 
     ~VaultKeys() = default;
 
@@ -66,6 +89,7 @@ struct VaultRunningResponse {
       symm_key = std::move(other.symm_key);
       symm_iv = std::move(other.symm_iv);
       pmid_and_signer = std::move(other.pmid_and_signer);
+      encrypted = std::move(other.encrypted);
       return *this;
     };
 
@@ -80,34 +104,56 @@ struct VaultRunningResponse {
 
     template <typename Archive>
     void save(Archive& archive) const {
-      archive(symm_key, symm_iv,
-              passport::EncryptAnpmid(pmid_and_signer->second, symm_key, symm_iv),
-              passport::EncryptPmid(pmid_and_signer->first, symm_key, symm_iv));
+      if (encrypted) {
+        archive(encrypted->symm_key, encrypted->symm_iv, encrypted->encrypted_anpmid,
+                encrypted->encrypted_pmid);
+      } else {
+        archive(symm_key, symm_iv,
+                passport::EncryptAnpmid(pmid_and_signer->second, symm_key, symm_iv),
+                passport::EncryptPmid(pmid_and_signer->first, symm_key, symm_iv));
+      }
     }
 
     crypto::AES256Key symm_key;
     crypto::AES256InitialisationVector symm_iv;
+    // Set when loaded, or when built from the keys themselves.
     std::shared_ptr<passport::PmidAndSigner> pmid_and_signer;
+    // If set, sent in place of encrypting 'pmid_and_signer'.
+    std::shared_ptr<const Encrypted> encrypted;
   };
 
-
-
   VaultRunningResponse() = default;
 
   VaultRunningResponse(const VaultRunningResponse&) = delete;
 
   VaultRunningResponse(VaultRunningResponse&& other) MAIDSAFE_NOEXCEPT
       : vault_label(std::move(other.vault_label)),
+        request_id(std::move(other.request_id)),
         vault_keys(std::move(other.vault_keys)),
         error(std::move(other.error)) {
     ValidateOptions();
   }
 
-  VaultRunningResponse(NonEmptyString vault_label_in, passport::PmidAndSigner pmid_and_signer)
-      : vault_label(std::move(vault_label_in)), vault_keys(std::move(pmid_and_signer)), error() {}
-
-  VaultRunningResponse(NonEmptyString vault_label_in, maidsafe_error error_in)
-      : vault_label(std::move(vault_label_in)), vault_keys(), error(std::move(error_in)) {}
+  VaultRunningResponse(NonEmptyString vault_label_in, uint64_t request_id_in,
+                       passport::PmidAndSigner pmid_and_signer)
+      : vault_label(std::move(vault_label_in)),
+        request_id(request_id_in),
+        vault_keys(std::move(pmid_and_signer)),
+        error() {}
+
+  VaultRunningResponse(NonEmptyString vault_label_in, uint64_t request_id_in,
+                       std::shared_ptr<const VaultKeys::Encrypted> encrypted_keys)
+      : vault_label(std::move(vault_label_in)),
+        request_id(request_id_in),
+        vault_keys(VaultKeys(std::move(encrypted_keys))),
+        error() {}
+
+  VaultRunningResponse(NonEmptyString vault_label_in, uint64_t request_id_in,
+                       maidsafe_error error_in)
+      : vault_label(std::move(vault_label_in)),
+        request_id(request_id_in),
+        vault_keys(),
+        error(std::move(error_in)) {}
 
   ~VaultRunningResponse() = default;
 
@@ -115,6 +161,7 @@ struct VaultRunningResponse {
 
   VaultRunningResponse& operator=(VaultRunningResponse&& other) MAIDSAFE_NOEXCEPT {
     vault_label = std::move(other.vault_label);
+    request_id = std::move(other.request_id);
     vault_keys = std::move(other.vault_keys);
     error = std::move(other.error);
     ValidateOptions();
@@ -130,17 +177,19 @@ struct VaultRunningResponse {
 
   template <typename Archive>
   void load(Archive& archive) {
-    archive(vault_label, vault_keys, error);
+    archive(vault_label, request_id, vault_keys, error);
     ValidateOptions();
   }
 
   template <typename Archive>
   void save(Archive& archive) const {
     ValidateOptions();
-    archive(vault_label, vault_keys, error);
+    archive(vault_label, request_id, vault_keys, error);
   }
 
   NonEmptyString vault_label;
+  // Echoes the id of the request being answered, or is 0 if unsolicited (e.g. after a restart).
+  uint64_t request_id;
   boost::optional<VaultKeys> vault_keys;
   boost::optional<maidsafe_error> error;
 };
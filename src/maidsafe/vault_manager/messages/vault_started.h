@@ -19,6 +19,9 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_VAULT_STARTED_H_
 #define MAIDSAFE_VAULT_MANAGER_MESSAGES_VAULT_STARTED_H_
 
+#include <string>
+#include <utility>
+
 #include "maidsafe/common/config.h"
 #include "maidsafe/common/process.h"
 
@@ -34,21 +37,29 @@ struct VaultStarted {
 
   VaultStarted() = default;
   VaultStarted(const VaultStarted&) = delete;
-  VaultStarted(VaultStarted&& other) MAIDSAFE_NOEXCEPT : process_id(std::move(other.process_id)) {}
-  explicit VaultStarted(process::ProcessId process_id_in) : process_id(process_id_in) {}
+  VaultStarted(VaultStarted&& other) MAIDSAFE_NOEXCEPT
+      : process_id(std::move(other.process_id)),
+        adoption_token(std::move(other.adoption_token)) {}
+  explicit VaultStarted(process::ProcessId process_id_in,
+                        std::string adoption_token_in = std::string())
+      : process_id(process_id_in), adoption_token(std::move(adoption_token_in)) {}
   ~VaultStarted() = default;
   VaultStarted& operator=(const VaultStarted&) = delete;
   VaultStarted& operator=(VaultStarted&& other) MAIDSAFE_NOEXCEPT {
     process_id = std::move(other.process_id);
+    adoption_token = std::move(other.adoption_token);
     return *this;
   };
 
   template <typename Archive>
   void serialize(Archive& archive) {
-    archive(process_id);
+    archive(process_id, adoption_token);
   }
 
   process::ProcessId process_id;
+  // Empty when the vault first starts.  A vault reconnecting after losing its VaultManager sends
+  // the token it was given in the VaultStartedResponse, and isn't sent another.
+  std::string adoption_token;
 };
 
 }  // namespace vault_manager
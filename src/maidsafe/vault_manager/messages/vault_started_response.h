@@ -19,6 +19,8 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_VAULT_STARTED_RESPONSE_H_
 #define MAIDSAFE_VAULT_MANAGER_MESSAGES_VAULT_STARTED_RESPONSE_H_
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -33,12 +35,36 @@
 
 #include "maidsafe/vault_manager/config.h"
 #include "maidsafe/vault_manager/utils.h"
+#include "maidsafe/vault_manager/vault_config.h"
 #include "maidsafe/vault_manager/vault_info.h"
 
 namespace maidsafe {
 
 namespace vault_manager {
 
+#ifdef TESTING
+template <typename Archive>
+void save(Archive& archive, const VaultConfig::BehaviourProfile& profile) {
+  archive(static_cast<int64_t>(profile.startup_delay_min.count()),
+          static_cast<int64_t>(profile.startup_delay_max.count()), profile.resident_bytes,
+          profile.log_lines_per_second, profile.crash_probability_per_minute,
+          static_cast<int64_t>(profile.shutdown_delay.count()),
+          static_cast<int64_t>(profile.joined_network_delay.count()));
+}
+
+template <typename Archive>
+void load(Archive& archive, VaultConfig::BehaviourProfile& profile) {
+  int64_t startup_delay_min, startup_delay_max, shutdown_delay, joined_network_delay;
+  archive(startup_delay_min, startup_delay_max, profile.resident_bytes,
+          profile.log_lines_per_second, profile.crash_probability_per_minute, shutdown_delay,
+          joined_network_delay);
+  profile.startup_delay_min = std::chrono::milliseconds(startup_delay_min);
+  profile.startup_delay_max = std::chrono::milliseconds(startup_delay_max);
+  profile.shutdown_delay = std::chrono::milliseconds(shutdown_delay);
+  profile.joined_network_delay = std::chrono::milliseconds(joined_network_delay);
+}
+#endif
+
 // VaultManager to Vault
 struct VaultStartedResponse {
   static const MessageTag tag = MessageTag::kVaultStartedResponse;
@@ -59,9 +85,12 @@ struct VaultStartedResponse {
         send_hostname_to_visualiser_server(std::move(other.send_hostname_to_visualiser_server)),
 #endif
 #ifdef TESTING
-        public_pmids(std::move(other.public_pmids)),
+        public_pmid_table_path(std::move(other.public_pmid_table_path)),
+        public_pmid_table_checksum(std::move(other.public_pmid_table_checksum)),
+        behaviour_profile(std::move(other.behaviour_profile)),
 #endif
-        max_disk_usage(std::move(other.max_disk_usage)) {
+        max_disk_usage(std::move(other.max_disk_usage)),
+        adoption_token(std::move(other.adoption_token)) {
   }
 
   VaultStartedResponse(const VaultInfo& vault_info, crypto::AES256Key symm_key_in,
@@ -77,9 +106,12 @@ struct VaultStartedResponse {
         send_hostname_to_visualiser_server(vault_info.send_hostname_to_visualiser_server),
 #endif
 #ifdef TESTING
-        public_pmids(GetPublicPmids()),
+        public_pmid_table_path(GetPublicPmidTablePath()),
+        public_pmid_table_checksum(GetPublicPmidTableChecksum()),
+        behaviour_profile(GetBehaviourProfile()),
 #endif
-        max_disk_usage(vault_info.max_disk_usage) {
+        max_disk_usage(vault_info.max_disk_usage),
+        adoption_token(vault_info.adoption_token) {
   }
 
   ~VaultStartedResponse() = default;
@@ -98,9 +130,12 @@ struct VaultStartedResponse {
     send_hostname_to_visualiser_server = std::move(other.send_hostname_to_visualiser_server);
 #endif
 #ifdef TESTING
-    public_pmids = std::move(other.public_pmids);
+    public_pmid_table_path = std::move(other.public_pmid_table_path);
+    public_pmid_table_checksum = std::move(other.public_pmid_table_checksum);
+    behaviour_profile = std::move(other.behaviour_profile);
 #endif
     max_disk_usage = std::move(other.max_disk_usage);
+    adoption_token = std::move(other.adoption_token);
     return *this;
   };
 
@@ -117,16 +152,9 @@ struct VaultStartedResponse {
     archive(send_hostname_to_visualiser_server);
 #endif
 #ifdef TESTING
-    std::size_t public_pmid_count(0);
-    archive(public_pmid_count);
-    for (std::size_t i(0); i < public_pmid_count; ++i) {
-      passport::PublicPmid::Name public_pmid_name;
-      passport::PublicPmid::serialised_type serialised_public_pmid;
-      archive(public_pmid_name, serialised_public_pmid);
-      public_pmids.emplace_back(std::move(public_pmid_name), std::move(serialised_public_pmid));
-    }
-#endif
-    archive(max_disk_usage);
+    archive(public_pmid_table_path, public_pmid_table_checksum, behaviour_profile);
+#endif
+    archive(max_disk_usage, adoption_token);
   }
 
   template <typename Archive>
@@ -139,11 +167,9 @@ struct VaultStartedResponse {
     archive(send_hostname_to_visualiser_server);
 #endif
 #ifdef TESTING
-    archive(public_pmids.size());
-    for (const auto& public_pmid : public_pmids)
-      archive(public_pmid.name(), public_pmid.Serialise());
+    archive(public_pmid_table_path, public_pmid_table_checksum, behaviour_profile);
 #endif
-    archive(max_disk_usage);
+    archive(max_disk_usage, adoption_token);
   }
 
   crypto::AES256Key symm_key;
@@ -157,9 +183,14 @@ struct VaultStartedResponse {
   bool send_hostname_to_visualiser_server;
 #endif
 #ifdef TESTING
-  std::vector<passport::PublicPmid> public_pmids;
+  // The vault maps the table itself (see PublicPmidTable) rather than being sent every key.
+  boost::filesystem::path public_pmid_table_path;
+  std::string public_pmid_table_checksum;
+  VaultConfig::BehaviourProfile behaviour_profile;
 #endif
   DiskUsage max_disk_usage;
+  // Sent back in VaultStarted if the vault has to reconnect to a new VaultManager.
+  std::string adoption_token;
 };
 
 }  // namespace vault_manager
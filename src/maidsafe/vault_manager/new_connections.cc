@@ -18,7 +18,9 @@
 
 #include "maidsafe/vault_manager/new_connections.h"
 
+#include <algorithm>
 #include <future>
+#include <utility>
 
 #include "maidsafe/common/error.h"
 #include "maidsafe/common/log.h"
@@ -29,32 +31,54 @@ namespace maidsafe {
 
 namespace vault_manager {
 
-NewConnections::NewConnections(asio::io_service& io_service)
-    : io_service_(io_service), connections_() {}
+NewConnections::NewConnections(std::shared_ptr<TimingWheel> timing_wheel)
+    : timing_wheel_(std::move(timing_wheel)), connections_() {}
 
-std::shared_ptr<NewConnections> NewConnections::MakeShared(asio::io_service& io_service) {
-  return std::shared_ptr<NewConnections>{new NewConnections{io_service}};
+std::shared_ptr<NewConnections> NewConnections::MakeShared(
+    std::shared_ptr<TimingWheel> timing_wheel) {
+  return std::shared_ptr<NewConnections>{new NewConnections{std::move(timing_wheel)}};
 }
 
 NewConnections::~NewConnections() { assert(connections_.empty()); }
 
 void NewConnections::Add(tcp::ConnectionPtr connection) {
-  TimerPtr timer{std::make_shared<Timer>(io_service_, kRpcTimeout)};
-  timer->async_wait([connection](const std::error_code& error_code) {
-    if (!error_code || error_code != asio::error::operation_aborted) {
-      LOG(kWarning) << "Timed out waiting for new connection to identify itself.";
-      connection->Close();
-    }
-  });
-  bool result{connections_.emplace(connection, timer).second};
+  TimingWheel::TimerId timer_id{timing_wheel_->Add(kRpcTimeout, [connection] {
+    LOG(kWarning) << "Timed out waiting for new connection to identify itself.";
+    connection->Close();
+  })};
+  bool result{connections_.emplace(connection, std::make_pair(timer_id,
+                                                              std::chrono::steady_clock::now()))
+                  .second};
   assert(result);
   static_cast<void>(result);
 }
 
 bool NewConnections::Remove(tcp::ConnectionPtr connection) {
-  return connections_.erase(connection) == 1U;
+  auto itr(connections_.find(connection));
+  if (itr == std::end(connections_))
+    return false;
+  timing_wheel_->Cancel(itr->second.first);
+  connections_.erase(itr);
+  return true;
 }
 
+void NewConnections::CloseOldest() {
+  auto oldest(std::min_element(
+      std::begin(connections_), std::end(connections_),
+      [](const decltype(connections_)::value_type& lhs,
+         const decltype(connections_)::value_type& rhs) {
+        return lhs.second.second < rhs.second.second;
+      }));
+  if (oldest == std::end(connections_))
+    return;
+  tcp::ConnectionPtr connection{oldest->first};
+  timing_wheel_->Cancel(oldest->second.first);
+  connections_.erase(oldest);
+  connection->Close();
+}
+
+std::size_t NewConnections::Size() const { return connections_.size(); }
+
 void NewConnections::CloseAll() {
   for (auto connection : connections_)
     connection.first->Close();
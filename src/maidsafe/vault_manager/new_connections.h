@@ -19,14 +19,16 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_NEW_CONNECTIONS_H_
 #define MAIDSAFE_VAULT_MANAGER_NEW_CONNECTIONS_H_
 
+#include <chrono>
+#include <cstddef>
 #include <map>
 #include <memory>
-
-#include "asio/io_service.hpp"
+#include <utility>
 
 #include "maidsafe/common/types.h"
 
 #include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/timing_wheel.h"
 
 namespace maidsafe {
 
@@ -34,17 +36,22 @@ namespace vault_manager {
 
 class NewConnections : public std::enable_shared_from_this<NewConnections> {
  public:
-  static std::shared_ptr<NewConnections> MakeShared(asio::io_service& io_service);
+  static std::shared_ptr<NewConnections> MakeShared(std::shared_ptr<TimingWheel> timing_wheel);
   ~NewConnections();
   void Add(tcp::ConnectionPtr connection);
   bool Remove(tcp::ConnectionPtr connection);
+  // Removes and closes the connection which has been waiting longest to identify itself.
+  void CloseOldest();
+  std::size_t Size() const;
   void CloseAll();
 
  private:
-  explicit NewConnections(asio::io_service& io_service);
+  explicit NewConnections(std::shared_ptr<TimingWheel> timing_wheel);
 
-  asio::io_service& io_service_;
-  std::map<tcp::ConnectionPtr, TimerPtr, std::owner_less<tcp::ConnectionPtr>> connections_;
+  std::shared_ptr<TimingWheel> timing_wheel_;
+  std::map<tcp::ConnectionPtr,
+           std::pair<TimingWheel::TimerId, std::chrono::steady_clock::time_point>,
+           std::owner_less<tcp::ConnectionPtr>> connections_;
 };
 
 }  // namespace vault_manager
@@ -0,0 +1,46 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/peer_capabilities.h"
+
+#include "maidsafe/vault_manager/messages/capabilities.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+void PeerCapabilities::Set(tcp::ConnectionPtr connection, uint32_t flags) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  capabilities_[connection] = flags;
+}
+
+void PeerCapabilities::Remove(tcp::ConnectionPtr connection) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  capabilities_.erase(connection);
+}
+
+bool PeerCapabilities::CompactMessages(tcp::ConnectionPtr connection) const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  auto itr(capabilities_.find(connection));
+  return itr != std::end(capabilities_) &&
+         (itr->second & Capabilities::kCompactMessages) != 0;
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
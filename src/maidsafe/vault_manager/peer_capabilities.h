@@ -0,0 +1,56 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_PEER_CAPABILITIES_H_
+#define MAIDSAFE_VAULT_MANAGER_PEER_CAPABILITIES_H_
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+#include "maidsafe/common/tcp/connection.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// The Capabilities advertised by each of the VaultManager's peers.  A connection which hasn't
+// advertised any is assumed to support none.  Threadsafe.
+class PeerCapabilities {
+ public:
+  PeerCapabilities() : mutex_(), capabilities_() {}
+
+  PeerCapabilities(const PeerCapabilities&) = delete;
+  PeerCapabilities(PeerCapabilities&&) = delete;
+  PeerCapabilities& operator=(PeerCapabilities) = delete;
+
+  void Set(tcp::ConnectionPtr connection, uint32_t flags);
+  void Remove(tcp::ConnectionPtr connection);
+  // True if the peer has advertised Capabilities::kCompactMessages.
+  bool CompactMessages(tcp::ConnectionPtr connection) const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::unordered_map<tcp::ConnectionPtr, uint32_t> capabilities_;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_PEER_CAPABILITIES_H_
@@ -0,0 +1,274 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/process_backend.h"
+
+#include <utility>
+
+#ifdef MAIDSAFE_BSD
+extern "C" char** environ;
+#endif
+
+#ifdef MAIDSAFE_WIN32
+#include "asio/windows/object_handle.hpp"
+#else
+#include <sys/wait.h>
+
+#include "asio/signal_set.hpp"
+#endif
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4702)
+#endif
+#include "boost/process/execute.hpp"
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+#include "boost/process/child.hpp"
+#include "boost/process/initializers.hpp"
+#include "boost/process/mitigate.hpp"
+#include "boost/process/terminate.hpp"
+#include "boost/process/wait_for_exit.hpp"
+
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/on_scope_exit.h"
+#include "maidsafe/common/process.h"
+
+#include "maidsafe/vault_manager/vault_config_channel.h"
+
+namespace bp = boost::process;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace {
+
+class RealProcessBackend : public ProcessBackend {
+ public:
+  explicit RealProcessBackend(asio::io_service& io_service)
+      : io_service_(io_service),
+#ifdef MAIDSAFE_WIN32
+        children_(),
+#else
+        signal_set_(io_service, SIGCHLD),
+#endif
+        on_exit_() {
+  }
+
+  void Start(OnExitFunctor on_exit) override {
+    on_exit_ = std::move(on_exit);
+#ifndef MAIDSAFE_WIN32
+    WaitForSignal();
+#endif
+  }
+
+  void Stop() override {
+    on_exit_ = nullptr;
+#ifndef MAIDSAFE_WIN32
+    std::error_code ignored_ec;
+    signal_set_.cancel(ignored_ec);
+#endif
+  }
+
+#ifdef MAIDSAFE_WIN32
+  ProcessId Spawn(const std::vector<std::string>& args,
+                  const VaultConfigChannel* /*config_channel*/) override {
+    bp::child child{bp::execute(bp::initializers::run_exe(args.front()),
+                                bp::initializers::set_cmd_line(process::ConstructCommandLine(args)),
+                                bp::initializers::throw_on_error(),
+                                bp::initializers::inherit_env())};
+    const ProcessId process_id{static_cast<ProcessId>(child.proc_info.dwProcessId)};
+    HANDLE copied_handle;
+    DuplicateHandle(GetCurrentProcess(), child.process_handle(), GetCurrentProcess(),
+                    &copied_handle, 0, FALSE, DUPLICATE_SAME_ACCESS);
+    auto handle(std::make_shared<asio::windows::object_handle>(io_service_, copied_handle));
+    HANDLE native_handle{handle->native_handle()};
+    handle->async_wait([this, handle, native_handle, process_id](const std::error_code&) {
+      DWORD exit_code;
+      GetExitCodeProcess(native_handle, &exit_code);
+      children_.erase(process_id);
+      if (on_exit_)
+        on_exit_(process_id, BOOST_PROCESS_EXITSTATUS(exit_code));
+    });
+    children_.emplace(process_id, std::move(child));
+    return process_id;
+  }
+
+  void Terminate(ProcessId process_id) override {
+    auto itr(children_.find(process_id));
+    if (itr == children_.end())
+      return;
+    boost::system::error_code ec;
+    bp::terminate(itr->second, ec);
+    if (ec)
+      LOG(kWarning) << "Error while terminating vault: " << ec.message();
+  }
+
+  bool IsRunning(ProcessId process_id) const override {
+    auto itr(children_.find(process_id));
+    try {
+      return itr != children_.end() && process::IsRunning(itr->second.process_handle());
+    } catch (const std::exception& e) {
+      LOG(kInfo) << boost::diagnostic_information(e);
+      return false;
+    }
+  }
+#else
+  ProcessId Spawn(const std::vector<std::string>& args,
+                  const VaultConfigChannel* config_channel) override {
+    bp::child child{0};
+    if (config_channel) {
+      child = bp::execute(
+          bp::initializers::run_exe(args.front()),
+          bp::initializers::set_cmd_line(process::ConstructCommandLine(args)),
+          bp::initializers::notify_io_service(io_service_),
+          bp::initializers::set_env(config_channel->ChildEnvironment()),
+          bp::initializers::on_exec_setup(
+              [config_channel](bp::executor&) { config_channel->InheritInChild(); }),
+          bp::initializers::throw_on_error());
+    } else {
+      child = bp::execute(bp::initializers::run_exe(args.front()),
+                          bp::initializers::set_cmd_line(process::ConstructCommandLine(args)),
+                          bp::initializers::notify_io_service(io_service_),
+                          bp::initializers::throw_on_error(), bp::initializers::inherit_env());
+    }
+    return static_cast<ProcessId>(child.pid);
+  }
+
+  // Also used for adopted vaults, which aren't our children.
+  void Terminate(ProcessId process_id) override {
+    bp::child child{static_cast<pid_t>(process_id)};
+    boost::system::error_code ec;
+    bp::terminate(child, ec);
+    if (ec)
+      LOG(kWarning) << "Error while terminating vault: " << ec.message();
+  }
+
+  bool IsRunning(ProcessId process_id) const override {
+    try {
+      return process::IsRunning(static_cast<pid_t>(process_id));
+    } catch (const std::exception& e) {
+      LOG(kInfo) << boost::diagnostic_information(e);
+      return false;
+    }
+  }
+#endif
+
+  bool CanHandOffConfig() const override {
+#ifdef MAIDSAFE_WIN32
+    return false;
+#else
+    return true;
+#endif
+  }
+
+ private:
+#ifndef MAIDSAFE_WIN32
+  void WaitForSignal() {
+    signal_set_.async_wait([this](const std::error_code& error_code, int signum) {
+      if (error_code)
+        return;
+      on_scope_exit wait_again([this] { WaitForSignal(); });
+      if (signum != SIGCHLD)
+        return;
+      // Several exits can be reported by a single SIGCHLD, so reap all of them.
+      int status;
+      pid_t process_id;
+      while ((process_id = waitpid(-1, &status, WNOHANG)) > 0) {
+        LOG(kInfo) << "Process ID " << process::GetProcessId()
+                   << " received SIGCHLD pid: " << process_id;
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+#endif
+        if (on_exit_)
+          on_exit_(static_cast<ProcessId>(process_id), BOOST_PROCESS_EXITSTATUS(status));
+#ifdef __GNUC__
+#pragma GCC diagnostic pop
+#endif
+      }
+    });
+  }
+#endif
+
+  asio::io_service& io_service_;
+#ifdef MAIDSAFE_WIN32
+  std::map<ProcessId, bp::child> children_;
+#else
+  asio::signal_set signal_set_;
+#endif
+  OnExitFunctor on_exit_;
+};
+
+}  // unnamed namespace
+
+std::shared_ptr<ProcessBackend> MakeProcessBackend(asio::io_service& io_service) {
+  return std::make_shared<RealProcessBackend>(io_service);
+}
+
+#ifdef TESTING
+SimulatedProcessBackend::SimulatedProcessBackend(asio::io_service& io_service)
+    : io_service_(io_service), mutex_(), on_exit_(), running_(), next_process_id_(1) {}
+
+void SimulatedProcessBackend::Start(OnExitFunctor on_exit) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  on_exit_ = std::move(on_exit);
+}
+
+void SimulatedProcessBackend::Stop() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  on_exit_ = nullptr;
+}
+
+ProcessId SimulatedProcessBackend::Spawn(const std::vector<std::string>& args,
+                                         const VaultConfigChannel* /*config_channel*/) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  running_.emplace(next_process_id_, args);
+  return next_process_id_++;
+}
+
+void SimulatedProcessBackend::Terminate(ProcessId process_id) { Exit(process_id, -1); }
+
+bool SimulatedProcessBackend::IsRunning(ProcessId process_id) const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return running_.count(process_id) != 0;
+}
+
+void SimulatedProcessBackend::Exit(ProcessId process_id, int exit_code) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  if (running_.erase(process_id) == 0 || !on_exit_)
+    return;
+  OnExitFunctor on_exit{on_exit_};
+  io_service_.post([on_exit, process_id, exit_code] { on_exit(process_id, exit_code); });
+}
+
+std::map<ProcessId, std::vector<std::string>> SimulatedProcessBackend::Running() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return running_;
+}
+
+uint64_t SimulatedProcessBackend::SpawnCount() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return next_process_id_ - 1;
+}
+#endif
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
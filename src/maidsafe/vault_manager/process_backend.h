@@ -0,0 +1,98 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_PROCESS_BACKEND_H_
+#define MAIDSAFE_VAULT_MANAGER_PROCESS_BACKEND_H_
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "asio/io_service.hpp"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+class VaultConfigChannel;
+
+typedef uint64_t ProcessId;
+
+// How the ProcessManager spawns, terminates and watches the vault processes.  MakeProcessBackend
+// returns the real one; a SimulatedProcessBackend spawns nothing, so that thousands of vault
+// lifecycles can be run inside a test.  Only used from the ProcessManager's io_service.
+class ProcessBackend {
+ public:
+  typedef std::function<void(ProcessId process_id, int exit_code)> OnExitFunctor;
+
+  virtual ~ProcessBackend() {}
+  // 'on_exit' is invoked on the io_service each time a process started by Spawn exits, until Stop.
+  virtual void Start(OnExitFunctor on_exit) = 0;
+  virtual void Stop() = 0;
+  // 'args' is the full command line, starting with the executable's path.  If non-null,
+  // 'config_channel' is inherited by the new process.  Throws on failure.
+  virtual ProcessId Spawn(const std::vector<std::string>& args,
+                          const VaultConfigChannel* config_channel) = 0;
+  virtual void Terminate(ProcessId process_id) = 0;
+  virtual bool IsRunning(ProcessId process_id) const = 0;
+  // Whether a 'config_channel' passed to Spawn reaches the new vault.
+  virtual bool CanHandOffConfig() const = 0;
+};
+
+// boost::process, with exits reported via SIGCHLD (or the process handle on Windows).
+std::shared_ptr<ProcessBackend> MakeProcessBackend(asio::io_service& io_service);
+
+#ifdef TESTING
+// Each Spawn allocates the next process ID, starting from 1, and the "process" runs until the test
+// calls Exit or the ProcessManager terminates it (exit code -1).  Deterministic and threadsafe.
+class SimulatedProcessBackend : public ProcessBackend {
+ public:
+  explicit SimulatedProcessBackend(asio::io_service& io_service);
+
+  void Start(OnExitFunctor on_exit) override;
+  void Stop() override;
+  ProcessId Spawn(const std::vector<std::string>& args,
+                  const VaultConfigChannel* config_channel) override;
+  void Terminate(ProcessId process_id) override;
+  bool IsRunning(ProcessId process_id) const override;
+  bool CanHandOffConfig() const override { return true; }
+
+  // Makes a running process exit with 'exit_code'.
+  void Exit(ProcessId process_id, int exit_code);
+  // The running processes and their command lines, in order of process ID.
+  std::map<ProcessId, std::vector<std::string>> Running() const;
+  uint64_t SpawnCount() const;
+
+ private:
+  asio::io_service& io_service_;
+  mutable std::mutex mutex_;
+  OnExitFunctor on_exit_;
+  std::map<ProcessId, std::vector<std::string>> running_;
+  ProcessId next_process_id_;
+};
+#endif
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_PROCESS_BACKEND_H_
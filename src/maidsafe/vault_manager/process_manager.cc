@@ -21,22 +21,12 @@
 #include <algorithm>
 #include <type_traits>
 
-#ifdef MAIDSAFE_BSD
-extern "C" char** environ;
+#ifdef MAIDSAFE_LINUX
+#include <sys/syscall.h>
+#include <unistd.h>
 #endif
 
-#ifdef _MSC_VER
-#pragma warning(push)
-#pragma warning(disable : 4702)
-#endif
-#include "boost/process/execute.hpp"
-#ifdef _MSC_VER
-#pragma warning(pop)
-#endif
-#include "boost/process/initializers.hpp"
-#include "boost/process/mitigate.hpp"
-#include "boost/process/terminate.hpp"
-#include "boost/process/wait_for_exit.hpp"
+#include "boost/filesystem/operations.hpp"
 
 #include "maidsafe/common/log.h"
 #include "maidsafe/common/make_unique.h"
@@ -45,10 +35,11 @@ extern "C" char** environ;
 #include "maidsafe/common/utils.h"
 #include "maidsafe/common/visualiser_log.h"
 
+#include "maidsafe/vault_manager/compact_message.h"
 #include "maidsafe/vault_manager/utils.h"
+#include "maidsafe/vault_manager/vault_config_channel.h"
 #include "maidsafe/vault_manager/messages/vault_shutdown_request.h"
 
-namespace bp = boost::process;
 namespace fs = boost::filesystem;
 
 namespace maidsafe {
@@ -79,7 +70,9 @@ void CheckNewVaultDoesntConflict(const VaultInfo& new_vault, const VaultInfo& ex
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::already_initialised));
   }
 
-  if (ConnectionsEqual(new_vault.tcp_connection, existing_vault.tcp_connection)) {
+  // Vaults which haven't connected yet have no connection to conflict over.
+  if (new_vault.tcp_connection &&
+      ConnectionsEqual(new_vault.tcp_connection, existing_vault.tcp_connection)) {
     LOG(kError) << "Vault process with this tcp_connection already exists.";
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::already_initialised));
   }
@@ -87,37 +80,37 @@ void CheckNewVaultDoesntConflict(const VaultInfo& new_vault, const VaultInfo& ex
 
 }  // unnamed namespace
 
-ProcessManager::Child::Child(VaultInfo info, asio::io_service& io_service, int restarts)
+ProcessManager::Child::Child(VaultInfo info, int restarts)
     : info(std::move(info)),
       on_exit(),
-      timer(maidsafe::make_unique<Timer>(io_service)),
+      timer_id(0),
       restart_count(restarts),
       process_args(),
       status(ProcessStatus::kBeforeStarted),
-#ifdef MAIDSAFE_WIN32
-      process(PROCESS_INFORMATION()),
-      handle(io_service) {
-}
-#else
-      process(0) {
-}
+      adopted(false),
+      config_handed_off(false),
+      poll_timer_id(0),
+#ifndef MAIDSAFE_WIN32
+      exit_monitor(),
 #endif
+      process_id(0) {
+}
 
 ProcessManager::Child::Child(Child&& other)
     : info(std::move(other.info)),
       on_exit(std::move(other.on_exit)),
-      timer(std::move(other.timer)),
+      timer_id(std::move(other.timer_id)),
       restart_count(std::move(other.restart_count)),
       process_args(std::move(other.process_args)),
       status(std::move(other.status)),
-#ifdef MAIDSAFE_WIN32
-      process(std::move(other.process)),
-      handle(std::move(other.handle)) {
-}
-#else
-      process(std::move(other.process)) {
-}
+      adopted(std::move(other.adopted)),
+      config_handed_off(std::move(other.config_handed_off)),
+      poll_timer_id(std::move(other.poll_timer_id)),
+#ifndef MAIDSAFE_WIN32
+      exit_monitor(std::move(other.exit_monitor)),
 #endif
+      process_id(std::move(other.process_id)) {
+}
 
 ProcessManager::Child& ProcessManager::Child::operator=(Child other) {
   swap(*this, other);
@@ -128,27 +121,38 @@ void swap(ProcessManager::Child& lhs, ProcessManager::Child& rhs) {
   using std::swap;
   swap(lhs.info, rhs.info);
   swap(lhs.on_exit, rhs.on_exit);
-  swap(lhs.timer, rhs.timer);
+  swap(lhs.timer_id, rhs.timer_id);
   swap(lhs.restart_count, rhs.restart_count);
   swap(lhs.process_args, rhs.process_args);
   swap(lhs.status, rhs.status);
-  swap(lhs.process, rhs.process);
-#ifdef MAIDSAFE_WIN32
-  swap(lhs.handle, rhs.handle);
+  swap(lhs.adopted, rhs.adopted);
+  swap(lhs.config_handed_off, rhs.config_handed_off);
+  swap(lhs.poll_timer_id, rhs.poll_timer_id);
+  swap(lhs.process_id, rhs.process_id);
+#ifndef MAIDSAFE_WIN32
+  swap(lhs.exit_monitor, rhs.exit_monitor);
 #endif
 }
 
-
-
 ProcessManager::ProcessManager(asio::io_service& io_service, fs::path vault_executable_path,
-                               tcp::Port listening_port)
+                               tcp::Port listening_port, OnVaultEventFunctor on_vault_event,
+                               std::shared_ptr<TimingWheel> timing_wheel,
+                               std::shared_ptr<PeerCapabilities> peer_capabilities,
+                               SerialiseVaultConfigFunctor serialise_vault_config,
+                               std::shared_ptr<ProcessBackend> process_backend,
+                               std::shared_ptr<SendQueues> send_queues)
     : io_service_(io_service),
-#ifndef MAIDSAFE_WIN32
-      signal_set_(io_service_, SIGCHLD),
-#endif
+      timing_wheel_(timing_wheel ? std::move(timing_wheel) : TimingWheel::MakeShared(io_service)),
+      peer_capabilities_(peer_capabilities ? std::move(peer_capabilities)
+                                           : std::make_shared<PeerCapabilities>()),
+      process_backend_(process_backend ? std::move(process_backend)
+                                       : MakeProcessBackend(io_service)),
+      send_queues_(send_queues ? std::move(send_queues) : std::make_shared<SendQueues>()),
       stop_all_flag_(),
       kListeningPort_(listening_port),
       kVaultExecutablePath_(vault_executable_path),
+      kOnVaultEvent_(std::move(on_vault_event)),
+      kSerialiseVaultConfig_(std::move(serialise_vault_config)),
       vaults_() {
   static_assert(std::is_same<ProcessId, process::ProcessId>::value,
                 "process::ProcessId is statically checked as being of suitable size for holding a "
@@ -166,14 +170,21 @@ ProcessManager::ProcessManager(asio::io_service& io_service, fs::path vault_exec
     LOG(kError) << kVaultExecutablePath_ << " is a symlink.  " << (ec ? ec.message() : "");
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
   }
-  InitSignalHandler();
+  process_backend_->Start(
+      [this](ProcessId process_id, int exit_code) { HandleProcessExit(process_id, exit_code); });
 }
 
 std::shared_ptr<ProcessManager> ProcessManager::MakeShared(
     asio::io_service& io_service, boost::filesystem::path vault_executable_path,
-    tcp::Port listening_port) {
-  return std::shared_ptr<ProcessManager>{
-      new ProcessManager{io_service, vault_executable_path, listening_port}};
+    tcp::Port listening_port, OnVaultEventFunctor on_vault_event,
+    std::shared_ptr<TimingWheel> timing_wheel,
+    std::shared_ptr<PeerCapabilities> peer_capabilities,
+    SerialiseVaultConfigFunctor serialise_vault_config,
+    std::shared_ptr<ProcessBackend> process_backend, std::shared_ptr<SendQueues> send_queues) {
+  return std::shared_ptr<ProcessManager>{new ProcessManager{
+      io_service, vault_executable_path, listening_port, std::move(on_vault_event),
+      std::move(timing_wheel), std::move(peer_capabilities), std::move(serialise_vault_config),
+      std::move(process_backend), std::move(send_queues)}};
 }
 
 ProcessManager::~ProcessManager() { assert(vaults_.empty()); }
@@ -182,10 +193,7 @@ void ProcessManager::StopAll() {
   std::call_once(stop_all_flag_, [this] {
     for (const auto& vault : vaults_)
       StopProcess(vault.info.tcp_connection);
-#ifndef MAIDSAFE_WIN32
-    std::error_code ignored_ec;
-    signal_set_.cancel(ignored_ec);
-#endif
+    process_backend_->Stop();
   });
 }
 
@@ -201,10 +209,7 @@ void ProcessManager::StopAllWithInterval() {
       StopProcess(connection);
       Sleep(std::chrono::seconds(5));
     }
-#ifndef MAIDSAFE_WIN32
-    std::error_code ignored_ec;
-    signal_set_.cancel(ignored_ec);
-#endif
+    process_backend_->Stop();
   });
 }
 
@@ -228,25 +233,114 @@ void ProcessManager::AddProcess(VaultInfo info, int restart_count) {
     CheckNewVaultDoesntConflict(info, vault.info);
 
   // emplace offers strong exception guarantee - only need to cover subsequent calls.
-  auto itr(vaults_.emplace(std::end(vaults_), Child{info, io_service_, restart_count}));
-  on_scope_exit strong_guarantee{[this, itr] { vaults_.erase(itr); }};
+  auto itr(vaults_.emplace(std::end(vaults_), Child{info, restart_count}));
+  on_scope_exit strong_guarantee{[this, itr] {
+    timing_wheel_->Cancel(itr->timer_id);
+    vaults_.erase(itr);
+  }};
   StartProcess(itr);
   strong_guarantee.Release();
 }
 
-VaultInfo ProcessManager::HandleVaultStarted(tcp::ConnectionPtr connection, ProcessId process_id) {
+void ProcessManager::ReleaseAll() {
+  std::call_once(stop_all_flag_, [this] {
+    for (auto& vault : vaults_) {
+      timing_wheel_->Cancel(vault.timer_id);
+      timing_wheel_->Cancel(vault.poll_timer_id);
+      if (vault.info.tcp_connection)
+        vault.info.tcp_connection->Close();
+    }
+    LOG(kInfo) << "Leaving " << vaults_.size() << " vault processes running.";
+    vaults_.clear();
+    process_backend_->Stop();
+  });
+}
+
+void ProcessManager::AdoptProcess(VaultInfo info, ProcessId process_id) {
+#ifdef MAIDSAFE_WIN32
+  static_cast<void>(info);
+  LOG(kError) << "Can't adopt vault process " << process_id << " on this platform.";
+  BOOST_THROW_EXCEPTION(MakeError(CommonErrors::unable_to_handle_request));
+#else
+  if (info.adoption_token.empty() || !IsVaultExecutable(process_id)) {
+    LOG(kError) << "Can't adopt process " << process_id << " as vault " << info.label.string();
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+  }
+  for (const auto& vault : vaults_)
+    CheckNewVaultDoesntConflict(info, vault.info);
+
+  auto itr(vaults_.emplace(std::end(vaults_), Child{info, 0}));
+  itr->process_id = process_id;
+  itr->adopted = true;
+  itr->status = ProcessStatus::kStarting;
+  NonEmptyString label{itr->info.label};
+  itr->timer_id = timing_wheel_->Add(kAdoptionTimeout, [this, label] {
+    LOG(kWarning) << "Timed out waiting for adopted process to reconnect via TCP.";
+    OnProcessExit(label, -1, true);
+  });
+  MonitorAdoptedProcess(itr);
+  LOG(kInfo) << "Adopted vault " << label.string() << " with process ID " << process_id;
+#endif
+}
+
+VaultInfo ProcessManager::HandleVaultStarted(tcp::ConnectionPtr connection, ProcessId process_id,
+                                             const std::string& adoption_token) {
+  // A vault still waiting to be spawned has no process ID yet.
   auto itr(
       std::find_if(std::begin(vaults_), std::end(vaults_), [this, process_id](const Child& vault) {
-        return GetProcessId(vault) == process_id;
+        return GetProcessId(vault) == process_id && process_id != 0;
       }));
   if (itr == std::end(vaults_)) {
     LOG(kError) << "Failed to find vault with process ID " << process_id << " in child processes.";
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::no_such_element));
   }
-  itr->timer->cancel();
+  if (!adoption_token.empty() &&
+      (!(itr->adopted || itr->config_handed_off) || itr->status != ProcessStatus::kStarting ||
+       itr->info.adoption_token != adoption_token)) {
+    LOG(kError) << "Vault with process ID " << process_id << " can't be re-adopted.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+  }
+  // Only the real vault could have read the token from its config channel, so a connection which
+  // doesn't present it is either from some other process claiming the vault's process ID, or from a
+  // vault which doesn't read the channel.  In case it's the latter, the vault isn't handed a
+  // channel when next restarted, so that it's sent its config over TCP instead.
+  if (adoption_token.empty() && itr->config_handed_off) {
+    LOG(kError) << "Connection claiming to be vault with process ID " << process_id
+                << " didn't present its adoption token.";
+    labels_without_config_channel_.insert(itr->info.label);
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+  }
+  if (!adoption_token.empty() && itr->config_handed_off)
+    labels_without_config_channel_.erase(itr->info.label);
+  timing_wheel_->Cancel(itr->timer_id);
+  itr->timer_id = 0;
   itr->info.tcp_connection = connection;
   itr->status = ProcessStatus::kRunning;
-  return itr->info;
+  if (itr->info.adoption_token.empty())
+    itr->info.adoption_token = RandomString(32);
+  VaultInfo vault_info{itr->info};
+  // Only the first start answers the originating client request; later restarts are unsolicited.
+  itr->info.request_id = 0;
+  itr->info.requester.reset();
+  return vault_info;
+}
+
+bool ProcessManager::AwaitingConfiguredVault(ProcessId process_id) const {
+  auto itr(
+      std::find_if(std::begin(vaults_), std::end(vaults_), [this, process_id](const Child& vault) {
+        return GetProcessId(vault) == process_id;
+      }));
+  return itr != std::end(vaults_) && itr->config_handed_off && !itr->adopted &&
+         itr->status == ProcessStatus::kStarting;
+}
+
+std::vector<ChildRecord> ProcessManager::GetChildRecords() const {
+  std::vector<ChildRecord> child_records;
+  for (const auto& vault : vaults_) {
+    if (!vault.info.adoption_token.empty() && vault.status != ProcessStatus::kStopping)
+      child_records.emplace_back(vault.info.label, GetProcessId(vault), vault.info.adoption_token);
+  }
+  return child_records;
 }
 
 void ProcessManager::AssignOwner(const NonEmptyString& label,
@@ -268,74 +362,63 @@ void ProcessManager::StartProcess(std::vector<Child>::iterator itr) {
   args.emplace_back("--log_folder " + (itr->info.vault_dir / "logs").string());
   args.insert(std::end(args), std::begin(itr->process_args), std::end(itr->process_args));
 
-  NonEmptyString label{itr->info.label};
-  itr->process = bp::execute(bp::initializers::run_exe(kVaultExecutablePath_),
-                             bp::initializers::set_cmd_line(process::ConstructCommandLine(args)),
-#ifndef MAIDSAFE_WIN32
-                             bp::initializers::notify_io_service(io_service_),
-#endif
-                             bp::initializers::throw_on_error(), bp::initializers::inherit_env());
-
   itr->status = ProcessStatus::kStarting;
-
-#ifdef MAIDSAFE_WIN32
-  HANDLE copied_handle;
-  DuplicateHandle(GetCurrentProcess(), itr->process.process_handle(), GetCurrentProcess(),
-                  &copied_handle, 0, FALSE, DUPLICATE_SAME_ACCESS);
-  itr->handle.assign(copied_handle);
-  HANDLE native_handle{itr->handle.native_handle()};
-  itr->handle.async_wait([this, label, native_handle](const std::error_code&) {
-    DWORD exit_code;
-    GetExitCodeProcess(native_handle, &exit_code);
-    OnProcessExit(label, BOOST_PROCESS_EXITSTATUS(exit_code));
-  });
-#endif
-
-  itr->timer->expires_from_now(kRpcTimeout);
-  itr->timer->async_wait([this, label](const std::error_code& error_code) {
-    if (!error_code || error_code != asio::error::operation_aborted)
-      return;
+  NonEmptyString label{itr->info.label};
+  itr->timer_id = timing_wheel_->Add(kRpcTimeout, [this, label] {
     LOG(kWarning) << "Timed out waiting for new process to connect via TCP.";
     OnProcessExit(label, -1, true);
   });
-}
 
-void ProcessManager::InitSignalHandler() {
 #ifndef MAIDSAFE_WIN32
-  signal_set_.async_wait([this](const std::error_code& error_code, int signum) {
-    if (!error_code || error_code != asio::error::operation_aborted)
-      return;
-
-    maidsafe::on_scope_exit init_on_exit([this]() { InitSignalHandler(); });
+  if (kSerialiseVaultConfig_ && process_backend_->CanHandOffConfig() &&
+      labels_without_config_channel_.count(label) == 0) {
+    // Each new process gets a new token; it's how the vault proves its identity when it connects.
+    itr->info.adoption_token = RandomString(32);
+    std::string adoption_token{itr->info.adoption_token};
+    // Encrypting the config is left to the crypto workers, so the vault is spawned once it's done.
+    return kSerialiseVaultConfig_(
+        itr->info, [this, label, adoption_token, args](tcp::Message config) {
+          try {
+            SpawnProcess(label, adoption_token, args, config);
+          } catch (const std::exception& e) {
+            LOG(kError) << "Failed to spawn vault " << label.string() << ": "
+                        << boost::diagnostic_information(e);
+            OnProcessExit(label, -1);
+          }
+        });
+  }
+#endif
+  SpawnProcess(label, itr->info.adoption_token, args, tcp::Message());
+}
 
-    if (signum != SIGCHLD) {
-      LOG(kWarning) << "Process ID " << process::GetProcessId() << " received signal " << signum;
-      return;
-    }
+void ProcessManager::SpawnProcess(const NonEmptyString& label, const std::string& adoption_token,
+                                  const std::vector<std::string>& args,
+                                  const tcp::Message& config) {
+  auto itr(std::find_if(std::begin(vaults_), std::end(vaults_), [&label](const Child& vault) {
+    return vault.info.label == label;
+  }));
+  if (itr == std::end(vaults_) || itr->status != ProcessStatus::kStarting ||
+      itr->process_id != 0 || itr->info.adoption_token != adoption_token) {
+    LOG(kInfo) << "Vault " << label.string() << " was stopped before it could be spawned.";
+    return;
+  }
 
-    int exit_code;
-    ProcessId process_id{static_cast<ProcessId>(wait(&exit_code))};
-    LOG(kWarning) << "Process ID " << process::GetProcessId()
-                  << " received SIGCHLD pid: " << process_id;
-    if (process_id == process::GetProcessId())
-      return;
-
-    auto child_itr(std::find_if(
-        std::begin(vaults_), std::end(vaults_),
-        [this, process_id](const Child& vault) { return GetProcessId(vault) == process_id; }));
-    if (child_itr == std::end(vaults_))
-      return;
-
-#ifdef __GNUC__
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wold-style-cast"
-#endif
-    OnProcessExit(child_itr->info.label, BOOST_PROCESS_EXITSTATUS(exit_code));
-#ifdef __GNUC__
-#pragma GCC diagnostic pop
-#endif
-  });
+  std::unique_ptr<VaultConfigChannel> config_channel;
+#ifndef MAIDSAFE_WIN32
+  if (!config.empty())
+    config_channel = maidsafe::make_unique<VaultConfigChannel>(config);
 #endif
+  itr->config_handed_off = config_channel && config_channel->IsOpen();
+  itr->process_id =
+      process_backend_->Spawn(args, itr->config_handed_off ? config_channel.get() : nullptr);
+}
+
+void ProcessManager::HandleProcessExit(ProcessId process_id, int exit_code) {
+  auto child_itr(std::find_if(
+      std::begin(vaults_), std::end(vaults_),
+      [this, process_id](const Child& vault) { return GetProcessId(vault) == process_id; }));
+  if (child_itr != std::end(vaults_))
+    OnProcessExit(child_itr->info.label, exit_code);
 }
 
 void ProcessManager::StopProcess(tcp::ConnectionPtr connection, OnExitFunctor on_exit_functor) {
@@ -346,19 +429,43 @@ void ProcessManager::StopProcess(tcp::ConnectionPtr connection, OnExitFunctor on
     LOG(kError) << "Vault process doesn't exist: " << boost::diagnostic_information(e);
     return;
   }
+  DoStopProcess(itr, on_exit_functor);
+}
+
+void ProcessManager::StopProcess(const NonEmptyString& label, OnExitFunctor on_exit_functor) {
+  auto itr(std::begin(vaults_));
+  try {
+    itr = DoFind(label);
+  } catch (const std::exception& e) {
+    LOG(kError) << "Vault process doesn't exist: " << boost::diagnostic_information(e);
+    return;
+  }
+  if (itr->info.tcp_connection)
+    return DoStopProcess(itr, on_exit_functor);
+  // It can't be asked to shut down, so is terminated straight away.
+  itr->on_exit = on_exit_functor;
+  itr->status = ProcessStatus::kStopping;
+  OnProcessExit(label, -1, true);
+}
+
+void ProcessManager::DoStopProcess(std::vector<Child>::iterator itr,
+                                   OnExitFunctor on_exit_functor) {
   itr->on_exit = on_exit_functor;
   itr->status = ProcessStatus::kStopping;
-  Send(itr->info.tcp_connection, VaultShutdownRequest());
+  const bool kCompact{peer_capabilities_->CompactMessages(itr->info.tcp_connection)};
+  send_queues_->Send(itr->info.tcp_connection, SerialiseMessage(VaultShutdownRequest(), kCompact));
   NonEmptyString label{itr->info.label};
-  itr->timer->expires_from_now(kVaultStopTimeout);
-  itr->timer->async_wait([this, label](const std::error_code& error_code) {
-    if (!error_code || error_code != asio::error::operation_aborted)
-      return;
+  timing_wheel_->Cancel(itr->timer_id);
+  itr->timer_id = timing_wheel_->Add(kVaultStopTimeout, [this, label] {
     LOG(kWarning) << "Timed out waiting for Vault to stop; terminating now.";
     OnProcessExit(label, -1, true);
   });
 }
 
+void ProcessManager::SetMaxDiskUsage(const NonEmptyString& label, DiskUsage max_disk_usage) {
+  DoFind(label)->info.max_disk_usage = max_disk_usage;
+}
+
 bool ProcessManager::HandleConnectionClosed(tcp::ConnectionPtr connection) {
   try {
     OnProcessExit(DoFind(connection)->info.label, -1, true);
@@ -372,6 +479,32 @@ bool ProcessManager::HandleConnectionClosed(tcp::ConnectionPtr connection) {
 
 VaultInfo ProcessManager::Find(const NonEmptyString& label) const { return DoFind(label)->info; }
 
+void ProcessManager::AssignRequest(const NonEmptyString& label, uint64_t request_id,
+                                   tcp::ConnectionPtr requester) {
+  auto itr(DoFind(label));
+  itr->info.request_id = request_id;
+  itr->info.requester = requester;
+}
+
+bool ProcessManager::Contains(const NonEmptyString& label) const {
+  return std::any_of(std::begin(vaults_), std::end(vaults_),
+                     [&label](const Child& vault) { return vault.info.label == label; });
+}
+
+bool ProcessManager::Contains(tcp::ConnectionPtr connection) const {
+  return connection &&
+         std::any_of(std::begin(vaults_), std::end(vaults_), [&connection](const Child& vault) {
+           return ConnectionsEqual(vault.info.tcp_connection, connection);
+         });
+}
+
+std::size_t ProcessManager::AwaitingConnectionCount() const {
+  return static_cast<std::size_t>(
+      std::count_if(std::begin(vaults_), std::end(vaults_), [](const Child& vault) {
+        return vault.status == ProcessStatus::kStarting && !vault.info.tcp_connection;
+      }));
+}
+
 std::vector<ProcessManager::Child>::const_iterator ProcessManager::DoFind(
     const NonEmptyString& label) const {
   auto itr(std::find_if(std::begin(vaults_), std::end(vaults_),
@@ -418,25 +551,79 @@ std::vector<ProcessManager::Child>::iterator ProcessManager::DoFind(tcp::Connect
   return itr;
 }
 
-ProcessId ProcessManager::GetProcessId(const Child& vault) const {
-#ifdef MAIDSAFE_WIN32
-  return static_cast<ProcessId>(vault.process.proc_info.dwProcessId);
-#else
-  return static_cast<ProcessId>(vault.process.pid);
+#ifdef TESTING
+void ProcessManager::AddRunningVaultForTesting(VaultInfo info) {
+  for (const auto& vault : vaults_)
+    CheckNewVaultDoesntConflict(info, vault.info);
+  auto itr(vaults_.emplace(std::end(vaults_), Child{std::move(info), 0}));
+  itr->status = ProcessStatus::kRunning;
+}
 #endif
+
+void ProcessManager::MonitorAdoptedProcess(std::vector<Child>::iterator itr) {
+  NonEmptyString label{itr->info.label};
+  ProcessId process_id{GetProcessId(*itr)};
+#if defined(MAIDSAFE_LINUX) && defined(SYS_pidfd_open)
+  int pidfd{static_cast<int>(syscall(SYS_pidfd_open, static_cast<pid_t>(process_id), 0))};
+  if (pidfd >= 0) {
+    // The descriptor becomes readable when the process exits.  Its exit code isn't available.
+    itr->exit_monitor = std::make_shared<asio::posix::stream_descriptor>(io_service_, pidfd);
+    itr->exit_monitor->async_read_some(
+        asio::null_buffers(), [this, label](const std::error_code& error_code, std::size_t) {
+          if (error_code != asio::error::operation_aborted)
+            OnProcessExit(label, -1);
+        });
+    return;
+  }
+  LOG(kWarning) << "pidfd_open failed for process " << process_id << "; polling instead.";
+#endif
+  itr->poll_timer_id = timing_wheel_->Add(
+      kAdoptedProcessPollInterval,
+      [this, label, process_id] { PollAdoptedProcess(label, process_id); });
 }
 
-bool ProcessManager::IsRunning(const Child& vault) const {
-  try {
-#ifdef MAIDSAFE_WIN32
-    return process::IsRunning(vault.process.process_handle());
+void ProcessManager::PollAdoptedProcess(const NonEmptyString& label, ProcessId process_id) {
+  auto itr(std::find_if(std::begin(vaults_), std::end(vaults_), [&](const Child& vault) {
+    return vault.info.label == label && GetProcessId(vault) == process_id;
+  }));
+  if (itr == std::end(vaults_))
+    return;
+  itr->poll_timer_id = 0;
+  if (!IsRunning(*itr))
+    return OnProcessExit(label, -1);
+  itr->poll_timer_id = timing_wheel_->Add(
+      kAdoptedProcessPollInterval,
+      [this, label, process_id] { PollAdoptedProcess(label, process_id); });
+}
+
+bool ProcessManager::IsVaultExecutable(ProcessId process_id) const {
+#ifdef MAIDSAFE_LINUX
+  // Guards against the recorded process ID having been reused by an unrelated process, which would
+  // otherwise be terminated if it didn't reconnect.  The executable may have been replaced since
+  // the vault started (e.g. by an upgrade), in which case the link has " (deleted)" appended.
+  boost::system::error_code error_code;
+  std::string executable{
+      fs::read_symlink(fs::path{"/proc"} / std::to_string(process_id) / "exe", error_code)
+          .string()};
+  const std::string kDeletedSuffix{" (deleted)"};
+  if (executable.size() > kDeletedSuffix.size() &&
+      executable.compare(executable.size() - kDeletedSuffix.size(), kDeletedSuffix.size(),
+                         kDeletedSuffix) == 0) {
+    executable.resize(executable.size() - kDeletedSuffix.size());
+  }
+  fs::path expected{fs::canonical(kVaultExecutablePath_, error_code)};
+  return !error_code && !executable.empty() && executable == expected.string();
 #else
-    return process::IsRunning(vault.process.pid);
+  // There's no portable way to confirm the process' identity, so it's not adopted.
+  static_cast<void>(process_id);
+  return false;
 #endif
-  } catch (const std::exception& e) {
-    LOG(kInfo) << boost::diagnostic_information(e);
-    return false;
-  }
+}
+
+ProcessId ProcessManager::GetProcessId(const Child& vault) const { return vault.process_id; }
+
+bool ProcessManager::IsRunning(const Child& vault) const {
+  return vault.process_id != 0 && process_backend_->IsRunning(vault.process_id);
 }
 
 void ProcessManager::OnProcessExit(const NonEmptyString& label, int exit_code, bool terminate) {
@@ -472,17 +659,21 @@ void ProcessManager::OnProcessExit(const NonEmptyString& label, int exit_code, b
     child_itr->info.tcp_connection->Close();
 
   OnExitFunctor on_exit{child_itr->on_exit};
+  VaultInfo exited_vault_info{child_itr->info};
+  timing_wheel_->Cancel(child_itr->timer_id);
+  timing_wheel_->Cancel(child_itr->poll_timer_id);
   vaults_.erase(child_itr);
 
   InvokeOnExitFunctor(on_exit, exit_code, terminate);
+  bool restarting{restart_count >= 0 && restart_count < kMaxVaultRestarts};
+  InvokeOnVaultEventFunctor(exited_vault_info,
+                            restarting ? VaultEventType::kRestarted : VaultEventType::kExited,
+                            exit_code);
   RestartIfRequired(restart_count, std::move(vault_info));
 }
 
 void ProcessManager::TerminateProcess(std::vector<Child>::iterator itr) {
-  boost::system::error_code ec;
-  bp::terminate(itr->process, ec);
-  if (ec)
-    LOG(kWarning) << "Error while terminating vault: " << ec.message();
+  process_backend_->Terminate(itr->process_id);
 }
 
 void ProcessManager::InvokeOnExitFunctor(OnExitFunctor on_exit, int exit_code, bool terminate) {
@@ -503,6 +694,20 @@ void ProcessManager::InvokeOnExitFunctor(OnExitFunctor on_exit, int exit_code, b
   }
 }
 
+void ProcessManager::InvokeOnVaultEventFunctor(const VaultInfo& vault_info, VaultEventType type,
+                                               int exit_code) {
+  if (!kOnVaultEvent_)
+    return;
+
+  try {
+    kOnVaultEvent_(vault_info, type, exit_code);
+  } catch (const std::exception& e) {
+    LOG(kError) << "Error executing on_vault_event functor: " << boost::diagnostic_information(e);
+  } catch (...) {
+    LOG(kError) << "Unknown error type while executing on_vault_event functor.";
+  }
+}
+
 void ProcessManager::RestartIfRequired(int restart_count, VaultInfo vault_info) {
   if (restart_count < 0 || restart_count >= kMaxVaultRestarts)
     return;
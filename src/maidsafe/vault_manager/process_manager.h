@@ -19,82 +19,147 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_PROCESS_MANAGER_H_
 #define MAIDSAFE_VAULT_MANAGER_PROCESS_MANAGER_H_
 
+#include <cstdint>
 #include <functional>
 #include <future>
 #include <memory>
 #include <mutex>
+#include <set>
 #include <string>
 #include <vector>
 
 #include "asio/io_service.hpp"
-#ifdef MAIDSAFE_WIN32
-#include "asio/windows/object_handle.hpp"
-#else
-#include "asio/signal_set.hpp"
+#ifndef MAIDSAFE_WIN32
+#include "asio/posix/stream_descriptor.hpp"
 #endif
 #include "boost/filesystem/path.hpp"
-#include "boost/process/child.hpp"
 
 #include "maidsafe/common/error.h"
 #include "maidsafe/common/types.h"
 #include "maidsafe/common/tcp/connection.h"
 #include "maidsafe/passport/types.h"
 
+#include "maidsafe/vault_manager/child_records.h"
 #include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/peer_capabilities.h"
+#include "maidsafe/vault_manager/process_backend.h"
+#include "maidsafe/vault_manager/send_queues.h"
+#include "maidsafe/vault_manager/timing_wheel.h"
+#include "maidsafe/vault_manager/vault_event.h"
 #include "maidsafe/vault_manager/vault_info.h"
 
 namespace maidsafe {
 
 namespace vault_manager {
 
-typedef uint64_t ProcessId;
-
 enum class ProcessStatus { kBeforeStarted, kStarting, kRunning, kStopping };
 
 // All functions provide the strong exception guarantee.
 class ProcessManager {
  public:
   typedef std::function<void(maidsafe_error, int)> OnExitFunctor;
+  // Invoked with kExited or kRestarted each time a vault process stops.
+  typedef std::function<void(const VaultInfo&, VaultEventType, int)> OnVaultEventFunctor;
+  // Serialises the VaultStartedResponse for a vault which is about to be spawned, then passes it
+  // (or an empty message on failure) to the given functor on the ProcessManager's io_service.
+  typedef std::function<void(const VaultInfo&, std::function<void(tcp::Message)>)>
+      SerialiseVaultConfigFunctor;
 
   ProcessManager(const ProcessManager&) = delete;
   ProcessManager(ProcessManager&&) = delete;
   ProcessManager& operator=(ProcessManager) = delete;
 
-  static std::shared_ptr<ProcessManager> MakeShared(asio::io_service& io_service,
-                                                    boost::filesystem::path vault_executable_path,
-                                                    tcp::Port listening_port);
+  // If 'timing_wheel' or 'peer_capabilities' is null, the ProcessManager creates its own.  If
+  // 'serialise_vault_config' is non-null, each vault is handed its config through a
+  // VaultConfigChannel when it's spawned, where the platform allows.  If 'process_backend' is null,
+  // that of MakeProcessBackend is used.  Messages to vaults are sent through 'send_queues' so that
+  // they stay in order with those sent by the VaultManager; if null, the ProcessManager creates its
+  // own.
+  static std::shared_ptr<ProcessManager> MakeShared(
+      asio::io_service& io_service, boost::filesystem::path vault_executable_path,
+      tcp::Port listening_port, OnVaultEventFunctor on_vault_event = nullptr,
+      std::shared_ptr<TimingWheel> timing_wheel = nullptr,
+      std::shared_ptr<PeerCapabilities> peer_capabilities = nullptr,
+      SerialiseVaultConfigFunctor serialise_vault_config = nullptr,
+      std::shared_ptr<ProcessBackend> process_backend = nullptr,
+      std::shared_ptr<SendQueues> send_queues = nullptr);
   ~ProcessManager();
   void StopAll();
   void StopAllWithInterval();
+  // Forgets all vaults without stopping them, so that they can be re-adopted by another
+  // ProcessManager.
+  void ReleaseAll();
   std::vector<VaultInfo> GetAll() const;
   void AddProcess(VaultInfo info, int restart_count = 0);
-  VaultInfo HandleVaultStarted(tcp::ConnectionPtr connection, ProcessId process_id);
+  // Takes over a vault process left running by a previous VaultManager.  It must reconnect with
+  // 'info.adoption_token' within kAdoptionTimeout or it's terminated and restarted.  The vault
+  // retries with a growing, jittered delay while the VaultManager is down (see GetReconnectDelay),
+  // so the window covers its longest delay.  Throws if the process isn't running an instance of the
+  // vault executable.
+  void AdoptProcess(VaultInfo info, ProcessId process_id);
+  // 'adoption_token' is empty for a newly-started vault, which is then allocated one.  Otherwise it
+  // must match that of the adopted vault with 'process_id', or that which was handed to the new
+  // vault through its config channel.  A vault which was handed its config must present the token.
+  VaultInfo HandleVaultStarted(tcp::ConnectionPtr connection, ProcessId process_id,
+                               const std::string& adoption_token = std::string());
+  // Whether the vault with 'process_id' was handed its config when spawned and hasn't connected
+  // yet, i.e. its VaultStarted isn't a reconnection even though it carries an adoption token.
+  bool AwaitingConfiguredVault(ProcessId process_id) const;
+  // The vaults which have connected and could be re-adopted.
+  std::vector<ChildRecord> GetChildRecords() const;
   void AssignOwner(const NonEmptyString& label, const passport::PublicMaid::Name& owner_name,
                    DiskUsage max_disk_usage);
   void StopProcess(tcp::ConnectionPtr connection, OnExitFunctor on_exit_functor = nullptr);
+  // As above, but also stops a vault which hasn't connected yet by terminating its process.
+  void StopProcess(const NonEmptyString& label, OnExitFunctor on_exit_functor = nullptr);
+  void SetMaxDiskUsage(const NonEmptyString& label, DiskUsage max_disk_usage);
   // Returns false if the process doesn't exist.
   bool HandleConnectionClosed(tcp::ConnectionPtr connection);
   VaultInfo Find(const NonEmptyString& label) const;
+  bool Contains(const NonEmptyString& label) const;
+  // Whether 'connection' is that of a vault which has started.
+  bool Contains(tcp::ConnectionPtr connection) const;
+  // The number of spawned or adopted vaults which haven't connected yet.
+  std::size_t AwaitingConnectionCount() const;
+  // Sets the client request to be answered when the vault with 'label' next starts.
+  void AssignRequest(const NonEmptyString& label, uint64_t request_id,
+                     tcp::ConnectionPtr requester);
   VaultInfo Find(tcp::ConnectionPtr connection) const;
+#ifdef TESTING
+  // Adds 'info' as a running vault without starting a process, so that lookups can be measured
+  // against many vaults.  Such entries must be removed with ReleaseAll().
+  void AddRunningVaultForTesting(VaultInfo info);
+#endif
 
  private:
   ProcessManager(asio::io_service& io_service, boost::filesystem::path vault_executable_path,
-                 tcp::Port listening_port);
+                 tcp::Port listening_port, OnVaultEventFunctor on_vault_event,
+                 std::shared_ptr<TimingWheel> timing_wheel,
+                 std::shared_ptr<PeerCapabilities> peer_capabilities,
+                 SerialiseVaultConfigFunctor serialise_vault_config,
+                 std::shared_ptr<ProcessBackend> process_backend,
+                 std::shared_ptr<SendQueues> send_queues);
 
   struct Child {
-    Child(VaultInfo info, asio::io_service& io_service, int restarts);
+    Child(VaultInfo info, int restarts);
     Child(Child&& other);
     Child& operator=(Child other);
     VaultInfo info;
     OnExitFunctor on_exit;
-    std::unique_ptr<Timer> timer;
+    TimingWheel::TimerId timer_id;  // 0 if no timeout is pending.
     int restart_count;
     std::vector<std::string> process_args;
     ProcessStatus status;
-#ifdef MAIDSAFE_WIN32
-    asio::windows::object_handle handle;
+    // An adopted process isn't our child, so its exit is detected via a pidfd where available,
+    // otherwise by polling.
+    bool adopted;
+    // Whether the process was handed its config through a VaultConfigChannel when spawned.
+    bool config_handed_off;
+    TimingWheel::TimerId poll_timer_id;
+#ifndef MAIDSAFE_WIN32
+    std::shared_ptr<asio::posix::stream_descriptor> exit_monitor;
 #endif
-    boost::process::child process;
+    ProcessId process_id;  // 0 until started.
 
    private:
     Child(const Child&) = delete;
@@ -102,7 +167,15 @@ class ProcessManager {
   friend void swap(Child& lhs, Child& rhs);
 
   void StartProcess(std::vector<Child>::iterator itr);
-  void InitSignalHandler();
+  // Spawns the vault once its config is serialised, unless it has been stopped or restarted in the
+  // meantime.  If 'config' is empty, the vault asks for its config over TCP instead.
+  void SpawnProcess(const NonEmptyString& label, const std::string& adoption_token,
+                    const std::vector<std::string>& args, const tcp::Message& config);
+  void DoStopProcess(std::vector<Child>::iterator itr, OnExitFunctor on_exit_functor);
+  void HandleProcessExit(ProcessId process_id, int exit_code);
+  void MonitorAdoptedProcess(std::vector<Child>::iterator itr);
+  void PollAdoptedProcess(const NonEmptyString& label, ProcessId process_id);
+  bool IsVaultExecutable(ProcessId process_id) const;
 
   std::vector<Child>::const_iterator DoFind(const NonEmptyString& label) const;
   std::vector<Child>::iterator DoFind(const NonEmptyString& label);
@@ -113,16 +186,23 @@ class ProcessManager {
   void OnProcessExit(const NonEmptyString& label, int exit_code, bool terminate = false);
   void TerminateProcess(std::vector<Child>::iterator itr);
   void InvokeOnExitFunctor(OnExitFunctor on_exit, int exit_code, bool terminate);
+  void InvokeOnVaultEventFunctor(const VaultInfo& vault_info, VaultEventType type, int exit_code);
   void RestartIfRequired(int restart_count, VaultInfo vault_info);
 
   asio::io_service& io_service_;
-#ifndef MAIDSAFE_WIN32
-  asio::signal_set signal_set_;
-#endif
+  std::shared_ptr<TimingWheel> timing_wheel_;
+  std::shared_ptr<PeerCapabilities> peer_capabilities_;
+  std::shared_ptr<ProcessBackend> process_backend_;
+  std::shared_ptr<SendQueues> send_queues_;
   std::once_flag stop_all_flag_;
   const tcp::Port kListeningPort_;
   const boost::filesystem::path kVaultExecutablePath_;
+  const OnVaultEventFunctor kOnVaultEvent_;
+  const SerialiseVaultConfigFunctor kSerialiseVaultConfig_;
   std::vector<Child> vaults_;
+  // Vaults which connected without reading their config channel (e.g. built before it existed),
+  // so are asked for their config over TCP once restarted.
+  std::set<NonEmptyString> labels_without_config_channel_;
 };
 
 }  // namespace vault_manager
@@ -0,0 +1,191 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/public_pmid_table.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#include "boost/filesystem/operations.hpp"
+#include "boost/interprocess/file_mapping.hpp"
+#include "boost/interprocess/mapped_region.hpp"
+
+#include "maidsafe/common/crypto.h"
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/utils.h"
+
+namespace fs = boost::filesystem;
+namespace bi = boost::interprocess;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace {
+
+// The file is laid out as: magic (8 bytes), checksum (SHA-512 of everything after the header, 64
+// bytes), count (4 bytes big-endian), then 'count' index entries of name (64 bytes), offset and
+// size (each 4 bytes big-endian, the offset being from the start of the file) sorted by name, then
+// the serialised keys.
+const char kMagic[] = "PMIDTBL1";
+const std::size_t kMagicSize(8);
+const std::size_t kChecksumSize(64);
+const std::size_t kCountSize(4);
+const std::size_t kHeaderSize(kMagicSize + kChecksumSize + kCountSize);
+const std::size_t kNameSize(identity_size);
+const std::size_t kEntrySize(kNameSize + 8);
+
+void AppendUint32(uint32_t value, std::string& output) {
+  for (int shift(24); shift >= 0; shift -= 8)
+    output.push_back(static_cast<char>((value >> shift) & 0xff));
+}
+
+uint32_t ReadUint32(const unsigned char* input) {
+  return (static_cast<uint32_t>(input[0]) << 24) | (static_cast<uint32_t>(input[1]) << 16) |
+         (static_cast<uint32_t>(input[2]) << 8) | static_cast<uint32_t>(input[3]);
+}
+
+maidsafe_error MalformedError(const fs::path& path) {
+  LOG(kError) << "Public PMID table " << path << " is malformed.";
+  return MakeError(CommonErrors::parsing_error);
+}
+
+}  // unnamed namespace
+
+std::string PublicPmidTable::Write(const fs::path& path,
+                                   const std::vector<passport::PublicPmid>& public_pmids) {
+  std::vector<std::pair<std::string, std::string>> entries;
+  entries.reserve(public_pmids.size());
+  for (const auto& public_pmid : public_pmids) {
+    entries.emplace_back(public_pmid.name().value.string(),
+                         public_pmid.Serialise().value.string());
+  }
+  std::sort(std::begin(entries), std::end(entries));
+
+  std::string body;
+  AppendUint32(static_cast<uint32_t>(entries.size()), body);
+  std::size_t offset(kHeaderSize + entries.size() * kEntrySize);
+  for (const auto& entry : entries) {
+    if (offset + entry.second.size() > std::numeric_limits<uint32_t>::max())
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::cannot_exceed_limit));
+    body += entry.first;
+    AppendUint32(static_cast<uint32_t>(offset), body);
+    AppendUint32(static_cast<uint32_t>(entry.second.size()), body);
+    offset += entry.second.size();
+  }
+  for (const auto& entry : entries)
+    body += entry.second;
+
+  // The count is covered by the checksum, so it's hashed from the start of 'body'.
+  std::string checksum(crypto::Hash<crypto::SHA512>(body).string());
+  // Written under a temporary name and renamed so vaults mapping an existing table never see a
+  // partially-written one.
+  fs::path temp_path(path.string() + ".tmp");
+  if (!WriteFile(temp_path, std::string(kMagic, kMagicSize) + checksum + body)) {
+    LOG(kError) << "Failed to write public PMID table to " << temp_path;
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  }
+  fs::rename(temp_path, path);
+  return checksum;
+}
+
+PublicPmidTable::PublicPmidTable(const fs::path& path, const std::string& checksum)
+    : region_(), begin_(nullptr), size_(0), count_(0) {
+  try {
+    bi::file_mapping file(path.string().c_str(), bi::read_only);
+    region_ = std::make_shared<bi::mapped_region>(file, bi::read_only);
+  } catch (const bi::interprocess_exception& error) {
+    LOG(kError) << "Failed to map public PMID table " << path << ": " << error.what();
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  }
+  begin_ = static_cast<const unsigned char*>(region_->get_address());
+  size_ = region_->get_size();
+
+  // The body is hashed to check it against the checksum, which costs time linear in the size of the
+  // file, but far less than parsing the keys would.  Each key is also checked against its indexed
+  // name when it's parsed.
+  if (size_ < kHeaderSize || std::memcmp(begin_, kMagic, kMagicSize) != 0)
+    BOOST_THROW_EXCEPTION(MalformedError(path));
+  if (checksum.size() != kChecksumSize ||
+      std::memcmp(begin_ + kMagicSize, checksum.data(), kChecksumSize) != 0) {
+    LOG(kError) << "Public PMID table " << path << " doesn't match the expected checksum.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+  }
+  const unsigned char* body(begin_ + kMagicSize + kChecksumSize);
+  if (crypto::Hash<crypto::SHA512>(std::string(reinterpret_cast<const char*>(body),
+                                               size_ - kMagicSize - kChecksumSize)).string() !=
+      checksum) {
+    LOG(kError) << "Public PMID table " << path << " is corrupt.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::hashing_error));
+  }
+  count_ = ReadUint32(begin_ + kMagicSize + kChecksumSize);
+  if ((size_ - kHeaderSize) / kEntrySize < count_)
+    BOOST_THROW_EXCEPTION(MalformedError(path));
+  for (std::size_t i(0); i < count_; ++i) {
+    const unsigned char* entry(Entry(i));
+    std::size_t offset(ReadUint32(entry + kNameSize)), length(ReadUint32(entry + kNameSize + 4));
+    if (length == 0 || offset > size_ || length > size_ - offset)
+      BOOST_THROW_EXCEPTION(MalformedError(path));
+  }
+}
+
+passport::PublicPmid PublicPmidTable::Find(const passport::PublicPmid::Name& name) const {
+  const std::string& wanted(name.value.string());
+  std::size_t low(0), high(count_);
+  while (low < high) {
+    std::size_t middle(low + (high - low) / 2);
+    int result(std::memcmp(Entry(middle), wanted.data(), kNameSize));
+    if (result == 0)
+      return Parse(Entry(middle));
+    if (result < 0)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+  LOG(kWarning) << "No PublicPmid " << HexSubstr(name.value) << " in public PMID table.";
+  BOOST_THROW_EXCEPTION(MakeError(CommonErrors::no_such_element));
+}
+
+std::vector<passport::PublicPmid> PublicPmidTable::GetAll() const {
+  std::vector<passport::PublicPmid> public_pmids;
+  public_pmids.reserve(count_);
+  for (std::size_t i(0); i < count_; ++i)
+    public_pmids.emplace_back(Parse(Entry(i)));
+  return public_pmids;
+}
+
+const unsigned char* PublicPmidTable::Entry(std::size_t index) const {
+  return begin_ + kHeaderSize + index * kEntrySize;
+}
+
+passport::PublicPmid PublicPmidTable::Parse(const unsigned char* entry) const {
+  const char* name(reinterpret_cast<const char*>(entry));
+  const char* serialised(reinterpret_cast<const char*>(begin_) + ReadUint32(entry + kNameSize));
+  // The PublicPmid constructor throws if the serialised key doesn't hash to 'name'.
+  return passport::PublicPmid(
+      passport::PublicPmid::Name(Identity(std::string(name, kNameSize))),
+      passport::PublicPmid::serialised_type(
+          NonEmptyString(std::string(serialised, ReadUint32(entry + kNameSize + 4)))));
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,150 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/re_exec.h"
+
+#ifndef MAIDSAFE_WIN32
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+const std::string kInheritedListenerFdOption("--inherited_listener_fd");
+
+#ifndef MAIDSAFE_WIN32
+
+namespace {
+
+int MaxDescriptor() {
+  rlimit limit;
+  if (getrlimit(RLIMIT_NOFILE, &limit) != 0 || limit.rlim_cur == RLIM_INFINITY)
+    return 1024;
+  return static_cast<int>(std::min<rlim_t>(limit.rlim_cur, 65536));
+}
+
+// Returns 0 if 'fd' isn't a listening TCP socket.
+tcp::Port ListeningPort(int fd) {
+  int accepting(0);
+  socklen_t length(sizeof(accepting));
+  if (getsockopt(fd, SOL_SOCKET, SO_ACCEPTCONN, &accepting, &length) != 0 || !accepting)
+    return 0;
+  sockaddr_storage address;
+  length = sizeof(address);
+  if (getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) != 0)
+    return 0;
+  if (address.ss_family == AF_INET)
+    return ntohs(reinterpret_cast<const sockaddr_in*>(&address)->sin_port);
+  if (address.ss_family == AF_INET6)
+    return ntohs(reinterpret_cast<const sockaddr_in6*>(&address)->sin6_port);
+  return 0;
+}
+
+void SetCloseOnExec(int fd, bool close_on_exec) {
+  int flags(fcntl(fd, F_GETFD));
+  if (flags == -1)
+    return;
+  fcntl(fd, F_SETFD, close_on_exec ? (flags | FD_CLOEXEC) : (flags & ~FD_CLOEXEC));
+}
+
+}  // unnamed namespace
+
+void ReExec(const boost::filesystem::path& executable, std::vector<std::string> args,
+            int listener_fd) {
+  if (ListeningPort(listener_fd) == 0) {
+    LOG(kError) << "Descriptor " << listener_fd << " isn't a listening socket.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+  }
+  // Vault and client connections in particular must be closed, or their peers won't notice that
+  // this VaultManager has gone.
+  for (int fd(3), max_fd(MaxDescriptor()); fd < max_fd; ++fd)
+    SetCloseOnExec(fd, fd != listener_fd);
+
+  args.erase(std::remove_if(std::begin(args), std::end(args),
+                            [](const std::string& arg) {
+                              return arg.compare(0, kInheritedListenerFdOption.size(),
+                                                 kInheritedListenerFdOption) == 0;
+                            }),
+             std::end(args));
+  args.insert(std::begin(args), executable.string());
+  args.push_back(kInheritedListenerFdOption + "=" + std::to_string(listener_fd));
+  std::vector<char*> argv;
+  for (auto& arg : args)
+    argv.push_back(&arg[0]);
+  argv.push_back(nullptr);
+
+  LOG(kInfo) << "Re-executing " << executable << " with listening socket " << listener_fd;
+  execv(executable.string().c_str(), argv.data());
+  LOG(kError) << "Failed to re-execute " << executable << ": " << std::strerror(errno);
+  SetCloseOnExec(listener_fd, true);
+  BOOST_THROW_EXCEPTION(MakeError(CommonErrors::unable_to_handle_request));
+}
+
+asio::ip::tcp::acceptor AdoptInheritedListener(asio::io_service& io_service, int listener_fd) {
+  sockaddr_storage address;
+  socklen_t length(sizeof(address));
+  tcp::Port port(ListeningPort(listener_fd));
+  if (port == 0 || getsockname(listener_fd, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+    LOG(kError) << "Inherited descriptor " << listener_fd << " isn't a listening socket.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+  }
+  SetCloseOnExec(listener_fd, true);
+  asio::ip::tcp::acceptor acceptor(io_service);
+  std::error_code error;
+  acceptor.assign(address.ss_family == AF_INET6 ? asio::ip::tcp::v6() : asio::ip::tcp::v4(),
+                  listener_fd, error);
+  if (error) {
+    LOG(kError) << "Failed to adopt inherited descriptor " << listener_fd << ": "
+                << error.message();
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+  }
+  LOG(kInfo) << "Took over port " << port << " from the previous process image.";
+  return acceptor;
+}
+
+#else
+
+void ReExec(const boost::filesystem::path& /*executable*/, std::vector<std::string> /*args*/,
+            int /*listener_fd*/) {
+  LOG(kError) << "Re-executing the VaultManager isn't supported on this platform.";
+  BOOST_THROW_EXCEPTION(MakeError(CommonErrors::unable_to_handle_request));
+}
+
+asio::ip::tcp::acceptor AdoptInheritedListener(asio::io_service& /*io_service*/,
+                                               int /*listener_fd*/) {
+  BOOST_THROW_EXCEPTION(MakeError(CommonErrors::unable_to_handle_request));
+}
+
+#endif
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
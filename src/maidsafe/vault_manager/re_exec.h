@@ -0,0 +1,55 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_RE_EXEC_H_
+#define MAIDSAFE_VAULT_MANAGER_RE_EXEC_H_
+
+#include <string>
+#include <vector>
+
+#include "asio/io_service.hpp"
+#include "asio/ip/tcp.hpp"
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/tcp/connection.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Support for replacing the running vault_manager binary in place (POSIX only).  The listening
+// socket is inherited across exec() so that the port stays bound throughout, and clients never
+// find it closed and move on to a different VaultManager further up the port range.
+
+extern const std::string kInheritedListenerFdOption;
+
+// Replaces the process image with 'executable', passing 'args' (excluding the program name and any
+// previous kInheritedListenerFdOption) and 'listener_fd'.  Every other descriptor is closed on
+// exec.  Only returns (by throwing) on failure.
+void ReExec(const boost::filesystem::path& executable, std::vector<std::string> args,
+            int listener_fd);
+
+// Called by the new process image.  Returns an acceptor which has adopted the inherited socket, so
+// the port is never unbound and connections queued during the exec() are accepted afterwards.
+asio::ip::tcp::acceptor AdoptInheritedListener(asio::io_service& io_service, int listener_fd);
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_RE_EXEC_H_
@@ -25,15 +25,13 @@
 #include <mutex>
 #include <string>
 
-#include "asio/error.hpp"
-#include "asio/io_service.hpp"
-#include "asio/steady_timer.hpp"
 #include "boost/exception/diagnostic_information.hpp"
 
 #include "maidsafe/common/error.h"
 #include "maidsafe/common/log.h"
 
 #include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/timing_wheel.h"
 #include "maidsafe/vault_manager/utils.h"
 
 namespace maidsafe {
@@ -44,9 +42,7 @@ namespace detail {
 
 template <typename ResultType, typename MessageType>
 struct PromiseAndTimer {
-  PromiseAndTimer(asio::io_service& io_service,
-                  const std::chrono::steady_clock::duration& timeout = kRpcTimeout)
-      : promise(), timer(io_service, timeout), once_flag() {}
+  PromiseAndTimer() : promise(), timer_id(0), once_flag() {}
 
   void SetValue(ResultType&& result) {
     std::call_once(once_flag, [&] { this->promise.set_value(std::move(result)); });
@@ -67,7 +63,7 @@ struct PromiseAndTimer {
   }
 
   std::promise<ResultType> promise;
-  Timer timer;
+  TimingWheel::TimerId timer_id;
   std::once_flag once_flag;
 };
 
@@ -75,11 +71,18 @@ struct PromiseAndTimer {
 
 template <typename ResultType, typename MessageType>
 std::future<ResultType> SetResponseCallback(std::function<void(MessageType&&)>& callback,
-                                            asio::io_service& io_service, std::mutex& mutex) {
-  auto promise_and_timer =
-      std::make_shared<detail::PromiseAndTimer<ResultType, MessageType>>(io_service);
+                                            std::shared_ptr<TimingWheel> timing_wheel,
+                                            std::mutex& mutex) {
+  auto promise_and_timer = std::make_shared<detail::PromiseAndTimer<ResultType, MessageType>>();
+  auto timer_id(timing_wheel->Add(kRpcTimeout, [=, &callback, &mutex] {
+    std::lock_guard<std::mutex> lock{mutex};
+    if (callback)
+      callback = nullptr;
+    promise_and_timer->SetException(MakeError(VaultManagerErrors::timed_out));
+  }));
   {
     std::lock_guard<std::mutex> lock{mutex};
+    promise_and_timer->timer_id = timer_id;
     auto callback_copy(callback);
     callback = [=](MessageType&& message) {
       try {
@@ -90,20 +93,9 @@ std::future<ResultType> SetResponseCallback(std::function<void(MessageType&&)>&
       }
       if (callback_copy)
         callback_copy(std::move(message));
-      promise_and_timer->timer.cancel();
+      timing_wheel->Cancel(promise_and_timer->timer_id);
     };
   }
-  promise_and_timer->timer.async_wait([=, &callback, &mutex](const std::error_code& ec) {
-    if (ec && ec == asio::error::operation_aborted)
-      return;
-    std::lock_guard<std::mutex> lock{mutex};
-    if (callback)
-      callback = nullptr;
-    if (ec)
-      promise_and_timer->SetException(ec);
-    else
-      promise_and_timer->SetException(MakeError(VaultManagerErrors::timed_out));
-  });
   return promise_and_timer->promise.get_future();
 }
 
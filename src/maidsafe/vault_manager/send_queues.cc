@@ -0,0 +1,89 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/send_queues.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "boost/exception/diagnostic_information.hpp"
+
+#include "maidsafe/common/log.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace {
+
+void DoSend(tcp::ConnectionPtr connection, tcp::Message message) {
+  try {
+    connection->Send(std::move(message));
+  } catch (const std::exception& e) {
+    LOG(kError) << "Failed to send message: " << boost::diagnostic_information(e);
+  }
+}
+
+}  // unnamed namespace
+
+SendQueues::Slot SendQueues::Reserve(tcp::ConnectionPtr connection) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  Entry entry{++next_slot_, false, tcp::Message()};
+  queues_[connection].push_back(std::move(entry));
+  return next_slot_;
+}
+
+void SendQueues::Fill(tcp::ConnectionPtr connection, Slot slot, tcp::Message message) {
+  // Sending while holding the lock keeps concurrent senders in order.  tcp::Connection::Send only
+  // queues the message, so this doesn't block.
+  std::lock_guard<std::mutex> lock{mutex_};
+  auto queue(queues_.find(connection));
+  if (queue == std::end(queues_))
+    return;  // The connection has closed.
+  auto entry(std::find_if(std::begin(queue->second), std::end(queue->second),
+                          [slot](const Entry& entry) { return entry.slot == slot; }));
+  if (entry == std::end(queue->second))
+    return;
+  entry->ready = true;
+  entry->message = std::move(message);
+  while (!queue->second.empty() && queue->second.front().ready) {
+    if (!queue->second.front().message.empty())
+      DoSend(connection, std::move(queue->second.front().message));
+    queue->second.pop_front();
+  }
+  if (queue->second.empty())
+    queues_.erase(queue);
+}
+
+void SendQueues::Send(tcp::ConnectionPtr connection, tcp::Message message) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  auto queue(queues_.find(connection));
+  if (queue == std::end(queues_))
+    return DoSend(connection, std::move(message));
+  Entry entry{0, true, std::move(message)};
+  queue->second.push_back(std::move(entry));
+}
+
+void SendQueues::Remove(tcp::ConnectionPtr connection) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  queues_.erase(connection);
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
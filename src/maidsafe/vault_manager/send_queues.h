@@ -0,0 +1,74 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_SEND_QUEUES_H_
+#define MAIDSAFE_VAULT_MANAGER_SEND_QUEUES_H_
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "maidsafe/common/tcp/connection.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Keeps the messages sent on each connection in the order in which they were sent, even when some
+// of them are still being built (serialised and encrypted) by the crypto workers.  A message sent
+// while an earlier one on the same connection is still being built is held back until that one has
+// been sent.  Only connections with a message being built are tracked.  Threadsafe.
+class SendQueues {
+ public:
+  typedef uint64_t Slot;
+
+  SendQueues() : mutex_(), next_slot_(0), queues_() {}
+
+  SendQueues(const SendQueues&) = delete;
+  SendQueues(SendQueues&&) = delete;
+  SendQueues& operator=(SendQueues) = delete;
+
+  // Reserves the connection's next place in the send order for a message still being built.
+  Slot Reserve(tcp::ConnectionPtr connection);
+  // Sends 'message' in the place reserved as 'slot', followed by any messages held back behind it.
+  // An empty 'message' (i.e. building it failed) just gives up the place.
+  void Fill(tcp::ConnectionPtr connection, Slot slot, tcp::Message message);
+  // Sends 'message' now, unless it must wait behind a message still being built.
+  void Send(tcp::ConnectionPtr connection, tcp::Message message);
+  // Drops any messages held back for the connection.
+  void Remove(tcp::ConnectionPtr connection);
+
+ private:
+  struct Entry {
+    Slot slot;
+    bool ready;
+    tcp::Message message;
+  };
+
+  mutable std::mutex mutex_;
+  Slot next_slot_;
+  std::map<tcp::ConnectionPtr, std::deque<Entry>, std::owner_less<tcp::ConnectionPtr>> queues_;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_SEND_QUEUES_H_
@@ -0,0 +1,143 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/session_tickets.h"
+
+#include <cstdint>
+
+#include "cryptopp/hmac.h"
+#include "cryptopp/sha.h"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace {
+
+// A ticket is laid out as: Maid name (64 bytes), id (8 bytes big-endian), expiry (seconds since
+// epoch, 8 bytes big-endian), MAC (64 bytes).
+const std::size_t kNameSize(64);
+const std::size_t kIdSize(8);
+const std::size_t kExpirySize(8);
+const std::size_t kMacSize(CryptoPP::HMAC<CryptoPP::SHA512>::DIGESTSIZE);
+const std::size_t kPayloadSize(kNameSize + kIdSize + kExpirySize);
+
+int64_t SecondsSinceEpoch() {
+  return std::chrono::duration_cast<std::chrono::seconds>(
+             std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::string Encode(uint64_t value) {
+  std::string encoded(sizeof(value), 0);
+  for (std::size_t i(0); i < sizeof(value); ++i, value >>= 8)
+    encoded[sizeof(value) - 1 - i] = static_cast<char>(value & 0xff);
+  return encoded;
+}
+
+uint64_t Decode(const std::string& encoded) {
+  uint64_t value(0);
+  for (std::size_t i(0); i < sizeof(value); ++i)
+    value = (value << 8) | static_cast<unsigned char>(encoded[i]);
+  return value;
+}
+
+// Compares in time independent of where the first difference lies.
+bool ConstantTimeEqual(const std::string& lhs, const std::string& rhs) {
+  if (lhs.size() != rhs.size())
+    return false;
+  unsigned char difference(0);
+  for (std::size_t i(0); i < lhs.size(); ++i)
+    difference |= static_cast<unsigned char>(lhs[i] ^ rhs[i]);
+  return difference == 0;
+}
+
+}  // unnamed namespace
+
+SessionTickets::SessionTickets(std::chrono::seconds lifetime, std::size_t max_outstanding)
+    : kLifetime_(lifetime),
+      kMaxOutstanding_(max_outstanding),
+      kKey_(RandomString(kMacSize)),
+      mutex_(),
+      next_id_(0),
+      outstanding_() {}
+
+std::string SessionTickets::Issue(const MaidName& maid_name) {
+  const int64_t kNow{SecondsSinceEpoch()};
+  TicketKey ticket_key;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    ticket_key = TicketKey{kNow + kLifetime_.count(), ++next_id_};
+    PruneOutstanding(kNow);
+    if (outstanding_.size() >= kMaxOutstanding_)
+      outstanding_.erase(std::begin(outstanding_));
+    outstanding_.insert(ticket_key);
+  }
+  std::string payload(maid_name->string() + Encode(ticket_key.second) +
+                      Encode(static_cast<uint64_t>(ticket_key.first)));
+  return payload + Mac(payload);
+}
+
+SessionTickets::MaidName SessionTickets::Redeem(const std::string& ticket) {
+  if (ticket.size() != kPayloadSize + kMacSize) {
+    LOG(kWarning) << "Session ticket has wrong size: " << ticket.size();
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+  }
+  std::string payload(ticket.substr(0, kPayloadSize));
+  if (!ConstantTimeEqual(Mac(payload), ticket.substr(kPayloadSize))) {
+    LOG(kWarning) << "Session ticket failed authentication.";
+    BOOST_THROW_EXCEPTION(MakeError(VaultManagerErrors::unvalidated_client));
+  }
+  const TicketKey kTicketKey{static_cast<int64_t>(Decode(payload.substr(kNameSize + kIdSize))),
+                             Decode(payload.substr(kNameSize, kIdSize))};
+  const int64_t kNow{SecondsSinceEpoch()};
+  if (kTicketKey.first < kNow) {
+    LOG(kInfo) << "Session ticket has expired.";
+    BOOST_THROW_EXCEPTION(MakeError(VaultManagerErrors::unvalidated_client));
+  }
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    PruneOutstanding(kNow);
+    if (outstanding_.erase(kTicketKey) == 0) {
+      LOG(kWarning) << "Session ticket has already been redeemed.";
+      BOOST_THROW_EXCEPTION(MakeError(VaultManagerErrors::unvalidated_client));
+    }
+  }
+  return MaidName(Identity(payload.substr(0, kNameSize)));
+}
+
+std::string SessionTickets::Mac(const std::string& payload) const {
+  CryptoPP::HMAC<CryptoPP::SHA512> hmac(reinterpret_cast<const byte*>(kKey_.data()),
+                                        kKey_.size());
+  std::string mac(kMacSize, 0);
+  hmac.CalculateDigest(reinterpret_cast<byte*>(&mac[0]),
+                       reinterpret_cast<const byte*>(payload.data()), payload.size());
+  return mac;
+}
+
+void SessionTickets::PruneOutstanding(int64_t now) {
+  while (!outstanding_.empty() && std::begin(outstanding_)->first < now)
+    outstanding_.erase(std::begin(outstanding_));
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,76 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_SESSION_TICKETS_H_
+#define MAIDSAFE_VAULT_MANAGER_SESSION_TICKETS_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+
+#include "maidsafe/passport/types.h"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Issues and redeems the short-lived tickets which let a client that has already answered a
+// challenge reconnect without another RSA signature check.  A ticket holds the client's Maid name,
+// a unique id and its expiry time, authenticated by HMAC-SHA512 under a key which is random per
+// instance, so tickets don't outlive the VaultManager which issued them.  Each ticket can only be
+// redeemed once, so one captured in transit can't be replayed after the client has used it; a
+// client is issued a fresh ticket each time it redeems one.  At most 'max_outstanding' unredeemed
+// tickets are remembered, the oldest being forgotten first.  Threadsafe.
+class SessionTickets {
+ public:
+  typedef passport::PublicMaid::Name MaidName;
+
+  explicit SessionTickets(std::chrono::seconds lifetime = kSessionTicketLifetime,
+                          std::size_t max_outstanding = kMaxOutstandingSessionTickets);
+
+  std::string Issue(const MaidName& maid_name);
+  // Throws if the ticket is malformed, has been tampered with, has expired or has already been
+  // redeemed.
+  MaidName Redeem(const std::string& ticket);
+
+ private:
+  // Expiry, then id.
+  typedef std::pair<int64_t, uint64_t> TicketKey;
+
+  std::string Mac(const std::string& payload) const;
+  void PruneOutstanding(int64_t now);
+
+  const std::chrono::seconds kLifetime_;
+  const std::size_t kMaxOutstanding_;
+  const std::string kKey_;
+  std::mutex mutex_;
+  uint64_t next_id_;
+  std::set<TicketKey> outstanding_;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_SESSION_TICKETS_H_
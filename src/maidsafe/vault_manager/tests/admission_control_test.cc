@@ -0,0 +1,79 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/admission_control.h"
+
+#include "maidsafe/common/test.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+TEST(AdmissionControlTest, BEH_RateLimit) {
+  AdmissionControl::Limits limits;
+  limits.max_new_connections_per_second = 2;
+  limits.max_pending_connections = 1;
+  AdmissionControl admission_control{limits};
+  EXPECT_EQ(AdmissionControl::Admission::kAccept, admission_control.AdmitConnection(0));
+  EXPECT_EQ(AdmissionControl::Admission::kAcceptAfterEvictingOldest,
+            admission_control.AdmitConnection(1));
+  EXPECT_EQ(AdmissionControl::Admission::kReject, admission_control.AdmitConnection(0));
+
+  AdmissionControl::Stats stats{admission_control.GetStats()};
+  EXPECT_EQ(2U, stats.admitted_connections);
+  EXPECT_EQ(1U, stats.rejected_connections);
+  EXPECT_EQ(1U, stats.evicted_connections);
+}
+
+TEST(AdmissionControlTest, BEH_ReserveForAwaitedVaults) {
+  AdmissionControl::Limits limits;
+  limits.max_new_connections_per_second = 1;
+  limits.max_pending_connections = 1;
+  AdmissionControl admission_control{limits};
+  EXPECT_EQ(AdmissionControl::Admission::kAccept, admission_control.AdmitConnection(0, 1));
+
+  // Beyond the rate limit, connections are only admitted while vaults are awaited.
+  EXPECT_EQ(AdmissionControl::Admission::kReject, admission_control.AdmitConnection(0, 0));
+  EXPECT_EQ(AdmissionControl::Admission::kAcceptVaultOnly,
+            admission_control.AdmitConnection(0, 1));
+  EXPECT_EQ(AdmissionControl::Admission::kAcceptVaultOnlyAfterEvictingOldest,
+            admission_control.AdmitConnection(1, 1));
+
+  AdmissionControl::Stats stats{admission_control.GetStats()};
+  EXPECT_EQ(1U, stats.admitted_connections);
+  EXPECT_EQ(1U, stats.rejected_connections);
+  EXPECT_EQ(2U, stats.vault_only_connections);
+  EXPECT_EQ(1U, stats.evicted_connections);
+}
+
+TEST(AdmissionControlTest, BEH_Challenges) {
+  AdmissionControl::Limits limits;
+  limits.max_outstanding_challenges = 2;
+  AdmissionControl admission_control{limits};
+  EXPECT_TRUE(admission_control.AdmitChallenge(1));
+  EXPECT_FALSE(admission_control.AdmitChallenge(2));
+  EXPECT_EQ(1U, admission_control.GetStats().rejected_challenges);
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,186 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "asio/io_service.hpp"
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/crypto.h"
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/process.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/passport/passport.h"
+
+#include "maidsafe/vault_manager/clock.h"
+#include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/process_backend.h"
+#include "maidsafe/vault_manager/process_manager.h"
+#include "maidsafe/vault_manager/timing_wheel.h"
+#include "maidsafe/vault_manager/utils.h"
+#include "maidsafe/vault_manager/vault_config.h"
+#include "maidsafe/vault_manager/vault_info.h"
+#include "maidsafe/vault_manager/messages/vault_started_response.h"
+#include "maidsafe/vault_manager/tests/behaviour_simulator.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+TEST(BehaviourProfileTest, BEH_ParseAndSerialise) {
+  VaultConfig::BehaviourProfile profile{ParseBehaviourProfile("")};
+  EXPECT_EQ(0, profile.startup_delay_max.count());
+  EXPECT_EQ(0U, profile.resident_bytes);
+  EXPECT_LT(profile.joined_network_delay.count(), 0);
+
+  profile = ParseBehaviourProfile(
+      "startup_delay_ms=100-2000,resident_mb=64,log_lines_per_second=10,"
+      "crash_probability_per_minute=0.25,shutdown_delay_ms=500,joined_network_delay_ms=1000");
+  EXPECT_EQ(100, profile.startup_delay_min.count());
+  EXPECT_EQ(2000, profile.startup_delay_max.count());
+  EXPECT_EQ(64U * 1024 * 1024, profile.resident_bytes);
+  EXPECT_EQ(10U, profile.log_lines_per_second);
+  EXPECT_DOUBLE_EQ(0.25, profile.crash_probability_per_minute);
+  EXPECT_EQ(500, profile.shutdown_delay.count());
+  EXPECT_EQ(1000, profile.joined_network_delay.count());
+
+  // A single startup delay is used as both bounds.
+  EXPECT_EQ(300, ParseBehaviourProfile("startup_delay_ms=300").startup_delay_max.count());
+
+  EXPECT_THROW(ParseBehaviourProfile("resident_mb"), maidsafe_error);
+  EXPECT_THROW(ParseBehaviourProfile("resident_mb=lots"), maidsafe_error);
+  EXPECT_THROW(ParseBehaviourProfile("shutdown_delay_ms=5s"), maidsafe_error);
+  EXPECT_THROW(ParseBehaviourProfile("startup_delay_ms=200-100"), maidsafe_error);
+  EXPECT_THROW(ParseBehaviourProfile("crash_probability_per_minute=2"), maidsafe_error);
+  EXPECT_THROW(ParseBehaviourProfile("unknown=1"), maidsafe_error);
+  EXPECT_THROW(ParseBehaviourProfile("resident_mb=-1"), maidsafe_error);
+  EXPECT_THROW(ParseBehaviourProfile("resident_mb=17592186044416"), maidsafe_error);  // 2^64 bytes
+  EXPECT_THROW(ParseBehaviourProfile("log_lines_per_second=-1"), maidsafe_error);
+  EXPECT_THROW(ParseBehaviourProfile("log_lines_per_second=4294967296"), maidsafe_error);
+  EXPECT_THROW(ParseBehaviourProfile("log_lines_per_second=+1"), maidsafe_error);
+
+  const auto parsed(ConvertFromString<VaultConfig::BehaviourProfile>(ConvertToString(profile)));
+  EXPECT_EQ(profile.startup_delay_min, parsed.startup_delay_min);
+  EXPECT_EQ(profile.startup_delay_max, parsed.startup_delay_max);
+  EXPECT_EQ(profile.resident_bytes, parsed.resident_bytes);
+  EXPECT_EQ(profile.log_lines_per_second, parsed.log_lines_per_second);
+  EXPECT_DOUBLE_EQ(profile.crash_probability_per_minute, parsed.crash_probability_per_minute);
+  EXPECT_EQ(profile.shutdown_delay, parsed.shutdown_delay);
+  EXPECT_EQ(profile.joined_network_delay, parsed.joined_network_delay);
+}
+
+#ifndef MAIDSAFE_WIN32
+// Runs a vault's lifecycle against a simulated process, from the config handed to it when spawned
+// to its exit.  The profile set by the test reaches the vault, and a certain crash makes the vault
+// exit with the non-zero code returned by WaitForExit, so it's restarted as after a real crash.
+TEST(BehaviourProfileTest, BEH_SimulatedCrashRestartsVault) {
+  SetBehaviourProfile(ParseBehaviourProfile("resident_mb=1,crash_probability_per_minute=1"));
+  asio::io_service io_service;
+  auto clock(std::make_shared<SimulatedClock>());
+  auto process_backend(std::make_shared<SimulatedProcessBackend>(io_service));
+  const crypto::AES256Key symm_key{RandomString(crypto::AES256_KeySize)};
+  const crypto::AES256InitialisationVector symm_iv{RandomString(crypto::AES256_IVSize)};
+  std::vector<tcp::Message> handed_off_configs;
+  std::vector<std::pair<VaultEventType, int>> events;
+  std::shared_ptr<ProcessManager> process_manager{ProcessManager::MakeShared(
+      io_service, process::GetOtherExecutablePath("dummy_vault"), tcp::Port{7777},
+      [&](const VaultInfo&, VaultEventType type, int exit_code) {
+        events.emplace_back(type, exit_code);
+      },
+      TimingWheel::MakeShared(io_service, kTimingWheelResolution, clock), nullptr,
+      // As VaultManager::SerialiseVaultConfig, but without the crypto workers.
+      [&](const VaultInfo& vault_info, std::function<void(tcp::Message)> on_serialised) {
+        VaultStartedResponse response(vault_info, symm_key, symm_iv);
+        handed_off_configs.push_back(Serialise(VaultStartedResponse::tag, std::move(response)));
+        on_serialised(handed_off_configs.back());
+      },
+      process_backend)};
+  auto poll([&] {
+    io_service.reset();
+    io_service.poll();
+  });
+  // As VaultInterface::ReadHandedOffConfig.
+  auto read_config([](const tcp::Message& message) {
+    InputVectorStream binary_input_stream(message);
+    MessageTag tag(static_cast<MessageTag>(-1));
+    Parse(binary_input_stream, tag);
+    EXPECT_EQ(MessageTag::kVaultStartedResponse, tag);
+    auto vault_started_response(Parse<VaultStartedResponse>(binary_input_stream));
+    return std::make_pair(detail::GetValue(vault_started_response),
+                          vault_started_response.adoption_token);
+  });
+
+  VaultInfo vault_info;
+  vault_info.pmid_and_signer =
+      std::make_shared<passport::PmidAndSigner>(passport::CreatePmidAndSigner());
+  vault_info.vault_dir = boost::filesystem::path{"simulated_vault"};
+  vault_info.label = GenerateLabel();
+  process_manager->AddProcess(vault_info);
+  poll();
+  ASSERT_EQ(1U, process_backend->SpawnCount());
+  ASSERT_EQ(1U, handed_off_configs.size());
+  auto config(read_config(handed_off_configs.back()));
+  EXPECT_EQ(1024U * 1024, config.first->test_config.behaviour_profile.resident_bytes);
+  EXPECT_DOUBLE_EQ(1.0, config.first->test_config.behaviour_profile.crash_probability_per_minute);
+  const ProcessId process_id(process_backend->Running().begin()->first);
+  EXPECT_NO_THROW(process_manager->HandleVaultStarted(nullptr, process_id, config.second));
+
+  std::atomic<bool> exiting{false};
+  std::promise<int> crash_exit_code;
+  auto wait_for_exit(crash_exit_code.get_future());
+  auto behaviour(SimulateBehaviour(*config.first, [] {},
+                                   [&](int exit_code) { crash_exit_code.set_value(exit_code); },
+                                   exiting));
+  ASSERT_EQ(std::future_status::ready, wait_for_exit.wait_for(std::chrono::seconds(10)));
+  behaviour.get();
+  const int exit_code(wait_for_exit.get());
+  EXPECT_NE(0, exit_code);
+  process_backend->Exit(process_id, exit_code);
+  poll();
+
+  ASSERT_EQ(1U, events.size());
+  EXPECT_EQ(VaultEventType::kRestarted, events.front().first);
+  EXPECT_EQ(kSimulatedCrashExitCode, events.front().second);
+  ASSERT_EQ(2U, process_backend->SpawnCount());
+  ASSERT_EQ(2U, handed_off_configs.size());
+  EXPECT_DOUBLE_EQ(1.0, read_config(handed_off_configs.back())
+                            .first->test_config.behaviour_profile.crash_probability_per_minute);
+
+  process_manager->StopAll();
+  poll();
+  EXPECT_TRUE(process_backend->Running().empty());
+  SetBehaviourProfile(VaultConfig::BehaviourProfile());
+}
+#endif
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,89 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/tests/behaviour_simulator.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+const int kSimulatedCrashExitCode{134};
+
+namespace {
+
+const std::chrono::milliseconds kBehaviourTick{100};
+
+}  // unnamed namespace
+
+std::future<void> SimulateBehaviour(const VaultConfig& config, std::function<void()> send_joined,
+                                    std::function<void(int exit_code)> crash,
+                                    std::atomic<bool>& exiting) {
+  const auto profile(config.test_config.behaviour_profile);
+  // Seed from the vault's own directory so that each vault behaves differently, but reproducibly.
+  std::mt19937_64 generator(std::hash<std::string>()(config.vault_dir.string()));
+  Sleep(std::chrono::milliseconds(std::uniform_int_distribution<int64_t>(
+      profile.startup_delay_min.count(), profile.startup_delay_max.count())(generator)));
+
+  return std::async(std::launch::async, [send_joined, crash, &exiting, profile,
+                                         generator]() mutable {
+    std::vector<char> resident(static_cast<std::size_t>(profile.resident_bytes), 1);
+    const double crash_probability_per_tick(
+        1.0 - std::pow(1.0 - profile.crash_probability_per_minute,
+                       std::chrono::duration<double>(kBehaviourTick) / std::chrono::minutes(1)));
+    std::bernoulli_distribution crashed(crash_probability_per_tick);
+    const auto started(std::chrono::steady_clock::now());
+    bool joined(profile.joined_network_delay.count() < 0);
+    double owed_log_lines(0.0);
+    uint64_t log_line_count(0);
+    while (!exiting) {
+      Sleep(kBehaviourTick);
+      if (!joined && std::chrono::steady_clock::now() - started >= profile.joined_network_delay) {
+        send_joined();
+        joined = true;
+      }
+      owed_log_lines += profile.log_lines_per_second *
+                        std::chrono::duration<double>(kBehaviourTick).count();
+      for (; owed_log_lines >= 1.0; owed_log_lines -= 1.0)
+        LOG(kInfo) << "Dummy vault log line " << log_line_count++ << " of " << resident.size()
+                   << " resident bytes.";
+      if (crashed(generator)) {
+        LOG(kWarning) << "Dummy vault simulating a crash.";
+        crash(kSimulatedCrashExitCode);
+        return;
+      }
+    }
+  });
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,52 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_TESTS_BEHAVIOUR_SIMULATOR_H_
+#define MAIDSAFE_VAULT_MANAGER_TESTS_BEHAVIOUR_SIMULATOR_H_
+
+#include <atomic>
+#include <functional>
+#include <future>
+
+#include "maidsafe/vault_manager/vault_config.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+// The exit code returned by WaitForExit when a simulated crash stops the vault.
+extern const int kSimulatedCrashExitCode;
+
+// Imitates a real vault's startup time, memory footprint, logging, crashes and JoinedNetwork as
+// described by the test config's behaviour profile.  Blocks for the startup delay, then returns a
+// future which becomes ready once 'exiting' is set or the vault crashes.  A dummy vault passes
+// VaultInterface::SendJoined as 'send_joined' and VaultInterface::Stop as 'crash', so a crash makes
+// WaitForExit return kSimulatedCrashExitCode.
+std::future<void> SimulateBehaviour(const VaultConfig& config, std::function<void()> send_joined,
+                                    std::function<void(int exit_code)> crash,
+                                    std::atomic<bool>& exiting);
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_TESTS_BEHAVIOUR_SIMULATOR_H_
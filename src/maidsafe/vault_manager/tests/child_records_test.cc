@@ -0,0 +1,67 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/child_records.h"
+
+#include <memory>
+#include <vector>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+TEST(ChildRecordsTest, BEH_WriteAndRead) {
+  std::shared_ptr<fs::path> test_dir{maidsafe::test::CreateTestPath("MaidSafe_TestChildRecords")};
+  fs::path path{*test_dir / "children.dat"};
+  EXPECT_TRUE(ReadChildRecords(path).empty());
+
+  std::vector<ChildRecord> child_records{
+      ChildRecord{NonEmptyString{"first"}, 1234, RandomString(32)},
+      ChildRecord{NonEmptyString{"second"}, 5678, RandomString(32)}};
+  WriteChildRecords(path, child_records);
+  std::vector<ChildRecord> read_records{ReadChildRecords(path)};
+  ASSERT_EQ(child_records.size(), read_records.size());
+  for (std::size_t i(0); i < child_records.size(); ++i) {
+    EXPECT_EQ(child_records[i].label, read_records[i].label);
+    EXPECT_EQ(child_records[i].process_id, read_records[i].process_id);
+    EXPECT_EQ(child_records[i].adoption_token, read_records[i].adoption_token);
+  }
+  // The tokens must not be readable by other users.
+  EXPECT_EQ(fs::owner_read | fs::owner_write, fs::status(path).permissions());
+
+  WriteChildRecords(path, std::vector<ChildRecord>{});
+  EXPECT_TRUE(ReadChildRecords(path).empty());
+
+  ASSERT_TRUE(WriteFile(path, "Not a list of child records"));
+  EXPECT_TRUE(ReadChildRecords(path).empty());
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -18,10 +18,18 @@
 
 #include "maidsafe/vault_manager/client_interface.h"
 
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <future>
 #include <memory>
+#include <thread>
 
+#include "asio/io_service.hpp"
 #include "boost/filesystem/path.hpp"
 
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/error.h"
 #include "maidsafe/common/process.h"
 #include "maidsafe/common/test.h"
 #include "maidsafe/common/utils.h"
@@ -52,8 +60,119 @@ TEST(ClientInterfaceTest, BEH_Basic) {
   {
     passport::MaidAndSigner maid_and_signer{passport::CreateMaidAndSigner()};
     ClientInterface client_interface{maid_and_signer.first};
+
+    // Concurrent requests for the same label must each get their own response.
+    NonEmptyString label{RandomAlphaNumericString(10)};
+    auto first(client_interface.TakeOwnership(label, *test_env_root_dir / "first", DiskUsage{1000},
+                                              std::chrono::seconds(10)));
+    auto second(client_interface.TakeOwnership(label, *test_env_root_dir / "second",
+                                               DiskUsage{1000}, std::chrono::seconds(10)));
+    EXPECT_NE(first.request_id, second.request_id);
+    for (auto* pending_request : {&first, &second}) {
+      try {
+        pending_request->result.get();
+        ADD_FAILURE() << "Taking ownership of non-existent vault should fail.";
+      } catch (const maidsafe_error& error) {
+        EXPECT_EQ(make_error_code(CommonErrors::no_such_element), error.code());
+      }
+    }
+    EXPECT_FALSE(client_interface.CancelRequest(first.request_id));
     LOG(kVerbose) << "Client stopping.";
   }
+
+  {
+    // The same, asynchronously on an io_service shared with other work.
+    AsioService asio_service{1};
+    passport::MaidAndSigner maid_and_signer{passport::CreateMaidAndSigner()};
+    ClientInterface client_interface{maid_and_signer.first, asio_service.service()};
+    std::promise<void> connected;
+    client_interface.AsyncConnect([&](std::exception_ptr error) {
+      EXPECT_FALSE(error);
+      connected.set_value();
+    });
+    ASSERT_EQ(std::future_status::ready, connected.get_future().wait_for(kRpcTimeout * 3));
+
+    std::promise<void> completed;
+    client_interface.AsyncTakeOwnership(
+        NonEmptyString{RandomAlphaNumericString(10)}, *test_env_root_dir / "async",
+        DiskUsage{1000}, std::chrono::seconds(10),
+        [&](std::exception_ptr error, std::unique_ptr<passport::PmidAndSigner> pmid_and_signer) {
+          EXPECT_FALSE(pmid_and_signer);
+          try {
+            std::rethrow_exception(error);
+          } catch (const maidsafe_error& e) {
+            EXPECT_EQ(make_error_code(CommonErrors::no_such_element), e.code());
+          } catch (...) {
+            ADD_FAILURE() << "Expected a maidsafe_error.";
+          }
+          completed.set_value();
+        });
+    EXPECT_EQ(std::future_status::ready,
+              completed.get_future().wait_for(std::chrono::seconds(10)));
+  }
+
+  {
+    // A second Maid authenticated over the same connection can act as the owner.
+    passport::MaidAndSigner maid_and_signer{passport::CreateMaidAndSigner()};
+    passport::MaidAndSigner other_maid_and_signer{passport::CreateMaidAndSigner()};
+    ClientInterface client_interface{maid_and_signer.first};
+    client_interface.AddMaid(other_maid_and_signer.first).get();
+
+    TakeOwnershipSpec spec{NonEmptyString{RandomAlphaNumericString(10)},
+                           *test_env_root_dir / "other", DiskUsage{1000}};
+    spec.owner = passport::PublicMaid(other_maid_and_signer.first).name();
+    try {
+      client_interface.TakeOwnership(spec, std::chrono::seconds(10)).result.get();
+      ADD_FAILURE() << "Taking ownership of non-existent vault should fail.";
+    } catch (const maidsafe_error& error) {
+      EXPECT_EQ(make_error_code(CommonErrors::no_such_element), error.code());
+    }
+
+    // Acting for a Maid which was never added is rejected.
+    spec.owner = passport::PublicMaid(passport::CreateMaidAndSigner().first).name();
+    try {
+      client_interface.TakeOwnership(spec, std::chrono::seconds(10)).result.get();
+      ADD_FAILURE() << "Acting for an unauthenticated Maid should fail.";
+    } catch (const maidsafe_error& error) {
+      EXPECT_EQ(make_error_code(VaultManagerErrors::unvalidated_client), error.code());
+    }
+  }
+}
+
+TEST(ClientInterfaceTest, BEH_FailedConnectReportsOnce) {
+  // With no VaultManager listening, the handler gets a single error, whether from the failed port
+  // scan or the session timer, and nothing is reported after it.
+  std::shared_ptr<fs::path> test_env_root_dir{
+      maidsafe::test::CreateTestPath("MaidSafe_TestClientInterface")};
+  SetEnvironment(tcp::Port{8988}, *test_env_root_dir,
+                 process::GetOtherExecutablePath("dummy_vault"));
+  AsioService asio_service{1};
+  passport::MaidAndSigner maid_and_signer{passport::CreateMaidAndSigner()};
+  ClientInterface client_interface{maid_and_signer.first, asio_service.service()};
+  std::atomic<int> call_count{0};
+  std::promise<std::exception_ptr> result;
+  client_interface.AsyncConnect([&](std::exception_ptr error) {
+    if (call_count++ == 0)
+      result.set_value(error);
+  });
+  auto result_future(result.get_future());
+  ASSERT_EQ(std::future_status::ready, result_future.wait_for(kRpcTimeout * 3));
+  EXPECT_TRUE(result_future.get());
+  std::this_thread::sleep_for(kRpcTimeout * 3);
+  EXPECT_EQ(1, call_count);
+}
+
+TEST(ClientInterfaceTest, BEH_DestroyWithoutRunningIoService) {
+  // Destruction mustn't wait forever on the strand of an io_service which nothing is running.
+  asio::io_service io_service;
+  passport::MaidAndSigner maid_and_signer{passport::CreateMaidAndSigner()};
+  std::promise<void> destroyed;
+  std::thread destroyer([&] {
+    { ClientInterface client_interface{maid_and_signer.first, io_service}; }
+    destroyed.set_value();
+  });
+  EXPECT_EQ(std::future_status::ready, destroyed.get_future().wait_for(kRpcTimeout * 3));
+  destroyer.join();
 }
 
 }  // namespace test
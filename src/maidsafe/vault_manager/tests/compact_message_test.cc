@@ -0,0 +1,68 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/compact_message.h"
+
+#include <cstdint>
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/test.h"
+
+#include "maidsafe/vault_manager/utils.h"
+#include "maidsafe/vault_manager/messages/joined_network.h"
+#include "maidsafe/vault_manager/messages/log_message.h"
+#include "maidsafe/vault_manager/messages/max_disk_usage_update.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+TEST(CompactMessageTest, BEH_EncodeAndDecode) {
+  const uint64_t usage{0x0102030405060708ULL};
+  tcp::Message frame{SerialiseMessage(MaxDiskUsageUpdate(DiskUsage(usage)), true)};
+  EXPECT_EQ(kCompactHeaderSize + sizeof(uint64_t), frame.size());
+  EXPECT_EQ(MessageTag::kCompactMessage, PeekTag(frame));
+  ASSERT_EQ(MessageTag::kMaxDiskUsageUpdate, CompactTag(frame));
+  EXPECT_EQ(usage, ParseCompact<MaxDiskUsageUpdate>(frame).usage.data);
+
+  frame = SerialiseMessage(JoinedNetwork(), true);
+  EXPECT_EQ(kCompactHeaderSize, frame.size());
+  EXPECT_EQ(MessageTag::kJoinedNetwork, CompactTag(frame));
+
+  // Frames whose size doesn't match their tag's layout are rejected.
+  frame.push_back(0);
+  EXPECT_THROW(CompactTag(frame), maidsafe_error);
+  frame = SerialiseMessage(MaxDiskUsageUpdate(DiskUsage(usage)), true);
+  frame.pop_back();
+  EXPECT_THROW(CompactTag(frame), maidsafe_error);
+  EXPECT_THROW(CompactTag(tcp::Message()), maidsafe_error);
+
+  // Without the peer's capability, or without a compact layout, cereal is used.
+  frame = SerialiseMessage(MaxDiskUsageUpdate(DiskUsage(usage)), false);
+  EXPECT_EQ(MessageTag::kMaxDiskUsageUpdate, PeekTag(frame));
+  frame = SerialiseMessage(LogMessage("log"), true);
+  EXPECT_EQ(MessageTag::kLogMessage, PeekTag(frame));
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,100 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/config_reload.h"
+
+#include <string>
+#include <vector>
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/test.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+namespace {
+
+VaultInfo MakeVaultInfo(const std::string& label, const std::string& vault_dir,
+                        uint64_t max_disk_usage) {
+  VaultInfo vault_info;
+  vault_info.label = NonEmptyString{label};
+  vault_info.vault_dir = vault_dir;
+  vault_info.max_disk_usage = DiskUsage{max_disk_usage};
+  return vault_info;
+}
+
+}  // unnamed namespace
+
+TEST(ConfigReloadTest, BEH_DiffVaults) {
+  std::vector<VaultInfo> live{MakeVaultInfo("unchanged", "/a", 100),
+                              MakeVaultInfo("removed", "/b", 100),
+                              MakeVaultInfo("relocated", "/c", 100),
+                              MakeVaultInfo("resized", "/d", 100)};
+  std::vector<VaultInfo> desired{MakeVaultInfo("resized", "/d", 200),
+                                 MakeVaultInfo("relocated", "/e", 200),
+                                 MakeVaultInfo("unchanged", "/a", 100),
+                                 MakeVaultInfo("added", "/f", 100)};
+
+  ConfigDiff diff{DiffVaults(live, desired)};
+  ASSERT_EQ(1U, diff.added.size());
+  EXPECT_EQ("added", diff.added.front().label.string());
+  ASSERT_EQ(1U, diff.removed.size());
+  EXPECT_EQ("removed", diff.removed.front().label.string());
+  ASSERT_EQ(1U, diff.relocated.size());
+  EXPECT_EQ("relocated", diff.relocated.front().label.string());
+  EXPECT_EQ(boost::filesystem::path("/e"), diff.relocated.front().vault_dir);
+  EXPECT_EQ(DiskUsage{200}, diff.relocated.front().max_disk_usage);
+  ASSERT_EQ(1U, diff.resized.size());
+  EXPECT_EQ("resized", diff.resized.front().label.string());
+  EXPECT_EQ(DiskUsage{200}, diff.resized.front().max_disk_usage);
+
+  EXPECT_TRUE(DiffVaults(live, live).Empty());
+}
+
+TEST(ConfigReloadTest, BEH_ApplyOverrides) {
+  std::vector<VaultInfo> vaults{MakeVaultInfo("first", "/a", 100),
+                                MakeVaultInfo("second", "/b", 100)};
+  ApplyOverrides(
+      "# Operator overrides\n"
+      "\n"
+      "first max_disk_usage=300  # trailing comment\n"
+      "second vault_dir=/c max_disk_usage=400\n"
+      "unknown max_disk_usage=500\n",
+      vaults);
+  EXPECT_EQ(boost::filesystem::path("/a"), vaults[0].vault_dir);
+  EXPECT_EQ(DiskUsage{300}, vaults[0].max_disk_usage);
+  EXPECT_EQ(boost::filesystem::path("/c"), vaults[1].vault_dir);
+  EXPECT_EQ(DiskUsage{400}, vaults[1].max_disk_usage);
+
+  // Malformed files are rejected as a whole.
+  for (const std::string malformed :
+       {"first max_disk_usage=300\nsecond\n", "first max_disk_usage=-1\n",
+        "first max_disk_usage=\n", "first vault_dir\n", "first owner=someone\n"}) {
+    EXPECT_THROW(ApplyOverrides(malformed, vaults), maidsafe_error) << malformed;
+    EXPECT_EQ(DiskUsage{300}, vaults[0].max_disk_usage);
+  }
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,79 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/crypto_executor.h"
+
+#include <future>
+#include <stdexcept>
+#include <utility>
+
+#include "asio/io_service_strand.hpp"
+
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/test.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+TEST(CryptoExecutorTest, BEH_Post) {
+  AsioService asio_service(1);
+  asio::io_service::strand strand(asio_service.service());
+  CryptoExecutor crypto_executor(strand, 2, 1);
+
+  // The result is passed back on the origin strand.
+  std::promise<void> release;
+  std::shared_future<void> released(release.get_future().share());
+  std::promise<std::pair<int, bool>> done;
+  EXPECT_TRUE(crypto_executor.Post(
+      [released] {
+        released.wait();
+        return 42;
+      },
+      [&](std::future<int> result) {
+        done.set_value(std::make_pair(result.get(), strand.running_in_this_thread()));
+      }));
+
+  // The queue is full until the first job completes.
+  EXPECT_FALSE(crypto_executor.Post([] { return 0; }, [](std::future<int>) {}));
+  release.set_value();
+  auto outcome(done.get_future().get());
+  EXPECT_EQ(42, outcome.first);
+  EXPECT_TRUE(outcome.second);
+
+  // Exceptions are passed back via the future.
+  std::promise<bool> threw;
+  EXPECT_TRUE(crypto_executor.Post([]() -> int { throw std::runtime_error("failed"); },
+                                   [&](std::future<int> result) {
+                                     try {
+                                       result.get();
+                                       threw.set_value(false);
+                                     } catch (const std::runtime_error&) {
+                                       threw.set_value(true);
+                                     }
+                                   }));
+  EXPECT_TRUE(threw.get_future().get());
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,67 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/discovery_file.h"
+
+#include <memory>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+TEST(DiscoveryFileTest, BEH_WriteReadAndRemove) {
+  std::shared_ptr<fs::path> test_dir{maidsafe::test::CreateTestPath("MaidSafe_TestDiscoveryFile")};
+  fs::path path{*test_dir / "endpoint.dat"};
+  EXPECT_FALSE(ReadDiscoveryFile(path));
+
+  DiscoveryRecord record{5483, RandomAlphaNumericString(16), 1234};
+  WriteDiscoveryFile(path, record);
+  auto read_record(ReadDiscoveryFile(path));
+  ASSERT_TRUE(read_record);
+  EXPECT_EQ(record.port, read_record->port);
+  EXPECT_EQ(record.instance_id, read_record->instance_id);
+  EXPECT_EQ(record.process_id, read_record->process_id);
+
+  // A newer instance's record replaces this one, and mustn't be removed by the older instance.
+  DiscoveryRecord newer_record{5484, RandomAlphaNumericString(16), 5678};
+  WriteDiscoveryFile(path, newer_record);
+  RemoveDiscoveryFile(path, record.instance_id);
+  read_record = ReadDiscoveryFile(path);
+  ASSERT_TRUE(read_record);
+  EXPECT_EQ(newer_record.port, read_record->port);
+  RemoveDiscoveryFile(path, newer_record.instance_id);
+  EXPECT_FALSE(fs::exists(path));
+
+  ASSERT_TRUE(WriteFile(path, "Not a discovery record"));
+  EXPECT_FALSE(ReadDiscoveryFile(path));
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -16,20 +16,76 @@
     See the Licences for the specific language governing permissions and limitations relating to
     use of the MaidSafe Software.                                                                 */
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <future>
+#include <string>
+#include <vector>
 
 #include "maidsafe/common/error.h"
 #include "maidsafe/common/log.h"
 #include "maidsafe/common/utils.h"
 
 #include "maidsafe/vault_manager/vault_config.h"
+#include "maidsafe/vault_manager/vault_host.h"
 #include "maidsafe/vault_manager/vault_interface.h"
+#include "maidsafe/vault_manager/tests/behaviour_simulator.h"
 
-int main(int argc, char* argv[]) {
+namespace {
+
+// Returns the exit code given by the VaultManager when it stops the vault.
+int RunDummyVault(maidsafe::vault_manager::VaultInterface& vault_interface) {
   using maidsafe::vault_manager::VaultConfig;
-  bool connected_to_vault_manager{false}, should_hang{false};
+  bool should_hang{false};
+  std::future<void> worker;
+  VaultConfig config{vault_interface.GetConfiguration()};
+  std::atomic<bool> exiting{false};
+  auto behaviour(maidsafe::vault_manager::test::SimulateBehaviour(
+      config, [&vault_interface] { vault_interface.SendJoined(); },
+      [&vault_interface](int exit_code) { vault_interface.Stop(exit_code); }, exiting));
+  switch (config.test_config.test_type) {
+    case VaultConfig::TestType::kNone:
+      break;
+    case VaultConfig::TestType::kKillConnection:
+      worker = std::async(std::launch::async, [&] { vault_interface.KillConnection(); });
+      break;
+    case VaultConfig::TestType::kSendInvalidMessage:
+      worker = std::async(std::launch::async, [&] { vault_interface.SendInvalidMessage(); });
+      break;
+    case VaultConfig::TestType::kStopProcess:
+      worker = std::async(std::launch::async, [&] { vault_interface.StopProcess(); });
+      break;
+    case VaultConfig::TestType::kIgnoreStopRequest:
+      should_hang = true;
+      break;
+    default:
+      BOOST_THROW_EXCEPTION(maidsafe::MakeError(maidsafe::CommonErrors::invalid_parameter));
+  }
+  int exit_code{vault_interface.WaitForExit()};
+  exiting = true;
+  behaviour.get();
+  if (worker.valid())
+    worker.get();
+  maidsafe::Sleep(config.test_config.behaviour_profile.shutdown_delay);
+  if (should_hang)
+    maidsafe::Sleep(std::chrono::hours(6));
+  return exit_code;
+}
+
+}  // unnamed namespace
+
+int main(int argc, char* argv[]) {
+  if (maidsafe::vault_manager::IsVaultHost(argc, argv)) {
+    maidsafe::log::Logging::Instance().Initialise(argc, argv);
+    return maidsafe::vault_manager::RunVaultHost(
+        argc, argv, [](maidsafe::vault_manager::VaultInterface& vault_interface,
+                       const std::vector<std::string>& /*args*/) {
+          return RunDummyVault(vault_interface);
+        });
+  }
+
+  bool connected_to_vault_manager{false};
   int exit_code{0};
   try {
     auto unuseds(maidsafe::log::Logging::Instance().Initialise(argc, argv));
@@ -38,29 +94,7 @@ int main(int argc, char* argv[]) {
     uint16_t port{static_cast<uint16_t>(std::stoi(std::string{&unuseds[1][0]}))};
     maidsafe::vault_manager::VaultInterface vault_interface{port};
     connected_to_vault_manager = true;
-
-    std::future<void> worker;
-    VaultConfig config{vault_interface.GetConfiguration()};
-    switch (config.test_config.test_type) {
-      case VaultConfig::TestType::kNone:
-        break;
-      case VaultConfig::TestType::kKillConnection:
-        worker = std::async(std::launch::async, [&] { vault_interface.KillConnection(); });
-        break;
-      case VaultConfig::TestType::kSendInvalidMessage:
-        worker = std::async(std::launch::async, [&] { vault_interface.SendInvalidMessage(); });
-        break;
-      case VaultConfig::TestType::kStopProcess:
-        worker = std::async(std::launch::async, [&] { vault_interface.StopProcess(); });
-        break;
-      case VaultConfig::TestType::kIgnoreStopRequest:
-        should_hang = true;
-        break;
-      default:
-        BOOST_THROW_EXCEPTION(maidsafe::MakeError(maidsafe::CommonErrors::invalid_parameter));
-    }
-    exit_code = vault_interface.WaitForExit();
-    worker.get();
+    exit_code = RunDummyVault(vault_interface);
   } catch (const maidsafe::maidsafe_error& error) {
     if (connected_to_vault_manager)
       LOG(kError) << error.what();
@@ -75,7 +109,5 @@ int main(int argc, char* argv[]) {
     exit_code =
         maidsafe::ErrorToInt(maidsafe::MakeError(maidsafe::CommonErrors::invalid_parameter));
   }
-  if (should_hang)
-    maidsafe::Sleep(std::chrono::hours(6));
   return exit_code;
 }
@@ -18,19 +18,30 @@
 
 #include "maidsafe/vault_manager/process_manager.h"
 
+#include <chrono>
+#include <functional>
+#include <map>
+#include <set>
 #include <thread>
 #include <string>
 #include <vector>
 
+#include "asio/io_service.hpp"
+#include "boost/filesystem/operations.hpp"
 #include "boost/filesystem/path.hpp"
 
 #include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/error.h"
 #include "maidsafe/common/make_unique.h"
 #include "maidsafe/common/process.h"
 #include "maidsafe/common/test.h"
 #include "maidsafe/common/utils.h"
+#include "maidsafe/passport/passport.h"
 
+#include "maidsafe/vault_manager/clock.h"
 #include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/process_backend.h"
+#include "maidsafe/vault_manager/timing_wheel.h"
 #include "maidsafe/vault_manager/utils.h"
 #include "maidsafe/vault_manager/tests/test_utils.h"
 
@@ -42,6 +53,27 @@ namespace vault_manager {
 
 namespace test {
 
+namespace {
+
+// Stands in for the backend of the previous VaultManager, which spawned the vault being adopted.
+// It reports the vault as running until it's terminated, which is recorded rather than done.
+class AdoptedProcessBackend : public ProcessBackend {
+ public:
+  void Start(OnExitFunctor /*on_exit*/) override {}
+  void Stop() override {}
+  ProcessId Spawn(const std::vector<std::string>& /*args*/,
+                  const VaultConfigChannel* /*config_channel*/) override {
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::unable_to_handle_request));
+  }
+  void Terminate(ProcessId process_id) override { terminated.insert(process_id); }
+  bool IsRunning(ProcessId process_id) const override { return terminated.count(process_id) == 0; }
+  bool CanHandOffConfig() const override { return false; }
+
+  std::set<ProcessId> terminated;
+};
+
+}  // unnamed namespace
+
 TEST(ProcessManagerTest, BEH_Constructor) {
   fs::path path_to_vault{process::GetOtherExecutablePath("dummy_vault")};
   std::unique_ptr<AsioService> asio_service{maidsafe::make_unique<AsioService>(1)};
@@ -52,6 +84,207 @@ TEST(ProcessManagerTest, BEH_Constructor) {
   asio_service.reset();
 }
 
+// Runs 10,000 vault lifecycles against simulated processes and a simulated clock, in waves of 16
+// vaults.  Each vault in a wave follows one of four scenarios:
+//   0 - connects, then is stopped
+//   1 - connects, crashes once, reconnects after being restarted, then is stopped
+//   2 - never connects, so times out on every start until it runs out of restarts
+//   3 - crashes on every start until it runs out of restarts
+TEST(ProcessManagerTest, BEH_SimulatedLifecycles) {
+  const int kVaultsPerWave(16), kWaveCount(625);
+  asio::io_service io_service;
+  auto clock(std::make_shared<SimulatedClock>());
+  auto process_backend(std::make_shared<SimulatedProcessBackend>(io_service));
+  std::map<VaultEventType, int> event_counts;
+  std::shared_ptr<ProcessManager> process_manager{ProcessManager::MakeShared(
+      io_service, process::GetOtherExecutablePath("dummy_vault"), tcp::Port{7777},
+      [&](const VaultInfo&, VaultEventType type, int) { ++event_counts[type]; },
+      TimingWheel::MakeShared(io_service, kTimingWheelResolution, clock), nullptr, nullptr,
+      process_backend)};
+
+  std::vector<VaultInfo> vaults;
+  std::map<std::string, int> vault_index_by_log_arg;
+  for (int i(0); i < kVaultsPerWave; ++i) {
+    VaultInfo vault_info;
+    vault_info.pmid_and_signer =
+        std::make_shared<passport::PmidAndSigner>(passport::CreatePmidAndSigner());
+    vault_info.vault_dir = fs::path{"simulated_vault_" + std::to_string(i)};
+    vault_info.label = GenerateLabel();
+    vault_index_by_log_arg["--log_folder " + (vault_info.vault_dir / "logs").string()] = i;
+    vaults.push_back(vault_info);
+  }
+
+  auto poll([&] {
+    io_service.reset();
+    io_service.poll();
+  });
+
+  for (int wave(0); wave < kWaveCount; ++wave) {
+    std::vector<int> spawn_counts(kVaultsPerWave, 0);
+    ProcessId last_handled_process_id(process_backend->SpawnCount());
+    for (const auto& vault_info : vaults)
+      process_manager->AddProcess(vault_info);
+
+    int steps(0);
+    while (!process_manager->GetAll().empty()) {
+      ASSERT_LT(++steps, 100) << "Wave " << wave << " didn't finish.";
+      poll();
+      for (const auto& running : process_backend->Running()) {
+        const ProcessId process_id(running.first);
+        if (process_id <= last_handled_process_id)
+          continue;
+        last_handled_process_id = process_id;
+        const int index(vault_index_by_log_arg.at(running.second.at(2)));
+        const int spawn_count(++spawn_counts[index]);
+        switch (index % 4) {
+          case 0:
+            process_manager->HandleVaultStarted(nullptr, process_id);
+            process_manager->StopProcess(vaults[index].label);
+            break;
+          case 1:
+            process_manager->HandleVaultStarted(nullptr, process_id);
+            if (spawn_count == 1)
+              process_backend->Exit(process_id, 1);
+            else
+              process_manager->StopProcess(vaults[index].label);
+            break;
+          case 2:
+            break;
+          default:
+            process_backend->Exit(process_id, 1);
+            break;
+        }
+      }
+      poll();
+      clock->Advance(std::chrono::seconds(1));
+      poll();
+    }
+
+    const std::vector<int> expected_spawn_counts{1, 2, kMaxVaultRestarts + 1,
+                                                 kMaxVaultRestarts + 1};
+    for (int i(0); i < kVaultsPerWave; ++i)
+      ASSERT_EQ(expected_spawn_counts[i % 4], spawn_counts[i]) << "Wave " << wave << ", vault "
+                                                               << i;
+  }
+  process_manager->StopAll();
+  poll();
+
+  const int kLifecycles(kVaultsPerWave * kWaveCount);
+  EXPECT_EQ(10000, kLifecycles);
+  EXPECT_EQ(kLifecycles, event_counts[VaultEventType::kExited]);
+  EXPECT_EQ(kLifecycles / 4 * (1 + 2 * kMaxVaultRestarts),
+            event_counts[VaultEventType::kRestarted]);
+  EXPECT_EQ(static_cast<uint64_t>(kLifecycles / 4 * (3 + 2 * (kMaxVaultRestarts + 1))),
+            process_backend->SpawnCount());
+  EXPECT_TRUE(process_backend->Running().empty());
+}
+
+#ifdef MAIDSAFE_LINUX
+// While the VaultManager is down, a vault retries with a growing, jittered delay, so its next
+// attempt can be up to one maximum delay plus jitter after the new VaultManager adopts it.  It must
+// still be waiting to be adopted then.  This test process stands in for the vault, so that it
+// passes the check that the adopted process is running the vault executable.
+TEST(ProcessManagerTest, BEH_AdoptedVaultReconnectsAfterBackoff) {
+  asio::io_service io_service;
+  auto clock(std::make_shared<SimulatedClock>());
+  auto process_backend(std::make_shared<AdoptedProcessBackend>());
+  std::shared_ptr<ProcessManager> process_manager{ProcessManager::MakeShared(
+      io_service, fs::canonical(fs::path{"/proc/self/exe"}), tcp::Port{7777}, nullptr,
+      TimingWheel::MakeShared(io_service, kTimingWheelResolution, clock), nullptr, nullptr,
+      process_backend)};
+  auto poll([&] {
+    io_service.reset();
+    io_service.poll();
+  });
+
+  VaultInfo vault_info;
+  vault_info.pmid_and_signer =
+      std::make_shared<passport::PmidAndSigner>(passport::CreatePmidAndSigner());
+  vault_info.vault_dir = fs::path{"adopted_vault"};
+  vault_info.label = GenerateLabel();
+  vault_info.adoption_token = RandomString(32);
+  const ProcessId process_id(process::GetProcessId());
+  process_manager->AdoptProcess(vault_info, process_id);
+
+  const std::chrono::milliseconds kLongestReconnectDelay(kMaxReconnectDelay * 3 / 2);
+  for (std::chrono::milliseconds waited(0); waited < kLongestReconnectDelay;
+       waited += std::chrono::seconds(1)) {
+    clock->Advance(std::chrono::seconds(1));
+    poll();
+  }
+  EXPECT_TRUE(process_backend->terminated.empty());
+  ASSERT_EQ(1U, process_manager->GetAll().size());
+  EXPECT_NO_THROW(
+      process_manager->HandleVaultStarted(nullptr, process_id, vault_info.adoption_token));
+
+  // Once adopted, it's no longer subject to the adoption timeout.
+  clock->Advance(kAdoptionTimeout);
+  poll();
+  EXPECT_TRUE(process_backend->terminated.empty());
+  EXPECT_EQ(1U, process_manager->GetAll().size());
+  process_manager->ReleaseAll();
+  poll();
+}
+#endif
+
+#ifndef MAIDSAFE_WIN32
+// A vault is only spawned once its config has been serialised.  One which doesn't read its config
+// channel is rejected, then restarted without a channel so that it's configured over TCP.
+TEST(ProcessManagerTest, BEH_VaultIgnoringConfigChannel) {
+  asio::io_service io_service;
+  auto clock(std::make_shared<SimulatedClock>());
+  auto process_backend(std::make_shared<SimulatedProcessBackend>(io_service));
+  std::vector<std::function<void(tcp::Message)>> pending_configs;
+  std::shared_ptr<ProcessManager> process_manager{ProcessManager::MakeShared(
+      io_service, process::GetOtherExecutablePath("dummy_vault"), tcp::Port{7777}, nullptr,
+      TimingWheel::MakeShared(io_service, kTimingWheelResolution, clock), nullptr,
+      [&](const VaultInfo&, std::function<void(tcp::Message)> on_serialised) {
+        pending_configs.push_back(on_serialised);
+      },
+      process_backend)};
+  auto poll([&] {
+    io_service.reset();
+    io_service.poll();
+  });
+
+  VaultInfo vault_info;
+  vault_info.pmid_and_signer =
+      std::make_shared<passport::PmidAndSigner>(passport::CreatePmidAndSigner());
+  vault_info.vault_dir = fs::path{"simulated_vault"};
+  vault_info.label = GenerateLabel();
+  process_manager->AddProcess(vault_info);
+  poll();
+  EXPECT_EQ(0U, process_backend->SpawnCount());
+  ASSERT_EQ(1U, pending_configs.size());
+  pending_configs.front()(tcp::Message(16, 'a'));
+  poll();
+  ASSERT_EQ(1U, process_backend->SpawnCount());
+
+  const ProcessId first_process_id(process_backend->Running().begin()->first);
+  try {
+    process_manager->HandleVaultStarted(nullptr, first_process_id);
+    ADD_FAILURE() << "A vault handed a config channel must present its adoption token.";
+  } catch (const maidsafe_error& error) {
+    EXPECT_EQ(make_error_code(CommonErrors::invalid_parameter), error.code());
+  }
+
+  // It times out, and is restarted without a channel.
+  clock->Advance(kRpcTimeout * 2);
+  poll();
+  ASSERT_EQ(2U, process_backend->SpawnCount());
+  EXPECT_EQ(1U, pending_configs.size());
+  const ProcessId second_process_id(process_backend->Running().begin()->first);
+  EXPECT_NE(first_process_id, second_process_id);
+  EXPECT_NO_THROW(process_manager->HandleVaultStarted(nullptr, second_process_id));
+
+  process_manager->StopProcess(vault_info.label);
+  poll();
+  process_manager->StopAll();
+  poll();
+  EXPECT_TRUE(process_backend->Running().empty());
+}
+#endif
+
 }  // namespace test
 
 }  // namespace vault_manager
@@ -0,0 +1,92 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/public_pmid_table.h"
+
+#include <string>
+#include <vector>
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/passport/passport.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+TEST(PublicPmidTableTest, BEH_WriteAndFind) {
+  auto test_path(maidsafe::test::CreateTestPath("MaidSafe_TestPublicPmidTable"));
+  boost::filesystem::path table_path(*test_path / "public_pmids.table");
+  std::vector<passport::PublicPmid> public_pmids;
+  for (int i(0); i < 5; ++i)
+    public_pmids.emplace_back(passport::CreatePmidAndSigner().first);
+
+  std::string checksum(PublicPmidTable::Write(table_path, public_pmids));
+  PublicPmidTable table(table_path, checksum);
+  EXPECT_EQ(public_pmids.size(), table.Size());
+  for (const auto& public_pmid : public_pmids) {
+    passport::PublicPmid found(table.Find(public_pmid.name()));
+    EXPECT_EQ(public_pmid.name(), found.name());
+    EXPECT_EQ(public_pmid.Serialise().value, found.Serialise().value);
+  }
+  EXPECT_EQ(public_pmids.size(), table.GetAll().size());
+
+  // Copies share the mapping.
+  PublicPmidTable copy(table);
+  EXPECT_EQ(public_pmids.front().name(), copy.Find(public_pmids.front().name()).name());
+
+  EXPECT_THROW(
+      table.Find(passport::PublicPmid{passport::CreatePmidAndSigner().first}.name()),
+      maidsafe_error);
+  EXPECT_THROW(PublicPmidTable(table_path, RandomString(checksum.size())), maidsafe_error);
+  EXPECT_THROW(PublicPmidTable(*test_path / "missing.table", checksum), maidsafe_error);
+
+  // Rewriting gives a new checksum, so a vault holding the old one can't map a different table.
+  public_pmids.pop_back();
+  std::string new_checksum(PublicPmidTable::Write(table_path, public_pmids));
+  EXPECT_NE(checksum, new_checksum);
+  EXPECT_THROW(PublicPmidTable(table_path, checksum), maidsafe_error);
+  EXPECT_EQ(public_pmids.size(), PublicPmidTable(table_path, new_checksum).Size());
+}
+
+TEST(PublicPmidTableTest, BEH_Malformed) {
+  auto test_path(maidsafe::test::CreateTestPath("MaidSafe_TestPublicPmidTable"));
+  boost::filesystem::path table_path(*test_path / "public_pmids.table");
+  std::string checksum(PublicPmidTable::Write(
+      table_path, std::vector<passport::PublicPmid>{
+                      passport::PublicPmid{passport::CreatePmidAndSigner().first}}));
+  std::string contents(ReadFile(table_path).string());
+  // A changed byte in the body is caught by the checksum.
+  std::string corrupted(contents);
+  corrupted.back() ^= 1;
+  ASSERT_TRUE(WriteFile(table_path, corrupted));
+  EXPECT_THROW(PublicPmidTable(table_path, checksum), maidsafe_error);
+  ASSERT_TRUE(WriteFile(table_path, contents.substr(0, contents.size() / 2)));
+  EXPECT_THROW(PublicPmidTable(table_path, checksum), maidsafe_error);
+  ASSERT_TRUE(WriteFile(table_path, "Not a table"));
+  EXPECT_THROW(PublicPmidTable(table_path, checksum), maidsafe_error);
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,143 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/re_exec.h"
+
+#ifndef MAIDSAFE_WIN32
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <string>
+#include <vector>
+
+#include "asio/io_service.hpp"
+#include "asio/ip/tcp.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/test.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+#ifndef MAIDSAFE_WIN32
+
+namespace {
+
+// Returns a socket listening on an ephemeral loopback port, as a descriptor which (like one
+// inherited across exec()) isn't owned by any acceptor.
+int MakeListeningSocket() {
+  const int fd(socket(AF_INET, SOCK_STREAM, 0));
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+      listen(fd, SOMAXCONN) != 0) {
+    ADD_FAILURE() << "Failed to create listening socket.";
+    return -1;
+  }
+  return fd;
+}
+
+bool IsCloseOnExec(int fd) { return (fcntl(fd, F_GETFD) & FD_CLOEXEC) != 0; }
+
+}  // unnamed namespace
+
+TEST(ReExecTest, BEH_AdoptInheritedListener) {
+  asio::io_service io_service;
+  const int listener_fd(MakeListeningSocket());
+  ASSERT_GE(listener_fd, 0);
+  ASSERT_FALSE(IsCloseOnExec(listener_fd));
+
+  asio::ip::tcp::acceptor acceptor(AdoptInheritedListener(io_service, listener_fd));
+  EXPECT_EQ(listener_fd, acceptor.native_handle());
+  // It mustn't leak into the vaults this image goes on to spawn.
+  EXPECT_TRUE(IsCloseOnExec(listener_fd));
+
+  // A connection made to the port is accepted by the adopted acceptor.
+  asio::ip::tcp::socket client(io_service), accepted(io_service);
+  client.connect(asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(),
+                                         acceptor.local_endpoint().port()));
+  acceptor.accept(accepted);
+  EXPECT_EQ(client.local_endpoint(), accepted.remote_endpoint());
+
+  // Anything other than a listening socket is rejected.
+  const int unbound_fd(socket(AF_INET, SOCK_STREAM, 0));
+  ASSERT_GE(unbound_fd, 0);
+  EXPECT_THROW(AdoptInheritedListener(io_service, unbound_fd), maidsafe_error);
+  close(unbound_fd);
+  EXPECT_THROW(AdoptInheritedListener(io_service, -1), maidsafe_error);
+}
+
+TEST(ReExecTest, BEH_ReExecFailures) {
+  const int listener_fd(MakeListeningSocket());
+  ASSERT_GE(listener_fd, 0);
+  const int unbound_fd(socket(AF_INET, SOCK_STREAM, 0));
+  ASSERT_GE(unbound_fd, 0);
+  try {
+    ReExec("/bin/sh", std::vector<std::string>(), unbound_fd);
+    ADD_FAILURE() << "Only a listening socket can be handed over.";
+  } catch (const maidsafe_error& error) {
+    EXPECT_EQ(make_error_code(CommonErrors::invalid_parameter), error.code());
+  }
+  close(unbound_fd);
+
+  // If the exec() fails, the process carries on and the listener isn't left to leak.  (This test
+  // process' other descriptors are left close-on-exec, which is harmless here.)
+  try {
+    ReExec("/no/such/executable", std::vector<std::string>(), listener_fd);
+    ADD_FAILURE() << "Re-executing a missing file should fail.";
+  } catch (const maidsafe_error& error) {
+    EXPECT_EQ(make_error_code(CommonErrors::unable_to_handle_request), error.code());
+  }
+  EXPECT_TRUE(IsCloseOnExec(listener_fd));
+  close(listener_fd);
+}
+
+// The new image inherits the listening socket, named by the appended kInheritedListenerFdOption,
+// and no other descriptor.  The shell stands in for the new image: its $0 is that option, and its
+// exit code reports what it inherited.
+TEST(ReExecTest, BEH_ReExecHandsOverOnlyListener) {
+  const int listener_fd(MakeListeningSocket());
+  ASSERT_GE(listener_fd, 0);
+  const int other_fd(open("/dev/null", O_RDONLY));
+  ASSERT_GE(other_fd, 0);
+  ASSERT_FALSE(IsCloseOnExec(other_fd));
+  const std::string kScript(
+      "[ \"${0%%=*}\" = " + kInheritedListenerFdOption + " ] && [ \"${0#*=}\" = " +
+      std::to_string(listener_fd) + " ] && [ -e /dev/fd/" + std::to_string(listener_fd) +
+      " ] && [ ! -e /dev/fd/" + std::to_string(other_fd) + " ]");
+  // A stale option from a previous exec() is replaced rather than passed on.
+  const std::vector<std::string> kArgs{kInheritedListenerFdOption + "=999", "-c", kScript};
+  EXPECT_EXIT(ReExec("/bin/sh", kArgs, listener_fd), ::testing::ExitedWithCode(0), "");
+  close(other_fd);
+  close(listener_fd);
+}
+
+#endif
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -35,7 +35,7 @@ namespace test {
 
 TEST(RpcHelperTest, BEH_SetResponseCallback) {
   AsioService asio_service(1);
-  asio::io_service& io_service(asio_service.service());
+  auto timing_wheel(TimingWheel::MakeShared(asio_service.service()));
   std::function<void(Challenge && )> callback;  // NOLINT
   std::mutex mutex;
   Challenge challenge(asymm::PlainText(RandomString((RandomUint32() % 100) + 100)));
@@ -43,7 +43,7 @@ TEST(RpcHelperTest, BEH_SetResponseCallback) {
   std::vector<std::future<std::unique_ptr<asymm::PlainText>>> futures;
   for (int i(0); i < 3; ++i)
     futures.emplace_back(SetResponseCallback<std::unique_ptr<asymm::PlainText>, Challenge>(
-        callback, io_service, mutex));
+        callback, timing_wheel, mutex));
 
   for (auto& future : futures)
     EXPECT_THROW(future.get(), maidsafe_error) << "must have failed";
@@ -51,7 +51,7 @@ TEST(RpcHelperTest, BEH_SetResponseCallback) {
   futures.clear();
   for (int i(0); i < 3; ++i)
     futures.emplace_back(SetResponseCallback<std::unique_ptr<asymm::PlainText>, Challenge>(
-        callback, io_service, mutex));
+        callback, timing_wheel, mutex));
 
   auto challenge_plaintext(challenge.plaintext);
   std::thread t([&]() {
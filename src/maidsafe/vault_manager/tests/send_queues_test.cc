@@ -0,0 +1,114 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/send_queues.h"
+
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "asio/io_service_strand.hpp"
+
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/tcp/connection.h"
+#include "maidsafe/common/tcp/listener.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+namespace {
+
+tcp::Message ToMessage(const std::string& text) {
+  return tcp::Message(std::begin(text), std::end(text));
+}
+
+}  // unnamed namespace
+
+TEST(SendQueuesTest, BEH_Order) {
+  AsioService asio_service{2};
+  asio::io_service::strand strand{asio_service.service()};
+  const std::size_t kExpectedCount{5};
+  std::mutex mutex;
+  std::vector<std::string> received;
+  std::promise<void> all_received;
+  tcp::ConnectionPtr accepted;
+  auto listener(tcp::Listener::MakeShared(
+      strand,
+      [&](tcp::ConnectionPtr connection) {
+        accepted = connection;
+        connection->Start(
+            [&](tcp::Message message) {
+              std::lock_guard<std::mutex> lock{mutex};
+              received.emplace_back(std::begin(message), std::end(message));
+              if (received.size() == kExpectedCount)
+                all_received.set_value();
+            },
+            [] {});
+      },
+      tcp::Port{maidsafe::test::GetRandomPort()}));
+  tcp::ConnectionPtr connection{tcp::Connection::MakeShared(strand, listener->ListeningPort())};
+
+  SendQueues send_queues;
+  // Nothing is being built, so this is sent straight away.
+  send_queues.Send(connection, ToMessage("0"));
+  const SendQueues::Slot kFirst{send_queues.Reserve(connection)};
+  send_queues.Send(connection, ToMessage("2"));
+  const SendQueues::Slot kAbandoned{send_queues.Reserve(connection)};
+  const SendQueues::Slot kSecond{send_queues.Reserve(connection)};
+  send_queues.Send(connection, ToMessage("4"));
+  // Filling later slots first holds them back behind the first.
+  send_queues.Fill(connection, kSecond, ToMessage("3"));
+  send_queues.Fill(connection, kAbandoned, tcp::Message());
+  send_queues.Fill(connection, kFirst, ToMessage("1"));
+
+  ASSERT_EQ(std::future_status::ready,
+            all_received.get_future().wait_for(std::chrono::seconds(10)));
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    EXPECT_EQ((std::vector<std::string>{"0", "1", "2", "3", "4"}), received);
+  }
+
+  // Once the connection is removed, held-back messages are dropped.
+  const SendQueues::Slot kDropped{send_queues.Reserve(connection)};
+  send_queues.Send(connection, ToMessage("5"));
+  send_queues.Remove(connection);
+  send_queues.Fill(connection, kDropped, ToMessage("6"));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    EXPECT_EQ(kExpectedCount, received.size());
+  }
+
+  connection->Close();
+  listener->StopListening();
+  if (accepted)
+    accepted->Close();
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,79 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/session_tickets.h"
+
+#include <chrono>
+#include <string>
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/passport/passport.h"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+TEST(SessionTicketsTest, BEH_IssueAndRedeem) {
+  SessionTickets session_tickets;
+  passport::PublicMaid::Name maid_name{
+      passport::PublicMaid{passport::CreateMaidAndSigner().first}.name()};
+
+  std::string ticket{session_tickets.Issue(maid_name)};
+  std::string tampered{ticket};
+  tampered[0] ^= 1;
+  EXPECT_THROW(session_tickets.Redeem(tampered), maidsafe_error);
+  EXPECT_THROW(session_tickets.Redeem(ticket.substr(1)), maidsafe_error);
+  EXPECT_THROW(session_tickets.Redeem(std::string()), maidsafe_error);
+
+  EXPECT_EQ(maid_name, session_tickets.Redeem(ticket));
+  // A ticket can only be redeemed once.
+  EXPECT_THROW(session_tickets.Redeem(ticket), maidsafe_error);
+
+  // Another instance (e.g. a restarted VaultManager) has a different key.
+  SessionTickets other_session_tickets;
+  EXPECT_THROW(other_session_tickets.Redeem(ticket), maidsafe_error);
+
+  SessionTickets expired_session_tickets(std::chrono::seconds(-1));
+  EXPECT_THROW(expired_session_tickets.Redeem(expired_session_tickets.Issue(maid_name)),
+               maidsafe_error);
+}
+
+TEST(SessionTicketsTest, BEH_MaxOutstanding) {
+  SessionTickets session_tickets(kSessionTicketLifetime, 2);
+  passport::PublicMaid::Name maid_name{
+      passport::PublicMaid{passport::CreateMaidAndSigner().first}.name()};
+
+  std::string first{session_tickets.Issue(maid_name)};
+  std::string second{session_tickets.Issue(maid_name)};
+  std::string third{session_tickets.Issue(maid_name)};
+  // The oldest unredeemed ticket is forgotten to make room.
+  EXPECT_THROW(session_tickets.Redeem(first), maidsafe_error);
+  EXPECT_EQ(maid_name, session_tickets.Redeem(third));
+  EXPECT_EQ(maid_name, session_tickets.Redeem(second));
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
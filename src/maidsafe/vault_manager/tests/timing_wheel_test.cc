@@ -0,0 +1,98 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/timing_wheel.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/test.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+TEST(TimingWheelTest, BEH_ExpireAndCancel) {
+  AsioService asio_service(1);
+  auto timing_wheel(TimingWheel::MakeShared(asio_service.service(), std::chrono::milliseconds(5)));
+
+  // Timeouts spanning several levels of the wheel must neither expire early nor be lost.
+  const std::vector<std::chrono::milliseconds> timeouts{
+      std::chrono::milliseconds(1), std::chrono::milliseconds(50),
+      std::chrono::milliseconds(1500), std::chrono::milliseconds(2500)};
+  std::vector<std::promise<std::chrono::steady_clock::time_point>> expired(timeouts.size());
+  const auto start(std::chrono::steady_clock::now());
+  for (std::size_t i(0); i < timeouts.size(); ++i) {
+    timing_wheel->Add(timeouts[i], [&expired, i] {
+      expired[i].set_value(std::chrono::steady_clock::now());
+    });
+  }
+
+  // Cancelled timeouts must not be invoked, and can only be cancelled once.
+  bool cancelled_invoked(false);
+  auto timer_id(
+      timing_wheel->Add(std::chrono::milliseconds(20), [&] { cancelled_invoked = true; }));
+  EXPECT_TRUE(timing_wheel->Cancel(timer_id));
+  EXPECT_FALSE(timing_wheel->Cancel(timer_id));
+  EXPECT_FALSE(timing_wheel->Cancel(0));
+
+  for (std::size_t i(0); i < timeouts.size(); ++i) {
+    auto future(expired[i].get_future());
+    ASSERT_EQ(std::future_status::ready, future.wait_for(std::chrono::seconds(10)));
+    EXPECT_GE(future.get() - start, timeouts[i]);
+  }
+  EXPECT_FALSE(cancelled_invoked);
+  EXPECT_EQ(0U, timing_wheel->Size());
+}
+
+TEST(TimingWheelTest, BEH_MultithreadedIoService) {
+  AsioService asio_service(4);
+  auto timing_wheel(TimingWheel::MakeShared(asio_service.service(), std::chrono::milliseconds(1)));
+
+  // Timeouts added from several threads while the wheel ticks on several others must all expire.
+  const int kThreadCount(4), kTimeoutsPerThread(500);
+  std::atomic<int> expired_count(0);
+  std::promise<void> all_expired;
+  std::vector<std::thread> threads;
+  for (int i(0); i < kThreadCount; ++i) {
+    threads.emplace_back([&, i] {
+      for (int j(0); j < kTimeoutsPerThread; ++j) {
+        timing_wheel->Add(std::chrono::milliseconds((i * kTimeoutsPerThread + j) % 50), [&] {
+          if (++expired_count == kThreadCount * kTimeoutsPerThread)
+            all_expired.set_value();
+        });
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+  EXPECT_EQ(std::future_status::ready, all_expired.get_future().wait_for(std::chrono::seconds(10)));
+  EXPECT_EQ(0U, timing_wheel->Size());
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,115 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/traffic_capture.h"
+
+#include <memory>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+
+#include "maidsafe/vault_manager/messages/log_message.h"
+#include "maidsafe/vault_manager/messages/resume_session_request.h"
+#include "maidsafe/vault_manager/messages/vault_started.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+TEST(TrafficCaptureTest, BEH_WriteAndRead) {
+  std::shared_ptr<fs::path> test_dir{maidsafe::test::CreateTestPath("MaidSafe_TestTrafficCapture")};
+  fs::path path{*test_dir / "capture.dat"};
+  const tcp::Message log_message{Serialise(LogMessage::tag, LogMessage(RandomString(1000)))};
+  {
+    TrafficCaptureWriter writer{path};
+#ifndef MAIDSAFE_WIN32
+    EXPECT_EQ(fs::owner_read | fs::owner_write, fs::status(path).permissions());
+#endif
+    writer.RecordConnected(1);
+    writer.RecordConnected(300);
+    writer.RecordMessage(300, log_message);
+    writer.RecordMessage(1, tcp::Message());
+    writer.RecordMessage(1, Serialise(ResumeSessionRequest::tag,
+                                      ResumeSessionRequest(RandomString(64))));
+    writer.RecordMessage(1, Serialise(VaultStarted::tag, VaultStarted(1234, RandomString(32))));
+    writer.RecordClosed(300);
+  }
+#ifndef MAIDSAFE_WIN32
+  EXPECT_EQ(fs::owner_read | fs::owner_write, fs::status(path).permissions());
+#endif
+
+  TrafficCaptureReader reader{path};
+  TrafficRecord record;
+  ASSERT_TRUE(reader.Next(record));
+  EXPECT_EQ(TrafficRecord::Type::kConnected, record.type);
+  EXPECT_EQ(1U, record.connection_id);
+  ASSERT_TRUE(reader.Next(record));
+  EXPECT_EQ(TrafficRecord::Type::kConnected, record.type);
+  EXPECT_EQ(300U, record.connection_id);
+  auto connected_time(record.time);
+  ASSERT_TRUE(reader.Next(record));
+  EXPECT_EQ(TrafficRecord::Type::kMessage, record.type);
+  EXPECT_EQ(300U, record.connection_id);
+  EXPECT_EQ(static_cast<uint8_t>(MessageTag::kLogMessage), record.tag);
+  EXPECT_TRUE(log_message == record.message);
+  EXPECT_GE(record.time, connected_time);
+  ASSERT_TRUE(reader.Next(record));
+  EXPECT_EQ(TrafficRecord::Type::kMessage, record.type);
+  EXPECT_EQ(TrafficRecord::kUnknownTag, record.tag);
+  EXPECT_TRUE(record.message.empty());
+  // Only the tag of a message carrying credentials is kept.
+  ASSERT_TRUE(reader.Next(record));
+  EXPECT_EQ(TrafficRecord::Type::kMessage, record.type);
+  EXPECT_EQ(static_cast<uint8_t>(MessageTag::kResumeSessionRequest), record.tag);
+  EXPECT_TRUE(IsCredential(record.tag));
+  EXPECT_TRUE(record.message.empty());
+  // A reconnecting vault's adoption token would let anything pass itself off as that vault.
+  ASSERT_TRUE(reader.Next(record));
+  EXPECT_EQ(TrafficRecord::Type::kMessage, record.type);
+  EXPECT_EQ(static_cast<uint8_t>(MessageTag::kVaultStarted), record.tag);
+  EXPECT_TRUE(IsCredential(record.tag));
+  EXPECT_TRUE(record.message.empty());
+  ASSERT_TRUE(reader.Next(record));
+  EXPECT_EQ(TrafficRecord::Type::kClosed, record.type);
+  EXPECT_EQ(300U, record.connection_id);
+  EXPECT_FALSE(reader.Next(record));
+
+  // A truncated capture is reported as corrupt rather than silently cut short.
+  const std::string contents{ReadFile(path).string()};
+  ASSERT_TRUE(WriteFile(path, contents.substr(0, contents.size() - 500)));
+  TrafficCaptureReader truncated_reader{path};
+  EXPECT_TRUE(truncated_reader.Next(record));
+  EXPECT_TRUE(truncated_reader.Next(record));
+  EXPECT_THROW(truncated_reader.Next(record), maidsafe_error);
+
+  ASSERT_TRUE(WriteFile(path, "Not a capture file"));
+  EXPECT_THROW(TrafficCaptureReader{path}, maidsafe_error);
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
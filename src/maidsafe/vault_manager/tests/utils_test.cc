@@ -0,0 +1,113 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/utils.h"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "boost/filesystem/operations.hpp"
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+
+#include "maidsafe/vault_manager/messages/log_message.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+TEST(UtilsTest, BEH_PeekTag) {
+  EXPECT_EQ(MessageTag::kLogMessage, PeekTag(Serialise(LogMessage::tag, LogMessage("text"))));
+  EXPECT_THROW(PeekTag(tcp::Message()), maidsafe_error);
+}
+
+TEST(UtilsTest, BEH_BroadcastSerialised) {
+  std::vector<tcp::Message> sent;
+  SendFunctor record([&](tcp::ConnectionPtr, tcp::Message message) {
+    sent.push_back(std::move(message));
+  });
+  const tcp::Message kMessage{Serialise(LogMessage::tag, LogMessage("text"))};
+
+  // Nothing is sent to an empty list of connections.
+  BroadcastSerialised(std::vector<tcp::ConnectionPtr>(), kMessage, record);
+  Broadcast(std::vector<tcp::ConnectionPtr>(), LogMessage("text"), record);
+  EXPECT_TRUE(sent.empty());
+
+  // Each recipient gets an intact copy.
+  const std::vector<tcp::ConnectionPtr> kConnections(3);
+  BroadcastSerialised(kConnections, kMessage, record);
+  ASSERT_EQ(kConnections.size(), sent.size());
+  for (const auto& message : sent)
+    EXPECT_EQ(kMessage, message);
+
+  sent.clear();
+  Broadcast(kConnections, LogMessage("text"), record);
+  ASSERT_EQ(kConnections.size(), sent.size());
+  for (const auto& message : sent)
+    EXPECT_EQ(kMessage, message);
+
+  // A failure to send to one recipient doesn't affect the others.
+  sent.clear();
+  bool failed(false);
+  EXPECT_NO_THROW(BroadcastSerialised(
+      kConnections, kMessage, [&](tcp::ConnectionPtr connection, tcp::Message message) {
+        if (!failed) {
+          failed = true;
+          throw std::runtime_error("Send failed");
+        }
+        record(connection, std::move(message));
+      }));
+  ASSERT_EQ(kConnections.size() - 1, sent.size());
+  for (const auto& message : sent)
+    EXPECT_EQ(kMessage, message);
+}
+
+TEST(UtilsTest, BEH_CreateOwnerOnlyFile) {
+  namespace fs = boost::filesystem;
+  std::shared_ptr<fs::path> test_dir{maidsafe::test::CreateTestPath("MaidSafe_TestUtils")};
+  const fs::path path{*test_dir / "secret"};
+
+  // Restricted before anything is written to it.
+  CreateOwnerOnlyFile(path);
+  EXPECT_EQ(0U, fs::file_size(path));
+  EXPECT_EQ(fs::owner_read | fs::owner_write, fs::status(path).permissions());
+  ASSERT_TRUE(WriteFile(path, "secret"));
+  EXPECT_EQ(fs::owner_read | fs::owner_write, fs::status(path).permissions());
+
+  // An existing file which others can read is replaced rather than reused.
+  fs::permissions(path, fs::all_all);
+  CreateOwnerOnlyFile(path);
+  EXPECT_EQ(0U, fs::file_size(path));
+  EXPECT_EQ(fs::owner_read | fs::owner_write, fs::status(path).permissions());
+
+  EXPECT_THROW(CreateOwnerOnlyFile(*test_dir / "no_such_dir" / "secret"), maidsafe_error);
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,71 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/vault_config_channel.h"
+
+#ifndef MAIDSAFE_WIN32
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+#ifndef MAIDSAFE_WIN32
+TEST(VaultConfigChannelTest, BEH_HandOff) {
+  std::string data(RandomString(1000));
+  tcp::Message message(std::begin(data), std::end(data));
+  VaultConfigChannel channel{message};
+  ASSERT_TRUE(channel.IsOpen());
+
+  const std::string prefix{kVaultConfigFdVariable + "="};
+  auto environment(channel.ChildEnvironment());
+  auto entry(std::find_if(std::begin(environment), std::end(environment),
+                          [&](const std::string& variable) {
+                            return variable.compare(0, prefix.size(), prefix) == 0;
+                          }));
+  ASSERT_NE(std::end(environment), entry);
+
+  // Read through a duplicate, since the channel closes its own descriptor.
+  int fd{dup(std::stoi(entry->substr(prefix.size())))};
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(0, setenv(kVaultConfigFdVariable.c_str(), std::to_string(fd).c_str(), 1));
+  EXPECT_EQ(message, ReadVaultConfigChannel());
+  EXPECT_EQ(nullptr, std::getenv(kVaultConfigFdVariable.c_str()));
+  EXPECT_TRUE(ReadVaultConfigChannel().empty());
+
+  // Too large for the pipe's buffer, so the vault has to ask for its config instead.
+  VaultConfigChannel oversized_channel{tcp::Message(16 * 1024 * 1024, 'x')};
+  EXPECT_FALSE(oversized_channel.IsOpen());
+}
+#endif
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
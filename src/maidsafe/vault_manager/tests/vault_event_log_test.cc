@@ -0,0 +1,162 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/vault_event_log.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/passport/passport.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+TEST(VaultEventLogTest, BEH_GetSince) {
+  const std::size_t kMaxEvents(5);
+  VaultEventLog vault_event_log(kMaxEvents);
+  passport::PublicMaid::Name owner{
+      passport::PublicMaid{passport::CreateMaidAndSigner().first}.name()};
+  passport::PublicMaid::Name other_owner{
+      passport::PublicMaid{passport::CreateMaidAndSigner().first}.name()};
+  NonEmptyString label{RandomAlphaNumericString(10)};
+
+  EXPECT_TRUE(vault_event_log.GetSince(owner, 0).empty());
+
+  std::vector<VaultEvent> added;
+  for (int i(0); i < 3; ++i)
+    added.push_back(vault_event_log.Add(owner, VaultEventType::kStarted, label));
+  vault_event_log.Add(other_owner, VaultEventType::kJoined, label);
+
+  // Sequence numbers are contiguous and independent per owner.
+  EXPECT_EQ(added[0].sequence_number + 1, added[1].sequence_number);
+  EXPECT_EQ(added[1].sequence_number + 1, added[2].sequence_number);
+
+  std::vector<VaultEvent> events{vault_event_log.GetSince(owner, 0)};
+  ASSERT_EQ(3U, events.size());
+  EXPECT_EQ(added[0].sequence_number, events[0].sequence_number);
+  EXPECT_EQ(label, events[0].vault_label);
+
+  events = vault_event_log.GetSince(owner, added[1].sequence_number);
+  ASSERT_EQ(1U, events.size());
+  EXPECT_EQ(added[2].sequence_number, events[0].sequence_number);
+  EXPECT_TRUE(vault_event_log.GetSince(owner, added[2].sequence_number).empty());
+
+  // A sequence number ahead of the log causes a full replay.
+  EXPECT_EQ(3U, vault_event_log.GetSince(owner, added[2].sequence_number + 10).size());
+
+  // Only the newest 'kMaxEvents' are retained.
+  VaultEvent last;
+  for (std::size_t i(0); i < kMaxEvents; ++i)
+    last = vault_event_log.Add(owner, VaultEventType::kExited, label, -1);
+  events = vault_event_log.GetSince(owner, added[0].sequence_number);
+  ASSERT_EQ(kMaxEvents, events.size());
+  EXPECT_EQ(last.sequence_number, events.back().sequence_number);
+  EXPECT_EQ(VaultEventType::kExited, events.back().type);
+  EXPECT_EQ(-1, events.back().exit_code);
+}
+
+TEST(VaultEventLogTest, BEH_ReplayAfterGap) {
+  VaultEventLog vault_event_log(2);
+  passport::PublicMaid::Name owner{
+      passport::PublicMaid{passport::CreateMaidAndSigner().first}.name()};
+  NonEmptyString label{RandomAlphaNumericString(10)};
+  std::vector<VaultEvent> added;
+  for (int i(0); i < 4; ++i)
+    added.push_back(vault_event_log.Add(owner, VaultEventType::kStarted, label));
+
+  // The client missed 'added[1]', which has since been dropped.
+  std::vector<VaultEvent> events{vault_event_log.GetSince(owner, added[0].sequence_number)};
+  ASSERT_EQ(2U, events.size());
+  EXPECT_EQ(added[2].sequence_number, events[0].sequence_number);
+  EXPECT_TRUE(events[0].follows_gap);
+  EXPECT_FALSE(events[1].follows_gap);
+  events = vault_event_log.GetSince(owner, added[1].sequence_number);
+  ASSERT_EQ(2U, events.size());
+  EXPECT_FALSE(events[0].follows_gap);
+
+  // The client's last event is ahead of the log, as after a restart with the clock wound back.  All
+  // retained events are replayed, and later ones are numbered after the client's last.
+  const uint64_t client_last(added[3].sequence_number + (1ULL << 40));
+  events = vault_event_log.GetSince(owner, client_last);
+  ASSERT_EQ(2U, events.size());
+  EXPECT_TRUE(events[0].follows_gap);
+  EXPECT_EQ(client_last + 1,
+            vault_event_log.Add(owner, VaultEventType::kJoined, label).sequence_number);
+  events = vault_event_log.GetSince(owner, added[3].sequence_number);
+  ASSERT_EQ(1U, events.size());
+  EXPECT_EQ(client_last + 1, events[0].sequence_number);
+
+  // A restarted VaultManager which holds no events for the owner yet.  The next live event is
+  // the first one the client sees from the new log, so it's marked as following the gap.
+  VaultEventLog restarted_log(2);
+  EXPECT_TRUE(restarted_log.GetSince(owner, client_last + 1).empty());
+  VaultEvent live_event{restarted_log.Add(owner, VaultEventType::kStarted, label)};
+  EXPECT_EQ(client_last + 2, live_event.sequence_number);
+  EXPECT_TRUE(live_event.follows_gap);
+  EXPECT_FALSE(restarted_log.Add(owner, VaultEventType::kJoined, label).follows_gap);
+}
+
+TEST(VaultEventLogTest, BEH_ResumeAgainstRestartedLog) {
+  passport::PublicMaid::Name owner{
+      passport::PublicMaid{passport::CreateMaidAndSigner().first}.name()};
+  NonEmptyString label{RandomAlphaNumericString(10)};
+  VaultEventLog old_log(2);
+  const uint64_t client_last(
+      old_log.Add(owner, VaultEventType::kStarted, label).sequence_number);
+
+  // The manager restarts and the client resumes before anything happens for its owner.  Nothing
+  // can be replayed, so the first live event carries the gap flag.
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  VaultEventLog restarted_log(2);
+  EXPECT_TRUE(restarted_log.GetSince(owner, client_last).empty());
+  std::vector<VaultEvent> added;
+  added.push_back(restarted_log.Add(owner, VaultEventType::kExited, label, 1));
+  EXPECT_LT(client_last, added[0].sequence_number);
+  EXPECT_TRUE(added[0].follows_gap);
+  added.push_back(restarted_log.Add(owner, VaultEventType::kStarted, label));
+  EXPECT_FALSE(added[1].follows_gap);
+
+  // Replays from the new log don't flag a gap for a client which has caught up with it.
+  std::vector<VaultEvent> events{restarted_log.GetSince(owner, added[0].sequence_number)};
+  ASSERT_EQ(1U, events.size());
+  EXPECT_FALSE(events[0].follows_gap);
+
+  // A client resuming after the events were added gets them replayed, the first marked.
+  events = restarted_log.GetSince(owner, client_last);
+  ASSERT_EQ(2U, events.size());
+  EXPECT_TRUE(events[0].follows_gap);
+  EXPECT_FALSE(events[1].follows_gap);
+  EXPECT_FALSE(restarted_log.GetSince(owner, 0).front().follows_gap);
+
+  // A client which has seen no events is never told of a gap.
+  VaultEventLog fresh_log(2);
+  EXPECT_TRUE(fresh_log.GetSince(owner, 0).empty());
+  EXPECT_FALSE(fresh_log.Add(owner, VaultEventType::kStarted, label).follows_gap);
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,70 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/vault_keys_cache.h"
+
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/passport/passport.h"
+
+#include "maidsafe/vault_manager/messages/vault_running_response.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+TEST(VaultKeysCacheTest, BEH_GetAndEvict) {
+  VaultKeysCache vault_keys_cache(2);
+  const NonEmptyString label0{RandomAlphaNumericString(8)}, label1{RandomAlphaNumericString(8)},
+      label2{RandomAlphaNumericString(8)};
+  const passport::PmidAndSigner pmid_and_signer0{passport::CreatePmidAndSigner()},
+      pmid_and_signer1{passport::CreatePmidAndSigner()};
+
+  // The bundle is reused until the vault's identity changes.
+  auto encrypted_keys(vault_keys_cache.Get(label0, pmid_and_signer0));
+  EXPECT_EQ(encrypted_keys, vault_keys_cache.Get(label0, pmid_and_signer0));
+  auto replaced_keys(vault_keys_cache.Get(label0, pmid_and_signer1));
+  EXPECT_NE(encrypted_keys, replaced_keys);
+  EXPECT_EQ(1U, vault_keys_cache.Size());
+
+  // A cached bundle must decrypt to the original keys.
+  VaultRunningResponse parsed{Parse<VaultRunningResponse>(Serialise(
+      VaultRunningResponse(label0, 1, vault_keys_cache.Get(label0, pmid_and_signer1))))};
+  ASSERT_TRUE(parsed.vault_keys && parsed.vault_keys->pmid_and_signer);
+  EXPECT_EQ(pmid_and_signer1.first.name(), parsed.vault_keys->pmid_and_signer->first.name());
+
+  // Touching 'label0' leaves 'label1' as the least recently used.
+  vault_keys_cache.Get(label1, pmid_and_signer0);
+  EXPECT_EQ(replaced_keys, vault_keys_cache.Get(label0, pmid_and_signer1));
+  vault_keys_cache.Get(label2, pmid_and_signer0);
+  EXPECT_EQ(2U, vault_keys_cache.Size());
+  EXPECT_EQ(replaced_keys, vault_keys_cache.Get(label0, pmid_and_signer1));
+
+  vault_keys_cache.Remove(label0);
+  vault_keys_cache.Remove(label0);
+  EXPECT_EQ(1U, vault_keys_cache.Size());
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -18,16 +18,37 @@
 
 #include "maidsafe/vault_manager/vault_manager.h"
 
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
+#include "asio/io_service_strand.hpp"
 #include "boost/filesystem/path.hpp"
 
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/on_scope_exit.h"
 #include "maidsafe/common/process.h"
 #include "maidsafe/common/test.h"
 #include "maidsafe/common/utils.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/common/tcp/connection.h"
+#include "maidsafe/passport/passport.h"
 
+#include "maidsafe/vault_manager/client_interface.h"
 #include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/discovery_file.h"
 #include "maidsafe/vault_manager/utils.h"
+#include "maidsafe/vault_manager/vault_event.h"
+#include "maidsafe/vault_manager/messages/challenge.h"
+#include "maidsafe/vault_manager/messages/challenge_response.h"
+#include "maidsafe/vault_manager/messages/take_ownership_request.h"
+#include "maidsafe/vault_manager/messages/validate_connection_request.h"
+#include "maidsafe/vault_manager/messages/vault_running_response.h"
 #include "maidsafe/vault_manager/tests/test_utils.h"
 
 namespace fs = boost::filesystem;
@@ -49,6 +70,232 @@ TEST(VaultManagerTest, BEH_Basic) {
   std::this_thread::sleep_for(std::chrono::seconds(1));
 }
 
+TEST(VaultManagerTest, BEH_ConnectionFlood) {
+  std::shared_ptr<fs::path> test_env_root_dir{
+      maidsafe::test::CreateTestPath("MaidSafe_TestVaultManager")};
+  fs::path path_to_vault{process::GetOtherExecutablePath("dummy_vault")};
+  SetEnvironment(tcp::Port{7777}, *test_env_root_dir, path_to_vault, 1);
+
+  AdmissionControl::Limits limits;
+  limits.max_new_connections_per_second = 20;
+  limits.max_pending_connections = 8;
+  VaultManager vault_manager{kCryptoThreadCount, limits};
+  passport::MaidAndSigner maid_and_signer{passport::CreateMaidAndSigner()};
+  ClientInterface client_interface{maid_and_signer.first};
+  std::atomic<int> vault_failures{0};
+  client_interface.SubscribeToVaultEvents([&](const VaultEvent& vault_event) {
+    if (vault_event.type == VaultEventType::kExited ||
+        vault_event.type == VaultEventType::kRestarted) {
+      ++vault_failures;
+    }
+  });
+
+  // Open and drop connections as fast as possible, far beyond the rate limit.
+  std::atomic<bool> stop_flood{false};
+  std::atomic<int> flood_count{0};
+  AsioService asio_service{1};
+  asio::io_service::strand strand{asio_service.service()};
+  std::thread flood{[&] {
+    while (!stop_flood) {
+      try {
+        tcp::Connection::MakeShared(strand, GetInitialListeningPort())->Close();
+        ++flood_count;
+      } catch (const std::exception&) {
+      }
+    }
+  }};
+  on_scope_exit join_flood{[&] {
+    stop_flood = true;
+    flood.join();
+  }};
+
+  // A vault started during the flood must still be able to connect to the VaultManager.
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  StartVaultSpec spec{*test_env_root_dir / "vault", DiskUsage{1000}};
+  spec.pmid_list_index = 0;
+  auto results(client_interface.StartVaults({spec}));
+  ASSERT_EQ(1U, results.size());
+  ASSERT_EQ(std::future_status::ready, results[0].wait_for(kRpcTimeout * 3));
+  std::unique_ptr<passport::PmidAndSigner> pmid_and_signer;
+  ASSERT_NO_THROW(pmid_and_signer = results[0].get());
+  ASSERT_TRUE(pmid_and_signer != nullptr);
+
+  // The established vault must keep running while the flood continues.
+  std::this_thread::sleep_for(std::chrono::seconds(1));
+  join_flood.Release();
+  stop_flood = true;
+  flood.join();
+  EXPECT_EQ(0, vault_failures);
+
+  AdmissionControl::Stats stats{vault_manager.GetAdmissionStats()};
+  LOG(kInfo) << "Flooded with " << flood_count << " connections.  Admitted "
+             << stats.admitted_connections << ", rejected " << stats.rejected_connections
+             << ", evicted " << stats.evicted_connections << ", admitted for vaults only "
+             << stats.vault_only_connections;
+  EXPECT_GT(static_cast<uint64_t>(flood_count), 2 * limits.max_new_connections_per_second);
+  EXPECT_GT(stats.rejected_connections, 0U);
+  EXPECT_LT(stats.admitted_connections, static_cast<uint64_t>(flood_count));
+  EXPECT_EQ(0U, stats.rejected_challenges);
+
+  // Once the flood stops, new clients are admitted again.
+  std::this_thread::sleep_for(std::chrono::seconds(1));
+  std::unique_ptr<ClientInterface> other_client;
+  EXPECT_NO_THROW(other_client.reset(new ClientInterface{maid_and_signer.first}));
+}
+
+TEST(VaultManagerTest, BEH_RequestStraightAfterChallengeResponse) {
+  std::shared_ptr<fs::path> test_env_root_dir{
+      maidsafe::test::CreateTestPath("MaidSafe_TestVaultManager")};
+  fs::path path_to_vault{process::GetOtherExecutablePath("dummy_vault")};
+  SetEnvironment(tcp::Port{7777}, *test_env_root_dir, path_to_vault);
+
+  VaultManager vault_manager;
+  passport::Maid maid{passport::CreateMaidAndSigner().first};
+  AsioService asio_service{1};
+  asio::io_service::strand strand{asio_service.service()};
+  tcp::ConnectionPtr connection{tcp::Connection::MakeShared(strand, GetInitialListeningPort())};
+  const NonEmptyString kLabel{GenerateLabel()};
+  std::promise<VaultRunningResponse> response;
+  connection->Start(
+      [&](tcp::Message message) {
+        InputVectorStream binary_input_stream{std::move(message)};
+        MessageTag tag(static_cast<MessageTag>(-1));
+        Parse(binary_input_stream, tag);
+        if (tag == MessageTag::kChallenge) {
+          Challenge challenge{Parse<Challenge>(binary_input_stream)};
+          // Send a request without waiting for the SessionTicket which confirms validation.
+          Send(connection, ChallengeResponse(passport::PublicMaid(maid),
+                                             asymm::Sign(challenge.plaintext, maid.private_key())));
+          Send(connection, TakeOwnershipRequest(kLabel, 1, *test_env_root_dir, DiskUsage{1000}));
+        } else if (tag == MessageTag::kVaultRunningResponse) {
+          response.set_value(Parse<VaultRunningResponse>(binary_input_stream));
+        }
+      },
+      [] {});
+  Send(connection, ValidateConnectionRequest());
+
+  auto future(response.get_future());
+  ASSERT_EQ(std::future_status::ready, future.wait_for(kRpcTimeout));
+  VaultRunningResponse vault_running_response{future.get()};
+  ASSERT_TRUE(static_cast<bool>(vault_running_response.error));
+  // The request is handled once the client is validated, so fails only for want of the vault.
+  EXPECT_EQ(make_error_code(CommonErrors::no_such_element), vault_running_response.error->code());
+  connection->Close();
+}
+
+TEST(VaultManagerTest, BEH_StaleDiscoveryFile) {
+  std::shared_ptr<fs::path> test_env_root_dir{
+      maidsafe::test::CreateTestPath("MaidSafe_TestVaultManager")};
+  fs::path path_to_vault{process::GetOtherExecutablePath("dummy_vault")};
+  SetEnvironment(tcp::Port{7777}, *test_env_root_dir, path_to_vault);
+
+  VaultManager vault_manager;
+  auto discovery_record(ReadDiscoveryFile(GetDiscoveryFilePath()));
+  ASSERT_TRUE(discovery_record);
+  // A record naming a different instance at the same port must not be trusted, so the client falls
+  // back to scanning the port range.
+  discovery_record->instance_id = RandomAlphaNumericString(16);
+  WriteDiscoveryFile(GetDiscoveryFilePath(), *discovery_record);
+  passport::MaidAndSigner maid_and_signer{passport::CreateMaidAndSigner()};
+  EXPECT_NO_THROW(ClientInterface client_interface{maid_and_signer.first});
+}
+
+TEST(VaultManagerTest, BEH_BatchStartVaults) {
+  std::shared_ptr<fs::path> test_env_root_dir{
+      maidsafe::test::CreateTestPath("MaidSafe_TestVaultManager")};
+  fs::path path_to_vault{process::GetOtherExecutablePath("dummy_vault")};
+  const int kVaultCount(3);
+  SetEnvironment(tcp::Port{7777}, *test_env_root_dir, path_to_vault, kVaultCount);
+
+  VaultManager vault_manager;
+  passport::MaidAndSigner maid_and_signer{passport::CreateMaidAndSigner()};
+  ClientInterface client_interface{maid_and_signer.first};
+  std::vector<StartVaultSpec> specs;
+  for (int i(0); i < kVaultCount; ++i) {
+    specs.emplace_back(*test_env_root_dir / ("vault_" + std::to_string(i)), DiskUsage{1000});
+    specs.back().pmid_list_index = i;
+  }
+  // All the vaults are started concurrently, none conflicting with another still starting.
+  auto results(client_interface.StartVaults(specs));
+  ASSERT_EQ(specs.size(), results.size());
+  for (int i(0); i < kVaultCount; ++i) {
+    ASSERT_EQ(std::future_status::ready, results[i].wait_for(kRpcTimeout * 3));
+    std::unique_ptr<passport::PmidAndSigner> pmid_and_signer;
+    ASSERT_NO_THROW(pmid_and_signer = results[i].get());
+    ASSERT_TRUE(pmid_and_signer != nullptr);
+    EXPECT_EQ(GetPmidAndSigner(i).first.name(), pmid_and_signer->first.name());
+  }
+}
+
+// Each owner's events have their own sequence, so a client multiplexing two Maids over one
+// connection is only sent those of its primary Maid.  The second Maid's events go to its own
+// connection, numbered independently.
+TEST(VaultManagerTest, BEH_VaultEventsOfMultiplexedOwners) {
+  std::shared_ptr<fs::path> test_env_root_dir{
+      maidsafe::test::CreateTestPath("MaidSafe_TestVaultManager")};
+  fs::path path_to_vault{process::GetOtherExecutablePath("dummy_vault")};
+  SetEnvironment(tcp::Port{7777}, *test_env_root_dir, path_to_vault);
+
+  VaultManager vault_manager;
+  passport::MaidAndSigner first_maid_and_signer{passport::CreateMaidAndSigner()};
+  passport::MaidAndSigner second_maid_and_signer{passport::CreateMaidAndSigner()};
+  ClientInterface multiplexing_client{first_maid_and_signer.first};
+  multiplexing_client.AddMaid(second_maid_and_signer.first).get();
+  ClientInterface second_client{second_maid_and_signer.first};
+
+  std::mutex mutex;
+  std::vector<VaultEvent> multiplexed_events, second_events;
+  multiplexing_client.SubscribeToVaultEvents([&](const VaultEvent& vault_event) {
+    std::lock_guard<std::mutex> lock{mutex};
+    multiplexed_events.push_back(vault_event);
+  });
+  second_client.SubscribeToVaultEvents([&](const VaultEvent& vault_event) {
+    std::lock_guard<std::mutex> lock{mutex};
+    second_events.push_back(vault_event);
+  });
+
+  StartVaultSpec first_spec{*test_env_root_dir / "first", DiskUsage{1000}};
+  StartVaultSpec second_spec{*test_env_root_dir / "second", DiskUsage{1000}};
+  second_spec.owner = passport::PublicMaid(second_maid_and_signer.first).name();
+  auto results(multiplexing_client.StartVaults({first_spec, second_spec}));
+  for (auto& result : results) {
+    ASSERT_EQ(std::future_status::ready, result.wait_for(kRpcTimeout * 3));
+    ASSERT_TRUE(result.get() != nullptr);
+  }
+
+  // Allow time for any event which shouldn't have been sent to arrive.
+  std::this_thread::sleep_for(kRpcTimeout);
+  std::lock_guard<std::mutex> lock{mutex};
+  ASSERT_EQ(1U, multiplexed_events.size());
+  ASSERT_EQ(1U, second_events.size());
+  EXPECT_EQ(VaultEventType::kStarted, multiplexed_events.front().type);
+  EXPECT_EQ(VaultEventType::kStarted, second_events.front().type);
+  EXPECT_NE(multiplexed_events.front().vault_label, second_events.front().vault_label);
+  EXPECT_EQ(multiplexed_events.front().sequence_number, second_events.front().sequence_number);
+  EXPECT_FALSE(multiplexed_events.front().follows_gap);
+  EXPECT_FALSE(second_events.front().follows_gap);
+}
+
+TEST(VaultManagerTest, BEH_HostedVaults) {
+  std::shared_ptr<fs::path> test_env_root_dir{
+      maidsafe::test::CreateTestPath("MaidSafe_TestVaultManager")};
+  fs::path path_to_vault{process::GetOtherExecutablePath("dummy_vault")};
+  SetEnvironment(tcp::Port{7777}, *test_env_root_dir, path_to_vault);
+
+  // Ten vaults need three hosts.
+  VaultManager vault_manager{kCryptoThreadCount, AdmissionControl::Limits(), -1, 4};
+  passport::MaidAndSigner maid_and_signer{passport::CreateMaidAndSigner()};
+  ClientInterface client_interface{maid_and_signer.first};
+  std::vector<StartVaultSpec> specs;
+  for (int i(0); i < 10; ++i)
+    specs.emplace_back(*test_env_root_dir / ("vault_" + std::to_string(i)), DiskUsage{1000});
+  auto results(client_interface.StartVaults(specs));
+  for (auto& result : results) {
+    ASSERT_EQ(std::future_status::ready, result.wait_for(kRpcTimeout * 3));
+    EXPECT_TRUE(result.get() != nullptr);
+  }
+}
+
 }  // namespace test
 
 }  // namespace vault_manager
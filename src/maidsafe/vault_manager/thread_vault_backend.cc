@@ -0,0 +1,275 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/thread_vault_backend.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "asio/io_service_strand.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/common/tcp/connection.h"
+#include "maidsafe/common/tcp/listener.h"
+
+#include "maidsafe/vault_manager/utils.h"
+#include "maidsafe/vault_manager/vault_host.h"
+#include "maidsafe/vault_manager/messages/hosted_vault_exited.h"
+#include "maidsafe/vault_manager/messages/start_hosted_vault.h"
+#include "maidsafe/vault_manager/messages/stop_hosted_vault.h"
+#include "maidsafe/vault_manager/messages/vault_started.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace {
+
+// Hosted vault IDs are reported to the VaultManager as process IDs and may be handed to the
+// process functions in common, so they must fit in a pid_t or DWORD.  They're allocated from above
+// the range of real process IDs on all supported platforms (at most 2^22 on Linux) up to the
+// largest positive 32-bit value.
+const ProcessId kFirstVaultId(ProcessId{1} << 30);
+const ProcessId kLastVaultId(std::numeric_limits<std::int32_t>::max());
+
+class ThreadVaultBackend : public ProcessBackend {
+ public:
+  ThreadVaultBackend(asio::io_service& io_service, std::size_t vaults_per_host)
+      : io_service_(io_service),
+        strand_(io_service),
+        kVaultsPerHost_(std::max(vaults_per_host, std::size_t{1})),
+        host_processes_(MakeProcessBackend(io_service)),
+        mutex_(),
+        on_exit_(),
+        listener_(),
+        hosts_(),
+        vault_hosts_(),
+        next_vault_id_(kFirstVaultId) {}
+
+  ~ThreadVaultBackend() { Stop(); }
+
+  void Start(OnExitFunctor on_exit) override {
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      on_exit_ = std::move(on_exit);
+    }
+    host_processes_->Start(
+        [this](ProcessId host_id, int exit_code) { HandleHostExit(host_id, exit_code); });
+  }
+
+  // The hosts stop their remaining vaults once disconnected.
+  void Stop() override {
+    host_processes_->Stop();
+    std::lock_guard<std::mutex> lock{mutex_};
+    on_exit_ = nullptr;
+    if (listener_)
+      listener_->StopListening();
+    for (auto& host : hosts_) {
+      host.second.closing = true;
+      if (host.second.connection)
+        host.second.connection->Close();
+    }
+  }
+
+  ProcessId Spawn(const std::vector<std::string>& args,
+                  const VaultConfigChannel* /*config_channel*/) override {
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (!listener_) {
+      // Listen on the first free port above the VaultManager's.
+      listener_ = tcp::Listener::MakeShared(
+          strand_, [this](tcp::ConnectionPtr connection) { HandleNewConnection(connection); },
+          static_cast<tcp::Port>(std::stoi(args.at(1)) + 1));
+    }
+    auto host_itr(std::find_if(std::begin(hosts_), std::end(hosts_),
+                               [this](const std::pair<const ProcessId, Host>& host) {
+      return !host.second.closing && host.second.vault_ids.size() < kVaultsPerHost_;
+    }));
+    if (host_itr == std::end(hosts_)) {
+      std::vector<std::string> host_args{args.front(), kVaultHostArgument,
+                                         std::to_string(listener_->ListeningPort())};
+      ProcessId host_id{host_processes_->Spawn(host_args, nullptr)};
+      LOG(kInfo) << "Started vault host with process ID " << host_id;
+      host_itr = hosts_.emplace(host_id, Host()).first;
+    }
+    if (next_vault_id_ > kLastVaultId) {
+      LOG(kError) << "Exhausted the range of hosted vault IDs.";
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::cannot_exceed_limit));
+    }
+    const ProcessId vault_id{next_vault_id_++};
+    host_itr->second.vault_ids.insert(vault_id);
+    vault_hosts_.emplace(vault_id, host_itr->first);
+    SendToHost(host_itr->second, StartHostedVault(vault_id, args));
+    return vault_id;
+  }
+
+  void Terminate(ProcessId vault_id) override {
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto itr(vault_hosts_.find(vault_id));
+    if (itr != std::end(vault_hosts_))
+      SendToHost(hosts_.at(itr->second), StopHostedVault(vault_id));
+  }
+
+  bool IsRunning(ProcessId vault_id) const override {
+    std::lock_guard<std::mutex> lock{mutex_};
+    return vault_hosts_.count(vault_id) != 0;
+  }
+
+  bool CanHandOffConfig() const override { return false; }
+
+ private:
+  struct Host {
+    Host() : connection(), pending(), vault_ids(), closing(false) {}
+    tcp::ConnectionPtr connection;  // Null until the host connects.
+    std::vector<tcp::Message> pending;  // Sent once the host connects.
+    std::set<ProcessId> vault_ids;
+    bool closing;  // Set once the host has been disconnected, or is about to be.
+  };
+
+  template <typename T>
+  void SendToHost(Host& host, T message) {
+    tcp::Message serialised{Serialise(T::tag, std::move(message))};
+    if (host.connection)
+      host.connection->Send(std::move(serialised));
+    else
+      host.pending.push_back(std::move(serialised));
+  }
+
+  void HandleNewConnection(tcp::ConnectionPtr connection) {
+    connection->Start(
+        [=](tcp::Message message) { HandleReceivedMessage(connection, std::move(message)); },
+        [=] { HandleConnectionClosed(connection); });
+  }
+
+  void HandleReceivedMessage(tcp::ConnectionPtr connection, tcp::Message&& message) {
+    try {
+      InputVectorStream binary_input_stream(std::move(message));
+      MessageTag tag(static_cast<MessageTag>(-1));
+      Parse(binary_input_stream, tag);
+      switch (tag) {
+        case MessageTag::kVaultStarted:
+          HandleHostStarted(connection, Parse<VaultStarted>(binary_input_stream).process_id);
+          break;
+        case MessageTag::kHostedVaultExited: {
+          auto exited(Parse<HostedVaultExited>(binary_input_stream));
+          std::lock_guard<std::mutex> lock{mutex_};
+          HandleVaultExit(exited.vault_id, exited.exit_code);
+          break;
+        }
+        default:
+          LOG(kError) << "Invalid tag " << tag << " from vault host.";
+          return connection->Close();
+      }
+    } catch (const std::exception& e) {
+      LOG(kError) << "Failed to handle message from vault host: "
+                  << boost::diagnostic_information(e);
+      connection->Close();
+    }
+  }
+
+  // A host identifies itself by sending its process ID.
+  void HandleHostStarted(tcp::ConnectionPtr connection, ProcessId host_id) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto itr(hosts_.find(host_id));
+    if (itr == std::end(hosts_) || itr->second.connection) {
+      LOG(kError) << "Connection claiming to be unknown vault host " << host_id;
+      return connection->Close();
+    }
+    itr->second.connection = connection;
+    for (auto& message : itr->second.pending)
+      connection->Send(std::move(message));
+    itr->second.pending.clear();
+  }
+
+  // A host which unexpectedly loses its connection can't be told to start or stop vaults, so it's
+  // terminated.  Its vaults are reported as exited when the host process exits.
+  void HandleConnectionClosed(tcp::ConnectionPtr connection) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    for (auto& host : hosts_) {
+      if (host.second.connection == connection && !host.second.closing) {
+        host.second.closing = true;
+        host_processes_->Terminate(host.first);
+        return;
+      }
+    }
+  }
+
+  void HandleHostExit(ProcessId host_id, int exit_code) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto itr(hosts_.find(host_id));
+    if (itr == std::end(hosts_))
+      return;
+    LOG(kInfo) << "Vault host with process ID " << host_id << " exited with " << exit_code;
+    std::set<ProcessId> vault_ids;
+    vault_ids.swap(itr->second.vault_ids);
+    for (ProcessId vault_id : vault_ids)
+      HandleVaultExit(vault_id, exit_code);
+    hosts_.erase(host_id);
+  }
+
+  // Must be called with 'mutex_' held.
+  void HandleVaultExit(ProcessId vault_id, int exit_code) {
+    auto itr(vault_hosts_.find(vault_id));
+    if (itr == std::end(vault_hosts_))
+      return;
+    auto host_itr(hosts_.find(itr->second));
+    vault_hosts_.erase(itr);
+    if (host_itr != std::end(hosts_)) {
+      host_itr->second.vault_ids.erase(vault_id);
+      // Disconnecting an idle host makes it exit.
+      if (host_itr->second.vault_ids.empty() && host_itr->second.connection) {
+        host_itr->second.closing = true;
+        host_itr->second.connection->Close();
+      }
+    }
+    if (on_exit_) {
+      OnExitFunctor on_exit{on_exit_};
+      io_service_.post([on_exit, vault_id, exit_code] { on_exit(vault_id, exit_code); });
+    }
+  }
+
+  asio::io_service& io_service_;
+  asio::io_service::strand strand_;
+  const std::size_t kVaultsPerHost_;
+  std::shared_ptr<ProcessBackend> host_processes_;
+  mutable std::mutex mutex_;
+  OnExitFunctor on_exit_;
+  std::shared_ptr<tcp::Listener> listener_;
+  std::map<ProcessId, Host> hosts_;  // By the host's process ID.
+  std::map<ProcessId, ProcessId> vault_hosts_;  // The host's process ID by vault ID.
+  ProcessId next_vault_id_;
+};
+
+}  // unnamed namespace
+
+std::shared_ptr<ProcessBackend> MakeThreadVaultBackend(asio::io_service& io_service,
+                                                       std::size_t vaults_per_host) {
+  return std::make_shared<ThreadVaultBackend>(io_service, vaults_per_host);
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
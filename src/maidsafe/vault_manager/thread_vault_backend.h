@@ -0,0 +1,47 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_THREAD_VAULT_BACKEND_H_
+#define MAIDSAFE_VAULT_MANAGER_THREAD_VAULT_BACKEND_H_
+
+#include <cstddef>
+#include <memory>
+
+#include "asio/io_service.hpp"
+
+#include "maidsafe/vault_manager/process_backend.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Runs each vault as a thread of a vault host process (see vault_host.h) rather than as a process
+// of its own, so that a local network needs fewer processes.  Each hosted vault still has its own
+// VaultInterface connection and thread.  A new host is started whenever each of the others already
+// runs 'vaults_per_host' vaults, and is told to close once its last vault has exited.  The IDs
+// allocated to hosted vaults can't clash with any real process ID.  Hosted vaults aren't handed
+// their config when spawned, and are stopped by their host when it loses the VaultManager, so they
+// can't be re-adopted.
+std::shared_ptr<ProcessBackend> MakeThreadVaultBackend(asio::io_service& io_service,
+                                                       std::size_t vaults_per_host);
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_THREAD_VAULT_BACKEND_H_
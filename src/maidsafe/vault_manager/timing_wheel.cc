@@ -0,0 +1,260 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/timing_wheel.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace {
+
+const unsigned kLevelCount(4);
+const unsigned kSlotBits(8);
+const uint32_t kSlotCount(1U << kSlotBits);
+const uint32_t kSlotMask(kSlotCount - 1);
+// Used for 'no entry' in the slot lists.
+const uint32_t kNil(std::numeric_limits<uint32_t>::max());
+const uint64_t kNoTick(std::numeric_limits<uint64_t>::max());
+// The furthest ahead an entry can be placed; longer timeouts are clamped to this (497 days at the
+// default resolution).
+const uint64_t kMaxTicksAhead((uint64_t{1} << (kSlotBits * kLevelCount)) - 1);
+
+}  // unnamed namespace
+
+TimingWheel::TimingWheel(asio::io_service& io_service, std::chrono::milliseconds resolution,
+                         std::shared_ptr<Clock> clock)
+    : strand_(io_service),
+      kClock_(clock ? std::move(clock) : SteadyClock()),
+      kResolution_(std::max(resolution, std::chrono::milliseconds(1))),
+      kStartTime_(kClock_->Now()),
+      mutex_(),
+      entries_(),
+      free_entries_(),
+      slot_heads_(kLevelCount * kSlotCount, kNil),
+      current_tick_(0),
+      scheduled_tick_(kNoTick),
+      size_(0),
+      timer_(kClock_->MakeTimer(io_service)) {}
+
+std::shared_ptr<TimingWheel> TimingWheel::MakeShared(asio::io_service& io_service,
+                                                     std::chrono::milliseconds resolution,
+                                                     std::shared_ptr<Clock> clock) {
+  return std::shared_ptr<TimingWheel>{new TimingWheel{io_service, resolution, std::move(clock)}};
+}
+
+TimingWheel::~TimingWheel() {}
+
+TimingWheel::TimerId TimingWheel::Add(std::chrono::steady_clock::duration timeout,
+                                      Functor on_expiry) {
+  TimerId timer_id(0);
+  bool rearm(false);
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    const uint64_t now_tick(TickAt(kClock_->Now()));
+    // With nothing pending the wheel isn't ticking, so catch it up to now.
+    if (size_ == 0)
+      current_tick_ = std::max(current_tick_, now_tick);
+
+    uint64_t ticks(0);
+    if (timeout > std::chrono::steady_clock::duration::zero()) {
+      ticks = static_cast<uint64_t>((timeout - std::chrono::steady_clock::duration(1)) /
+                                    kResolution_) + 1;
+    }
+    // The current tick is already partly over, so count from the next one.
+    const uint64_t expiry_tick(
+        std::min(now_tick + 1 + std::min(ticks, kMaxTicksAhead), current_tick_ + kMaxTicksAhead));
+
+    uint32_t index;
+    if (free_entries_.empty()) {
+      index = static_cast<uint32_t>(entries_.size());
+      entries_.emplace_back();
+    } else {
+      index = free_entries_.back();
+      free_entries_.pop_back();
+    }
+    Entry& entry(entries_[index]);
+    entry.on_expiry = std::move(on_expiry);
+    entry.expiry_tick = expiry_tick;
+    entry.pending = true;
+    Link(index);
+    ++size_;
+    timer_id = (static_cast<TimerId>(entry.generation) << 32) | index;
+
+    if (expiry_tick < scheduled_tick_) {
+      scheduled_tick_ = expiry_tick;
+      rearm = true;
+    }
+  }
+  if (rearm) {
+    // The timer isn't threadsafe, so only touch it on the strand.
+    std::weak_ptr<TimingWheel> timing_wheel{shared_from_this()};
+    strand_.post([timing_wheel] {
+      if (auto self = timing_wheel.lock())
+        self->ArmTimer();
+    });
+  }
+  return timer_id;
+}
+
+bool TimingWheel::Cancel(TimerId timer_id) {
+  const uint32_t index(static_cast<uint32_t>(timer_id & 0xffffffff));
+  const uint32_t generation(static_cast<uint32_t>(timer_id >> 32));
+  Functor discarded;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (index >= entries_.size() || !entries_[index].pending ||
+        entries_[index].generation != generation) {
+      return false;
+    }
+    Unlink(index);
+    discarded = Release(index);
+  }
+  // Leave the asio timer armed; if nothing is due when it fires, it will be re-armed later or not
+  // at all.
+  return true;
+}
+
+std::size_t TimingWheel::Size() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return size_;
+}
+
+uint64_t TimingWheel::TickAt(std::chrono::steady_clock::time_point time_point) const {
+  return static_cast<uint64_t>((time_point - kStartTime_) / kResolution_);
+}
+
+void TimingWheel::Link(uint32_t index) {
+  Entry& entry(entries_[index]);
+  const uint64_t ticks_ahead(entry.expiry_tick - current_tick_);
+  unsigned level(0);
+  while (level + 1 < kLevelCount && ticks_ahead >= (uint64_t{1} << (kSlotBits * (level + 1))))
+    ++level;
+  entry.slot = level * kSlotCount +
+               static_cast<uint32_t>((entry.expiry_tick >> (kSlotBits * level)) & kSlotMask);
+  uint32_t& head(slot_heads_[entry.slot]);
+  entry.previous = kNil;
+  entry.next = head;
+  if (head != kNil)
+    entries_[head].previous = index;
+  head = index;
+}
+
+void TimingWheel::Unlink(uint32_t index) {
+  Entry& entry(entries_[index]);
+  if (entry.previous == kNil)
+    slot_heads_[entry.slot] = entry.next;
+  else
+    entries_[entry.previous].next = entry.next;
+  if (entry.next != kNil)
+    entries_[entry.next].previous = entry.previous;
+}
+
+TimingWheel::Functor TimingWheel::Release(uint32_t index) {
+  Entry& entry(entries_[index]);
+  Functor on_expiry(std::move(entry.on_expiry));
+  entry.on_expiry = nullptr;
+  entry.pending = false;
+  if (++entry.generation == 0)
+    entry.generation = 1;
+  free_entries_.push_back(index);
+  --size_;
+  return on_expiry;
+}
+
+void TimingWheel::Cascade(unsigned level) {
+  uint32_t& head(
+      slot_heads_[level * kSlotCount +
+                  static_cast<uint32_t>((current_tick_ >> (kSlotBits * level)) & kSlotMask)]);
+  uint32_t index(head);
+  head = kNil;
+  while (index != kNil) {
+    uint32_t next(entries_[index].next);
+    Link(index);
+    index = next;
+  }
+}
+
+uint64_t TimingWheel::NextTick() const {
+  // Nothing can expire before either the next occupied slot of the lowest level, or the next
+  // cascade from the levels above.
+  for (uint64_t tick(current_tick_ + 1);; ++tick) {
+    if ((tick & kSlotMask) == 0 || slot_heads_[tick & kSlotMask] != kNil)
+      return tick;
+  }
+}
+
+void TimingWheel::ArmTimer() {
+  uint64_t scheduled_tick;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    scheduled_tick = scheduled_tick_;
+  }
+  if (scheduled_tick == kNoTick)
+    return;
+  // Re-arming cancels any earlier wait, so only one wait is ever outstanding.
+  std::weak_ptr<TimingWheel> timing_wheel{shared_from_this()};
+  timer_->WaitUntil(kStartTime_ + kResolution_ * scheduled_tick, strand_.wrap([timing_wheel] {
+    if (auto self = timing_wheel.lock())
+      self->HandleTick();
+  }));
+}
+
+void TimingWheel::HandleTick() {
+  std::vector<Functor> expired;
+  bool rearm(false);
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    const uint64_t now_tick(TickAt(kClock_->Now()));
+    while (current_tick_ < now_tick && size_ != 0) {
+      ++current_tick_;
+      for (unsigned level(1); level < kLevelCount; ++level) {
+        if ((current_tick_ & ((uint64_t{1} << (kSlotBits * level)) - 1)) != 0)
+          break;
+        Cascade(level);
+      }
+      uint32_t& head(slot_heads_[current_tick_ & kSlotMask]);
+      while (head != kNil) {
+        uint32_t index(head);
+        Unlink(index);
+        expired.push_back(Release(index));
+      }
+    }
+    if (size_ == 0) {
+      current_tick_ = std::max(current_tick_, now_tick);
+      scheduled_tick_ = kNoTick;
+    } else {
+      scheduled_tick_ = NextTick();
+      rearm = true;
+    }
+  }
+  for (auto& on_expiry : expired) {
+    if (on_expiry)
+      on_expiry();
+  }
+  if (rearm)
+    ArmTimer();
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
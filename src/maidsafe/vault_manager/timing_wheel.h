@@ -0,0 +1,115 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_TIMING_WHEEL_H_
+#define MAIDSAFE_VAULT_MANAGER_TIMING_WHEEL_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "asio/io_service.hpp"
+#include "asio/io_service_strand.hpp"
+
+#include "maidsafe/vault_manager/clock.h"
+#include "maidsafe/vault_manager/config.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// A hierarchical timing wheel for the many short timeouts of connections, processes and requests,
+// all driven by a single timer of its Clock.  Timeouts are rounded up to whole ticks of
+// 'resolution' and are never invoked early.  Adding or cancelling a timeout is O(1); each level of
+// the wheel holds 256 slots, with entries in the upper levels redistributed downwards as their time
+// approaches.  The timer is only armed for ticks at which something can expire, so an idle wheel
+// causes no wake-ups.
+//
+// Threadsafe.  Functors are invoked on a thread running the io_service, never while the wheel's
+// mutex is held, so they can add or cancel timeouts.  The io_service may be run by any number of
+// threads, since the timer is only touched through the wheel's own strand.
+class TimingWheel : public std::enable_shared_from_this<TimingWheel> {
+ public:
+  typedef std::function<void()> Functor;
+  // Never 0, so 0 can be used to mean "no timeout".
+  typedef uint64_t TimerId;
+
+  TimingWheel(const TimingWheel&) = delete;
+  TimingWheel(TimingWheel&&) = delete;
+  TimingWheel& operator=(TimingWheel) = delete;
+
+  // If 'clock' is null, SteadyClock() is used.
+  static std::shared_ptr<TimingWheel> MakeShared(
+      asio::io_service& io_service,
+      std::chrono::milliseconds resolution = kTimingWheelResolution,
+      std::shared_ptr<Clock> clock = nullptr);
+  // Pending functors are destroyed without being invoked.
+  ~TimingWheel();
+
+  TimerId Add(std::chrono::steady_clock::duration timeout, Functor on_expiry);
+  // Returns false if the timeout has already expired or been cancelled.
+  bool Cancel(TimerId timer_id);
+  std::size_t Size() const;
+
+ private:
+  struct Entry {
+    Entry() : on_expiry(), expiry_tick(0), generation(1), slot(0), previous(0), next(0),
+              pending(false) {}
+
+    Functor on_expiry;
+    uint64_t expiry_tick;
+    uint32_t generation, slot, previous, next;
+    bool pending;
+  };
+
+  TimingWheel(asio::io_service& io_service, std::chrono::milliseconds resolution,
+              std::shared_ptr<Clock> clock);
+
+  uint64_t TickAt(std::chrono::steady_clock::time_point time_point) const;
+  void Link(uint32_t index);
+  void Unlink(uint32_t index);
+  // Returns the entry's functor, to be destroyed or invoked once the mutex is released.
+  Functor Release(uint32_t index);
+  void Cascade(unsigned level);
+  uint64_t NextTick() const;
+  void ArmTimer();
+  void HandleTick();
+
+  asio::io_service::strand strand_;
+  const std::shared_ptr<Clock> kClock_;
+  const std::chrono::steady_clock::duration kResolution_;
+  const std::chrono::steady_clock::time_point kStartTime_;
+  mutable std::mutex mutex_;
+  std::vector<Entry> entries_;
+  std::vector<uint32_t> free_entries_;
+  // Index of the first entry in each slot, level by level.
+  std::vector<uint32_t> slot_heads_;
+  uint64_t current_tick_, scheduled_tick_;
+  std::size_t size_;
+  std::unique_ptr<Clock::Timer> timer_;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_TIMING_WHEEL_H_
@@ -43,6 +43,7 @@
 #include "maidsafe/nfs/client/maid_client.h"
 
 #include "maidsafe/vault_manager/client_interface.h"
+#include "maidsafe/vault_manager/public_pmid_table.h"
 #include "maidsafe/vault_manager/utils.h"
 #include "maidsafe/vault_manager/vault_manager.h"
 #include "maidsafe/vault_manager/tools/local_network_controller.h"
@@ -60,17 +61,14 @@ namespace tools {
 namespace {
 
 void GivePublicPmidKey(const NodeId& node_id, routing::GivePublicKeyFunctor give_key,
-                       const std::vector<passport::PublicPmid>& public_pmids) {
-  assert(!public_pmids.empty());
+                       const PublicPmidTable& public_pmid_table) {
   passport::PublicPmid::Name name(Identity(node_id.string()));
-  LOG(kVerbose) << "fetch from local list containing " << public_pmids.size() << " pmids";
-  auto itr(std::find_if(std::begin(public_pmids), std::end(public_pmids),
-                        [&name](const passport::PublicPmid& pmid) { return pmid.name() == name; }));
-  if (itr == public_pmids.end()) {
-    LOG(kError) << "can't Get PublicPmid " << HexSubstr(name.value) << " from local list";
-  } else {
-    LOG(kVerbose) << "Got PublicPmid from local list " << HexSubstr(name.value);
-    give_key((*itr).public_key());
+  LOG(kVerbose) << "fetch from local table containing " << public_pmid_table.Size() << " pmids";
+  try {
+    give_key(public_pmid_table.Find(name).public_key());
+    LOG(kVerbose) << "Got PublicPmid from local table " << HexSubstr(name.value);
+  } catch (const std::exception&) {
+    LOG(kError) << "can't Get PublicPmid " << HexSubstr(name.value) << " from local table";
   }
 }
 
@@ -91,10 +89,11 @@ void StartZeroStateRoutingNodes(std::promise<void>& zero_state_nodes_started,
     node_info1.public_key = GetPmidAndSigner(1).first.public_key();
 
     routing::Functors functors0, functors1;
-    auto public_pmids = GetPublicPmids();  // from env
+    auto public_pmid_table = std::make_shared<PublicPmidTable>(  // from env
+        GetPublicPmidTablePath(), GetPublicPmidTableChecksum());
     functors0.request_public_key = functors1.request_public_key =
-        [public_pmids](NodeId node_id, const routing::GivePublicKeyFunctor& give_key) {
-      GivePublicPmidKey(node_id, give_key, public_pmids);
+        [public_pmid_table](NodeId node_id, const routing::GivePublicKeyFunctor& give_key) {
+      GivePublicPmidKey(node_id, give_key, *public_pmid_table);
     };
     functors0.typed_message_and_caching.group_to_group.message_received =
         functors1.typed_message_and_caching.group_to_group.message_received =
@@ -212,7 +211,7 @@ class PublicPmidStorer {
 
   void Store() {
     size_t failures(0);
-    std::vector<passport::PublicPmid> public_pmids{GetPublicPmids()};  // From test environment
+    const auto& public_pmids(GetPublicPmids());  // From test environment
     for (const auto& public_pmid : public_pmids) {
       try {
         client_nfs_->Put(public_pmid).get();
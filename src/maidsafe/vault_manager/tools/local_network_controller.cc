@@ -44,6 +44,7 @@ Default::Default()
       kVaultManagerPort(44444),
       kVaultCountNewNetwork(16),
       kVaultCount(1),
+      kVaultsPerHost(0),
       kCreateTestRootDir(true),
       kClearTestRootDir(true),
       kSendHostnameToVisualiserServer(false) {}
@@ -64,6 +65,7 @@ LocalNetworkController::LocalNetworkController(const boost::filesystem::path& sc
       path_to_bootstrap_file(),
       vault_manager_port(0),
       vault_count(0),
+      vaults_per_host(GetDefault().kVaultsPerHost),
       new_network(false),
       vlog_session_id(),
       send_hostname_to_visualiser_server() {
@@ -47,6 +47,8 @@ struct Default {
   const int kVaultManagerPort;
   const int kVaultCountNewNetwork;
   const int kVaultCount;
+  // Zero to run each vault as a process of its own.
+  const int kVaultsPerHost;
   const bool kCreateTestRootDir;
   const bool kClearTestRootDir;
   const bool kSendHostnameToVisualiserServer;
@@ -63,7 +65,7 @@ struct LocalNetworkController {
   std::unique_ptr<ClientInterface> client_interface;
   std::unique_ptr<VaultManager> vault_manager;
   boost::filesystem::path test_env_root_dir, path_to_vault, path_to_bootstrap_file;
-  int vault_manager_port, vault_count;
+  int vault_manager_port, vault_count, vaults_per_host;
   bool new_network;
   std::unique_ptr<std::string> vlog_session_id;
   std::unique_ptr<bool> send_hostname_to_visualiser_server;
@@ -29,7 +29,9 @@ namespace tools {
 
 void StartVaultManagerAndClientInterface(LocalNetworkController* local_network_controller) {
   TLOG(kDefaultColour) << "Creating VaultManager and ClientInterface\n";
-  local_network_controller->vault_manager = maidsafe::make_unique<VaultManager>();
+  local_network_controller->vault_manager = maidsafe::make_unique<VaultManager>(
+      kCryptoThreadCount, AdmissionControl::Limits(), -1,
+      static_cast<std::size_t>(local_network_controller->vaults_per_host));
   passport::MaidAndSigner maid_and_signer{passport::CreateMaidAndSigner()};
   local_network_controller->client_interface =
       maidsafe::make_unique<ClientInterface>(maid_and_signer.first);
@@ -0,0 +1,187 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/traffic_capture.h"
+
+#include <array>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+
+#include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/utils.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace {
+
+const std::array<char, 8> kCaptureHeader{{'M', 'S', 'V', 'M', 'C', 'A', 'P', '1'}};
+
+// Frames larger than this can't have been accepted by tcp::Connection, so a longer length means
+// the capture is corrupt.
+const uint64_t kMaxCapturedMessageSize(1 << 30);
+
+void WriteVarint(std::ofstream& stream, uint64_t value) {
+  while (value >= 0x80) {
+    stream.put(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  stream.put(static_cast<char>(value));
+}
+
+uint64_t ReadVarint(std::ifstream& stream) {
+  uint64_t value(0);
+  for (int shift(0); shift < 64; shift += 7) {
+    const int byte(stream.get());
+    if (byte == std::char_traits<char>::eof())
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+    value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0)
+      return value;
+  }
+  BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+}
+
+}  // unnamed namespace
+
+bool IsCredential(uint8_t tag) {
+  return tag == static_cast<uint8_t>(MessageTag::kChallengeResponse) ||
+         tag == static_cast<uint8_t>(MessageTag::kOwnerChallengeResponse) ||
+         tag == static_cast<uint8_t>(MessageTag::kResumeSessionRequest) ||
+         tag == static_cast<uint8_t>(MessageTag::kVaultStarted);
+}
+
+TrafficCaptureWriter::TrafficCaptureWriter(const fs::path& path)
+    : stream_(),
+      kStart_(std::chrono::steady_clock::now()),
+      last_time_(0),
+      writer_(1) {
+  // Captures hold owners' requests, so the file is owner-only before anything is written to it.
+  CreateOwnerOnlyFile(path);
+  stream_.open(path.string(), std::ios::binary | std::ios::trunc);
+  stream_.write(kCaptureHeader.data(), kCaptureHeader.size());
+  if (!stream_) {
+    LOG(kError) << "Failed to create capture file " << path;
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  }
+}
+
+TrafficCaptureWriter::~TrafficCaptureWriter() { writer_.Stop(); }
+
+void TrafficCaptureWriter::RecordConnected(uint32_t connection_id) {
+  TrafficRecord record;
+  record.type = TrafficRecord::Type::kConnected;
+  record.connection_id = connection_id;
+  Post(std::move(record));
+}
+
+void TrafficCaptureWriter::RecordMessage(uint32_t connection_id, const tcp::Message& message) {
+  TrafficRecord record;
+  record.type = TrafficRecord::Type::kMessage;
+  record.connection_id = connection_id;
+  try {
+    record.tag = static_cast<uint8_t>(PeekTag(message));
+  } catch (const std::exception&) {
+  }
+  if (!IsCredential(record.tag))
+    record.message = message;
+  Post(std::move(record));
+}
+
+void TrafficCaptureWriter::RecordClosed(uint32_t connection_id) {
+  TrafficRecord record;
+  record.type = TrafficRecord::Type::kClosed;
+  record.connection_id = connection_id;
+  Post(std::move(record));
+}
+
+void TrafficCaptureWriter::Post(TrafficRecord record) {
+  record.time = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - kStart_);
+  auto shared_record(std::make_shared<TrafficRecord>(std::move(record)));
+  writer_.service().post([this, shared_record] { Write(*shared_record); });
+}
+
+void TrafficCaptureWriter::Write(const TrafficRecord& record) {
+  if (!stream_)
+    return;
+  stream_.put(static_cast<char>(record.type));
+  stream_.put(static_cast<char>(record.tag));
+  WriteVarint(stream_, static_cast<uint64_t>((record.time - last_time_).count()));
+  WriteVarint(stream_, record.connection_id);
+  WriteVarint(stream_, record.message.size());
+  if (!record.message.empty()) {
+    stream_.write(reinterpret_cast<const char*>(record.message.data()),
+                  static_cast<std::streamsize>(record.message.size()));
+  }
+  last_time_ = record.time;
+  if (!stream_)
+    LOG(kError) << "Failed to write to capture file; ending the capture.";
+}
+
+TrafficCaptureReader::TrafficCaptureReader(const fs::path& path)
+    : stream_(path.string(), std::ios::binary), time_(0) {
+  std::array<char, 8> header;
+  stream_.read(header.data(), header.size());
+  if (!stream_ || header != kCaptureHeader) {
+    LOG(kError) << path << " is not a capture file.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+  }
+}
+
+bool TrafficCaptureReader::Next(TrafficRecord& record) {
+  const int type(stream_.get());
+  if (type == std::char_traits<char>::eof())
+    return false;
+  if (type > static_cast<int>(TrafficRecord::Type::kClosed))
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+  const int tag(stream_.get());
+  if (tag == std::char_traits<char>::eof())
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+  time_ += std::chrono::microseconds(ReadVarint(stream_));
+  const uint64_t connection_id(ReadVarint(stream_)), size(ReadVarint(stream_));
+  if (connection_id > std::numeric_limits<uint32_t>::max() || size > kMaxCapturedMessageSize)
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+
+  record.type = static_cast<TrafficRecord::Type>(type);
+  record.tag = static_cast<uint8_t>(tag);
+  record.time = time_;
+  record.connection_id = static_cast<uint32_t>(connection_id);
+  record.message.resize(static_cast<std::size_t>(size));
+  if (size != 0U) {
+    stream_.read(reinterpret_cast<char*>(record.message.data()),
+                 static_cast<std::streamsize>(size));
+    if (!stream_)
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+  }
+  return true;
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
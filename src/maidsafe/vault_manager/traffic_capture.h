@@ -0,0 +1,106 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_TRAFFIC_CAPTURE_H_
+#define MAIDSAFE_VAULT_MANAGER_TRAFFIC_CAPTURE_H_
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/tcp/connection.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// One entry of a capture file.  'connection_id' is allocated by the VaultManager per accepted
+// connection.  'tag' is that of the message's frame (kUnknownTag if it's too short to hold one),
+// and is set, like 'message', only for kMessage.  'message' is also left empty for messages which
+// carry credentials (see IsCredential).  'time' is relative to the start of the capture.
+struct TrafficRecord {
+  enum class Type : uint8_t { kConnected, kMessage, kClosed };
+  static const uint8_t kUnknownTag = 0xFF;
+
+  TrafficRecord()
+      : type(Type::kConnected), time(0), connection_id(0), tag(kUnknownTag), message() {}
+
+  Type type;
+  std::chrono::microseconds time;
+  uint32_t connection_id;
+  uint8_t tag;
+  tcp::Message message;
+};
+
+// Whether messages with 'tag' carry credentials (signed challenges, session tickets or adoption
+// tokens), so mustn't be written to a capture file.
+bool IsCredential(uint8_t tag);
+
+// Writes every inbound connection and framed message to a capture file which TrafficCaptureReader
+// (e.g. in the vm_replay tool) can feed back into a VaultManager.  The file is an 8-byte header
+// followed by one record per entry: its type and tag, then as varints the microseconds since the
+// previous record, the connection id and the length of the message, then the message itself.
+// The file is only readable by its owner.
+//
+// The Record functions only copy the entry and hand it to a thread of the writer's own, so the
+// caller never waits on the file.  They must not be called concurrently, so that entries stay in
+// order; the VaultManager only calls them from its strand.  Write failures are logged and end the
+// capture rather than throwing.  Destruction waits until every entry has been written.
+class TrafficCaptureWriter {
+ public:
+  // Throws if the file can't be created.
+  explicit TrafficCaptureWriter(const boost::filesystem::path& path);
+  ~TrafficCaptureWriter();
+
+  void RecordConnected(uint32_t connection_id);
+  void RecordMessage(uint32_t connection_id, const tcp::Message& message);
+  void RecordClosed(uint32_t connection_id);
+
+ private:
+  void Post(TrafficRecord record);
+  void Write(const TrafficRecord& record);
+
+  std::ofstream stream_;
+  const std::chrono::steady_clock::time_point kStart_;
+  // Only used on the writer thread.
+  std::chrono::microseconds last_time_;
+  // Must be last member so that pending entries are written before the stream is closed.
+  AsioService writer_;
+};
+
+class TrafficCaptureReader {
+ public:
+  // Throws if the file can't be opened or isn't a capture file.
+  explicit TrafficCaptureReader(const boost::filesystem::path& path);
+
+  // Returns false at the end of the capture.  Throws if the file is truncated or corrupt.
+  bool Next(TrafficRecord& record);
+
+ private:
+  std::ifstream stream_;
+  std::chrono::microseconds time_;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_TRAFFIC_CAPTURE_H_
@@ -18,15 +18,24 @@
 
 #include "maidsafe/vault_manager/utils.h"
 
+#ifndef MAIDSAFE_WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include <algorithm>
 #include <cctype>
+#include <chrono>
 #include <functional>
 #include <iterator>
 #include <limits>
 #include <mutex>
+#include <stdexcept>
 
 #include "boost/filesystem/operations.hpp"
 
+#include "maidsafe/common/application_support_directories.h"
 #include "maidsafe/common/error.h"
 #include "maidsafe/common/log.h"
 #include "maidsafe/common/make_unique.h"
@@ -34,13 +43,28 @@
 #include "maidsafe/common/serialisation/serialisation.h"
 #include "maidsafe/passport/passport.h"
 
+#include "maidsafe/vault_manager/public_pmid_table.h"
 #include "maidsafe/vault_manager/vault_info.h"
+#include "maidsafe/vault_manager/messages/add_owner_request.h"
+#include "maidsafe/vault_manager/messages/batch_start_vault_request.h"
+#include "maidsafe/vault_manager/messages/batch_take_ownership_request.h"
+#include "maidsafe/vault_manager/messages/capabilities.h"
 #include "maidsafe/vault_manager/messages/challenge.h"
 #include "maidsafe/vault_manager/messages/challenge_response.h"
+#include "maidsafe/vault_manager/messages/hosted_vault_exited.h"
 #include "maidsafe/vault_manager/messages/log_message.h"
 #include "maidsafe/vault_manager/messages/max_disk_usage_update.h"
+#include "maidsafe/vault_manager/messages/owner_added.h"
+#include "maidsafe/vault_manager/messages/owner_challenge.h"
+#include "maidsafe/vault_manager/messages/owner_challenge_response.h"
+#include "maidsafe/vault_manager/messages/resume_session_request.h"
+#include "maidsafe/vault_manager/messages/session_ticket.h"
+#include "maidsafe/vault_manager/messages/start_hosted_vault.h"
 #include "maidsafe/vault_manager/messages/start_vault_request.h"
+#include "maidsafe/vault_manager/messages/stop_hosted_vault.h"
+#include "maidsafe/vault_manager/messages/subscribe_to_vault_events_request.h"
 #include "maidsafe/vault_manager/messages/take_ownership_request.h"
+#include "maidsafe/vault_manager/messages/vault_event_notification.h"
 #include "maidsafe/vault_manager/messages/vault_running_response.h"
 #include "maidsafe/vault_manager/messages/vault_started.h"
 #include "maidsafe/vault_manager/messages/vault_started_response.h"
@@ -52,12 +76,26 @@ namespace maidsafe {
 namespace vault_manager {
 
 #if !defined(_MSC_VER) || _MSC_VER >= 1900
+const MessageTag AddOwnerRequest::tag;
+const MessageTag BatchStartVaultRequest::tag;
+const MessageTag BatchTakeOwnershipRequest::tag;
+const MessageTag Capabilities::tag;
 const MessageTag Challenge::tag;
 const MessageTag ChallengeResponse::tag;
+const MessageTag HostedVaultExited::tag;
 const MessageTag LogMessage::tag;
 const MessageTag MaxDiskUsageUpdate::tag;
+const MessageTag OwnerAdded::tag;
+const MessageTag OwnerChallenge::tag;
+const MessageTag OwnerChallengeResponse::tag;
+const MessageTag ResumeSessionRequest::tag;
+const MessageTag SessionTicket::tag;
+const MessageTag StartHostedVault::tag;
 const MessageTag StartVaultRequest::tag;
+const MessageTag StopHostedVault::tag;
+const MessageTag SubscribeToVaultEventsRequest::tag;
 const MessageTag TakeOwnershipRequest::tag;
+const MessageTag VaultEventNotification::tag;
 const MessageTag VaultRunningResponse::tag;
 const MessageTag VaultStarted::tag;
 const MessageTag VaultStartedResponse::tag;
@@ -72,6 +110,29 @@ fs::path g_test_env_root_dir, g_path_to_vault;
 bool g_using_default_environment(true);
 std::vector<passport::PmidAndSigner> g_pmids_and_signers;
 std::vector<passport::PublicPmid> g_public_pmids;
+fs::path g_public_pmid_table_path;
+std::string g_public_pmid_table_checksum;
+std::mutex g_behaviour_profile_mutex;
+VaultConfig::BehaviourProfile g_behaviour_profile;
+
+std::chrono::milliseconds ParseMilliseconds(const std::string& value) {
+  std::size_t parsed(0);
+  std::chrono::milliseconds result(std::stoll(value, &parsed));
+  if (parsed != value.size())
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+  return result;
+}
+
+// std::stoull silently negates a leading '-', so anything other than a plain number is rejected.
+uint64_t ParseUnsigned(const std::string& value, uint64_t max) {
+  if (value.empty() || !std::isdigit(static_cast<unsigned char>(value.front())))
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+  std::size_t parsed(0);
+  const uint64_t result(std::stoull(value, &parsed));
+  if (parsed != value.size() || result > max)
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+  return result;
+}
 #endif
 
 }  // unnamed namespace
@@ -95,13 +156,44 @@ std::unique_ptr<VaultConfig> GetValue(const VaultStartedResponse& vault_started_
       vault_started_response.send_hostname_to_visualiser_server;
 #endif
 #ifdef TESTING
-  vault_config->test_config.public_pmid_list = vault_started_response.public_pmids;
+  if (!vault_started_response.public_pmid_table_path.empty()) {
+    vault_config->test_config.public_pmid_table = std::make_shared<PublicPmidTable>(
+        vault_started_response.public_pmid_table_path,
+        vault_started_response.public_pmid_table_checksum);
+  }
+  vault_config->test_config.behaviour_profile = vault_started_response.behaviour_profile;
 #endif
   return vault_config;
 }
 
 }  // namespace detail
 
+void BroadcastSerialised(const std::vector<tcp::ConnectionPtr>& connections, tcp::Message message,
+                         const SendFunctor& send_functor) {
+  if (connections.empty())
+    return;
+  auto send([&send_functor](const tcp::ConnectionPtr& connection, tcp::Message&& frame) {
+    try {
+      if (send_functor)
+        send_functor(connection, std::move(frame));
+      else
+        connection->Send(std::move(frame));
+    } catch (const std::exception& e) {
+      LOG(kWarning) << "Failed to broadcast message: " << boost::diagnostic_information(e);
+    }
+  });
+  for (auto itr(std::begin(connections)); itr != std::prev(std::end(connections)); ++itr)
+    send(*itr, tcp::Message(message));
+  send(connections.back(), std::move(message));
+}
+
+MessageTag PeekTag(const tcp::Message& message) {
+  if (message.size() < sizeof(MessageTag))
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+  return Parse<MessageTag>(
+      tcp::Message(std::begin(message), std::begin(message) + sizeof(MessageTag)));
+}
+
 NonEmptyString GenerateLabel() {
   std::string label{RandomAlphaNumericString(4)};
   for (int i(0); i < 4; ++i)
@@ -119,6 +211,45 @@ tcp::Port GetInitialListeningPort() {
 #endif
 }
 
+fs::path GetVaultManagerFilePath(const fs::path& filename) {
+#ifdef TESTING
+  return (GetTestEnvironmentRootDir().empty() ? GetUserAppDir() : GetTestEnvironmentRootDir()) /
+         filename;
+#else
+  return GetSystemAppSupportDir() / filename;
+#endif
+}
+
+fs::path GetDiscoveryFilePath() { return GetVaultManagerFilePath(kDiscoveryFilename); }
+
+std::chrono::milliseconds GetReconnectDelay(int attempt) {
+  std::chrono::milliseconds delay{
+      std::min(kInitialReconnectDelay * (1 << std::min(attempt, 16)), kMaxReconnectDelay)};
+  return delay / 2 +
+         std::chrono::milliseconds{RandomUint32() % (static_cast<uint32_t>(delay.count()) + 1)};
+}
+
+void CreateOwnerOnlyFile(const fs::path& path) {
+  boost::system::error_code ec;
+  fs::remove(path, ec);
+#ifdef MAIDSAFE_WIN32
+  // Windows has no creation mode; access is otherwise governed by the directory's ACL.
+  if (!ec && !WriteFile(path, std::string()))
+    ec = make_error_code(boost::system::errc::io_error);
+  if (!ec)
+    fs::permissions(path, fs::owner_read | fs::owner_write, ec);
+#else
+  // O_EXCL, so that a file created by someone else in the meantime isn't used.
+  const int fd(open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, S_IRUSR | S_IWUSR));
+  if (fd < 0 || close(fd) != 0)
+    ec = boost::system::error_code(errno, boost::system::system_category());
+#endif
+  if (ec) {
+    LOG(kError) << "Failed to create " << path << ": " << ec.message();
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  }
+}
+
 #ifdef TESTING
 namespace test {
 
@@ -136,17 +267,85 @@ void SetEnvironment(tcp::Port test_vault_manager_port, const fs::path& test_env_
       g_pmids_and_signers.emplace_back(passport::CreatePmidAndSigner());
       g_public_pmids.emplace_back(passport::PublicPmid{g_pmids_and_signers.back().first});
     }
+    if (!g_public_pmids.empty()) {
+      g_public_pmid_table_path = test_env_root_dir / "public_pmids.table";
+      g_public_pmid_table_checksum =
+          PublicPmidTable::Write(g_public_pmid_table_path, g_public_pmids);
+    }
     g_using_default_environment = false;
   });
 }
 
+void SetBehaviourProfile(const VaultConfig::BehaviourProfile& profile) {
+  std::lock_guard<std::mutex> lock{g_behaviour_profile_mutex};
+  g_behaviour_profile = profile;
+}
+
+VaultConfig::BehaviourProfile ParseBehaviourProfile(const std::string& profile) {
+  VaultConfig::BehaviourProfile result;
+  std::size_t begin(0);
+  while (begin < profile.size()) {
+    std::size_t end(std::min(profile.find(',', begin), profile.size()));
+    const std::string pair(profile.substr(begin, end - begin));
+    begin = end + 1;
+    const std::size_t equals(pair.find('='));
+    if (equals == std::string::npos) {
+      LOG(kError) << "Behaviour profile entry \"" << pair << "\" has no value.";
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+    }
+    const std::string name(pair.substr(0, equals)), value(pair.substr(equals + 1));
+    try {
+      if (name == "startup_delay_ms") {
+        const std::size_t dash(value.find('-', 1));
+        result.startup_delay_min = ParseMilliseconds(value.substr(0, dash));
+        result.startup_delay_max = dash == std::string::npos
+                                       ? result.startup_delay_min
+                                       : ParseMilliseconds(value.substr(dash + 1));
+      } else if (name == "resident_mb") {
+        const uint64_t kBytesPerMiB(1024 * 1024);
+        result.resident_bytes =
+            ParseUnsigned(value, std::numeric_limits<uint64_t>::max() / kBytesPerMiB) *
+            kBytesPerMiB;
+      } else if (name == "log_lines_per_second") {
+        result.log_lines_per_second =
+            static_cast<uint32_t>(ParseUnsigned(value, std::numeric_limits<uint32_t>::max()));
+      } else if (name == "crash_probability_per_minute") {
+        result.crash_probability_per_minute = std::stod(value);
+      } else if (name == "shutdown_delay_ms") {
+        result.shutdown_delay = ParseMilliseconds(value);
+      } else if (name == "joined_network_delay_ms") {
+        result.joined_network_delay = ParseMilliseconds(value);
+      } else {
+        LOG(kError) << "Unknown behaviour profile entry \"" << name << "\".";
+        BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+      }
+    } catch (const std::logic_error&) {  // From the std::sto* functions.
+      LOG(kError) << "Invalid value \"" << value << "\" for behaviour profile entry " << name;
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+    }
+  }
+  if (result.startup_delay_max < result.startup_delay_min || result.startup_delay_min.count() < 0 ||
+      result.shutdown_delay.count() < 0 || result.crash_probability_per_minute < 0.0 ||
+      result.crash_probability_per_minute > 1.0) {
+    LOG(kError) << "Behaviour profile \"" << profile << "\" is out of range.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+  }
+  return result;
+}
+
 }  // namespace test
 
 tcp::Port GetTestVaultManagerPort() { return g_test_vault_manager_port; }
 fs::path GetTestEnvironmentRootDir() { return g_test_env_root_dir; }
 fs::path GetPathToVault() { return g_path_to_vault; }
 passport::PmidAndSigner GetPmidAndSigner(int index) { return g_pmids_and_signers.at(index); }
-std::vector<passport::PublicPmid> GetPublicPmids() { return g_public_pmids; }
+const std::vector<passport::PublicPmid>& GetPublicPmids() { return g_public_pmids; }
+fs::path GetPublicPmidTablePath() { return g_public_pmid_table_path; }
+std::string GetPublicPmidTableChecksum() { return g_public_pmid_table_checksum; }
+VaultConfig::BehaviourProfile GetBehaviourProfile() {
+  std::lock_guard<std::mutex> lock{g_behaviour_profile_mutex};
+  return g_behaviour_profile;
+}
 #endif  // TESTING
 
 }  //  namespace vault_manager
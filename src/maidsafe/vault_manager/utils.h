@@ -19,6 +19,8 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_UTILS_H_
 #define MAIDSAFE_VAULT_MANAGER_UTILS_H_
 
+#include <chrono>
+#include <functional>
 #include <future>
 #include <memory>
 #include <string>
@@ -57,10 +59,47 @@ void Send(tcp::ConnectionPtr connection, T message) {
   connection->Send(Serialise(T::tag, std::move(message)));
 }
 
+// Sends an already-serialised message (e.g. a frame being relayed unchanged) to each connection.
+// tcp::Connection takes ownership of what it sends, so each recipient but the last gets a copy of
+// the bytes and the last takes 'message' itself.  A failure to send to one recipient is logged and
+// doesn't affect the others, so this doesn't throw.  If 'send' is non-null, each copy is passed to
+// it rather than sent directly.
+typedef std::function<void(tcp::ConnectionPtr, tcp::Message)> SendFunctor;
+void BroadcastSerialised(const std::vector<tcp::ConnectionPtr>& connections, tcp::Message message,
+                         const SendFunctor& send = nullptr);
+
+// Serialises 'message' once, however many connections it is sent to.
+template <typename T>
+void Broadcast(const std::vector<tcp::ConnectionPtr>& connections, T message,
+               const SendFunctor& send = nullptr) {
+  if (!connections.empty())
+    BroadcastSerialised(connections, Serialise(T::tag, std::move(message)), send);
+}
+
+// Returns the tag of a serialised message without parsing its body.  Throws if 'message' is too
+// short to hold a tag.
+MessageTag PeekTag(const tcp::Message& message);
+
 NonEmptyString GenerateLabel();
 
 tcp::Port GetInitialListeningPort();
 
+// The path of 'filename' in the VaultManager's data directory (in tests, the test environment's
+// root dir where set).
+boost::filesystem::path GetVaultManagerFilePath(const boost::filesystem::path& filename);
+
+// Where a running VaultManager publishes its listening port for clients on the same machine.
+boost::filesystem::path GetDiscoveryFilePath();
+
+// The delay before reconnection attempt 'attempt' (counting from 0) to the VaultManager.  It
+// doubles with each attempt up to a limit, then is randomised by +/-50% so that clients and vaults
+// don't all retry in step when the VaultManager restarts.
+std::chrono::milliseconds GetReconnectDelay(int attempt);
+
+// Replaces any file at 'path' with an empty one which only the owner can read or write, so that
+// secrets written to it afterwards are never exposed, even briefly.  Throws on failure.
+void CreateOwnerOnlyFile(const boost::filesystem::path& path);
+
 #ifdef TESTING
 namespace test {
 
@@ -68,13 +107,27 @@ void SetEnvironment(tcp::Port test_vault_manager_port,
                     const boost::filesystem::path& test_env_root_dir,
                     const boost::filesystem::path& path_to_vault, int pmid_list_size = 0);
 
+// Sets the profile sent to every vault started from now on.  Threadsafe.
+void SetBehaviourProfile(const VaultConfig::BehaviourProfile& profile);
+
+// Parses comma-separated "name=value" pairs, any of which may be omitted:
+//   startup_delay_ms=<min>[-<max>], resident_mb=<MiB>, log_lines_per_second=<n>,
+//   crash_probability_per_minute=<p>, shutdown_delay_ms=<n>, joined_network_delay_ms=<n>
+// e.g. "startup_delay_ms=100-2000,resident_mb=64,crash_probability_per_minute=0.01".  Throws
+// CommonErrors::invalid_parameter if 'profile' is malformed.
+VaultConfig::BehaviourProfile ParseBehaviourProfile(const std::string& profile);
+
 }  // namespace test
 
 tcp::Port GetTestVaultManagerPort();
 boost::filesystem::path GetTestEnvironmentRootDir();
 boost::filesystem::path GetPathToVault();
 passport::PmidAndSigner GetPmidAndSigner(int index);
-std::vector<passport::PublicPmid> GetPublicPmids();
+const std::vector<passport::PublicPmid>& GetPublicPmids();
+// Empty unless 'SetEnvironment' was passed a non-zero 'pmid_list_size'.
+boost::filesystem::path GetPublicPmidTablePath();
+std::string GetPublicPmidTableChecksum();
+VaultConfig::BehaviourProfile GetBehaviourProfile();
 #endif
 
 }  // namespace vault_manager
@@ -0,0 +1,144 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/vault_config_channel.h"
+
+#ifndef MAIDSAFE_WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include "maidsafe/common/log.h"
+
+#ifndef MAIDSAFE_WIN32
+extern "C" char** environ;
+#endif
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+const std::string kVaultConfigFdVariable("MAIDSAFE_VAULT_CONFIG_FD");
+
+#ifndef MAIDSAFE_WIN32
+
+namespace {
+
+bool SetFlags(int fd, int get_command, int set_command, int flags) {
+  int current(fcntl(fd, get_command));
+  return current != -1 && fcntl(fd, set_command, current | flags) != -1;
+}
+
+}  // unnamed namespace
+
+VaultConfigChannel::VaultConfigChannel(const tcp::Message& message) : read_fd_(-1) {
+  int fds[2];
+  if (pipe(fds) != 0) {
+    LOG(kWarning) << "Failed to create vault config channel: " << std::strerror(errno);
+    return;
+  }
+  // Both ends are closed on exec, so that vaults spawned later don't inherit this one.  Writing
+  // before the vault is spawned means the write end can be closed straight away, and the vault
+  // reads up to EOF without any further coordination.
+  bool written(SetFlags(fds[0], F_GETFD, F_SETFD, FD_CLOEXEC) &&
+               SetFlags(fds[1], F_GETFD, F_SETFD, FD_CLOEXEC) &&
+               SetFlags(fds[1], F_GETFL, F_SETFL, O_NONBLOCK) &&
+               write(fds[1], message.data(), message.size()) ==
+                   static_cast<ssize_t>(message.size()));
+  close(fds[1]);
+  if (!written) {
+    LOG(kWarning) << "Failed to write " << message.size() << " bytes to vault config channel.";
+    close(fds[0]);
+    return;
+  }
+  read_fd_ = fds[0];
+}
+
+VaultConfigChannel::~VaultConfigChannel() {
+  if (read_fd_ >= 0)
+    close(read_fd_);
+}
+
+std::vector<std::string> VaultConfigChannel::ChildEnvironment() const {
+  std::vector<std::string> environment;
+  const std::string prefix(kVaultConfigFdVariable + "=");
+  for (char** entry(environ); entry && *entry; ++entry) {
+    if (std::strncmp(*entry, prefix.c_str(), prefix.size()) != 0)
+      environment.emplace_back(*entry);
+  }
+  environment.push_back(prefix + std::to_string(read_fd_));
+  return environment;
+}
+
+void VaultConfigChannel::InheritInChild() const {
+  int flags(fcntl(read_fd_, F_GETFD));
+  if (flags != -1)
+    fcntl(read_fd_, F_SETFD, flags & ~FD_CLOEXEC);
+}
+
+tcp::Message ReadVaultConfigChannel() {
+  const char* variable(std::getenv(kVaultConfigFdVariable.c_str()));
+  if (!variable)
+    return tcp::Message();
+  const int fd(std::atoi(variable));
+  unsetenv(kVaultConfigFdVariable.c_str());
+  if (fd <= STDERR_FILENO) {
+    LOG(kError) << "Invalid vault config channel descriptor " << fd;
+    return tcp::Message();
+  }
+  tcp::Message message;
+  char buffer[4096];
+  for (;;) {
+    ssize_t bytes_read(read(fd, buffer, sizeof(buffer)));
+    if (bytes_read > 0) {
+      message.insert(std::end(message), buffer, buffer + bytes_read);
+    } else if (bytes_read == 0) {
+      break;
+    } else if (errno != EINTR) {
+      LOG(kError) << "Failed to read vault config channel: " << std::strerror(errno);
+      message.clear();
+      break;
+    }
+  }
+  close(fd);
+  return message;
+}
+
+#else
+
+VaultConfigChannel::VaultConfigChannel(const tcp::Message& /*message*/) : read_fd_(-1) {}
+
+VaultConfigChannel::~VaultConfigChannel() {}
+
+std::vector<std::string> VaultConfigChannel::ChildEnvironment() const {
+  return std::vector<std::string>();
+}
+
+void VaultConfigChannel::InheritInChild() const {}
+
+tcp::Message ReadVaultConfigChannel() { return tcp::Message(); }
+
+#endif
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
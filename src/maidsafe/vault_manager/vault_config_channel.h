@@ -0,0 +1,72 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_VAULT_CONFIG_CHANNEL_H_
+#define MAIDSAFE_VAULT_MANAGER_VAULT_CONFIG_CHANNEL_H_
+
+#include <string>
+#include <vector>
+
+#include "maidsafe/common/tcp/connection.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Hands a newly-spawned vault its serialised VaultStartedResponse through a pipe which only that
+// vault inherits (POSIX only).  The vault is then configured before it connects to the
+// VaultManager, rather than having to ask for its config and wait for the reply.  The descriptor
+// of the read end is passed to the vault in the environment variable kVaultConfigFdVariable.
+
+extern const std::string kVaultConfigFdVariable;
+
+class VaultConfigChannel {
+ public:
+  VaultConfigChannel(const VaultConfigChannel&) = delete;
+  VaultConfigChannel(VaultConfigChannel&&) = delete;
+  VaultConfigChannel& operator=(VaultConfigChannel) = delete;
+
+  // Creates the pipe and writes 'message' into it.  If the platform has no suitable pipes or
+  // 'message' doesn't fit in the pipe's buffer, the channel is left closed and the vault has to
+  // fall back to asking for its config over TCP.  Never blocks.
+  explicit VaultConfigChannel(const tcp::Message& message);
+  ~VaultConfigChannel();
+
+  bool IsOpen() const { return read_fd_ >= 0; }
+
+  // This process' environment, plus kVaultConfigFdVariable naming the read end.
+  std::vector<std::string> ChildEnvironment() const;
+
+  // Called in the forked child between fork() and exec() to let the read end survive the exec.
+  // Only makes async-signal-safe calls.
+  void InheritInChild() const;
+
+ private:
+  int read_fd_;
+};
+
+// Called by the vault.  Returns the message written by the VaultManager, or an empty message if
+// this process wasn't given a channel or couldn't read it.  Closes the descriptor and removes
+// kVaultConfigFdVariable from the environment so that it isn't passed on to our own children.
+tcp::Message ReadVaultConfigChannel();
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_VAULT_CONFIG_CHANNEL_H_
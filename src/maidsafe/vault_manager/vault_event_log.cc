@@ -0,0 +1,94 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/vault_event_log.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+VaultEventLog::VaultEventLog(std::size_t max_events_per_owner)
+    : kMaxEventsPerOwner_(std::max(max_events_per_owner, std::size_t(1))),
+      kFirstSequenceNumber_(static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              std::chrono::system_clock::now().time_since_epoch()).count())),
+      logs_() {}
+
+VaultEvent VaultEventLog::Add(const MaidName& owner_name, VaultEventType type,
+                              const NonEmptyString& label, int32_t exit_code) {
+  auto itr(logs_.find(owner_name));
+  if (itr == std::end(logs_))
+    itr = logs_.emplace(owner_name, OwnerLog{kFirstSequenceNumber_}).first;
+  OwnerLog& owner_log(itr->second);
+  owner_log.events.emplace_back(owner_log.next_sequence_number++, type, label, exit_code);
+  if (owner_log.events.size() > kMaxEventsPerOwner_)
+    owner_log.events.pop_front();
+  // Only the live event is marked; a later replay works out any gap for its own client.
+  VaultEvent event{owner_log.events.back()};
+  event.follows_gap = owner_log.gap_pending;
+  owner_log.gap_pending = false;
+  return event;
+}
+
+std::vector<VaultEvent> VaultEventLog::GetSince(const MaidName& owner_name,
+                                                uint64_t last_sequence_number) {
+  std::vector<VaultEvent> events;
+  auto itr(logs_.find(owner_name));
+  if (itr == std::end(logs_)) {
+    if (last_sequence_number == 0)
+      return events;
+    itr = logs_.emplace(owner_name, OwnerLog{kFirstSequenceNumber_}).first;
+  }
+
+  OwnerLog& owner_log(itr->second);
+  bool gap(false);
+  if (last_sequence_number >= owner_log.next_sequence_number) {
+    owner_log.next_sequence_number = last_sequence_number + 1;
+    gap = true;
+    last_sequence_number = 0;
+  } else if (owner_log.events.empty() && last_sequence_number != 0 &&
+             last_sequence_number < kFirstSequenceNumber_) {
+    // The client's last event was allocated before this log existed (e.g. before a VaultManager
+    // restart), and nothing has been added since, so anything in between has been lost.
+    gap = true;
+  }
+
+  // Sequence numbers in the deque are increasing, but have a jump wherever they were moved on.
+  auto first(std::upper_bound(std::begin(owner_log.events), std::end(owner_log.events),
+                              last_sequence_number,
+                              [](uint64_t sequence_number, const VaultEvent& event) {
+                                return sequence_number < event.sequence_number;
+                              }));
+  if (first == std::begin(owner_log.events) && first != std::end(owner_log.events) &&
+      last_sequence_number != 0 && last_sequence_number + 1 < first->sequence_number) {
+    gap = true;
+  }
+  events.assign(first, std::end(owner_log.events));
+  if (gap && !events.empty())
+    events.front().follows_gap = true;
+  else if (gap)
+    owner_log.gap_pending = true;
+  return events;
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
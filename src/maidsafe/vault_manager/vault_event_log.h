@@ -0,0 +1,80 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_VAULT_EVENT_LOG_H_
+#define MAIDSAFE_VAULT_MANAGER_VAULT_EVENT_LOG_H_
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <vector>
+
+#include "maidsafe/common/types.h"
+#include "maidsafe/passport/types.h"
+
+#include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/vault_event.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Holds the most recent events for each owner so that a client which was disconnected when an
+// event occurred can retrieve it on resubscribing.  Sequence numbers for every owner start from the
+// time (in microseconds since epoch) at which the log was constructed, so they usually keep
+// increasing across VaultManager restarts.  The log itself is only held in memory, so events from
+// before a restart are lost; a resuming client is told of any such gap (see VaultEvent).  Not
+// threadsafe - only to be used from the VaultManager's asio thread.
+class VaultEventLog {
+ public:
+  typedef passport::PublicMaid::Name MaidName;
+
+  explicit VaultEventLog(std::size_t max_events_per_owner = kMaxVaultEventsPerOwner);
+
+  // Appends a new event to the owner's log, dropping the oldest if the log is full.  Returns the
+  // event with its allocated sequence number.
+  VaultEvent Add(const MaidName& owner_name, VaultEventType type, const NonEmptyString& label,
+                 int32_t exit_code = 0);
+  // Returns all retained events for the owner with a sequence number greater than
+  // 'last_sequence_number', which is 0 for a client that has seen no events.  If events after
+  // 'last_sequence_number' have been dropped, or it's ahead of the log (e.g. it was allocated
+  // before a VaultManager restart, and the system clock has since been wound back), all retained
+  // events are returned and the first is marked 'follows_gap'.  In the latter case, later events
+  // are numbered after 'last_sequence_number' so that the client doesn't discard them.  If there
+  // is a gap but no retained events, the next event added for the owner is marked instead.
+  std::vector<VaultEvent> GetSince(const MaidName& owner_name, uint64_t last_sequence_number);
+
+ private:
+  struct OwnerLog {
+    explicit OwnerLog(uint64_t first_sequence_number)
+        : next_sequence_number(first_sequence_number), events(), gap_pending(false) {}
+    uint64_t next_sequence_number;
+    std::deque<VaultEvent> events;
+    bool gap_pending;
+  };
+
+  const std::size_t kMaxEventsPerOwner_;
+  const uint64_t kFirstSequenceNumber_;
+  std::map<MaidName, OwnerLog> logs_;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_VAULT_EVENT_LOG_H_
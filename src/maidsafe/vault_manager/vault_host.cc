@@ -0,0 +1,214 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/vault_host.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "asio/io_service_strand.hpp"
+
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/on_scope_exit.h"
+#include "maidsafe/common/process.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/common/tcp/connection.h"
+
+#include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/utils.h"
+#include "maidsafe/vault_manager/messages/hosted_vault_exited.h"
+#include "maidsafe/vault_manager/messages/start_hosted_vault.h"
+#include "maidsafe/vault_manager/messages/stop_hosted_vault.h"
+#include "maidsafe/vault_manager/messages/vault_started.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+const std::string kVaultHostArgument("--vault_host");
+
+namespace {
+
+// Each vault's thread holds a shared_ptr to the host, since a vault which ignores being stopped is
+// left running when the host returns.
+class VaultHost : public std::enable_shared_from_this<VaultHost> {
+ public:
+  explicit VaultHost(HostedVaultFunctor run_vault)
+      : kRunVault_(std::move(run_vault)),
+        mutex_(),
+        cond_var_(),
+        disconnected_(false),
+        vaults_(),
+        asio_service_(1),
+        strand_(asio_service_.service()),
+        connection_() {}
+
+  ~VaultHost() {
+    if (connection_)
+      connection_->Close();
+    asio_service_.Stop();
+  }
+
+  int Run(tcp::Port control_port) {
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      connection_ = tcp::Connection::MakeShared(strand_, control_port);
+      connection_->Start(
+          [this](tcp::Message message) { HandleReceivedMessage(std::move(message)); },
+          [this] { OnConnectionClosed(); });
+      Send(connection_, VaultStarted(process::GetProcessId()));
+    }
+
+    std::unique_lock<std::mutex> lock{mutex_};
+    cond_var_.wait(lock, [this] { return disconnected_; });
+    for (auto& vault : vaults_) {
+      vault.second.stopped = true;
+      if (vault.second.vault_interface)
+        vault.second.vault_interface->Stop(-1);
+    }
+    if (!cond_var_.wait_for(lock, kVaultStopTimeout, [this] { return vaults_.empty(); }))
+      LOG(kWarning) << vaults_.size() << " hosted vaults failed to stop.";
+    return 0;
+  }
+
+ private:
+  struct HostedVault {
+    HostedVault() : vault_interface(nullptr), stopped(false) {}
+    VaultInterface* vault_interface;  // Null until it has retrieved its config.
+    bool stopped;  // Already reported as exited to the VaultManager.
+  };
+
+  void HandleReceivedMessage(tcp::Message&& message) {
+    try {
+      InputVectorStream binary_input_stream(std::move(message));
+      MessageTag tag(static_cast<MessageTag>(-1));
+      Parse(binary_input_stream, tag);
+      switch (tag) {
+        case MessageTag::kStartHostedVault:
+          HandleStartHostedVault(Parse<StartHostedVault>(binary_input_stream));
+          break;
+        case MessageTag::kStopHostedVault:
+          HandleStopHostedVault(Parse<StopHostedVault>(binary_input_stream));
+          break;
+        default:
+          return;
+      }
+    } catch (const std::exception& e) {
+      LOG(kError) << "Failed to handle incoming message: " << boost::diagnostic_information(e);
+    }
+  }
+
+  void HandleStartHostedVault(StartHostedVault&& request) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (disconnected_ || !vaults_.emplace(request.vault_id, HostedVault()).second)
+      return;
+    std::thread{&VaultHost::RunVault, shared_from_this(), request.vault_id,
+                std::move(request.args)}.detach();
+  }
+
+  // Threads can't be killed, so the vault is asked to stop and reported as exited straight away.
+  void HandleStopHostedVault(StopHostedVault&& request) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto itr(vaults_.find(request.vault_id));
+    if (itr == std::end(vaults_) || itr->second.stopped)
+      return;
+    itr->second.stopped = true;
+    if (itr->second.vault_interface)
+      itr->second.vault_interface->Stop(-1);
+    Send(connection_, HostedVaultExited(request.vault_id, -1));
+  }
+
+  void RunVault(uint64_t vault_id, std::vector<std::string> args) {
+    int exit_code(0);
+    try {
+      VaultInterface vault_interface{static_cast<tcp::Port>(std::stoi(args.at(1))), vault_id};
+      {
+        std::lock_guard<std::mutex> lock{mutex_};
+        HostedVault& vault(vaults_.at(vault_id));
+        vault.vault_interface = &vault_interface;
+        if (vault.stopped)
+          vault_interface.Stop(-1);
+      }
+      on_scope_exit forget_interface([&] {
+        std::lock_guard<std::mutex> lock{mutex_};
+        vaults_.at(vault_id).vault_interface = nullptr;
+      });
+      exit_code = kRunVault_(vault_interface, args);
+    } catch (const maidsafe_error& error) {
+      LOG(kError) << "Hosted vault " << vault_id << " failed: " << error.what();
+      exit_code = ErrorToInt(error);
+    } catch (const std::exception& e) {
+      LOG(kError) << "Hosted vault " << vault_id << " failed: " << e.what();
+      exit_code = ErrorToInt(MakeError(CommonErrors::unknown));
+    }
+
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (!vaults_.at(vault_id).stopped && !disconnected_)
+      Send(connection_, HostedVaultExited(vault_id, exit_code));
+    vaults_.erase(vault_id);
+    cond_var_.notify_all();
+  }
+
+  void OnConnectionClosed() {
+    LOG(kInfo) << "Vault host disconnected from VaultManager.";
+    std::lock_guard<std::mutex> lock{mutex_};
+    disconnected_ = true;
+    cond_var_.notify_all();
+  }
+
+  const HostedVaultFunctor kRunVault_;
+  std::mutex mutex_;
+  std::condition_variable cond_var_;
+  bool disconnected_;
+  std::map<uint64_t, HostedVault> vaults_;
+  AsioService asio_service_;
+  asio::io_service::strand strand_;
+  tcp::ConnectionPtr connection_;
+};
+
+}  // unnamed namespace
+
+bool IsVaultHost(int argc, char* argv[]) {
+  return argc == 3 && std::string{argv[1]} == kVaultHostArgument;
+}
+
+int RunVaultHost(int argc, char* argv[], HostedVaultFunctor run_vault) {
+  try {
+    if (!IsVaultHost(argc, argv))
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+    auto vault_host(std::make_shared<VaultHost>(std::move(run_vault)));
+    return vault_host->Run(static_cast<tcp::Port>(std::stoi(std::string{argv[2]})));
+  } catch (const maidsafe_error& error) {
+    LOG(kError) << "Vault host failed: " << error.what();
+    return ErrorToInt(error);
+  } catch (const std::exception& e) {
+    LOG(kError) << "Vault host failed: " << e.what();
+    return ErrorToInt(MakeError(CommonErrors::invalid_parameter));
+  }
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -30,6 +30,9 @@ VaultInfo::VaultInfo()
       max_disk_usage(0),
       owner_name(),
       label(),
+      request_id(0),
+      requester(),
+      adoption_token(),
 #ifdef USE_VLOGGING
       vlog_session_id(),
       send_hostname_to_visualiser_server(false),
@@ -43,6 +46,9 @@ VaultInfo::VaultInfo(const VaultInfo& other)
       max_disk_usage(other.max_disk_usage),
       owner_name(other.owner_name),
       label(other.label),
+      request_id(other.request_id),
+      requester(other.requester),
+      adoption_token(other.adoption_token),
 #ifdef USE_VLOGGING
       vlog_session_id(other.vlog_session_id),
       send_hostname_to_visualiser_server(other.send_hostname_to_visualiser_server),
@@ -56,6 +62,9 @@ VaultInfo::VaultInfo(VaultInfo&& other)
       max_disk_usage(std::move(other.max_disk_usage)),
       owner_name(std::move(other.owner_name)),
       label(std::move(other.label)),
+      request_id(std::move(other.request_id)),
+      requester(std::move(other.requester)),
+      adoption_token(std::move(other.adoption_token)),
 #ifdef USE_VLOGGING
       vlog_session_id(std::move(other.vlog_session_id)),
       send_hostname_to_visualiser_server(std::move(other.send_hostname_to_visualiser_server)),
@@ -75,6 +84,9 @@ void swap(VaultInfo& lhs, VaultInfo& rhs) {
   swap(lhs.max_disk_usage, rhs.max_disk_usage);
   swap(lhs.owner_name, rhs.owner_name);
   swap(lhs.label, rhs.label);
+  swap(lhs.request_id, rhs.request_id);
+  swap(lhs.requester, rhs.requester);
+  swap(lhs.adoption_token, rhs.adoption_token);
 #ifdef USE_VLOGGING
   swap(lhs.vlog_session_id, rhs.vlog_session_id);
   swap(lhs.send_hostname_to_visualiser_server, rhs.send_hostname_to_visualiser_server);
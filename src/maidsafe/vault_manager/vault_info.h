@@ -46,6 +46,13 @@ struct VaultInfo {
   DiskUsage max_disk_usage;
   passport::PublicMaid::Name owner_name;
   NonEmptyString label;
+  // Id of the client request to be answered when the vault next starts; 0 if none.  Not persisted.
+  uint64_t request_id;
+  // The client connection which made that request.  Not persisted.
+  std::weak_ptr<tcp::Connection> requester;
+  // Given to the vault so that a restarted VaultManager can re-adopt it.  Not persisted in the
+  // config file.
+  std::string adoption_token;
 #ifdef USE_VLOGGING
   std::string vlog_session_id;
   bool send_hostname_to_visualiser_server;
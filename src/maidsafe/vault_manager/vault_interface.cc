@@ -24,9 +24,14 @@
 #include "maidsafe/common/utils.h"
 #include "maidsafe/common/tcp/connection.h"
 
+#include "maidsafe/vault_manager/compact_message.h"
 #include "maidsafe/vault_manager/rpc_helper.h"
+#include "maidsafe/vault_manager/timing_wheel.h"
 #include "maidsafe/vault_manager/utils.h"
+#include "maidsafe/vault_manager/vault_config_channel.h"
+#include "maidsafe/vault_manager/messages/capabilities.h"
 #include "maidsafe/vault_manager/messages/joined_network.h"
+#include "maidsafe/vault_manager/messages/log_message.h"
 #include "maidsafe/vault_manager/messages/vault_started.h"
 #include "maidsafe/vault_manager/messages/vault_started_response.h"
 
@@ -36,47 +41,142 @@ namespace maidsafe {
 
 namespace vault_manager {
 
-VaultInterface::VaultInterface(tcp::Port vault_manager_port)
+VaultInterface::VaultInterface(tcp::Port vault_manager_port, process::ProcessId hosted_vault_id)
     : exit_code_promise_(),
       exit_code_flag_(),
+      exiting_(false),
+      kProcessId_(hosted_vault_id == 0 ? process::GetProcessId() : hosted_vault_id),
+      kHosted_(hosted_vault_id != 0),
       vault_manager_port_(vault_manager_port),
       on_vault_started_response_(),
       vault_config_(),
+      compact_messages_(false),
+      adoption_token_(),
+      reconnect_attempts_(0),
+      disconnected_at_(),
+      mutex_(),
       asio_service_(1),
       strand_(asio_service_.service()),
+      reconnect_timer_(asio_service_.service()),
       tcp_connection_(tcp::Connection::MakeShared(strand_, vault_manager_port_)),
-      connection_closer_([&] { tcp_connection_->Close(); }) {
+      connection_closer_([&] {
+        exiting_ = true;
+        std::lock_guard<std::mutex> lock{mutex_};
+        if (tcp_connection_)
+          tcp_connection_->Close();
+      }) {
   tcp_connection_->Start(
       [this](tcp::Message message) { HandleReceivedMessage(std::move(message)); },
       [this] { OnConnectionClosed(); });
   LOG(kSuccess) << "Connected to VaultManager which is listening on port " << vault_manager_port_;
+  // A hosted vault shares its process' environment with the other vaults of the host, none of which
+  // is handed a config channel.
+  if (!kHosted_ && ReadHandedOffConfig()) {
+    Send(tcp_connection_, Capabilities(Capabilities::kAll));
+    Send(tcp_connection_, VaultStarted(kProcessId_, adoption_token_));
+    LOG(kSuccess) << "Retrieved config info from VaultManager's config channel";
+    return;
+  }
   std::mutex mutex;
   auto vault_config_future(SetResponseCallback<std::unique_ptr<VaultConfig>, VaultStartedResponse>(
-      on_vault_started_response_, asio_service_.service(), mutex));
-  Send(tcp_connection_, VaultStarted(process::GetProcessId()));
+      on_vault_started_response_, TimingWheel::MakeShared(asio_service_.service()), mutex));
+  Send(tcp_connection_, Capabilities(Capabilities::kAll));
+  Send(tcp_connection_, VaultStarted(kProcessId_));
   vault_config_ = vault_config_future.get();
   LOG(kSuccess) << "Retrieved config info from VaultManager";
 }
 
+VaultInterface::~VaultInterface() {
+  exiting_ = true;
+  // The timer isn't threadsafe, so cancel it on the asio thread.
+  std::promise<void> reconnection_stopped;
+  strand_.dispatch([&] {
+    reconnect_timer_.cancel();
+    reconnection_stopped.set_value();
+  });
+  reconnection_stopped.get_future().wait();
+}
+
 VaultConfig VaultInterface::GetConfiguration() { return *vault_config_; }
 
 int VaultInterface::WaitForExit() { return exit_code_promise_.get_future().get(); }
 
-void VaultInterface::SendJoined() { Send(tcp_connection_, JoinedNetwork()); }
+void VaultInterface::SendJoined() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  Send(tcp_connection_, JoinedNetwork(), compact_messages_);
+}
+
+void VaultInterface::SendLogMessage(const std::string& message) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  Send(tcp_connection_, LogMessage(message));
+}
+
+void VaultInterface::Stop(int exit_code) { Exit(exit_code); }
 
 void VaultInterface::OnConnectionClosed() {
   LOG(kError) << "Lost connection to Vault Manager";
-  std::call_once(exit_code_flag_, [this] {
-    exit_code_promise_.set_value(ErrorToInt(MakeError(VaultManagerErrors::connection_aborted)));
+  if (exiting_)
+    return;
+  // Until the vault has been configured, no VaultManager could re-adopt it.
+  strand_.dispatch([this] {
+    if (adoption_token_.empty())
+      return Exit(ErrorToInt(MakeError(VaultManagerErrors::connection_aborted)));
+    disconnected_at_ = std::chrono::steady_clock::now();
+    reconnect_attempts_ = 0;
+    ScheduleReconnect();
   });
 }
 
+void VaultInterface::ScheduleReconnect() {
+  if (std::chrono::steady_clock::now() - disconnected_at_ > kVaultReconnectTimeout) {
+    LOG(kError) << "Giving up trying to reconnect to Vault Manager";
+    return Exit(ErrorToInt(MakeError(VaultManagerErrors::connection_aborted)));
+  }
+  reconnect_timer_.expires_from_now(GetReconnectDelay(reconnect_attempts_++));
+  reconnect_timer_.async_wait(strand_.wrap([this](const std::error_code& error_code) {
+    if (error_code == asio::error::operation_aborted || exiting_)
+      return;
+    Reconnect();
+  }));
+}
+
+void VaultInterface::Reconnect() {
+  std::shared_ptr<tcp::Connection> tcp_connection;
+  try {
+    tcp_connection = tcp::Connection::MakeShared(strand_, vault_manager_port_);
+  } catch (const std::exception& e) {
+    LOG(kVerbose) << "Failed to reconnect to Vault Manager: " << boost::diagnostic_information(e);
+    return ScheduleReconnect();
+  }
+  compact_messages_ = false;
+  tcp_connection->Start(
+      [this](tcp::Message message) { HandleReceivedMessage(std::move(message)); },
+      [this] { OnConnectionClosed(); });
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    tcp_connection_ = tcp_connection;
+  }
+  LOG(kInfo) << "Reconnected to Vault Manager; asking to be re-adopted.";
+  Send(tcp_connection, Capabilities(Capabilities::kAll));
+  Send(tcp_connection, VaultStarted(kProcessId_, adoption_token_));
+}
+
+void VaultInterface::Exit(int exit_code) {
+  exiting_ = true;
+  std::call_once(exit_code_flag_, [this, exit_code] { exit_code_promise_.set_value(exit_code); });
+}
+
 void VaultInterface::HandleReceivedMessage(tcp::Message&& message) {
   try {
+    if (PeekTag(message) == MessageTag::kCompactMessage)
+      return HandleCompactMessage(message);
     InputVectorStream binary_input_stream(std::move(message));
     MessageTag tag(static_cast<MessageTag>(-1));
     Parse(binary_input_stream, tag);
     switch (tag) {
+      case MessageTag::kCapabilities:
+        HandleCapabilities(Parse<Capabilities>(binary_input_stream));
+        break;
       case MessageTag::kVaultStartedResponse:
         HandleVaultStartedResponse(Parse<VaultStartedResponse>(binary_input_stream));
         break;
@@ -91,25 +191,63 @@ void VaultInterface::HandleReceivedMessage(tcp::Message&& message) {
   }
 }
 
+void VaultInterface::HandleCompactMessage(const tcp::Message& message) {
+  switch (CompactTag(message)) {
+    case MessageTag::kVaultShutdownRequest:
+      HandleVaultShutdownRequest();
+      break;
+    default:
+      return;
+  }
+}
+
+void VaultInterface::HandleCapabilities(Capabilities&& capabilities) {
+  compact_messages_ = (capabilities.flags & Capabilities::kCompactMessages) != 0;
+}
+
 void VaultInterface::HandleVaultStartedResponse(VaultStartedResponse&& vault_started_response) {
+  adoption_token_ = vault_started_response.adoption_token;
   if (on_vault_started_response_)
     on_vault_started_response_(std::move(vault_started_response));
   else
     assert(false);  // already received vault configuration
 }
 
+bool VaultInterface::ReadHandedOffConfig() {
+  tcp::Message message{ReadVaultConfigChannel()};
+  if (message.empty())
+    return false;
+  try {
+    InputVectorStream binary_input_stream(std::move(message));
+    MessageTag tag(static_cast<MessageTag>(-1));
+    Parse(binary_input_stream, tag);
+    if (tag != MessageTag::kVaultStartedResponse)
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+    auto vault_started_response(Parse<VaultStartedResponse>(binary_input_stream));
+    vault_config_ = detail::GetValue(vault_started_response);
+    adoption_token_ = vault_started_response.adoption_token;
+    return true;
+  } catch (const std::exception& e) {
+    LOG(kError) << "Failed to parse config channel; falling back to asking VaultManager: "
+                << boost::diagnostic_information(e);
+    return false;
+  }
+}
+
 void VaultInterface::HandleVaultShutdownRequest() {
   LOG(kInfo) << "Received  ShutdownRequest from Vault Manager";
-  std::call_once(exit_code_flag_, [this] { exit_code_promise_.set_value(0); });
+  Exit(0);
 }
 
 #ifdef TESTING
 void VaultInterface::KillConnection() {
   maidsafe::Sleep(std::chrono::seconds(1));
+  std::lock_guard<std::mutex> lock{mutex_};
   tcp_connection_.reset();
 }
 
 void VaultInterface::SendInvalidMessage() {
+  std::lock_guard<std::mutex> lock{mutex_};
   tcp_connection_->Send(tcp::Message{'R', 'u', 'b', 'b', 'i', 's', 'h'});
 }
 
@@ -0,0 +1,79 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/vault_keys_cache.h"
+
+#include "maidsafe/common/error.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+VaultKeysCache::VaultKeysCache(std::size_t capacity)
+    : kCapacity_(capacity), mutex_(), entries_(), index_() {
+  if (kCapacity_ == 0)
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+}
+
+VaultKeysCache::EncryptedKeys VaultKeysCache::Get(
+    const NonEmptyString& label, const passport::PmidAndSigner& pmid_and_signer) {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto itr(index_.find(label));
+    if (itr != std::end(index_) && itr->second->second->pmid_name == pmid_and_signer.first.name()) {
+      entries_.splice(std::begin(entries_), entries_, itr->second);
+      return itr->second->second;
+    }
+  }
+
+  // Encrypt without holding the lock.  If another thread does the same for this label meanwhile,
+  // the later bundle simply replaces the earlier one.
+  EncryptedKeys encrypted_keys{
+      std::make_shared<const VaultRunningResponse::VaultKeys::Encrypted>(pmid_and_signer)};
+  std::lock_guard<std::mutex> lock{mutex_};
+  auto itr(index_.find(label));
+  if (itr != std::end(index_)) {
+    entries_.erase(itr->second);
+    index_.erase(itr);
+  }
+  entries_.emplace_front(label, encrypted_keys);
+  index_.emplace(label, std::begin(entries_));
+  if (entries_.size() > kCapacity_) {
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+  return encrypted_keys;
+}
+
+void VaultKeysCache::Remove(const NonEmptyString& label) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  auto itr(index_.find(label));
+  if (itr == std::end(index_))
+    return;
+  entries_.erase(itr->second);
+  index_.erase(itr);
+}
+
+std::size_t VaultKeysCache::Size() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return entries_.size();
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,72 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_VAULT_KEYS_CACHE_H_
+#define MAIDSAFE_VAULT_MANAGER_VAULT_KEYS_CACHE_H_
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "maidsafe/common/types.h"
+#include "maidsafe/passport/passport.h"
+
+#include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/messages/vault_running_response.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Holds the encrypted key bundles most recently sent in VaultRunningResponses, keyed by vault
+// label, so that repeated TakeOwnership requests and restarts of a vault don't re-encrypt its keys.
+// A bundle is only reused while the vault's Pmid is unchanged.  The least recently used bundle is
+// evicted once 'capacity' is reached.  Threadsafe.
+class VaultKeysCache {
+ public:
+  typedef std::shared_ptr<const VaultRunningResponse::VaultKeys::Encrypted> EncryptedKeys;
+
+  explicit VaultKeysCache(std::size_t capacity = kVaultKeysCacheSize);
+
+  VaultKeysCache(const VaultKeysCache&) = delete;
+  VaultKeysCache(VaultKeysCache&&) = delete;
+  VaultKeysCache& operator=(VaultKeysCache) = delete;
+
+  // Encrypts and caches the keys if there is no bundle for 'label' built from the same Pmid.
+  EncryptedKeys Get(const NonEmptyString& label, const passport::PmidAndSigner& pmid_and_signer);
+  void Remove(const NonEmptyString& label);
+  std::size_t Size() const;
+
+ private:
+  typedef std::list<std::pair<NonEmptyString, EncryptedKeys>> Entries;
+
+  const std::size_t kCapacity_;
+  mutable std::mutex mutex_;
+  // Most recently used first.
+  Entries entries_;
+  std::map<NonEmptyString, Entries::iterator> index_;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_VAULT_KEYS_CACHE_H_
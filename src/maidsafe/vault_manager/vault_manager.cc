@@ -18,14 +18,21 @@
 
 #include "maidsafe/vault_manager/vault_manager.h"
 
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <future>
+#include <map>
 #include <string>
 #include <vector>
 
 #include "boost/filesystem/operations.hpp"
 
 #include "maidsafe/common/application_support_directories.h"
+#include "maidsafe/common/crypto.h"
 #include "maidsafe/common/error.h"
 #include "maidsafe/common/log.h"
+#include "maidsafe/common/on_scope_exit.h"
 #include "maidsafe/common/process.h"
 #include "maidsafe/common/utils.h"
 #include "maidsafe/common/serialisation/serialisation.h"
@@ -35,9 +42,19 @@
 #include "maidsafe/nfs/client/maid_client.h"
 
 #include "maidsafe/vault_manager/client_connections.h"
+#include "maidsafe/vault_manager/config_reload.h"
+#include "maidsafe/vault_manager/discovery_file.h"
+#include "maidsafe/vault_manager/compact_message.h"
 #include "maidsafe/vault_manager/new_connections.h"
 #include "maidsafe/vault_manager/process_manager.h"
+#include "maidsafe/vault_manager/re_exec.h"
+#include "maidsafe/vault_manager/thread_vault_backend.h"
+#include "maidsafe/vault_manager/traffic_capture.h"
 #include "maidsafe/vault_manager/utils.h"
+#include "maidsafe/vault_manager/messages/add_owner_request.h"
+#include "maidsafe/vault_manager/messages/batch_start_vault_request.h"
+#include "maidsafe/vault_manager/messages/batch_take_ownership_request.h"
+#include "maidsafe/vault_manager/messages/capabilities.h"
 #include "maidsafe/vault_manager/messages/challenge.h"
 #include "maidsafe/vault_manager/messages/challenge_response.h"
 #include "maidsafe/vault_manager/messages/joined_network.h"
@@ -45,10 +62,17 @@
 #include "maidsafe/vault_manager/messages/max_disk_usage_update.h"
 #include "maidsafe/vault_manager/messages/network_stable_request.h"
 #include "maidsafe/vault_manager/messages/network_stable_response.h"
+#include "maidsafe/vault_manager/messages/owner_added.h"
+#include "maidsafe/vault_manager/messages/owner_challenge.h"
+#include "maidsafe/vault_manager/messages/owner_challenge_response.h"
+#include "maidsafe/vault_manager/messages/resume_session_request.h"
+#include "maidsafe/vault_manager/messages/session_ticket.h"
 #include "maidsafe/vault_manager/messages/set_network_as_stable.h"
 #include "maidsafe/vault_manager/messages/start_vault_request.h"
+#include "maidsafe/vault_manager/messages/subscribe_to_vault_events_request.h"
 #include "maidsafe/vault_manager/messages/take_ownership_request.h"
 #include "maidsafe/vault_manager/messages/validate_connection_request.h"
+#include "maidsafe/vault_manager/messages/vault_event_notification.h"
 #include "maidsafe/vault_manager/messages/vault_running_response.h"
 #include "maidsafe/vault_manager/messages/vault_shutdown_request.h"
 #include "maidsafe/vault_manager/messages/vault_started.h"
@@ -62,17 +86,13 @@ namespace vault_manager {
 
 namespace {
 
-fs::path GetPath(const fs::path& p) {
-#ifdef TESTING
-  return (GetTestEnvironmentRootDir().empty() ? GetUserAppDir() : GetTestEnvironmentRootDir()) / p;
-#else
-  return GetSystemAppSupportDir() / p;
-#endif
-}
+fs::path GetConfigFilePath() { return GetVaultManagerFilePath(kConfigFilename); }
+
+fs::path GetOverridesFilePath() { return GetVaultManagerFilePath(kOverridesFilename); }
 
-fs::path GetConfigFilePath() { return GetPath(kConfigFilename); }
+fs::path GetChildrenFilePath() { return GetVaultManagerFilePath(kChildrenFilename); }
 
-fs::path GetVaultDir(const std::string& debug_id) { return GetPath(debug_id); }
+fs::path GetVaultDir(const std::string& debug_id) { return GetVaultManagerFilePath(debug_id); }
 
 fs::path GetVaultExecutablePath() {
 #ifdef TESTING
@@ -90,21 +110,159 @@ void PutPmidAndSigner(const passport::PmidAndSigner& pmid_and_signer) {
   client_nfs->Stop();
 }
 
+// Stores the public keys of all the given vault identities via a single client, with all the Puts
+// in flight concurrently.  Blocks until all have finished, invoking 'on_stored' with the index of
+// each identity in turn as soon as its Puts have finished, along with the error if they failed.
+void PutPmidsAndSigners(
+    const std::vector<std::shared_ptr<passport::PmidAndSigner>>& pmids_and_signers,
+    const std::function<void(std::size_t, std::exception_ptr)>& on_stored) {
+  if (pmids_and_signers.empty())
+    return;
+  std::shared_ptr<nfs_client::MaidClient> client_nfs;
+  try {
+    client_nfs = nfs_client::MaidClient::MakeShared(
+        passport::MaidAndSigner{passport::CreateMaidAndSigner()});
+  } catch (...) {
+    for (std::size_t i(0); i < pmids_and_signers.size(); ++i)
+      on_stored(i, std::current_exception());
+    return;
+  }
+  on_scope_exit stop_client([&] { client_nfs->Stop(); });
+
+  typedef decltype(client_nfs->Put(passport::PublicPmid{pmids_and_signers.front()->first}))
+      PutFuture;
+  std::vector<std::pair<PutFuture, PutFuture>> puts;
+  puts.reserve(pmids_and_signers.size());
+  for (const auto& pmid_and_signer : pmids_and_signers) {
+    puts.emplace_back(client_nfs->Put(passport::PublicPmid{pmid_and_signer->first}),
+                      client_nfs->Put(passport::PublicAnpmid{pmid_and_signer->second}));
+  }
+  for (std::size_t i(0); i < puts.size(); ++i) {
+    try {
+      puts[i].first.get();
+      puts[i].second.get();
+    } catch (...) {
+      LOG(kError) << "Failed to put PmidAndSigner for "
+                  << DebugId(pmids_and_signers[i]->first.name().value);
+      on_stored(i, std::current_exception());
+      continue;
+    }
+    on_stored(i, nullptr);
+  }
+}
+
 }  // unnamed namespace
 
-VaultManager::VaultManager()
+template <typename SerialiseFunctor>
+void VaultManager::SerialiseAndSend(tcp::ConnectionPtr connection, SerialiseFunctor serialise) {
+  typedef decltype(serialise()) SerialisedMessage;
+  const SendQueues::Slot kSlot{send_queues_->Reserve(connection)};
+  bool posted{crypto_executor_.Post(serialise, [this, connection, kSlot](
+                                                   std::future<SerialisedMessage> message) {
+    tcp::Message serialised;
+    try {
+      serialised = message.get();
+    } catch (const std::exception& e) {
+      LOG(kError) << "Failed to serialise message: " << boost::diagnostic_information(e);
+    }
+    send_queues_->Fill(connection, kSlot, std::move(serialised));
+  })};
+  // If the crypto workers are saturated, do the work here rather than drop the message.
+  if (!posted)
+    send_queues_->Fill(connection, kSlot, serialise());
+}
+
+void VaultManager::SerialiseVaultConfig(const VaultInfo& vault_info,
+                                        std::function<void(tcp::Message)> on_serialised) {
+  crypto::AES256Key symm_key{config_file_handler_.SymmKey()};
+  crypto::AES256InitialisationVector symm_iv{config_file_handler_.SymmIv()};
+  auto serialise([vault_info, symm_key, symm_iv] {
+    return Serialise(VaultStartedResponse::tag,
+                     VaultStartedResponse(vault_info, symm_key, symm_iv));
+  });
+  bool posted{crypto_executor_.Post(serialise, [on_serialised](std::future<tcp::Message> message) {
+    tcp::Message serialised;
+    try {
+      serialised = message.get();
+    } catch (const std::exception& e) {
+      LOG(kError) << "Failed to serialise vault config: " << boost::diagnostic_information(e);
+    }
+    on_serialised(std::move(serialised));
+  })};
+  // If the crypto workers are saturated, do the work here rather than delay the vault.
+  if (!posted)
+    on_serialised(serialise());
+}
+
+template <typename T>
+void VaultManager::Send(tcp::ConnectionPtr connection, T message) {
+  send_queues_->Send(connection, Serialise(T::tag, std::move(message)));
+}
+
+template <typename T>
+void VaultManager::Send(tcp::ConnectionPtr connection, T message, bool compact) {
+  send_queues_->Send(connection, SerialiseMessage(std::move(message), compact));
+}
+
+template <typename T>
+void VaultManager::Broadcast(const std::vector<tcp::ConnectionPtr>& connections, T message) {
+  if (!connections.empty())
+    BroadcastSerialised(connections, Serialise(T::tag, std::move(message)));
+}
+
+void VaultManager::BroadcastSerialised(const std::vector<tcp::ConnectionPtr>& connections,
+                                       tcp::Message message) {
+  auto send_queues(send_queues_);
+  vault_manager::BroadcastSerialised(
+      connections, std::move(message),
+      [send_queues](tcp::ConnectionPtr connection, tcp::Message frame) {
+        send_queues->Send(connection, std::move(frame));
+      });
+}
+
+VaultManager::VaultManager(std::size_t crypto_thread_count,
+                           AdmissionControl::Limits admission_limits, int inherited_listener_fd,
+                           std::size_t vaults_per_host)
     : config_file_handler_(GetConfigFilePath()),
       network_stable_(false),
       tear_down_with_interval_(false),
+      leave_vaults_running_(false),
+      instance_id_(RandomAlphaNumericString(16)),
+      vault_event_log_(),
+      admission_control_(std::move(admission_limits)),
+      session_tickets_(),
+      vault_keys_cache_(),
+      time_handlers_(false),
+      handler_timings_(),
+      connection_count_(0),
+      traffic_capture_(),
       asio_service_(1),
       strand_(asio_service_.service()),
-      listener_(tcp::Listener::MakeShared(
-          strand_, [this](tcp::ConnectionPtr connection) { HandleNewConnection(connection); },
-          GetInitialListeningPort())),
-      process_manager_(ProcessManager::MakeShared(asio_service_.service(), GetVaultExecutablePath(),
-                                                  listener_->ListeningPort())),
-      client_connections_(ClientConnections::MakeShared(asio_service_.service())),
-      new_connections_(NewConnections::MakeShared(asio_service_.service())) {
+      timing_wheel_(TimingWheel::MakeShared(asio_service_.service())),
+      peer_capabilities_(std::make_shared<PeerCapabilities>()),
+      send_queues_(std::make_shared<SendQueues>()),
+      crypto_executor_(strand_, crypto_thread_count),
+      listener_(MakeListener(inherited_listener_fd)),
+      process_manager_(ProcessManager::MakeShared(
+          asio_service_.service(), GetVaultExecutablePath(), listener_->ListeningPort(),
+          [this](const VaultInfo& vault_info, VaultEventType type, int exit_code) {
+            if (type == VaultEventType::kExited)
+              vault_keys_cache_.Remove(vault_info.label);
+            WriteChildRecordsFile();
+            PublishVaultEvent(vault_info, type, exit_code);
+          },
+          timing_wheel_, peer_capabilities_,
+          [this](const VaultInfo& vault_info, std::function<void(tcp::Message)> on_serialised) {
+            SerialiseVaultConfig(vault_info, std::move(on_serialised));
+          },
+          vaults_per_host == 0 ? nullptr
+                               : MakeThreadVaultBackend(asio_service_.service(), vaults_per_host),
+          send_queues_)),
+      client_connections_(ClientConnections::MakeShared(timing_wheel_)),
+      new_connections_(NewConnections::MakeShared(timing_wheel_)),
+      messages_awaiting_validation_(),
+      vaults_awaiting_identity_(),
+      identity_store_service_(static_cast<uint32_t>(kIdentityStoreThreadCount)) {
   std::vector<VaultInfo> vaults{config_file_handler_.ReadConfigFile()};
   if (vaults.empty()) {
 #ifndef TESTING
@@ -134,12 +292,125 @@ VaultManager::VaultManager()
     config_file_handler_.WriteConfigFile(process_manager_->GetAll());
 #endif
   } else {
+    std::vector<ChildRecord> child_records{ReadChildRecords(GetChildrenFilePath())};
     for (auto& vault_info : vaults)
-      process_manager_->AddProcess(std::move(vault_info));
+      AdoptOrStartVault(std::move(vault_info), child_records);
   }
+  PublishEndpoint();
   LOG(kInfo) << "VaultManager started";
 }
 
+void VaultManager::PublishEndpoint() {
+  try {
+    WriteDiscoveryFile(GetDiscoveryFilePath(),
+                       DiscoveryRecord{listener_->ListeningPort(), instance_id_,
+                                       process::GetProcessId()});
+  } catch (const std::exception& e) {
+    // Clients fall back to scanning the port range.
+    LOG(kWarning) << "Failed to publish listening port: " << boost::diagnostic_information(e);
+  }
+}
+
+void VaultManager::AdoptOrStartVault(VaultInfo vault_info,
+                                     const std::vector<ChildRecord>& child_records) {
+  auto child_record(std::find_if(
+      std::begin(child_records), std::end(child_records),
+      [&vault_info](const ChildRecord& record) { return record.label == vault_info.label; }));
+  if (child_record != std::end(child_records)) {
+    try {
+      VaultInfo adopted_vault_info{vault_info};
+      adopted_vault_info.adoption_token = child_record->adoption_token;
+      return process_manager_->AdoptProcess(std::move(adopted_vault_info),
+                                            child_record->process_id);
+    } catch (const std::exception& e) {
+      LOG(kWarning) << "Starting vault " << vault_info.label.string()
+                    << " afresh: " << boost::diagnostic_information(e);
+    }
+  }
+  process_manager_->AddProcess(std::move(vault_info));
+}
+
+void VaultManager::WriteChildRecordsFile() {
+  try {
+    WriteChildRecords(GetChildrenFilePath(), process_manager_->GetChildRecords());
+  } catch (const std::exception& e) {
+    LOG(kError) << "Failed to record vault processes: " << boost::diagnostic_information(e);
+  }
+}
+
+void VaultManager::LeaveVaultsRunning() { leave_vaults_running_ = true; }
+
+int VaultManager::DetachForReExec() {
+  leave_vaults_running_ = true;
+  std::promise<void> detached;
+  strand_.dispatch([&] {
+    config_file_handler_.WriteConfigFile(process_manager_->GetAll());
+    WriteChildRecordsFile();
+    new_connections_->CloseAll();
+    client_connections_->CloseAll();
+    process_manager_->ReleaseAll();
+    detached.set_value();
+  });
+  detached.get_future().get();
+  return listener_->NativeHandle();
+}
+
+void VaultManager::ReloadConfig() {
+  strand_.post([this] { DoReloadConfig(); });
+}
+
+void VaultManager::DoReloadConfig() {
+  std::vector<VaultInfo> desired;
+  try {
+    desired = config_file_handler_.ReadConfigFile();
+    fs::path overrides_path{GetOverridesFilePath()};
+    if (fs::exists(overrides_path))
+      ApplyOverrides(ReadFile(overrides_path).string(), desired);
+  } catch (const std::exception& e) {
+    LOG(kError) << "Not reloading config: " << boost::diagnostic_information(e);
+    return;
+  }
+
+  ConfigDiff diff{DiffVaults(process_manager_->GetAll(), desired)};
+  LOG(kInfo) << "Reloading config: " << diff.added.size() << " added, " << diff.removed.size()
+             << " removed, " << diff.relocated.size() << " relocated and " << diff.resized.size()
+             << " resized.";
+  if (diff.Empty())
+    return;
+
+  ProcessManager::OnExitFunctor on_removed{[this](maidsafe_error /*error*/, int /*exit_code*/) {
+    config_file_handler_.WriteConfigFile(process_manager_->GetAll());
+  }};
+  for (const auto& vault_info : diff.removed)
+    process_manager_->StopProcess(vault_info.label, on_removed);
+
+  for (const auto& desired_info : diff.relocated) {
+    VaultInfo vault_info{process_manager_->Find(desired_info.label)};
+    vault_info.vault_dir = desired_info.vault_dir;
+    vault_info.max_disk_usage = desired_info.max_disk_usage;
+    ChangeChunkstorePath(std::move(vault_info));
+  }
+
+  for (const auto& desired_info : diff.resized) {
+    process_manager_->SetMaxDiskUsage(desired_info.label, desired_info.max_disk_usage);
+    tcp::ConnectionPtr connection{process_manager_->Find(desired_info.label).tcp_connection};
+    // A vault which hasn't connected yet will be given the new value when it does.
+    if (connection)
+      Send(connection, MaxDiskUsageUpdate(desired_info.max_disk_usage),
+           peer_capabilities_->CompactMessages(connection));
+  }
+
+  for (const auto& vault_info : diff.added) {
+    try {
+      process_manager_->AddProcess(vault_info);
+    } catch (const std::exception& e) {
+      LOG(kError) << "Failed to start vault " << vault_info.label.string() << ": "
+                  << boost::diagnostic_information(e);
+    }
+  }
+  config_file_handler_.WriteConfigFile(process_manager_->GetAll());
+}
+
 void VaultManager::TearDownWithInterval() {
   tear_down_with_interval_ = true;
   auto listener(listener_);
@@ -157,29 +428,133 @@ void VaultManager::TearDownWithInterval() {
 }
 
 VaultManager::~VaultManager() {
+  RemoveDiscoveryFile(GetDiscoveryFilePath(), instance_id_);
+  AdmissionControl::Stats stats{admission_control_.GetStats()};
+  LOG(kInfo) << "Connections admitted: " << stats.admitted_connections
+             << ", rejected: " << stats.rejected_connections
+             << ", evicted: " << stats.evicted_connections
+             << ", admitted for starting vaults only: " << stats.vault_only_connections
+             << ".  Challenges refused: " << stats.rejected_challenges;
   if (!tear_down_with_interval_) {
     auto listener(listener_);
     auto new_connections(new_connections_);
     auto client_connections(client_connections_);
     auto process_manager(process_manager_);
+    const bool kLeaveVaultsRunning{leave_vaults_running_};
     asio_service_.service().post([=] {
       listener->StopListening();
       new_connections->CloseAll();
       client_connections->CloseAll();
-      process_manager->StopAll();
+      if (kLeaveVaultsRunning)
+        process_manager->ReleaseAll();
+      else
+        process_manager->StopAll();
     });
     asio_service_.Stop();
   }
 }
 
+std::shared_ptr<tcp::Listener> VaultManager::MakeListener(int inherited_listener_fd) {
+  tcp::NewConnectionFunctor on_new_connection{
+      [this](tcp::ConnectionPtr connection) { HandleNewConnection(connection); }};
+  if (inherited_listener_fd < 0)
+    return tcp::Listener::MakeShared(strand_, on_new_connection, GetInitialListeningPort());
+  return tcp::Listener::MakeShared(
+      strand_, on_new_connection,
+      AdoptInheritedListener(asio_service_.service(), inherited_listener_fd));
+}
+
 void VaultManager::HandleNewConnection(tcp::ConnectionPtr connection) {
+  const uint32_t connection_id{++connection_count_};
+  if (traffic_capture_)
+    traffic_capture_->RecordConnected(connection_id);
+  typedef AdmissionControl::Admission Admission;
+  const Admission kAdmission{admission_control_.AdmitConnection(
+      new_connections_->Size(), process_manager_->AwaitingConnectionCount())};
+  if (kAdmission == Admission::kReject) {
+    if (traffic_capture_)
+      traffic_capture_->RecordClosed(connection_id);
+    return connection->Close();
+  }
+  if (kAdmission == Admission::kAcceptAfterEvictingOldest ||
+      kAdmission == Admission::kAcceptVaultOnlyAfterEvictingOldest) {
+    new_connections_->CloseOldest();
+  }
+  const bool kVaultOnly{kAdmission == Admission::kAcceptVaultOnly ||
+                        kAdmission == Admission::kAcceptVaultOnlyAfterEvictingOldest};
   new_connections_->Add(connection);
-  tcp::MessageReceivedFunctor on_message{
-      [=](tcp::Message message) { HandleReceivedMessage(connection, std::move(message)); }};
-  connection->Start(on_message, [=] { HandleConnectionClosed(connection); });
+  tcp::MessageReceivedFunctor on_message{[=](tcp::Message message) {
+    if (traffic_capture_)
+      traffic_capture_->RecordMessage(connection_id, message);
+    if (kVaultOnly && !process_manager_->Contains(connection))
+      return HandleUnidentifiedVaultMessage(connection, std::move(message));
+    HandleReceivedMessage(connection, std::move(message));
+  }};
+  connection->Start(on_message, [=] {
+    if (traffic_capture_)
+      traffic_capture_->RecordClosed(connection_id);
+    HandleConnectionClosed(connection);
+  });
+}
+
+void VaultManager::HandleUnidentifiedVaultMessage(tcp::ConnectionPtr connection,
+                                                  tcp::Message&& message) {
+  MessageTag tag(static_cast<MessageTag>(-1));
+  try {
+    tag = PeekTag(message);
+  } catch (const std::exception&) {
+  }
+  if (tag != MessageTag::kCapabilities && tag != MessageTag::kVaultStarted) {
+    LOG(kWarning) << "Closing connection admitted only for a starting vault.";
+    return connection->Close();
+  }
+  HandleReceivedMessage(connection, std::move(message));
+  if (tag == MessageTag::kVaultStarted && !process_manager_->Contains(connection))
+    connection->Close();
+}
+
+AdmissionControl::Stats VaultManager::GetAdmissionStats() const {
+  return admission_control_.GetStats();
+}
+
+void VaultManager::StartCapture(const fs::path& capture_file) {
+  auto traffic_capture(std::make_shared<TrafficCaptureWriter>(capture_file));
+  LOG(kInfo) << "Capturing inbound traffic to " << capture_file;
+  strand_.post([this, traffic_capture] { traffic_capture_ = traffic_capture; });
+}
+
+void VaultManager::StopCapture() {
+  std::promise<void> stopped;
+  strand_.dispatch([&] {
+    traffic_capture_.reset();
+    stopped.set_value();
+  });
+  stopped.get_future().get();
+}
+
+void VaultManager::StartHandlerTimings() {
+  strand_.dispatch([this] { time_handlers_ = true; });
+}
+
+std::map<MessageTag, VaultManager::HandlerTiming> VaultManager::GetHandlerTimings() {
+  std::promise<std::map<MessageTag, HandlerTiming>> timings;
+  strand_.dispatch([&] { timings.set_value(handler_timings_); });
+  return timings.get_future().get();
+}
+
+void VaultManager::RecordHandlerTiming(MessageTag tag,
+                                       std::chrono::steady_clock::time_point start) {
+  const std::chrono::nanoseconds elapsed{std::chrono::steady_clock::now() - start};
+  HandlerTiming& timing(handler_timings_[tag]);
+  ++timing.count;
+  timing.total += elapsed;
+  timing.max = std::max(timing.max, elapsed);
 }
 
 void VaultManager::HandleConnectionClosed(tcp::ConnectionPtr connection) {
+  peer_capabilities_->Remove(connection);
+  send_queues_->Remove(connection);
+  messages_awaiting_validation_.erase(connection);
   if (process_manager_->HandleConnectionClosed(connection) ||
       client_connections_->Remove(connection)) {
     return;
@@ -188,7 +563,27 @@ void VaultManager::HandleConnectionClosed(tcp::ConnectionPtr connection) {
 }
 
 void VaultManager::HandleReceivedMessage(tcp::ConnectionPtr connection, tcp::Message&& message) {
+  auto awaiting_validation(messages_awaiting_validation_.find(connection));
+  if (awaiting_validation != std::end(messages_awaiting_validation_)) {
+    if (awaiting_validation->second.size() >= kMaxMessagesAwaitingValidation) {
+      LOG(kWarning) << "Too many messages from client awaiting validation - closing connection.";
+      return connection->Close();
+    }
+    return awaiting_validation->second.push_back(std::move(message));
+  }
+  const bool kTimed{time_handlers_};
+  const auto start(kTimed ? std::chrono::steady_clock::now()
+                          : std::chrono::steady_clock::time_point());
   try {
+    const MessageTag peeked_tag{PeekTag(message)};
+    on_scope_exit record_timing{[=] {
+      if (kTimed)
+        RecordHandlerTiming(peeked_tag, start);
+    }};
+    if (peeked_tag == MessageTag::kLogMessage)
+      return HandleLogMessage(connection, std::move(message));
+    if (peeked_tag == MessageTag::kCompactMessage)
+      return HandleCompactMessage(connection, message);
     InputVectorStream binary_input_stream(std::move(message));
     MessageTag tag(static_cast<MessageTag>(-1));
     Parse(binary_input_stream, tag);
@@ -199,12 +594,33 @@ void VaultManager::HandleReceivedMessage(tcp::ConnectionPtr connection, tcp::Mes
       case MessageTag::kChallengeResponse:
         HandleChallengeResponse(connection, Parse<ChallengeResponse>(binary_input_stream));
         break;
+      case MessageTag::kCapabilities:
+        HandleCapabilities(connection, Parse<Capabilities>(binary_input_stream));
+        break;
+      case MessageTag::kAddOwnerRequest:
+        HandleAddOwnerRequest(connection, Parse<AddOwnerRequest>(binary_input_stream));
+        break;
+      case MessageTag::kOwnerChallengeResponse:
+        HandleOwnerChallengeResponse(connection,
+                                     Parse<OwnerChallengeResponse>(binary_input_stream));
+        break;
+      case MessageTag::kResumeSessionRequest:
+        HandleResumeSessionRequest(connection, Parse<ResumeSessionRequest>(binary_input_stream));
+        break;
       case MessageTag::kStartVaultRequest:
         HandleStartVaultRequest(connection, Parse<StartVaultRequest>(binary_input_stream));
         break;
       case MessageTag::kTakeOwnershipRequest:
         HandleTakeOwnershipRequest(connection, Parse<TakeOwnershipRequest>(binary_input_stream));
         break;
+      case MessageTag::kBatchStartVaultRequest:
+        HandleBatchStartVaultRequest(connection,
+                                     Parse<BatchStartVaultRequest>(binary_input_stream));
+        break;
+      case MessageTag::kBatchTakeOwnershipRequest:
+        HandleBatchTakeOwnershipRequest(connection,
+                                        Parse<BatchTakeOwnershipRequest>(binary_input_stream));
+        break;
       case MessageTag::kVaultStarted:
         HandleVaultStarted(connection, Parse<VaultStarted>(binary_input_stream));
         break;
@@ -219,8 +635,9 @@ void VaultManager::HandleReceivedMessage(tcp::ConnectionPtr connection, tcp::Mes
         HandleNetworkStableRequest(connection);
         break;
 #endif
-      case MessageTag::kLogMessage:
-        HandleLogMessage(connection, Parse<LogMessage>(binary_input_stream));
+      case MessageTag::kSubscribeToVaultEventsRequest:
+        HandleSubscribeToVaultEvents(
+            connection, Parse<SubscribeToVaultEventsRequest>(binary_input_stream));
         break;
       default:
         return;
@@ -230,8 +647,39 @@ void VaultManager::HandleReceivedMessage(tcp::ConnectionPtr connection, tcp::Mes
   }
 }
 
+void VaultManager::HandleCompactMessage(tcp::ConnectionPtr connection,
+                                        const tcp::Message& message) {
+  switch (CompactTag(message)) {
+    case MessageTag::kValidateConnectionRequest:
+      HandleValidateConnectionRequest(connection);
+      break;
+    case MessageTag::kJoinedNetwork:
+      HandleJoinedNetwork(connection);
+      break;
+#ifdef TESTING
+    case MessageTag::kSetNetworkAsStable:
+      HandleSetNetworkAsStable();
+      break;
+    case MessageTag::kNetworkStableRequest:
+      HandleNetworkStableRequest(connection);
+      break;
+#endif
+    default:
+      LOG(kWarning) << "Unexpected compact message.";
+      break;
+  }
+}
+
+void VaultManager::HandleCapabilities(tcp::ConnectionPtr connection,
+                                      Capabilities&& capabilities) {
+  peer_capabilities_->Set(connection, capabilities.flags);
+  Send(connection, Capabilities(Capabilities::kAll, instance_id_));
+}
+
 void VaultManager::HandleValidateConnectionRequest(tcp::ConnectionPtr connection) {
   RemoveFromNewConnections(connection);
+  if (!admission_control_.AdmitChallenge(client_connections_->UnvalidatedCount()))
+    return connection->Close();
   asymm::PlainText plain_text{RandomString((RandomUint32() % 100) + 100)};
 
   client_connections_->Add(connection, plain_text);
@@ -240,38 +688,159 @@ void VaultManager::HandleValidateConnectionRequest(tcp::ConnectionPtr connection
 
 void VaultManager::HandleChallengeResponse(tcp::ConnectionPtr connection,
                                            ChallengeResponse&& challenge_response) {
-  client_connections_->Validate(connection, *challenge_response.public_maid,
-                                challenge_response.signature);
+  asymm::PlainText challenge{client_connections_->GetChallenge(connection)};
+  std::shared_ptr<passport::PublicMaid> public_maid{std::move(challenge_response.public_maid)};
+  asymm::Signature signature{std::move(challenge_response.signature)};
+  // A client may send requests straight after its response, so hold these until it's validated.
+  messages_awaiting_validation_[connection];
+  bool posted{crypto_executor_.Post(
+      [challenge, signature, public_maid] {
+        return asymm::CheckSignature(challenge, signature, public_maid->public_key());
+      },
+      [this, connection, public_maid](std::future<bool> signature_is_valid) {
+        std::vector<tcp::Message> held_messages;
+        auto awaiting_validation(messages_awaiting_validation_.find(connection));
+        if (awaiting_validation != std::end(messages_awaiting_validation_)) {
+          held_messages = std::move(awaiting_validation->second);
+          messages_awaiting_validation_.erase(awaiting_validation);
+        }
+        try {
+          client_connections_->Validate(connection, *public_maid, signature_is_valid.get());
+          Send(connection, SessionTicket(session_tickets_.Issue(public_maid->name())));
+        } catch (const std::exception& e) {
+          LOG(kError) << "Failed to validate client: " << boost::diagnostic_information(e);
+          return;
+        }
+        for (auto& held_message : held_messages)
+          HandleReceivedMessage(connection, std::move(held_message));
+      })};
+  if (!posted) {
+    LOG(kWarning) << "Crypto workers saturated - dropping unvalidated client.";
+    messages_awaiting_validation_.erase(connection);
+    connection->Close();
+  }
 }
 
+void VaultManager::HandleAddOwnerRequest(tcp::ConnectionPtr connection,
+                                         AddOwnerRequest&& add_owner_request) {
+  asymm::PlainText plain_text{RandomString((RandomUint32() % 100) + 100)};
+  try {
+    client_connections_->AddOwnerChallenge(connection, add_owner_request.request_id, plain_text);
+  } catch (const maidsafe_error& error) {
+    return Send(connection, OwnerAdded(add_owner_request.request_id, error));
+  }
+  Send(connection, OwnerChallenge(add_owner_request.request_id, std::move(plain_text)));
+}
+
+void VaultManager::HandleOwnerChallengeResponse(tcp::ConnectionPtr connection,
+                                                OwnerChallengeResponse&& challenge_response) {
+  const uint64_t request_id{challenge_response.request_id};
+  asymm::PlainText challenge;
+  try {
+    challenge = client_connections_->GetOwnerChallenge(connection, request_id);
+  } catch (const maidsafe_error& error) {
+    return Send(connection, OwnerAdded(request_id, error));
+  }
+  std::shared_ptr<passport::PublicMaid> public_maid{std::move(challenge_response.public_maid)};
+  asymm::Signature signature{std::move(challenge_response.signature)};
+  bool posted{crypto_executor_.Post(
+      [challenge, signature, public_maid] {
+        return asymm::CheckSignature(challenge, signature, public_maid->public_key());
+      },
+      [this, connection, request_id, public_maid](std::future<bool> signature_is_valid) {
+        try {
+          client_connections_->ValidateOwner(connection, request_id, *public_maid,
+                                             signature_is_valid.get());
+          Send(connection, OwnerAdded(request_id));
+        } catch (const maidsafe_error& error) {
+          LOG(kError) << "Failed to add owner: " << boost::diagnostic_information(error);
+          Send(connection, OwnerAdded(request_id, error));
+        } catch (const std::exception& e) {
+          LOG(kError) << "Failed to add owner: " << boost::diagnostic_information(e);
+          Send(connection, OwnerAdded(request_id, MakeError(CommonErrors::unknown)));
+        }
+      })};
+  if (!posted) {
+    // Unlike an unvalidated connection, this one may be in use by other owners, so isn't closed.
+    LOG(kWarning) << "Crypto workers saturated - refusing to add owner.";
+    Send(connection, OwnerAdded(request_id, MakeError(CommonErrors::unable_to_handle_request)));
+  }
+}
+
+void VaultManager::HandleResumeSessionRequest(tcp::ConnectionPtr connection,
+                                              ResumeSessionRequest&& resume_session_request) {
+  passport::PublicMaid::Name client_name;
+  try {
+    client_name = session_tickets_.Redeem(resume_session_request.ticket);
+  } catch (const std::exception& e) {
+    LOG(kInfo) << "Refused session ticket, falling back to challenge: "
+               << boost::diagnostic_information(e);
+    return HandleValidateConnectionRequest(connection);
+  }
+  RemoveFromNewConnections(connection);
+  client_connections_->AddValidated(connection, client_name);
+  Send(connection, SessionTicket(session_tickets_.Issue(client_name)));
+}
 
 void VaultManager::HandleStartVaultRequest(tcp::ConnectionPtr connection,
                                            StartVaultRequest&& start_vault_request) {
-  maidsafe_error error{MakeError(CommonErrors::unknown)};
-  VaultInfo vault_info;
-  try {
-    passport::PublicMaid::Name client_name{client_connections_->FindValidated(connection)};
-    vault_info.label = std::move(start_vault_request.vault_label);
+  std::vector<StartVaultRequest> start_vault_requests;
+  start_vault_requests.emplace_back(std::move(start_vault_request));
+  StartVaults(connection, std::move(start_vault_requests));
+}
+
+void VaultManager::HandleBatchStartVaultRequest(tcp::ConnectionPtr connection,
+                                                BatchStartVaultRequest&& batch_request) {
+  LOG(kVerbose) << "Received request to start " << batch_request.requests.size() << " vaults.";
+  // ClientInterface never sends more than this in one batch.
+  while (batch_request.requests.size() > kMaxVaultsPerBatch) {
+    const StartVaultRequest& refused(batch_request.requests.back());
+    SendVaultRunningError(connection, refused.vault_label, refused.request_id,
+                          std::make_exception_ptr(
+                              MakeError(CommonErrors::unable_to_handle_request)));
+    batch_request.requests.pop_back();
+  }
+  StartVaults(connection, std::move(batch_request.requests));
+}
+
+void VaultManager::StartVaults(tcp::ConnectionPtr connection,
+                               std::vector<StartVaultRequest> start_vault_requests) {
+  bool added_vault(false);
+  std::vector<NonEmptyString> labels_awaiting_identity;
+  for (auto& start_vault_request : start_vault_requests) {
+    // Each request in a batch may be made on behalf of a different owner of the connection.
+    passport::PublicMaid::Name client_name;
+    try {
+      client_name = client_connections_->FindOwner(connection, start_vault_request.owner);
+    } catch (...) {
+      SendVaultRunningError(connection, start_vault_request.vault_label,
+                            start_vault_request.request_id, std::current_exception());
+      continue;
+    }
+    if (process_manager_->Contains(start_vault_request.vault_label) ||
+        vaults_awaiting_identity_.count(start_vault_request.vault_label) != 0) {
+      HandleReplayedStartVaultRequest(connection, client_name, start_vault_request);
+      continue;
+    }
+    VaultInfo vault_info;
+    vault_info.label = start_vault_request.vault_label;
+    vault_info.request_id = start_vault_request.request_id;
+    vault_info.requester = connection;
+    vault_info.vault_dir = std::move(start_vault_request.vault_dir);
     vault_info.max_disk_usage = start_vault_request.max_disk_usage;
     vault_info.owner_name = client_name;
 #ifdef TESTING
     if (start_vault_request.pmid_list_index) {
-      vault_info.pmid_and_signer = std::make_shared<passport::PmidAndSigner>(
-          GetPmidAndSigner(*start_vault_request.pmid_list_index));
+      try {
+        vault_info.pmid_and_signer = std::make_shared<passport::PmidAndSigner>(
+            GetPmidAndSigner(*start_vault_request.pmid_list_index));
+      } catch (...) {
+        SendVaultRunningError(connection, vault_info.label, vault_info.request_id,
+                              std::current_exception());
+        continue;
+      }
     }
 #endif
-    if (!vault_info.pmid_and_signer) {
-      vault_info.pmid_and_signer =
-          std::make_shared<passport::PmidAndSigner>(passport::CreatePmidAndSigner());
-      PutPmidAndSigner(*vault_info.pmid_and_signer);
-    }
-    if (start_vault_request.vault_dir.empty()) {
-      vault_info.vault_dir = GetVaultDir(DebugId(vault_info.pmid_and_signer->first.name().value));
-      if (!fs::exists(vault_info.vault_dir))
-        fs::create_directories(vault_info.vault_dir);
-    } else {
-      vault_info.vault_dir = std::move(start_vault_request.vault_dir);
-    }
 #ifdef USE_VLOGGING
     vault_info.vlog_session_id = std::move(start_vault_request.vlog_session_id);
 #ifdef TESTING
@@ -279,27 +848,116 @@ void VaultManager::HandleStartVaultRequest(tcp::ConnectionPtr connection,
         start_vault_request.send_hostname_to_visualiser_server;
 #endif
 #endif
-    process_manager_->AddProcess(std::move(vault_info));
+    if (vault_info.pmid_and_signer) {
+      if (SpawnVault(std::move(vault_info)))
+        added_vault = true;
+      continue;
+    }
+    labels_awaiting_identity.push_back(vault_info.label);
+    vaults_awaiting_identity_.emplace(vault_info.label, std::move(vault_info));
+  }
+  if (added_vault)
     config_file_handler_.WriteConfigFile(process_manager_->GetAll());
+  if (labels_awaiting_identity.empty())
     return;
-  } catch (const maidsafe_error& e) {
-    LOG(kWarning) << boost::diagnostic_information(e);
-    error = e;
-  } catch (const std::exception& e) {
-    LOG(kWarning) << boost::diagnostic_information(e);
+
+  // Generating the keys (once per vault) and the Puts would each hold the strand far longer than
+  // other connections' handshakes and timeouts can wait, so both are done off the strand.  Each
+  // vault process is spawned as soon as its identity is stored; the VaultRunningResponse for each
+  // is sent independently once that vault connects (see HandleVaultStarted).  The config file is
+  // written once the whole batch is done.
+  identity_store_service_.service().post([this, labels_awaiting_identity] {
+    std::vector<NonEmptyString> labels;
+    std::vector<std::shared_ptr<passport::PmidAndSigner>> pmids_and_signers;
+    for (const auto& label : labels_awaiting_identity) {
+      try {
+        pmids_and_signers.push_back(
+            std::make_shared<passport::PmidAndSigner>(passport::CreatePmidAndSigner()));
+        labels.push_back(label);
+      } catch (...) {
+        std::exception_ptr error{std::current_exception()};
+        strand_.post([this, label, error] { HandleIdentityStored(label, nullptr, error); });
+      }
+    }
+    PutPmidsAndSigners(pmids_and_signers, [&](std::size_t index, std::exception_ptr error) {
+      NonEmptyString label{labels[index]};
+      std::shared_ptr<passport::PmidAndSigner> pmid_and_signer{pmids_and_signers[index]};
+      strand_.post([this, label, pmid_and_signer, error] {
+        HandleIdentityStored(label, pmid_and_signer, error);
+      });
+    });
+    strand_.post([this] { config_file_handler_.WriteConfigFile(process_manager_->GetAll()); });
+  });
+}
+
+void VaultManager::HandleIdentityStored(const NonEmptyString& label,
+                                        std::shared_ptr<passport::PmidAndSigner> pmid_and_signer,
+                                        std::exception_ptr error) {
+  auto itr(vaults_awaiting_identity_.find(label));
+  if (itr == std::end(vaults_awaiting_identity_))
+    return;
+  VaultInfo vault_info{std::move(itr->second)};
+  vaults_awaiting_identity_.erase(itr);
+  tcp::ConnectionPtr requester{vault_info.requester.lock()};
+  if (!error) {
+    vault_info.pmid_and_signer = std::move(pmid_and_signer);
+    SpawnVault(std::move(vault_info));
+  } else if (requester) {
+    SendVaultRunningError(requester, vault_info.label, vault_info.request_id, error);
+  }
+}
+
+bool VaultManager::SpawnVault(VaultInfo vault_info) {
+  try {
+    if (vault_info.vault_dir.empty()) {
+      vault_info.vault_dir = GetVaultDir(DebugId(vault_info.pmid_and_signer->first.name().value));
+      if (!fs::exists(vault_info.vault_dir))
+        fs::create_directories(vault_info.vault_dir);
+    }
+    process_manager_->AddProcess(vault_info);
+    return true;
+  } catch (...) {
+    tcp::ConnectionPtr requester{vault_info.requester.lock()};
+    if (requester) {
+      SendVaultRunningError(requester, vault_info.label, vault_info.request_id,
+                            std::current_exception());
+    }
   }
-  LOG(kError) << "VaultManager::HandleStartVaultRequest reporting error";
-  Send(connection, VaultRunningResponse(std::move(vault_info.label), std::move(error)));
+  return false;
 }
 
 void VaultManager::HandleTakeOwnershipRequest(tcp::ConnectionPtr connection,
                                               TakeOwnershipRequest&& take_ownership_request) {
-  maidsafe_error error{MakeError(CommonErrors::unknown)};
-  VaultInfo vault_info;
+  if (TakeOwnership(connection, std::move(take_ownership_request)))
+    config_file_handler_.WriteConfigFile(process_manager_->GetAll());
+}
+
+void VaultManager::HandleBatchTakeOwnershipRequest(tcp::ConnectionPtr connection,
+                                                   BatchTakeOwnershipRequest&& batch_request) {
+  while (batch_request.requests.size() > kMaxVaultsPerBatch) {
+    const TakeOwnershipRequest& refused(batch_request.requests.back());
+    SendVaultRunningError(connection, refused.vault_label, refused.request_id,
+                          std::make_exception_ptr(
+                              MakeError(CommonErrors::unable_to_handle_request)));
+    batch_request.requests.pop_back();
+  }
+  bool config_changed(false);
+  for (auto& take_ownership_request : batch_request.requests) {
+    if (TakeOwnership(connection, std::move(take_ownership_request)))
+      config_changed = true;
+  }
+  if (config_changed)
+    config_file_handler_.WriteConfigFile(process_manager_->GetAll());
+}
+
+bool VaultManager::TakeOwnership(tcp::ConnectionPtr connection,
+                                 TakeOwnershipRequest&& take_ownership_request) {
+  NonEmptyString label{take_ownership_request.vault_label};
+  const uint64_t request_id{take_ownership_request.request_id};
   try {
-    passport::PublicMaid::Name client_name{client_connections_->FindValidated(connection)};
+    passport::PublicMaid::Name client_name{
+        client_connections_->FindOwner(connection, take_ownership_request.owner)};
 
-    NonEmptyString label{take_ownership_request.vault_label};
     fs::path new_vault_dir{take_ownership_request.vault_dir};
     DiskUsage new_max_disk_usage{take_ownership_request.max_disk_usage};
     VaultInfo vault_info{process_manager_->Find(label)};
@@ -308,59 +966,126 @@ void VaultManager::HandleTakeOwnershipRequest(tcp::ConnectionPtr connection,
       vault_info.vault_dir = new_vault_dir;
       vault_info.max_disk_usage = new_max_disk_usage;
       vault_info.owner_name = client_name;
-      return ChangeChunkstorePath(std::move(vault_info));
+      vault_info.request_id = request_id;
+      vault_info.requester = connection;
+      ChangeChunkstorePath(std::move(vault_info));
+      return false;
     }
 
     if (vault_info.max_disk_usage != new_max_disk_usage && new_max_disk_usage != 0U)
-      Send(vault_info.tcp_connection, MaxDiskUsageUpdate(new_max_disk_usage));
+      Send(vault_info.tcp_connection, MaxDiskUsageUpdate(new_max_disk_usage),
+           peer_capabilities_->CompactMessages(vault_info.tcp_connection));
 
     process_manager_->AssignOwner(label, client_name, new_max_disk_usage);
-    config_file_handler_.WriteConfigFile(process_manager_->GetAll());
-    Send(connection,
-         VaultRunningResponse(std::move(label), std::move(*vault_info.pmid_and_signer)));
+    SendVaultRunningResponse(connection, label, request_id, vault_info.pmid_and_signer);
+    return true;
+  } catch (...) {
+    SendVaultRunningError(connection, label, request_id, std::current_exception());
+  }
+  return false;
+}
+
+void VaultManager::HandleReplayedStartVaultRequest(
+    tcp::ConnectionPtr connection, const passport::PublicMaid::Name& client_name,
+    const StartVaultRequest& start_vault_request) {
+  NonEmptyString label{start_vault_request.vault_label};
+  const uint64_t request_id{start_vault_request.request_id};
+  auto awaiting_identity(vaults_awaiting_identity_.find(label));
+  if (awaiting_identity != std::end(vaults_awaiting_identity_)) {
+    if (awaiting_identity->second.owner_name != client_name) {
+      LOG(kError) << "Vault process with label " << label.string() << " already exists.";
+      return SendVaultRunningError(connection, label, request_id,
+                                   std::make_exception_ptr(
+                                       MakeError(CommonErrors::already_initialised)));
+    }
+    // The response will be sent on this connection once the vault has started.
+    awaiting_identity->second.request_id = request_id;
+    awaiting_identity->second.requester = connection;
     return;
+  }
+  VaultInfo vault_info{process_manager_->Find(label)};
+  if (vault_info.owner_name != client_name) {
+    LOG(kError) << "Vault process with label " << label.string() << " already exists.";
+    return SendVaultRunningError(connection, label, request_id,
+                                 std::make_exception_ptr(
+                                     MakeError(CommonErrors::already_initialised)));
+  }
+  if (!vault_info.tcp_connection)
+    return process_manager_->AssignRequest(label, request_id, connection);
+  SendVaultRunningResponse(connection, label, request_id, vault_info.pmid_and_signer);
+}
+
+void VaultManager::SendVaultRunningResponse(
+    tcp::ConnectionPtr connection, const NonEmptyString& label, uint64_t request_id,
+    std::shared_ptr<passport::PmidAndSigner> pmid_and_signer) {
+  SerialiseAndSend(connection, [this, label, request_id, pmid_and_signer] {
+    return Serialise(VaultRunningResponse::tag,
+                     VaultRunningResponse(label, request_id,
+                                          vault_keys_cache_.Get(label, *pmid_and_signer)));
+  });
+}
+
+void VaultManager::SendVaultRunningError(tcp::ConnectionPtr connection,
+                                         const NonEmptyString& label, uint64_t request_id,
+                                         std::exception_ptr exception) {
+  maidsafe_error error{MakeError(CommonErrors::unknown)};
+  try {
+    std::rethrow_exception(exception);
   } catch (const maidsafe_error& e) {
     LOG(kWarning) << boost::diagnostic_information(e);
     error = e;
   } catch (const std::exception& e) {
     LOG(kWarning) << boost::diagnostic_information(e);
   }
-  Send(connection, VaultRunningResponse(std::move(vault_info.label), std::move(error)));
+  LOG(kError) << "Reporting failure to start or take ownership of vault " << label.string();
+  Send(connection, VaultRunningResponse(label, request_id, std::move(error)));
 }
 
 void VaultManager::ChangeChunkstorePath(VaultInfo vault_info) {
   // TODO(Fraser#5#): 2014-05-13 - Handle sending a "MoveChunkstoreRequest" to avoid stopping then
   //                               restarting the vault.
-  Send(vault_info.tcp_connection, VaultShutdownRequest());
+  NonEmptyString label{vault_info.label};
   ProcessManager::OnExitFunctor on_exit{
       [this, vault_info](maidsafe_error /*error*/, int /*exit_code*/) {
         process_manager_->AddProcess(std::move(vault_info));
         config_file_handler_.WriteConfigFile(process_manager_->GetAll());
       }};
-  process_manager_->StopProcess(vault_info.tcp_connection, on_exit);
+  process_manager_->StopProcess(label, on_exit);
 }
 
 void VaultManager::HandleVaultStarted(tcp::ConnectionPtr connection, VaultStarted&& vault_started) {
   // TODO(Fraser#5#): 2014-05-20 - We should validate received ProcessID since a malicious process
   //                  could have spotted a new vault process starting and jumped in with this TCP
   //                  connection before the new vault can connect, passing itself off as the new
-  //                  vault (i.e. lying about its own Process ID).
+  //                  vault (i.e. lying about its own Process ID).  This is now only the case where
+  //                  the vault couldn't be handed its config when spawned; otherwise it proves
+  //                  its identity with the adoption token it read from its config channel.
   RemoveFromNewConnections(connection);
-  VaultInfo vault_info{
-      process_manager_->HandleVaultStarted(connection, {vault_started.process_id})};
+  const bool configured{process_manager_->AwaitingConfiguredVault(vault_started.process_id)};
+  if (!vault_started.adoption_token.empty() && !configured)
+    return HandleVaultReconnected(connection, std::move(vault_started));
+  VaultInfo vault_info{process_manager_->HandleVaultStarted(
+      connection, {vault_started.process_id}, vault_started.adoption_token)};
+  WriteChildRecordsFile();
 
-  // Send vault its credentials
-  Send(vault_info.tcp_connection, VaultStartedResponse(vault_info, config_file_handler_.SymmKey(),
-                                                       config_file_handler_.SymmIv()));
+  // Send vault its credentials, unless it already has them.
+  if (!configured) {
+    crypto::AES256Key symm_key{config_file_handler_.SymmKey()};
+    crypto::AES256InitialisationVector symm_iv{config_file_handler_.SymmIv()};
+    SerialiseAndSend(vault_info.tcp_connection, [vault_info, symm_key, symm_iv] {
+      return Serialise(VaultStartedResponse::tag,
+                       VaultStartedResponse(vault_info, symm_key, symm_iv));
+    });
+  }
 
-  // If the corresponding client is connected, send it the credentials too
-  if (vault_info.owner_name->IsInitialised()) {
-    try {
-      tcp::ConnectionPtr client{client_connections_->FindValidated(vault_info.owner_name)};
-      Send(client, VaultRunningResponse(vault_info.label, *vault_info.pmid_and_signer));
-    } catch (const std::exception&) {
-    }  // We don't care if the client isn't connected.
+  // If the client which asked for this vault is still connected, send it the credentials too.  (If
+  // it has reconnected since, it will replay the request and be answered then.)
+  tcp::ConnectionPtr requester{vault_info.requester.lock()};
+  if (requester) {
+    SendVaultRunningResponse(requester, vault_info.label, vault_info.request_id,
+                             vault_info.pmid_and_signer);
   }
+  PublishVaultEvent(vault_info, VaultEventType::kStarted, 0);
 
   LOG(kSuccess) << "Vault started.  Pmid ID: "
                 << DebugId(vault_info.pmid_and_signer->first.name().value)
@@ -368,12 +1093,32 @@ void VaultManager::HandleVaultStarted(tcp::ConnectionPtr connection, VaultStarte
                 << "  Label: " << vault_info.label.string();
 }
 
+void VaultManager::HandleVaultReconnected(tcp::ConnectionPtr connection,
+                                          VaultStarted&& vault_started) {
+  VaultInfo vault_info;
+  try {
+    vault_info = process_manager_->HandleVaultStarted(connection, {vault_started.process_id},
+                                                      vault_started.adoption_token);
+  } catch (const std::exception& e) {
+    // Most likely a vault left running by a previous VaultManager which this one didn't adopt.
+    LOG(kWarning) << "Telling unknown vault with process ID " << vault_started.process_id
+                  << " to stop: " << boost::diagnostic_information(e);
+    return Send(connection, VaultShutdownRequest(),
+                peer_capabilities_->CompactMessages(connection));
+  }
+  WriteChildRecordsFile();
+  // The vault already has its credentials, and its owner was told when it first started.
+  LOG(kSuccess) << "Vault re-adopted.  Pmid ID: "
+                << DebugId(vault_info.pmid_and_signer->first.name().value)
+                << "  Process ID: " << vault_started.process_id
+                << "  Label: " << vault_info.label.string();
+}
+
 #ifdef TESTING
 void VaultManager::HandleSetNetworkAsStable() {
   asio_service_.service().dispatch([=] {
-    std::vector<tcp::ConnectionPtr> all_clients{client_connections_->GetAll()};
-    for (const auto& client : all_clients)
-      Send(client, NetworkStableResponse());
+    for (const auto& client : client_connections_->GetAll())
+      Send(client, NetworkStableResponse(), peer_capabilities_->CompactMessages(client));
     network_stable_ = true;
   });
 }
@@ -383,7 +1128,7 @@ void VaultManager::HandleNetworkStableRequest(tcp::ConnectionPtr connection) {
     // If network is already stable send reply, else do nothing since all clients get notified once
     // stable anyway.
     if (network_stable_)
-      Send(connection, NetworkStableResponse());
+      Send(connection, NetworkStableResponse(), peer_capabilities_->CompactMessages(connection));
   });
 }
 #endif
@@ -391,24 +1136,60 @@ void VaultManager::HandleNetworkStableRequest(tcp::ConnectionPtr connection) {
 void VaultManager::HandleJoinedNetwork(tcp::ConnectionPtr connection) {
   try {
     VaultInfo vault_info(process_manager_->Find(connection));
+    PublishVaultEvent(vault_info, VaultEventType::kJoined, 0);
     // TODO(Prakash) do vault_info need joined field
     std::string log_message("Vault running as " +
                             HexSubstr(vault_info.pmid_and_signer->first.name().value));
     LOG(kInfo) << log_message;
-    tcp::ConnectionPtr client{client_connections_->FindValidated(vault_info.owner_name)};
-    Send(client, LogMessage(log_message));
+    Broadcast(client_connections_->GetSessions(vault_info.owner_name), LogMessage(log_message));
   } catch (const std::exception&) {
-  }  // We don't care if the client isn't connected.
+  }  // We don't care if the vault isn't found.
 }
 
-void VaultManager::HandleLogMessage(tcp::ConnectionPtr connection, LogMessage&& log_message) {
-  LOG(kInfo) << log_message.data;
+void VaultManager::HandleLogMessage(tcp::ConnectionPtr connection, tcp::Message&& message) {
+  if (message.size() > kMaxLogMessageSize) {
+    LOG(kWarning) << "Dropping " << message.size() << "-byte log message; the limit is "
+                  << kMaxLogMessageSize << " bytes.";
+    return;
+  }
+  VaultInfo vault_info;
   try {
-    VaultInfo vault_info(process_manager_->Find(connection));
-    tcp::ConnectionPtr client{client_connections_->FindValidated(vault_info.owner_name)};
-    Send(client, std::move(log_message));
+    vault_info = process_manager_->Find(connection);
   } catch (const std::exception&) {
-  }  // We don't care if the client isn't connected.
+    return;  // We don't care if the vault isn't found.
+  }
+  // The message is parsed only to check that it's well-formed and to log it.  The frame itself is
+  // relayed unchanged rather than being serialised again.
+  try {
+    InputVectorStream binary_input_stream{tcp::Message(message)};
+    MessageTag tag(static_cast<MessageTag>(-1));
+    Parse(binary_input_stream, tag);
+    LOG(kInfo) << "Vault " << vault_info.label.string() << ": "
+               << Parse<LogMessage>(binary_input_stream).data;
+  } catch (const std::exception& e) {
+    LOG(kWarning) << "Dropping malformed log message from vault " << vault_info.label.string()
+                  << ": " << boost::diagnostic_information(e);
+    return;
+  }
+  BroadcastSerialised(client_connections_->GetSessions(vault_info.owner_name), std::move(message));
+}
+
+void VaultManager::HandleSubscribeToVaultEvents(tcp::ConnectionPtr connection,
+                                                SubscribeToVaultEventsRequest&& request) {
+  passport::PublicMaid::Name client_name{client_connections_->FindValidated(connection)};
+  client_connections_->SubscribeToVaultEvents(connection);
+  // Replay any retained events the client hasn't seen before it starts receiving live ones.
+  for (auto& event : vault_event_log_.GetSince(client_name, request.last_sequence_number))
+    Send(connection, VaultEventNotification(std::move(event)));
+}
+
+void VaultManager::PublishVaultEvent(const VaultInfo& vault_info, VaultEventType type,
+                                     int exit_code) {
+  if (!vault_info.owner_name->IsInitialised())
+    return;
+  VaultEvent event{vault_event_log_.Add(vault_info.owner_name, type, vault_info.label, exit_code)};
+  Broadcast(client_connections_->GetVaultEventSubscribers(vault_info.owner_name),
+            VaultEventNotification(std::move(event)));
 }
 
 void VaultManager::RemoveFromNewConnections(tcp::ConnectionPtr connection) {
@@ -19,8 +19,15 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_VAULT_MANAGER_H_
 #define MAIDSAFE_VAULT_MANAGER_VAULT_MANAGER_H_
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "asio/io_service_strand.hpp"
 #include "boost/filesystem/path.hpp"
@@ -30,70 +37,238 @@
 #include "maidsafe/common/types.h"
 #include "maidsafe/passport/types.h"
 
+#include "maidsafe/vault_manager/admission_control.h"
+#include "maidsafe/vault_manager/child_records.h"
 #include "maidsafe/vault_manager/config.h"
 #include "maidsafe/vault_manager/config_file_handler.h"
+#include "maidsafe/vault_manager/crypto_executor.h"
+#include "maidsafe/vault_manager/peer_capabilities.h"
+#include "maidsafe/vault_manager/send_queues.h"
+#include "maidsafe/vault_manager/session_tickets.h"
+#include "maidsafe/vault_manager/timing_wheel.h"
+#include "maidsafe/vault_manager/vault_event.h"
+#include "maidsafe/vault_manager/vault_event_log.h"
 #include "maidsafe/vault_manager/vault_info.h"
+#include "maidsafe/vault_manager/vault_keys_cache.h"
 
 namespace maidsafe {
 
 namespace vault_manager {
 
+struct AddOwnerRequest;
+struct BatchStartVaultRequest;
+struct BatchTakeOwnershipRequest;
+struct Capabilities;
 struct ChallengeResponse;
 class ClientConnections;
-struct LogMessage;
 class NewConnections;
+struct OwnerChallengeResponse;
 class ProcessManager;
+struct ResumeSessionRequest;
 struct StartVaultRequest;
+struct SubscribeToVaultEventsRequest;
 struct TakeOwnershipRequest;
+class TrafficCaptureWriter;
 struct VaultStarted;
 
 // The VaultManager has several responsibilities:
 // * Reads config file on startup and restarts vaults listed in file.
 // * Writes details of all vaults to config file.
-// * Listens and responds to client and vault requests on the loopback address.
+// * Listens and responds to client and vault requests on the loopback address, limiting the rate
+//   and number of new connections it will accept.
+// * Issues session tickets to validated clients so that they can reconnect without repeating the
+//   challenge.
+// * Lets a client authenticate several Maids over one connection, acting for any of them.
+// * Notifies subscribed clients of state changes of the vaults they own.
+// * On request, re-reads the config file and applies only the differences to the running vaults.
+// * Records the running vault processes so that a restarted VaultManager can re-adopt them.
+// * On request, captures its inbound traffic for later replay (see traffic_capture.h).
 class VaultManager {
  public:
+  // Time spent on the strand handling inbound messages of one tag, including parsing them but not
+  // work passed to the crypto workers.
+  struct HandlerTiming {
+    HandlerTiming() : count(0), total(0), max(0) {}
+    uint64_t count;
+    std::chrono::nanoseconds total, max;
+  };
+
   VaultManager(const VaultManager&) = delete;
   VaultManager(VaultManager&&) = delete;
   VaultManager operator=(VaultManager) = delete;
 
-  VaultManager();
+  // 'inherited_listener_fd' is the listening socket handed over by the previous process image when
+  // re-executed (see DetachForReExec), or -1.  If 'vaults_per_host' is non-zero, vaults are run as
+  // threads of vault host processes rather than as processes of their own (see vault_host.h).
+  explicit VaultManager(std::size_t crypto_thread_count = kCryptoThreadCount,
+                        AdmissionControl::Limits admission_limits = AdmissionControl::Limits(),
+                        int inherited_listener_fd = -1, std::size_t vaults_per_host = 0);
   ~VaultManager();
 
   void TearDownWithInterval();
+  // Re-reads the config file and the optional operator overrides file, then starts, stops, resizes
+  // or relocates only those vaults which differ from the running set.  Threadsafe.
+  void ReloadConfig();
+  // If called before destruction, the vaults are left running (e.g. while the VaultManager is
+  // upgraded) and will be re-adopted by the next VaultManager to start.  Threadsafe.
+  void LeaveVaultsRunning();
+  // Writes the config and child records, closes all connections and releases the vaults, ready for
+  // the process image to be replaced by ReExec.  Returns the listening socket's descriptor for the
+  // new image to inherit.  The vaults reconnect with backoff and are re-adopted by the new image;
+  // each has kAdoptionTimeout from its adoption to do so, which covers its longest delay however
+  // long the new image takes to start.  Afterwards, the only valid operation is destruction, which
+  // then leaves the vaults running.
+  int DetachForReExec();
+  // Counters of connections and challenges admitted or refused.  Threadsafe.
+  AdmissionControl::Stats GetAdmissionStats() const;
+  // Records every inbound connection and message to 'capture_file', replacing any capture already
+  // in progress.  Throws if the file can't be created.  Threadsafe.
+  void StartCapture(const boost::filesystem::path& capture_file);
+  // Returns once the capture file is complete.  Threadsafe.
+  void StopCapture();
+  // Starts timing the handling of inbound messages, which costs nothing until then.  Threadsafe.
+  void StartHandlerTimings();
+  // Handler timings by tag of all messages received since StartHandlerTimings.  Threadsafe.
+  std::map<MessageTag, HandlerTiming> GetHandlerTimings();
 
  private:
+  // Listens on the initial port, or adopts the socket inherited from the previous process image.
+  std::shared_ptr<tcp::Listener> MakeListener(int inherited_listener_fd);
   void HandleNewConnection(tcp::ConnectionPtr connection);
+  void RecordHandlerTiming(MessageTag tag, std::chrono::steady_clock::time_point start);
   void HandleConnectionClosed(tcp::ConnectionPtr connection);
   void HandleReceivedMessage(tcp::ConnectionPtr connection, tcp::Message&& message);
+  // Handles a message on a connection admitted beyond the rate limit because vaults are yet to
+  // connect.  Until it has identified itself as one of those vaults, the connection is closed on
+  // receipt of anything other than Capabilities or VaultStarted.
+  void HandleUnidentifiedVaultMessage(tcp::ConnectionPtr connection, tcp::Message&& message);
+  void HandleCompactMessage(tcp::ConnectionPtr connection, const tcp::Message& message);
+  // From Client or Vault
+  void HandleCapabilities(tcp::ConnectionPtr connection, Capabilities&& capabilities);
 
   // Messages from Client
   void HandleValidateConnectionRequest(tcp::ConnectionPtr connection);
   void HandleChallengeResponse(tcp::ConnectionPtr connection,
                                ChallengeResponse&& challenge_response);
+  void HandleAddOwnerRequest(tcp::ConnectionPtr connection, AddOwnerRequest&& add_owner_request);
+  void HandleOwnerChallengeResponse(tcp::ConnectionPtr connection,
+                                    OwnerChallengeResponse&& challenge_response);
+  void HandleResumeSessionRequest(tcp::ConnectionPtr connection,
+                                  ResumeSessionRequest&& resume_session_request);
   void HandleStartVaultRequest(tcp::ConnectionPtr connection,
                                StartVaultRequest&& start_vault_request);
   void HandleTakeOwnershipRequest(tcp::ConnectionPtr connection,
                                   TakeOwnershipRequest&& take_ownership_request);
+  void HandleBatchStartVaultRequest(tcp::ConnectionPtr connection,
+                                    BatchStartVaultRequest&& batch_request);
+  void HandleBatchTakeOwnershipRequest(tcp::ConnectionPtr connection,
+                                       BatchTakeOwnershipRequest&& batch_request);
   void HandleSetNetworkAsStable();
   void HandleNetworkStableRequest(tcp::ConnectionPtr connection);
+  void HandleSubscribeToVaultEvents(tcp::ConnectionPtr connection,
+                                    SubscribeToVaultEventsRequest&& request);
 
   // Messages from Vault
   void HandleVaultStarted(tcp::ConnectionPtr connection, VaultStarted&& vault_started);
+  // A vault left running by a previous VaultManager reconnecting with its adoption token.
+  void HandleVaultReconnected(tcp::ConnectionPtr connection, VaultStarted&& vault_started);
   void HandleJoinedNetwork(tcp::ConnectionPtr connection);
-  void HandleLogMessage(tcp::ConnectionPtr connection, LogMessage&& log_message);
+  // Logs the vault's log message, then relays the frame unchanged to its owner's clients.  Frames
+  // larger than kMaxLogMessageSize or which don't parse are dropped.
+  void HandleLogMessage(tcp::ConnectionPtr connection, tcp::Message&& message);
 
+  void DoReloadConfig();
+  // Re-adopts the vault if its process was left running by a previous VaultManager, otherwise
+  // starts it.
+  void AdoptOrStartVault(VaultInfo vault_info, const std::vector<ChildRecord>& child_records);
+  void WriteChildRecordsFile();
+  // Writes the discovery file so that clients can connect without scanning the port range.
+  void PublishEndpoint();
   void RemoveFromNewConnections(tcp::ConnectionPtr connection);
   void ChangeChunkstorePath(VaultInfo vault_info);
+  // Provisions all the requested vaults, spawning each as soon as its identity is stored.  Failures
+  // are reported to the client per vault; successes are reported as each vault connects.
+  void StartVaults(tcp::ConnectionPtr connection,
+                   std::vector<StartVaultRequest> start_vault_requests);
+  // Spawns the vault whose new identity has been created and stored, or reports 'error' to its
+  // requester.
+  void HandleIdentityStored(const NonEmptyString& label,
+                            std::shared_ptr<passport::PmidAndSigner> pmid_and_signer,
+                            std::exception_ptr error);
+  // Returns false if the vault couldn't be added, having reported the failure to its requester.
+  bool SpawnVault(VaultInfo vault_info);
+  // Returns true if the config file needs to be rewritten as a result.
+  bool TakeOwnership(tcp::ConnectionPtr connection, TakeOwnershipRequest&& take_ownership_request);
+  // A reconnecting client replays any StartVaultRequest it didn't get a response to.  If the vault
+  // is already running, this answers the request; if it's still starting, the response will be
+  // sent once it connects.
+  void HandleReplayedStartVaultRequest(tcp::ConnectionPtr connection,
+                                       const passport::PublicMaid::Name& client_name,
+                                       const StartVaultRequest& start_vault_request);
+  // Runs 'serialise' (which builds and serialises a message, encrypting any keys it holds) on the
+  // crypto workers, then sends the result from the strand.  Messages sent on the connection in the
+  // meantime are held back until it has been sent.
+  template <typename SerialiseFunctor>
+  void SerialiseAndSend(tcp::ConnectionPtr connection, SerialiseFunctor serialise);
+  // Builds the VaultStartedResponse handed to a vault as it's spawned on the crypto workers, then
+  // passes it to 'on_serialised' on the strand.
+  void SerialiseVaultConfig(const VaultInfo& vault_info,
+                            std::function<void(tcp::Message)> on_serialised);
+  // These hide the free functions of the same names, so that everything the VaultManager sends
+  // goes through 'send_queues_' and can't overtake a message passed to SerialiseAndSend earlier.
+  template <typename T>
+  void Send(tcp::ConnectionPtr connection, T message);
+  template <typename T>
+  void Send(tcp::ConnectionPtr connection, T message, bool compact);
+  template <typename T>
+  void Broadcast(const std::vector<tcp::ConnectionPtr>& connections, T message);
+  void BroadcastSerialised(const std::vector<tcp::ConnectionPtr>& connections,
+                           tcp::Message message);
+  // The vault's keys are encrypted at most once while they're held in 'vault_keys_cache_'.
+  void SendVaultRunningResponse(tcp::ConnectionPtr connection, const NonEmptyString& label,
+                                uint64_t request_id,
+                                std::shared_ptr<passport::PmidAndSigner> pmid_and_signer);
+  void SendVaultRunningError(tcp::ConnectionPtr connection, const NonEmptyString& label,
+                             uint64_t request_id, std::exception_ptr exception);
+  // Records the event in the owner's log and forwards it to all of the owner's subscribed clients.
+  void PublishVaultEvent(const VaultInfo& vault_info, VaultEventType type, int exit_code);
 
   ConfigFileHandler config_file_handler_;
   bool network_stable_, tear_down_with_interval_;
+  std::atomic<bool> leave_vaults_running_;
+  const std::string instance_id_;
+  VaultEventLog vault_event_log_;
+  AdmissionControl admission_control_;
+  SessionTickets session_tickets_;
+  // Used by the crypto workers, so must outlive 'crypto_executor_'.
+  VaultKeysCache vault_keys_cache_;
+  // Only used on the strand.
+  bool time_handlers_;
+  std::map<MessageTag, HandlerTiming> handler_timings_;
+  uint32_t connection_count_;
+  std::shared_ptr<TrafficCaptureWriter> traffic_capture_;
   AsioService asio_service_;
   asio::io_service::strand strand_;
+  // Shared by all connection and process timeouts.
+  std::shared_ptr<TimingWheel> timing_wheel_;
+  std::shared_ptr<PeerCapabilities> peer_capabilities_;
+  std::shared_ptr<SendQueues> send_queues_;
+  CryptoExecutor crypto_executor_;
   std::shared_ptr<tcp::Listener> listener_;
   std::shared_ptr<ProcessManager> process_manager_;
   std::shared_ptr<ClientConnections> client_connections_;
   std::shared_ptr<NewConnections> new_connections_;
+  // Messages received from clients whose ChallengeResponse is still being checked, to be handled
+  // once they're validated.  Only used on the strand.
+  std::map<tcp::ConnectionPtr, std::vector<tcp::Message>, std::owner_less<tcp::ConnectionPtr>>
+      messages_awaiting_validation_;
+  // Requested vaults whose new identities are being created and stored on the network, by label.
+  // Only used on the strand.
+  std::map<NonEmptyString, VaultInfo> vaults_awaiting_identity_;
+  // Creates and stores the identities of new vaults, since key generation is slow and each Put
+  // blocks.  Must be last member so that its threads are joined before anything they use is
+  // destroyed.
+  AsioService identity_store_service_;
 };
 
 }  // namespace vault_manager
@@ -22,12 +22,15 @@
 #include <signal.h>
 #endif
 
+#include <functional>
 #include <future>
 #include <iostream>
 #include <string>
-#include <thread>
+#include <system_error>
 #include <vector>
 
+#include "asio/io_service.hpp"
+#include "asio/signal_set.hpp"
 #include "boost/filesystem/path.hpp"
 #include "boost/program_options.hpp"
 #include "boost/regex.hpp"
@@ -37,6 +40,9 @@
 #include "maidsafe/common/log.h"
 #include "maidsafe/common/utils.h"
 
+#include "maidsafe/common/process.h"
+
+#include "maidsafe/vault_manager/re_exec.h"
 #include "maidsafe/vault_manager/vault_manager.h"
 #include "maidsafe/vault_manager/utils.h"
 
@@ -45,12 +51,68 @@ namespace po = boost::program_options;
 
 namespace {
 
+#ifdef MAIDSAFE_WIN32
 std::promise<void> g_shutdown_promise;
 
 void ShutDownVaultManager(int /*signal*/) {
   std::cout << "Stopping vault_manager." << std::endl;
   g_shutdown_promise.set_value();
 }
+#else
+// Blocks until the VaultManager is to stop, handling the signals which control it as they arrive.
+// Returns true if the vaults are to be left running for a replacement VaultManager to re-adopt.
+//   SIGINT, SIGTERM - stop, stopping the vaults.
+//   SIGUSR1 - stop, leaving the vaults running (used when upgrading the VaultManager).
+//   SIGHUP - reload the config.
+//   SIGUSR2 - replace this process with the (possibly upgraded) vault_manager binary, keeping the
+//             listening socket and the vaults.
+bool WaitForShutdown(maidsafe::vault_manager::VaultManager& vault_manager, int argc, char** argv) {
+  asio::io_service io_service;
+  asio::signal_set signals(io_service, SIGINT, SIGTERM);
+  signals.add(SIGHUP);
+  signals.add(SIGUSR1);
+  signals.add(SIGUSR2);
+  bool leave_vaults_running(false);
+  std::function<void(const std::error_code&, int)> on_signal;
+  on_signal = [&](const std::error_code& error_code, int signal_number) {
+    if (error_code)
+      return;
+    switch (signal_number) {
+      case SIGHUP:
+        LOG(kInfo) << "SIGHUP received - reloading config.";
+        vault_manager.ReloadConfig();
+        break;
+      case SIGUSR2:
+        LOG(kInfo) << "SIGUSR2 received - re-executing vault_manager.";
+        try {
+          int listener_fd(vault_manager.DetachForReExec());
+          // Not /proc/self/exe, since that still refers to the replaced binary after an upgrade.
+          maidsafe::vault_manager::ReExec(
+              maidsafe::process::GetOtherExecutablePath(fs::path(argv[0]).filename()),
+              std::vector<std::string>(argv + 1, argv + argc), listener_fd);
+        } catch (const std::exception& e) {
+          // The connections have already been handed off, so this process can't carry on serving.
+          LOG(kError) << "Failed to re-execute vault_manager: " << e.what();
+          leave_vaults_running = true;
+          return;
+        }
+        break;
+      case SIGUSR1:
+        leave_vaults_running = true;
+        std::cout << "Stopping vault_manager." << std::endl;
+        return;
+      default:
+        std::cout << "Stopping vault_manager." << std::endl;
+        return;
+    }
+    signals.async_wait(on_signal);
+  };
+  signals.async_wait(on_signal);
+  // Returns once no handler is waiting, i.e. once a signal to stop has been handled.
+  io_service.run();
+  return leave_vaults_running;
+}
+#endif
 
 #ifdef MAIDSAFE_WIN32
 
@@ -133,13 +195,22 @@ BOOL CtrlHandler(DWORD control_type) {
 
 #endif
 
-void HandleProgramOptions(int argc, char** argv) {
+// Sets 'capture_file' if inbound traffic is to be captured for replay by vm_replay.
+int HandleProgramOptions(int argc, char** argv, fs::path& capture_file) {
   po::options_description options_description("Allowed options");
-  options_description.add_options()
+  options_description.add_options()(
+      maidsafe::vault_manager::kInheritedListenerFdOption.substr(2).c_str(), po::value<int>(),
+      "Listening socket inherited from the previous vault_manager (set automatically on re-exec)")(
+      "capture_file", po::value<std::string>(),
+      "Record all inbound connections and messages to this file, for replay by vm_replay")
 #ifdef TESTING
       ("port", po::value<int>(), "Listening port")("vault_path", po::value<std::string>(),
                                                    "Path to the vault executable including name")(
-          "root_dir", po::value<std::string>(), "Path to folder of config file")
+          "root_dir", po::value<std::string>(), "Path to folder of config file")(
+          "vault_profile", po::value<std::string>(),
+          "Behaviour of dummy vaults, e.g. startup_delay_ms=100-2000,resident_mb=64,"
+          "log_lines_per_second=10,crash_probability_per_minute=0.01,shutdown_delay_ms=500,"
+          "joined_network_delay_ms=1000")
 #endif
           ("help", "produce help message");
   po::variables_map variables_map;
@@ -173,7 +244,17 @@ void HandleProgramOptions(int argc, char** argv) {
     path_to_vault = variables_map["vault_path"].as<std::string>();
 
   maidsafe::vault_manager::test::SetEnvironment(port, root_dir, path_to_vault);
+  if (variables_map.count("vault_profile") != 0) {
+    maidsafe::vault_manager::test::SetBehaviourProfile(
+        maidsafe::vault_manager::test::ParseBehaviourProfile(
+            variables_map["vault_profile"].as<std::string>()));
+  }
 #endif
+  if (variables_map.count("capture_file") != 0)
+    capture_file = variables_map["capture_file"].as<std::string>();
+  if (variables_map.count(maidsafe::vault_manager::kInheritedListenerFdOption.substr(2)) != 0)
+    return variables_map[maidsafe::vault_manager::kInheritedListenerFdOption.substr(2)].as<int>();
+  return -1;
 }
 
 }  // unnamed namespace
@@ -183,9 +264,12 @@ int main(int argc, char** argv) {
 #ifdef MAIDSAFE_WIN32
 #ifdef TESTING
   try {
-    HandleProgramOptions(argc, argv);
+    fs::path capture_file;
+    HandleProgramOptions(argc, argv, capture_file);
     if (SetConsoleCtrlHandler(reinterpret_cast<PHANDLER_ROUTINE>(CtrlHandler), TRUE)) {
       maidsafe::vault_manager::VaultManager vault_manager;
+      if (!capture_file.empty())
+        vault_manager.StartCapture(capture_file);
       g_shutdown_promise.get_future().get();
     } else {
       LOG(kError) << "Failed to set control handler.";
@@ -206,12 +290,19 @@ int main(int argc, char** argv) {
 #endif
 #else
   try {
-    HandleProgramOptions(argc, argv);
-    maidsafe::vault_manager::VaultManager vault_manager;
+    fs::path capture_file;
+    int inherited_listener_fd(HandleProgramOptions(argc, argv, capture_file));
+    maidsafe::vault_manager::VaultManager vault_manager(
+        maidsafe::vault_manager::kCryptoThreadCount,
+        maidsafe::vault_manager::AdmissionControl::Limits(), inherited_listener_fd);
+    if (!capture_file.empty())
+      vault_manager.StartCapture(capture_file);
     std::cout << "Successfully started vault_manager" << std::endl;
-    signal(SIGINT, ShutDownVaultManager);
-    signal(SIGTERM, ShutDownVaultManager);
-    g_shutdown_promise.get_future().get();
+    const bool kLeaveVaultsRunning(WaitForShutdown(vault_manager, argc, argv));
+    if (!capture_file.empty())
+      vault_manager.StopCapture();
+    if (kLeaveVaultsRunning)
+      vault_manager.LeaveVaultsRunning();
     std::cout << "Successfully stopped vault_manager" << std::endl;
   } catch (const std::exception& e) {
     LOG(kError) << "Error: " << e.what();